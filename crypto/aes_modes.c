@@ -0,0 +1,477 @@
+/****************************************************************************
+ * crypto/aes_modes.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/crypto/aes.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of counter blocks that are enciphered by one call of
+ * aes_encipher(), which lets an up_aes_encipher() pipeline the blocks.
+ */
+
+#define AES_CTR_NBLK 4
+
+#define GETU64(p) \
+  (((uint64_t)(p)[0] << 56) | ((uint64_t)(p)[1] << 48) | \
+   ((uint64_t)(p)[2] << 40) | ((uint64_t)(p)[3] << 32) | \
+   ((uint64_t)(p)[4] << 24) | ((uint64_t)(p)[5] << 16) | \
+   ((uint64_t)(p)[6] << 8)  |  (uint64_t)(p)[7])
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The reduction of the four bits that are shifted out of the low end of
+ * a GHASH value, times x^128 = x^7 + x^2 + x + 1.
+ */
+
+static const uint16_t g_last4[16] =
+{
+  0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+  0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: putu64
+ ****************************************************************************/
+
+static void putu64(FAR uint8_t *p, uint64_t v)
+{
+  int i;
+
+  for (i = 7; i >= 0; i--)
+    {
+      p[i] = (uint8_t)v;
+      v >>= 8;
+    }
+}
+
+/****************************************************************************
+ * Name: ctr_increment
+ *
+ * Description:
+ *   Increment the last width bytes of a counter block as a big-endian
+ *   number.
+ *
+ ****************************************************************************/
+
+static void ctr_increment(FAR uint8_t *ctr, int width)
+{
+  int i;
+
+  for (i = AES_BLOCK_SIZE - 1; i >= AES_BLOCK_SIZE - width; i--)
+    {
+      if (++ctr[i] != 0)
+        {
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: ctr_crypt
+ *
+ * Description:
+ *   XOR data with the key stream of a counter block whose last width
+ *   bytes are incremented per block:  16 for CTR mode and 4 for GCM.
+ *
+ ****************************************************************************/
+
+static void ctr_crypt(FAR struct aes_state_s *state, FAR uint8_t *ctr,
+                      int width, FAR const uint8_t *in, FAR uint8_t *out,
+                      size_t len)
+{
+  uint8_t stream[AES_CTR_NBLK * AES_BLOCK_SIZE];
+  size_t nbytes;
+  size_t i;
+  int nblk;
+  int j;
+
+  while (len > 0)
+    {
+      nblk = (len + AES_BLOCK_SIZE - 1) / AES_BLOCK_SIZE;
+      if (nblk > AES_CTR_NBLK)
+        {
+          nblk = AES_CTR_NBLK;
+        }
+
+      for (j = 0; j < nblk; j++)
+        {
+          memcpy(stream + j * AES_BLOCK_SIZE, ctr, AES_BLOCK_SIZE);
+          ctr_increment(ctr, width);
+        }
+
+      aes_encipher(state, stream, nblk);
+
+      nbytes = nblk * AES_BLOCK_SIZE;
+      if (nbytes > len)
+        {
+          nbytes = len;
+        }
+
+      for (i = 0; i < nbytes; i++)
+        {
+          out[i] = in[i] ^ stream[i];
+        }
+
+      in  += nbytes;
+      out += nbytes;
+      len -= nbytes;
+    }
+}
+
+/****************************************************************************
+ * Name: gcm_mult
+ *
+ * Description:
+ *   Multiply a GHASH value by H in GF(2^128), four bits at a time with the
+ *   precomputed multiples of H (Shoup's method).
+ *
+ ****************************************************************************/
+
+static void gcm_mult(FAR struct aes_gcm_s *gcm, FAR uint8_t *x)
+{
+  uint64_t zh;
+  uint64_t zl;
+  uint8_t rem;
+  uint8_t lo;
+  uint8_t hi;
+  int i;
+
+  lo = x[15] & 0x0f;
+  zh = gcm->hh[lo];
+  zl = gcm->hl[lo];
+
+  for (i = 15; i >= 0; i--)
+    {
+      lo = x[i] & 0x0f;
+      hi = x[i] >> 4;
+
+      if (i != 15)
+        {
+          rem = (uint8_t)zl & 0x0f;
+          zl  = (zh << 60) | (zl >> 4);
+          zh  = (zh >> 4) ^ ((uint64_t)g_last4[rem] << 48);
+          zh ^= gcm->hh[lo];
+          zl ^= gcm->hl[lo];
+        }
+
+      rem = (uint8_t)zl & 0x0f;
+      zl  = (zh << 60) | (zl >> 4);
+      zh  = (zh >> 4) ^ ((uint64_t)g_last4[rem] << 48);
+      zh ^= gcm->hh[hi];
+      zl ^= gcm->hl[hi];
+    }
+
+  putu64(x, zh);
+  putu64(x + 8, zl);
+}
+
+/****************************************************************************
+ * Name: gcm_ghash
+ *
+ * Description:
+ *   Add data to a GHASH value.  A partial last block is padded with zeros.
+ *
+ ****************************************************************************/
+
+static void gcm_ghash(FAR struct aes_gcm_s *gcm, FAR uint8_t *y,
+                      FAR const uint8_t *data, size_t len)
+{
+  size_t nbytes;
+  size_t i;
+
+  while (len > 0)
+    {
+      nbytes = len < AES_BLOCK_SIZE ? len : AES_BLOCK_SIZE;
+      for (i = 0; i < nbytes; i++)
+        {
+          y[i] ^= data[i];
+        }
+
+      gcm_mult(gcm, y);
+
+      data += nbytes;
+      len  -= nbytes;
+    }
+}
+
+/****************************************************************************
+ * Name: gcm_lengths
+ *
+ * Description:
+ *   Add the block of two 64-bit bit lengths that ends a GHASH input.
+ *
+ ****************************************************************************/
+
+static void gcm_lengths(FAR struct aes_gcm_s *gcm, FAR uint8_t *y,
+                        uint64_t len1, uint64_t len2)
+{
+  uint8_t block[AES_BLOCK_SIZE];
+
+  putu64(block, len1 * 8);
+  putu64(block + 8, len2 * 8);
+  gcm_ghash(gcm, y, block, AES_BLOCK_SIZE);
+}
+
+/****************************************************************************
+ * Name: gcm_start
+ *
+ * Description:
+ *   Derive the first counter block J0 from the IV.  The key stream starts
+ *   at J0 + 1; J0 itself encrypts the tag.
+ *
+ ****************************************************************************/
+
+static int gcm_start(FAR struct aes_gcm_s *gcm, FAR uint8_t *j0,
+                     FAR const uint8_t *iv, size_t ivlen, size_t taglen)
+{
+  if (ivlen == 0 || taglen < AES_GCM_MINTAG || taglen > AES_GCM_MAXTAG)
+    {
+      return -EINVAL;
+    }
+
+  memset(j0, 0, AES_BLOCK_SIZE);
+
+  if (ivlen == 12)
+    {
+      memcpy(j0, iv, ivlen);
+      j0[15] = 1;
+    }
+  else
+    {
+      gcm_ghash(gcm, j0, iv, ivlen);
+      gcm_lengths(gcm, j0, 0, ivlen);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: gcm_tag
+ *
+ * Description:
+ *   Compute the full authentication tag of a message from its additional
+ *   data and its cipher text.
+ *
+ ****************************************************************************/
+
+static void gcm_tag(FAR struct aes_gcm_s *gcm, FAR const uint8_t *j0,
+                    FAR const uint8_t *aad, size_t aadlen,
+                    FAR const uint8_t *text, size_t len,
+                    FAR uint8_t *tag)
+{
+  uint8_t ek0[AES_BLOCK_SIZE];
+  int i;
+
+  memset(tag, 0, AES_BLOCK_SIZE);
+  gcm_ghash(gcm, tag, aad, aadlen);
+  gcm_ghash(gcm, tag, text, len);
+  gcm_lengths(gcm, tag, aadlen, len);
+
+  memcpy(ek0, j0, AES_BLOCK_SIZE);
+  aes_encipher(&gcm->aes, ek0, 1);
+
+  for (i = 0; i < AES_BLOCK_SIZE; i++)
+    {
+      tag[i] ^= ek0[i];
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aes_ctr
+ *
+ * Description:
+ *   Encrypt or decrypt data in CTR mode.  See include/nuttx/crypto/aes.h.
+ *
+ ****************************************************************************/
+
+void aes_ctr(FAR struct aes_state_s *state, FAR uint8_t *ctr,
+             FAR const uint8_t *in, FAR uint8_t *out, size_t len)
+{
+  ctr_crypt(state, ctr, AES_BLOCK_SIZE, in, out, len);
+}
+
+/****************************************************************************
+ * Name: aes_gcm_setkey
+ *
+ * Description:
+ *   Set up the AES key and the GHASH tables of a GCM context.  The table
+ *   holds i * H for all 4-bit values of i, in the bit-reflected order of
+ *   GCM:  Entry 8 is H, entries 4, 2 and 1 are H times x, x^2 and x^3, and
+ *   the other entries are sums of those.
+ *
+ ****************************************************************************/
+
+int aes_gcm_setkey(FAR struct aes_gcm_s *gcm, FAR const uint8_t *key,
+                   int len)
+{
+  uint8_t h[AES_BLOCK_SIZE];
+  uint64_t vh;
+  uint64_t vl;
+  uint32_t t;
+  int ret;
+  int i;
+  int j;
+
+  ret = aes_setupkey(&gcm->aes, key, len);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memset(h, 0, AES_BLOCK_SIZE);
+  aes_encipher(&gcm->aes, h, 1);
+
+  vh = GETU64(h);
+  vl = GETU64(h + 8);
+
+  gcm->hh[0] = 0;
+  gcm->hl[0] = 0;
+  gcm->hh[8] = vh;
+  gcm->hl[8] = vl;
+
+  for (i = 4; i > 0; i >>= 1)
+    {
+      t  = (uint32_t)(vl & 1) * 0xe1000000;
+      vl = (vh << 63) | (vl >> 1);
+      vh = (vh >> 1) ^ ((uint64_t)t << 32);
+
+      gcm->hh[i] = vh;
+      gcm->hl[i] = vl;
+    }
+
+  for (i = 2; i <= 8; i <<= 1)
+    {
+      for (j = 1; j < i; j++)
+        {
+          gcm->hh[i + j] = gcm->hh[i] ^ gcm->hh[j];
+          gcm->hl[i + j] = gcm->hl[i] ^ gcm->hl[j];
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aes_gcm_encrypt
+ *
+ * Description:
+ *   Encrypt a message and compute its authentication tag with AES-GCM.
+ *   See include/nuttx/crypto/aes.h.
+ *
+ ****************************************************************************/
+
+int aes_gcm_encrypt(FAR struct aes_gcm_s *gcm,
+                    FAR const uint8_t *iv, size_t ivlen,
+                    FAR const uint8_t *aad, size_t aadlen,
+                    FAR const uint8_t *in, FAR uint8_t *out, size_t len,
+                    FAR uint8_t *tag, size_t taglen)
+{
+  uint8_t j0[AES_BLOCK_SIZE];
+  uint8_t ctr[AES_BLOCK_SIZE];
+  uint8_t full[AES_BLOCK_SIZE];
+  int ret;
+
+  ret = gcm_start(gcm, j0, iv, ivlen, taglen);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  memcpy(ctr, j0, AES_BLOCK_SIZE);
+  ctr_increment(ctr, 4);
+  ctr_crypt(&gcm->aes, ctr, 4, in, out, len);
+
+  gcm_tag(gcm, j0, aad, aadlen, out, len, full);
+  memcpy(tag, full, taglen);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aes_gcm_decrypt
+ *
+ * Description:
+ *   Verify the authentication tag of a message and decrypt it with
+ *   AES-GCM.  See include/nuttx/crypto/aes.h.
+ *
+ ****************************************************************************/
+
+int aes_gcm_decrypt(FAR struct aes_gcm_s *gcm,
+                    FAR const uint8_t *iv, size_t ivlen,
+                    FAR const uint8_t *aad, size_t aadlen,
+                    FAR const uint8_t *in, FAR uint8_t *out, size_t len,
+                    FAR const uint8_t *tag, size_t taglen)
+{
+  uint8_t j0[AES_BLOCK_SIZE];
+  uint8_t ctr[AES_BLOCK_SIZE];
+  uint8_t full[AES_BLOCK_SIZE];
+  uint8_t diff = 0;
+  size_t i;
+  int ret;
+
+  ret = gcm_start(gcm, j0, iv, ivlen, taglen);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* The tag is computed over the cipher text before it is decrypted, in
+   * case that it is decrypted in place.  It is compared in constant time.
+   */
+
+  gcm_tag(gcm, j0, aad, aadlen, in, len, full);
+
+  for (i = 0; i < taglen; i++)
+    {
+      diff |= full[i] ^ tag[i];
+    }
+
+  if (diff != 0)
+    {
+      memset(out, 0, len);
+      return -EBADMSG;
+    }
+
+  memcpy(ctr, j0, AES_BLOCK_SIZE);
+  ctr_increment(ctr, 4);
+  ctr_crypt(&gcm->aes, ctr, 4, in, out, len);
+  return OK;
+}
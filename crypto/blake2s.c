@@ -91,66 +91,6 @@ static inline uint32_t rotr32(const uint32_t w, const unsigned int c)
   return (w >> (c & 31)) | (w << ((32 - c) & 31));
 }
 
-static void blake2_memcpy(FAR void *dst, FAR const void *src, size_t len)
-{
-#ifdef BLAKE2_UNALIGNED
-  FAR uint32_alias_t *idst = dst;
-  FAR const uint32_alias_t *isrc = src;
-  FAR uint8_t *bdst;
-  FAR const uint8_t *bsrc;
-
-  while (len >= sizeof(uint32_alias_t))
-    {
-      *idst = *isrc;
-      idst++;
-      isrc++;
-      len -= sizeof(uint32_alias_t);
-    }
-
-  bdst = (FAR uint8_t *)idst;
-  bsrc = (FAR const uint8_t *)isrc;
-  while (len)
-    {
-      *bdst = *bsrc;
-      bdst++;
-      bsrc++;
-      len--;
-    }
-#else
-  memcpy(dst, set, len);
-#endif
-}
-
-static void blake2_memset(FAR void *dst, int set, size_t len)
-{
-#ifdef BLAKE2_UNALIGNED
-  FAR uint32_alias_t *idst = dst;
-  FAR uint8_t *bdst;
-  uint32_t mset;
-
-  set &= 0xff;
-  mset = (uint32_t)set * 0x01010101ul;
-
-  while (len >= sizeof(uint32_alias_t))
-    {
-      *idst = mset;
-      idst++;
-      len -= sizeof(uint32_alias_t);
-    }
-
-  bdst = (FAR uint8_t *)idst;
-  set &= 0xff;
-  while (len)
-    {
-      *bdst = set;
-      bdst++;
-      len--;
-    }
-#else
-  memset(dst, set, len);
-#endif
-}
-
 static inline void secure_zero_memory(FAR void *v, size_t n)
 {
   explicit_bzero(v, n);
@@ -179,7 +119,7 @@ static void blake2s_init0(FAR blake2s_state *S)
 {
   size_t i;
 
-  blake2_memset(S, 0, sizeof(*S) - sizeof(S->buf));
+  memset(S, 0, sizeof(*S) - sizeof(S->buf));
 
   for (i = 0; i < 8; ++i)
     S->h[i] = blake2s_iv[i];
@@ -191,12 +131,23 @@ static void blake2s_compress(FAR blake2s_state *S,
   uint32_t m[16];
   uint32_t v[16];
   size_t i;
+#ifndef CONFIG_CRYPTO_BLAKE2S_UNROLL
   unsigned int round;
+#endif
 
+  /* The message words are little-endian, so they are simply copied on
+   * little-endian CPUs.  memcpy() copes with an unaligned block and is
+   * inlined by the compiler.
+   */
+
+#ifdef CONFIG_ENDIAN_BIG
   for (i = 0; i < 16; ++i)
     {
       m[i] = blake2_load32(in + i * sizeof(m[i]));
     }
+#else
+  memcpy(m, in, sizeof(m));
+#endif
 
   for (i = 0; i < 8; ++i)
     {
@@ -238,10 +189,11 @@ static void blake2s_compress(FAR blake2s_state *S,
 
   /* Size vs performance trade-off. With unrolling, on ARMv7-M function text
    * is ~4 KiB and without ~1 KiB. Without unrolling we take ~25%
-   * performance hit.
+   * performance hit:  The message schedule is then looked up in
+   * blake2s_sigma at run time instead of being folded into the code.
    */
 
-#if 1
+#ifndef CONFIG_CRYPTO_BLAKE2S_UNROLL
   /* Smaller, slightly slower. */
 
   for (round = 0; round < 10; round++)
@@ -249,9 +201,8 @@ static void blake2s_compress(FAR blake2s_state *S,
       ROUND(round);
     }
 #else
-  /* Larger, slightly faster. */
+  /* Larger, faster. */
 
-  UNUSED(round);
   ROUND(0);
   ROUND(1);
   ROUND(2);
@@ -439,8 +390,8 @@ int blake2s_init(FAR blake2s_state *S, size_t outlen)
 #if 0
   memset(P->reserved, 0, sizeof(P->reserved));
 #endif
-  blake2_memset(P->salt, 0, sizeof(P->salt));
-  blake2_memset(P->personal, 0, sizeof(P->personal));
+  memset(P->salt, 0, sizeof(P->salt));
+  memset(P->personal, 0, sizeof(P->personal));
   return blake2s_init_param(S, P);
 }
 
@@ -474,13 +425,13 @@ int blake2s_init_key(FAR blake2s_state *S,
 #if 0
   memset(P->reserved, 0, sizeof(P->reserved));
 #endif
-  blake2_memset(P->salt, 0, sizeof(P->salt));
-  blake2_memset(P->personal, 0, sizeof(P->personal));
+  memset(P->salt, 0, sizeof(P->salt));
+  memset(P->personal, 0, sizeof(P->personal));
 
   blake2s_init_param(S, P);
 
-  blake2_memset(block, 0, BLAKE2S_BLOCKBYTES);
-  blake2_memcpy(block, key, keylen);
+  memset(block, 0, BLAKE2S_BLOCKBYTES);
+  memcpy(block, key, keylen);
   blake2s_update(S, block, BLAKE2S_BLOCKBYTES);
   secure_zero_memory(block, BLAKE2S_BLOCKBYTES); /* Burn the key from stack */
 
@@ -489,7 +440,7 @@ int blake2s_init_key(FAR blake2s_state *S,
 
 int blake2s_update(FAR blake2s_state *S, FAR const void *pin, size_t inlen)
 {
-  FAR const unsigned char *in = FAR (const unsigned char *)pin;
+  FAR const unsigned char *in = (FAR const unsigned char *)pin;
   size_t left;
   size_t fill;
 
@@ -505,7 +456,7 @@ int blake2s_update(FAR blake2s_state *S, FAR const void *pin, size_t inlen)
       S->buflen = 0;
       if (fill)
         {
-          blake2_memcpy(S->buf + left, in, fill); /* Fill buffer */
+          memcpy(S->buf + left, in, fill); /* Fill buffer */
         }
 
       blake2s_increment_counter(S, BLAKE2S_BLOCKBYTES);
@@ -521,7 +472,7 @@ int blake2s_update(FAR blake2s_state *S, FAR const void *pin, size_t inlen)
         }
     }
 
-  blake2_memcpy(S->buf + S->buflen, in, inlen);
+  memcpy(S->buf + S->buflen, in, inlen);
   S->buflen += inlen;
 
   return 0;
@@ -550,7 +501,7 @@ int blake2s_final(FAR blake2s_state *S, FAR void *out, size_t outlen)
   padding = BLAKE2S_BLOCKBYTES - S->buflen;
   if (padding)
     {
-      blake2_memset(S->buf + S->buflen, 0, padding);
+      memset(S->buf + S->buflen, 0, padding);
     }
 
   blake2s_compress(S, S->buf);
@@ -573,7 +524,7 @@ int blake2s_final(FAR blake2s_state *S, FAR void *out, size_t outlen)
       /* Store partial word */
 
       blake2_store32(&tmp, S->h[i]);
-      blake2_memcpy(outbuf, &tmp, outlen);
+      memcpy(outbuf, &tmp, outlen);
     }
 
   return 0;
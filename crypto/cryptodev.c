@@ -41,11 +41,20 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <string.h>
+#include <fcntl.h>
 #include <poll.h>
+#include <queue.h>
+#include <assert.h>
 #include <errno.h>
+#include <debug.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/drivers/drivers.h>
 
 #include <nuttx/crypto/crypto.h>
@@ -55,27 +64,106 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#ifdef CONFIG_CRYPTO_AES
-#  define AES_CYPHER(mode) \
-  aes_cypher(op->dst, op->src, op->len, op->iv, ses->key, ses->keylen, \
-             mode, encrypt)
+#ifndef CONFIG_CRYPTO_CRYPTODEV_NSESSIONS
+#  define CONFIG_CRYPTO_CRYPTODEV_NSESSIONS 4
 #endif
 
+#ifndef CONFIG_CRYPTO_CRYPTODEV_MAXREQS
+#  define CONFIG_CRYPTO_CRYPTODEV_MAXREQS 16
+#endif
+
+#ifndef CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS
+#  define CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS 2
+#endif
+
+/* The longest key, the most iovecs in the source or the destination of a
+ * queued operation and the longest iv that are accepted
+ */
+
+#define CRYPTODEV_MAXKEY  32
+#define CRYPTODEV_MAXIOV  64
+#define CRYPTODEV_MAXIV   64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A session of an open file.  The session ID returned to the user is the
+ * index of the session plus one.
+ */
+
+struct cryptodev_session_s
+{
+  FAR void *priv;             /* The session of the lower half, or NULL */
+  uint32_t cipher;            /* i.e. CRYPTO_AES_CBC */
+  uint16_t nreqs;             /* Queued operations of the session */
+};
+
+struct cryptodev_file_s;
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+/* An operation queued with CIOCSUBMIT.  The allocation also holds the copy
+ * of the destination iovecs, the iv, the aad and the data, which is
+ * processed in place.
+ */
+
+struct cryptodev_async_s
+{
+  sq_entry_t flink;                     /* In the pending or done queue */
+  struct cryptodev_req_s req;           /* The operation */
+  FAR struct cryptodev_file_s *file;    /* The file of the operation */
+  FAR struct cryptodev_session_s *ses;  /* The session of the operation */
+  size_t size;                          /* The size of the allocation */
+  uint32_t id;                          /* The ID given by the user */
+  unsigned dstcnt;                      /* The number of iovecs in dst */
+  FAR const struct iovec *dst;          /* The destination iovecs */
+  FAR uint8_t *usertag;                 /* Receives the tag, or NULL */
+  uint8_t tag[AES_BLOCK_LEN];           /* The tag */
+};
+#endif
+
+/* The state of an open file */
+
+struct cryptodev_file_s
+{
+  FAR struct cryptodev_lowerhalf_s *lower;
+  sem_t exclsem;              /* Exclusive access to the file */
+  struct cryptodev_session_s sessions[CONFIG_CRYPTO_CRYPTODEV_NSESSIONS];
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  sq_queue_t pending;         /* Not yet passed to the lower half */
+  sq_queue_t done;            /* Completed, the result was not yet read */
+  struct work_s work;         /* Passes the pending operations on */
+  sem_t donesem;              /* Wakes up the tasks waiting for results */
+  uint16_t nreqs;             /* Operations whose result was not read */
+  uint16_t nbusy;             /* Operations in the lower half + worker */
+  uint8_t nwaiters;           /* Tasks waiting on donesem */
+  bool queued;                /* The worker was queued and holds nbusy */
+  FAR struct pollfd *fds[CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS];
+#endif
+};
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
 
 /* Character driver methods */
 
+static int     cryptodev_open(FAR struct file *filep);
+static int     cryptodev_close(FAR struct file *filep);
 static ssize_t cryptodev_read(FAR struct file *filep,
                               FAR char *buffer,
                               size_t len);
 static ssize_t cryptodev_write(FAR struct file *filep,
                                FAR const char *buffer,
                                size_t len);
-static int cryptodev_ioctl(FAR struct file *filep,
-                           int cmd,
-                           unsigned long arg);
+static int     cryptodev_ioctl(FAR struct file *filep,
+                               int cmd,
+                               unsigned long arg);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+static int     cryptodev_poll(FAR struct file *filep,
+                              FAR struct pollfd *fds,
+                              bool setup);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -83,13 +171,17 @@ static int cryptodev_ioctl(FAR struct file *filep,
 
 static const struct file_operations g_cryptodevops =
 {
-  NULL,               /* open   */
-  NULL,               /* close  */
+  cryptodev_open,     /* open   */
+  cryptodev_close,    /* close  */
   cryptodev_read,     /* read   */
   cryptodev_write,    /* write  */
   NULL,               /* seek   */
   cryptodev_ioctl,    /* ioctl  */
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  cryptodev_poll      /* poll   */
+#else
   NULL                /* poll   */
+#endif
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   , NULL              /* unlink */
 #endif
@@ -99,11 +191,784 @@ static const struct file_operations g_cryptodevops =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: cryptodev_getsession
+ *
+ * Description:
+ *   Return the session of a session ID, or NULL if it is not valid
+ *
+ ****************************************************************************/
+
+static FAR struct cryptodev_session_s *
+cryptodev_getsession(FAR struct cryptodev_file_s *file, uint32_t id)
+{
+  FAR struct cryptodev_session_s *ses;
+
+  if (id < 1 || id > CONFIG_CRYPTO_CRYPTODEV_NSESSIONS)
+    {
+      return NULL;
+    }
+
+  ses = &file->sessions[id - 1];
+  return ses->priv != NULL ? ses : NULL;
+}
+
+/****************************************************************************
+ * Name: cryptodev_newsession
+ *
+ * Description:
+ *   Set up a session with the key of the user.  The key is expanded once,
+ *   by the lower half, and used for all operations of the session.
+ *
+ ****************************************************************************/
+
+static int cryptodev_newsession(FAR struct cryptodev_file_s *file,
+                                FAR struct session_op *op)
+{
+  FAR struct cryptodev_lowerhalf_s *lower = file->lower;
+  FAR struct cryptodev_session_s *ses;
+  int ret;
+  int i;
+
+  if (op->key == NULL || op->keylen == 0 || op->keylen > CRYPTODEV_MAXKEY)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < CONFIG_CRYPTO_CRYPTODEV_NSESSIONS; i++)
+    {
+      ses = &file->sessions[i];
+      if (ses->priv == NULL)
+        {
+          ret = lower->ops->newsession(lower, op->cipher,
+                                       (FAR const uint8_t *)op->key,
+                                       op->keylen, &ses->priv);
+          if (ret < 0)
+            {
+              ses->priv = NULL;
+              return ret;
+            }
+
+          ses->cipher = op->cipher;
+          ses->nreqs  = 0;
+          op->ses     = i + 1;
+          return OK;
+        }
+    }
+
+  return -ENFILE;
+}
+
+/****************************************************************************
+ * Name: cryptodev_freesession
+ ****************************************************************************/
+
+static int cryptodev_freesession(FAR struct cryptodev_file_s *file,
+                                 uint32_t id)
+{
+  FAR struct cryptodev_lowerhalf_s *lower = file->lower;
+  FAR struct cryptodev_session_s *ses;
+
+  ses = cryptodev_getsession(file, id);
+  if (ses == NULL)
+    {
+      return -EINVAL;
+    }
+
+  /* The results of the queued operations must be read first */
+
+  if (ses->nreqs > 0)
+    {
+      return -EBUSY;
+    }
+
+  lower->ops->freesession(lower, ses->priv);
+  ses->priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cryptodev_wakeup
+ *
+ * Description:
+ *   Wake up the task waiting for the completion of a synchronous operation
+ *
+ ****************************************************************************/
+
+static void cryptodev_wakeup(FAR struct cryptodev_req_s *req)
+{
+  nxsem_post((FAR sem_t *)req->priv);
+}
+
+/****************************************************************************
+ * Name: cryptodev_process
+ *
+ * Description:
+ *   Do an operation in the calling task and wait for its completion
+ *
+ ****************************************************************************/
+
+static int cryptodev_process(FAR struct cryptodev_file_s *file,
+                             FAR struct cryptodev_req_s *req)
+{
+  FAR struct cryptodev_lowerhalf_s *lower = file->lower;
+  sem_t waitsem;
+  int ret;
+
+  nxsem_init(&waitsem, 0, 0);
+  nxsem_setprotocol(&waitsem, SEM_PRIO_NONE);
+
+  req->result   = OK;
+  req->callback = cryptodev_wakeup;
+  req->priv     = &waitsem;
+
+  ret = lower->ops->process(lower, req);
+  if (ret == -EINPROGRESS)
+    {
+      nxsem_wait_uninterruptible(&waitsem);
+      ret = req->result;
+    }
+
+  nxsem_destroy(&waitsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cryptodev_crypt
+ *
+ * Description:
+ *   Encrypt or decrypt a buffer with CIOCCRYPT
+ *
+ ****************************************************************************/
+
+static int cryptodev_crypt(FAR struct cryptodev_file_s *file,
+                           FAR struct crypt_op *op)
+{
+  FAR struct cryptodev_session_s *ses;
+  struct cryptodev_req_s req;
+
+  ses = cryptodev_getsession(file, op->ses);
+  if (ses == NULL || (op->op != COP_ENCRYPT && op->op != COP_DECRYPT))
+    {
+      return -EINVAL;
+    }
+
+  memset(&req, 0, sizeof(struct cryptodev_req_s));
+  req.session = ses->priv;
+  req.op      = op->op;
+  req.src     = (FAR const uint8_t *)op->src;
+  req.dst     = (FAR uint8_t *)op->dst;
+  req.len     = op->len;
+  req.iv      = (FAR const uint8_t *)op->iv;
+  req.ivlen   = op->iv != NULL ? AES_BLOCK_LEN : 0;
+
+  return cryptodev_process(file, &req);
+}
+
+/****************************************************************************
+ * Name: cryptodev_aead
+ *
+ * Description:
+ *   Encrypt or decrypt a message and its authentication tag with
+ *   CIOCCRYPTAEAD
+ *
+ ****************************************************************************/
+
+static int cryptodev_aead(FAR struct cryptodev_file_s *file,
+                          FAR struct crypt_aead *op)
+{
+  FAR struct cryptodev_session_s *ses;
+  struct cryptodev_req_s req;
+
+  ses = cryptodev_getsession(file, op->ses);
+  if (ses == NULL || (op->op != COP_ENCRYPT && op->op != COP_DECRYPT) ||
+      op->tag == NULL)
+    {
+      return -EINVAL;
+    }
+
+  memset(&req, 0, sizeof(struct cryptodev_req_s));
+  req.session = ses->priv;
+  req.op      = op->op;
+  req.src     = (FAR const uint8_t *)op->src;
+  req.dst     = (FAR uint8_t *)op->dst;
+  req.len     = op->len;
+  req.iv      = (FAR const uint8_t *)op->iv;
+  req.ivlen   = op->ivlen;
+  req.aad     = (FAR const uint8_t *)op->aad;
+  req.aadlen  = op->aadlen;
+  req.tag     = (FAR uint8_t *)op->tag;
+
+  return cryptodev_process(file, &req);
+}
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+/****************************************************************************
+ * Name: cryptodev_pollnotify
+ *
+ * Assumptions:
+ *   Called in a critical section
+ *
+ ****************************************************************************/
+
+static void cryptodev_pollnotify(FAR struct cryptodev_file_s *file,
+                                 pollevent_t eventset)
+{
+  FAR struct pollfd *fds;
+  int i;
+
+  for (i = 0; i < CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS; i++)
+    {
+      fds = file->fds[i];
+      if (fds != NULL)
+        {
+          fds->revents |= (fds->events & eventset);
+          if (fds->revents != 0)
+            {
+              nxsem_post(fds->sem);
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: cryptodev_complete
+ *
+ * Description:
+ *   Move a queued operation that completed to the done queue.  This is the
+ *   callback of the operations that the lower half completes later.
+ *
+ ****************************************************************************/
+
+static void cryptodev_complete(FAR struct cryptodev_req_s *req)
+{
+  FAR struct cryptodev_async_s *async = req->priv;
+  FAR struct cryptodev_file_s *file = async->file;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  sq_addlast(&async->flink, &file->done);
+
+  DEBUGASSERT(file->nbusy > 0);
+  file->nbusy--;
+
+  if (file->nwaiters > 0)
+    {
+      file->nwaiters--;
+      nxsem_post(&file->donesem);
+    }
+
+  cryptodev_pollnotify(file, POLLIN);
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: cryptodev_worker
+ *
+ * Description:
+ *   Pass the pending operations of a file to the lower half, in the low
+ *   priority work queue.  The worker holds a count of nbusy until it
+ *   returns, so that the file is not released while the worker runs.
+ *
+ ****************************************************************************/
+
+static void cryptodev_worker(FAR void *arg)
+{
+  FAR struct cryptodev_file_s *file = arg;
+  FAR struct cryptodev_lowerhalf_s *lower = file->lower;
+  FAR struct cryptodev_async_s *async;
+  irqstate_t flags;
+  int ret;
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      async = (FAR struct cryptodev_async_s *)sq_remfirst(&file->pending);
+      if (async == NULL)
+        {
+          /* Drop the count of the worker.  The file must not be accessed
+           * after leaving the critical section.
+           */
+
+          file->queued = false;
+          file->nbusy--;
+
+          if (file->nwaiters > 0)
+            {
+              file->nwaiters--;
+              nxsem_post(&file->donesem);
+            }
+
+          leave_critical_section(flags);
+          return;
+        }
+
+      file->nbusy++;
+      leave_critical_section(flags);
+
+      ret = lower->ops->process(lower, &async->req);
+      if (ret != -EINPROGRESS)
+        {
+          async->req.result = ret;
+          cryptodev_complete(&async->req);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: cryptodev_release
+ *
+ * Description:
+ *   Free a queued operation.  It holds data of the user, so it is cleared.
+ *
+ ****************************************************************************/
+
+static void cryptodev_release(FAR struct cryptodev_async_s *async)
+{
+  memset(async, 0, async->size);
+  kmm_free(async);
+}
+
+/****************************************************************************
+ * Name: cryptodev_queue
+ *
+ * Description:
+ *   Copy one operation of a batch and add it to the pending queue
+ *
+ ****************************************************************************/
+
+static int cryptodev_queue(FAR struct cryptodev_file_s *file,
+                           FAR const struct crypt_req *creq)
+{
+  FAR struct cryptodev_session_s *ses;
+  FAR struct cryptodev_async_s *async;
+  FAR struct iovec *dst;
+  FAR uint8_t *data;
+  irqstate_t flags;
+  size_t srclen = 0;
+  size_t dstlen = 0;
+  size_t size;
+  unsigned i;
+
+  ses = cryptodev_getsession(file, creq->ses);
+  if (ses == NULL || (creq->op != COP_ENCRYPT && creq->op != COP_DECRYPT))
+    {
+      return -EINVAL;
+    }
+
+  if (creq->src == NULL || creq->srccnt == 0 ||
+      creq->srccnt > CRYPTODEV_MAXIOV || creq->dst == NULL ||
+      creq->dstcnt == 0 || creq->dstcnt > CRYPTODEV_MAXIOV ||
+      creq->ivlen > CRYPTODEV_MAXIV)
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < creq->srccnt; i++)
+    {
+      srclen += creq->src[i].iov_len;
+      if (srclen < creq->src[i].iov_len)
+        {
+          return -EINVAL;
+        }
+    }
+
+  for (i = 0; i < creq->dstcnt; i++)
+    {
+      dstlen += creq->dst[i].iov_len;
+      if (dstlen < creq->dst[i].iov_len)
+        {
+          return -EINVAL;
+        }
+    }
+
+  if (srclen != dstlen)
+    {
+      return -EINVAL;
+    }
+
+  size = sizeof(struct cryptodev_async_s) +
+         creq->dstcnt * sizeof(struct iovec) + creq->ivlen;
+  if (creq->aadlen > SIZE_MAX - size ||
+      srclen > SIZE_MAX - size - creq->aadlen)
+    {
+      return -ENOMEM;
+    }
+
+  size  += creq->aadlen + srclen;
+  async  = kmm_malloc(size);
+  if (async == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memset(async, 0, sizeof(struct cryptodev_async_s));
+  async->file   = file;
+  async->ses    = ses;
+  async->size   = size;
+  async->id     = creq->id;
+  async->dstcnt = creq->dstcnt;
+
+  dst = (FAR struct iovec *)(async + 1);
+  memcpy(dst, creq->dst, creq->dstcnt * sizeof(struct iovec));
+  async->dst = dst;
+
+  data = (FAR uint8_t *)(dst + creq->dstcnt);
+  if (creq->ivlen > 0 && creq->iv != NULL)
+    {
+      memcpy(data, creq->iv, creq->ivlen);
+      async->req.iv    = data;
+      async->req.ivlen = creq->ivlen;
+      data += creq->ivlen;
+    }
+
+  if (creq->aadlen > 0 && creq->aad != NULL)
+    {
+      memcpy(data, creq->aad, creq->aadlen);
+      async->req.aad    = data;
+      async->req.aadlen = creq->aadlen;
+      data += creq->aadlen;
+    }
+
+  /* The tag is an input when decrypting and an output when encrypting */
+
+  if (creq->tag != NULL)
+    {
+      if (creq->op == COP_DECRYPT)
+        {
+          memcpy(async->tag, creq->tag, AES_BLOCK_LEN);
+        }
+      else
+        {
+          async->usertag = (FAR uint8_t *)creq->tag;
+        }
+
+      async->req.tag = async->tag;
+    }
+
+  /* Gather the source, which is then processed in place */
+
+  async->req.src = data;
+  async->req.dst = data;
+  async->req.len = srclen;
+
+  for (i = 0; i < creq->srccnt; i++)
+    {
+      memcpy(data, creq->src[i].iov_base, creq->src[i].iov_len);
+      data += creq->src[i].iov_len;
+    }
+
+  async->req.session  = ses->priv;
+  async->req.op       = creq->op;
+  async->req.callback = cryptodev_complete;
+  async->req.priv     = async;
+
+  ses->nreqs++;
+  file->nreqs++;
+
+  flags = enter_critical_section();
+  sq_addlast(&async->flink, &file->pending);
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cryptodev_submit
+ *
+ * Description:
+ *   Queue the operations of a batch with CIOCSUBMIT and start the worker
+ *   if it is not queued.  The number of queued operations is returned.
+ *
+ ****************************************************************************/
+
+static int cryptodev_submit(FAR struct cryptodev_file_s *file,
+                            FAR const struct crypt_batch *batch)
+{
+  irqstate_t flags;
+  unsigned i;
+  int ret = OK;
+
+  for (i = 0; i < batch->nreqs; i++)
+    {
+      if (file->nreqs >= CONFIG_CRYPTO_CRYPTODEV_MAXREQS)
+        {
+          ret = -EAGAIN;
+          break;
+        }
+
+      ret = cryptodev_queue(file, &batch->reqs[i]);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  if (i > 0)
+    {
+      flags = enter_critical_section();
+      if (!file->queued)
+        {
+          file->queued = true;
+          file->nbusy++;
+          work_queue(LPWORK, &file->work, cryptodev_worker, file, 0);
+        }
+
+      leave_critical_section(flags);
+      return i;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cryptodev_finish
+ *
+ * Description:
+ *   Scatter the output of a completed operation to the destination of the
+ *   user, release the operation and return its result.
+ *
+ ****************************************************************************/
+
+static int cryptodev_finish(FAR struct cryptodev_file_s *file,
+                            FAR struct cryptodev_async_s *async)
+{
+  FAR const uint8_t *data = async->req.dst;
+  int result = async->req.result;
+  unsigned i;
+
+  if (result >= 0)
+    {
+      for (i = 0; i < async->dstcnt; i++)
+        {
+          memcpy(async->dst[i].iov_base, data, async->dst[i].iov_len);
+          data += async->dst[i].iov_len;
+        }
+
+      if (async->usertag != NULL)
+        {
+          memcpy(async->usertag, async->tag, AES_BLOCK_LEN);
+        }
+    }
+
+  async->ses->nreqs--;
+  file->nreqs--;
+
+  cryptodev_release(async);
+  return result;
+}
+#endif /* CONFIG_CRYPTO_CRYPTODEV_ASYNC */
+
+/****************************************************************************
+ * Name: cryptodev_open
+ ****************************************************************************/
+
+static int cryptodev_open(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct cryptodev_file_s *file;
+
+  file = kmm_zalloc(sizeof(struct cryptodev_file_s));
+  if (file == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  file->lower = inode->i_private;
+  nxsem_init(&file->exclsem, 0, 1);
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  sq_init(&file->pending);
+  sq_init(&file->done);
+
+  /* donesem is used for signaling and, hence, should not have priority
+   * inheritance enabled.
+   */
+
+  nxsem_init(&file->donesem, 0, 0);
+  nxsem_setprotocol(&file->donesem, SEM_PRIO_NONE);
+#endif
+
+  filep->f_priv = file;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cryptodev_close
+ ****************************************************************************/
+
+static int cryptodev_close(FAR struct file *filep)
+{
+  FAR struct cryptodev_file_s *file = filep->f_priv;
+  FAR struct cryptodev_lowerhalf_s *lower = file->lower;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  FAR struct cryptodev_async_s *async;
+  sq_queue_t pending;
+  irqstate_t flags;
+#endif
+  int i;
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  /* Take the pending operations away from the worker, cancel it and wait
+   * until the lower half has completed the operations that it has started
+   * and the worker has returned.
+   */
+
+  flags = enter_critical_section();
+  sq_move(&file->pending, &pending);
+
+  if (file->queued && work_cancel(LPWORK, &file->work) == OK)
+    {
+      file->queued = false;
+      file->nbusy--;
+    }
+
+  while (file->nbusy > 0)
+    {
+      file->nwaiters++;
+      nxsem_wait_uninterruptible(&file->donesem);
+    }
+
+  leave_critical_section(flags);
+
+  while ((async = (FAR struct cryptodev_async_s *)
+                  sq_remfirst(&pending)) != NULL)
+    {
+      cryptodev_release(async);
+    }
+
+  while ((async = (FAR struct cryptodev_async_s *)
+                  sq_remfirst(&file->done)) != NULL)
+    {
+      cryptodev_release(async);
+    }
+
+  nxsem_destroy(&file->donesem);
+#endif
+
+  for (i = 0; i < CONFIG_CRYPTO_CRYPTODEV_NSESSIONS; i++)
+    {
+      if (file->sessions[i].priv != NULL)
+        {
+          lower->ops->freesession(lower, file->sessions[i].priv);
+        }
+    }
+
+  nxsem_destroy(&file->exclsem);
+  kmm_free(file);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: cryptodev_read
+ *
+ * Description:
+ *   Return the results of queued operations that completed, as an array of
+ *   struct crypt_result.  Unless the file is non-blocking, wait for one if
+ *   there is none yet.  Zero is returned if no operation is queued.
+ *
+ ****************************************************************************/
+
 static ssize_t cryptodev_read(FAR struct file *filep,
                               FAR char *buffer,
                               size_t len)
 {
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  FAR struct cryptodev_file_s *file = filep->f_priv;
+  FAR struct crypt_result *result = (FAR struct crypt_result *)buffer;
+  FAR struct cryptodev_async_s *async;
+  irqstate_t flags;
+  size_t nread;
+  bool wait;
+  int ret;
+
+  if (len < sizeof(struct crypt_result))
+    {
+      return -EINVAL;
+    }
+
+  for (; ; )
+    {
+      ret = nxsem_wait(&file->exclsem);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      nread = 0;
+      while (nread + sizeof(struct crypt_result) <= len)
+        {
+          flags = enter_critical_section();
+          async = (FAR struct cryptodev_async_s *)sq_remfirst(&file->done);
+          leave_critical_section(flags);
+
+          if (async == NULL)
+            {
+              break;
+            }
+
+          result->id     = async->id;
+          result->status = cryptodev_finish(file, async);
+          result++;
+          nread += sizeof(struct crypt_result);
+        }
+
+      if (nread > 0 || file->nreqs == 0)
+        {
+          if (nread > 0)
+            {
+              flags = enter_critical_section();
+              cryptodev_pollnotify(file, POLLOUT);
+              leave_critical_section(flags);
+            }
+
+          nxsem_post(&file->exclsem);
+          return (ssize_t)nread;
+        }
+
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          nxsem_post(&file->exclsem);
+          return -EAGAIN;
+        }
+
+      /* Wait for a completion without holding the file */
+
+      flags = enter_critical_section();
+      wait  = sq_empty(&file->done);
+      if (wait)
+        {
+          file->nwaiters++;
+        }
+
+      leave_critical_section(flags);
+      nxsem_post(&file->exclsem);
+
+      if (wait)
+        {
+          ret = nxsem_wait(&file->donesem);
+          if (ret < 0)
+            {
+              /* Give up the wait.  If a completion has already counted
+               * this task out and posted donesem, the count is left for
+               * the next reader, which will find the done queue and wait
+               * again if it is empty.
+               */
+
+              flags = enter_critical_section();
+              if (file->nwaiters > 0)
+                {
+                  file->nwaiters--;
+                }
+
+              leave_critical_section(flags);
+              return ret;
+            }
+        }
+    }
+#else
   return -EACCES;
+#endif
 }
 
 static ssize_t cryptodev_write(FAR struct file *filep,
@@ -113,72 +978,163 @@ static ssize_t cryptodev_write(FAR struct file *filep,
   return -EACCES;
 }
 
+/****************************************************************************
+ * Name: cryptodev_ioctl
+ ****************************************************************************/
+
 static int cryptodev_ioctl(FAR struct file *filep,
                            int cmd,
                            unsigned long arg)
 {
+  FAR struct cryptodev_file_s *file = filep->f_priv;
+  int ret;
+
+  ret = nxsem_wait(&file->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   switch (cmd)
   {
   case CIOCGSESSION:
     {
-      FAR struct session_op *ses = (FAR struct session_op *)arg;
-      ses->ses = (uint32_t)ses;
-      return OK;
+      ret = cryptodev_newsession(file, (FAR struct session_op *)arg);
+      break;
     }
 
   case CIOCFSESSION:
     {
-      return OK;
+      ret = cryptodev_freesession(file, *(FAR uint32_t *)arg);
+      break;
     }
 
-#ifdef CONFIG_CRYPTO_AES
   case CIOCCRYPT:
     {
-      FAR struct crypt_op *op    = (FAR struct crypt_op *)arg;
-      FAR struct session_op *ses = (FAR struct session_op *)op->ses;
-      int encrypt;
+      ret = cryptodev_crypt(file, (FAR struct crypt_op *)arg);
+      break;
+    }
 
-      switch (op->op)
-        {
-        case COP_ENCRYPT:
-          encrypt = 1;
-          break;
+  case CIOCCRYPTAEAD:
+    {
+      ret = cryptodev_aead(file, (FAR struct crypt_aead *)arg);
+      break;
+    }
 
-        case COP_DECRYPT:
-          encrypt = 0;
-          break;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  case CIOCSUBMIT:
+    {
+      ret = cryptodev_submit(file, (FAR struct crypt_batch *)arg);
+      break;
+    }
+#endif
 
-        default:
-          return -EINVAL;
-        }
+  default:
+    ret = -ENOTTY;
+    break;
+  }
 
-      switch (ses->cipher)
+  nxsem_post(&file->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: cryptodev_poll
+ *
+ * Description:
+ *   The file is readable when a result is available and writable when
+ *   more operations may be queued.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+static int cryptodev_poll(FAR struct file *filep,
+                          FAR struct pollfd *fds,
+                          bool setup)
+{
+  FAR struct cryptodev_file_s *file = filep->f_priv;
+  FAR struct pollfd **slot;
+  pollevent_t eventset = 0;
+  irqstate_t flags;
+  int ret;
+  int i;
+
+  ret = nxsem_wait(&file->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  flags = enter_critical_section();
+  if (setup)
+    {
+      for (i = 0; i < CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS; i++)
         {
-        case CRYPTO_AES_ECB:
-          return AES_CYPHER(AES_MODE_ECB);
+          if (file->fds[i] == NULL)
+            {
+              file->fds[i] = fds;
+              fds->priv    = &file->fds[i];
+              break;
+            }
+        }
 
-        case CRYPTO_AES_CBC:
-          return AES_CYPHER(AES_MODE_CBC);
+      if (i >= CONFIG_CRYPTO_CRYPTODEV_NPOLLWAITERS)
+        {
+          fds->priv = NULL;
+          ret       = -EBUSY;
+        }
+      else
+        {
+          if (!sq_empty(&file->done))
+            {
+              eventset |= POLLIN;
+            }
 
-        case CRYPTO_AES_CTR:
-          return AES_CYPHER(AES_MODE_CTR);
+          if (file->nreqs < CONFIG_CRYPTO_CRYPTODEV_MAXREQS)
+            {
+              eventset |= POLLOUT;
+            }
 
-        default:
-           return -EINVAL;
+          if (eventset != 0)
+            {
+              cryptodev_pollnotify(file, eventset);
+            }
         }
     }
-#endif
+  else if (fds->priv != NULL)
+    {
+      slot      = (FAR struct pollfd **)fds->priv;
+      *slot     = NULL;
+      fds->priv = NULL;
+    }
 
-  default:
-    return -ENOTTY;
-  }
+  leave_critical_section(flags);
+  nxsem_post(&file->exclsem);
+  return ret;
 }
+#endif
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: cryptodev_register
+ *
+ * Description:
+ *   Register a /dev/crypto compatible driver for a lower half.  See
+ *   include/nuttx/crypto/cryptodev.h.
+ *
+ ****************************************************************************/
+
+int cryptodev_register(FAR const char *path,
+                       FAR struct cryptodev_lowerhalf_s *lower)
+{
+  DEBUGASSERT(path != NULL && lower != NULL && lower->ops != NULL);
+  return register_driver(path, &g_cryptodevops, 0666, lower);
+}
+
 void devcrypto_register(void)
 {
-  register_driver("/dev/crypto", &g_cryptodevops, 0666, NULL);
+  cryptodev_register("/dev/crypto", cryptodev_swinitialize());
 }
@@ -0,0 +1,354 @@
+/****************************************************************************
+ * crypto/cryptodev_sw.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/crypto/crypto.h>
+#include <nuttx/crypto/cryptodev.h>
+
+#ifdef CONFIG_CRYPTO_SW_AES
+#  include <nuttx/crypto/aes.h>
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A session.  With the software AES library, the expanded key is kept so
+ * that it is not set up again for each operation.  aes_cypher() takes the
+ * key itself.
+ */
+
+struct swcrypto_session_s
+{
+  uint32_t cipher;                /* i.e. CRYPTO_AES_CBC */
+#if defined(CONFIG_CRYPTO_SW_AES)
+  union
+  {
+    struct aes_state_s aes;       /* ECB, CBC and CTR */
+    struct aes_gcm_s gcm;         /* GCM */
+  } u;
+#elif defined(CONFIG_CRYPTO_AES)
+  uint32_t keylen;
+  uint8_t key[32];
+#endif
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int  swcrypto_newsession(FAR struct cryptodev_lowerhalf_s *lower,
+                                uint32_t cipher, FAR const uint8_t *key,
+                                size_t keylen, FAR void **session);
+static void swcrypto_freesession(FAR struct cryptodev_lowerhalf_s *lower,
+                                 FAR void *session);
+static int  swcrypto_process(FAR struct cryptodev_lowerhalf_s *lower,
+                             FAR struct cryptodev_req_s *req);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct cryptodev_ops_s g_swcrypto_ops =
+{
+  swcrypto_newsession,    /* newsession */
+  swcrypto_freesession,   /* freesession */
+  swcrypto_process        /* process */
+};
+
+static struct cryptodev_lowerhalf_s g_swcrypto =
+{
+  &g_swcrypto_ops
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: swcrypto_cbc
+ *
+ * Description:
+ *   Encrypt or decrypt in CBC mode, one block at a time so that the data
+ *   may be processed in place
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CRYPTO_SW_AES
+static void swcrypto_cbc(FAR struct aes_state_s *aes, uint16_t op,
+                         FAR const uint8_t *iv, FAR const uint8_t *in,
+                         FAR uint8_t *out, size_t len)
+{
+  uint8_t chain[AES_BLOCK_SIZE];
+  uint8_t block[AES_BLOCK_SIZE];
+  size_t off;
+  int i;
+
+  memcpy(chain, iv, AES_BLOCK_SIZE);
+
+  for (off = 0; off < len; off += AES_BLOCK_SIZE)
+    {
+      if (op == COP_ENCRYPT)
+        {
+          for (i = 0; i < AES_BLOCK_SIZE; i++)
+            {
+              chain[i] ^= in[off + i];
+            }
+
+          aes_encipher(aes, chain, 1);
+          memcpy(out + off, chain, AES_BLOCK_SIZE);
+        }
+      else
+        {
+          memcpy(block, in + off, AES_BLOCK_SIZE);
+          aes_decipher(aes, block, 1);
+
+          for (i = 0; i < AES_BLOCK_SIZE; i++)
+            {
+              block[i] ^= chain[i];
+            }
+
+          memcpy(chain, in + off, AES_BLOCK_SIZE);
+          memcpy(out + off, block, AES_BLOCK_SIZE);
+        }
+    }
+
+  memset(block, 0, AES_BLOCK_SIZE);
+}
+#endif
+
+/****************************************************************************
+ * Name: swcrypto_newsession
+ ****************************************************************************/
+
+static int swcrypto_newsession(FAR struct cryptodev_lowerhalf_s *lower,
+                               uint32_t cipher, FAR const uint8_t *key,
+                               size_t keylen, FAR void **session)
+{
+  FAR struct swcrypto_session_s *ses;
+  int ret;
+
+  switch (cipher)
+    {
+#if defined(CONFIG_CRYPTO_SW_AES) || defined(CONFIG_CRYPTO_AES)
+    case CRYPTO_AES_ECB:
+    case CRYPTO_AES_CBC:
+    case CRYPTO_AES_CTR:
+#endif
+#ifdef CONFIG_CRYPTO_SW_AES
+    case CRYPTO_AES_GCM:
+#endif
+      break;
+
+    default:
+      return -EINVAL;
+    }
+
+  ses = kmm_zalloc(sizeof(struct swcrypto_session_s));
+  if (ses == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ses->cipher = cipher;
+
+#if defined(CONFIG_CRYPTO_SW_AES)
+  if (cipher == CRYPTO_AES_GCM)
+    {
+      ret = aes_gcm_setkey(&ses->u.gcm, key, keylen);
+    }
+  else
+    {
+      ret = aes_setupkey(&ses->u.aes, key, keylen);
+    }
+#elif defined(CONFIG_CRYPTO_AES)
+  if (keylen > sizeof(ses->key))
+    {
+      ret = -EINVAL;
+    }
+  else
+    {
+      memcpy(ses->key, key, keylen);
+      ses->keylen = keylen;
+      ret = OK;
+    }
+#else
+  ret = -EINVAL;
+#endif
+
+  if (ret < 0)
+    {
+      kmm_free(ses);
+      return ret;
+    }
+
+  *session = ses;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: swcrypto_freesession
+ ****************************************************************************/
+
+static void swcrypto_freesession(FAR struct cryptodev_lowerhalf_s *lower,
+                                 FAR void *session)
+{
+  /* Do not leave the key in the heap */
+
+  memset(session, 0, sizeof(struct swcrypto_session_s));
+  kmm_free(session);
+}
+
+/****************************************************************************
+ * Name: swcrypto_process
+ *
+ * Description:
+ *   Do an operation in the calling thread.  It is always completed before
+ *   returning.
+ *
+ ****************************************************************************/
+
+static int swcrypto_process(FAR struct cryptodev_lowerhalf_s *lower,
+                            FAR struct cryptodev_req_s *req)
+{
+  FAR struct swcrypto_session_s *ses = req->session;
+#if defined(CONFIG_CRYPTO_SW_AES)
+  uint8_t ctr[AES_BLOCK_SIZE];
+#elif defined(CONFIG_CRYPTO_AES)
+  int mode;
+#endif
+
+  if (ses->cipher != CRYPTO_AES_GCM && ses->cipher != CRYPTO_AES_CTR &&
+      (req->len % AES_BLOCK_LEN) != 0)
+    {
+      return -EINVAL;
+    }
+
+  if (ses->cipher != CRYPTO_AES_ECB && ses->cipher != CRYPTO_AES_GCM &&
+      (req->iv == NULL || req->ivlen != AES_BLOCK_LEN))
+    {
+      return -EINVAL;
+    }
+
+#if defined(CONFIG_CRYPTO_SW_AES)
+  switch (ses->cipher)
+    {
+    case CRYPTO_AES_ECB:
+      if (req->dst != req->src)
+        {
+          memcpy(req->dst, req->src, req->len);
+        }
+
+      if (req->op == COP_ENCRYPT)
+        {
+          aes_encipher(&ses->u.aes, req->dst, req->len / AES_BLOCK_SIZE);
+        }
+      else
+        {
+          aes_decipher(&ses->u.aes, req->dst, req->len / AES_BLOCK_SIZE);
+        }
+
+      return OK;
+
+    case CRYPTO_AES_CBC:
+      swcrypto_cbc(&ses->u.aes, req->op, req->iv, req->src, req->dst,
+                   req->len);
+      return OK;
+
+    case CRYPTO_AES_CTR:
+      memcpy(ctr, req->iv, AES_BLOCK_SIZE);
+      aes_ctr(&ses->u.aes, ctr, req->src, req->dst, req->len);
+      return OK;
+
+    case CRYPTO_AES_GCM:
+      if (req->tag == NULL)
+        {
+          return -EINVAL;
+        }
+
+      if (req->op == COP_ENCRYPT)
+        {
+          return aes_gcm_encrypt(&ses->u.gcm, req->iv, req->ivlen,
+                                 req->aad, req->aadlen, req->src, req->dst,
+                                 req->len, req->tag, AES_GCM_MAXTAG);
+        }
+
+      return aes_gcm_decrypt(&ses->u.gcm, req->iv, req->ivlen,
+                             req->aad, req->aadlen, req->src, req->dst,
+                             req->len, req->tag, AES_GCM_MAXTAG);
+
+    default:
+      return -EINVAL;
+    }
+
+#elif defined(CONFIG_CRYPTO_AES)
+  switch (ses->cipher)
+    {
+    case CRYPTO_AES_ECB:
+      mode = AES_MODE_ECB;
+      break;
+
+    case CRYPTO_AES_CBC:
+      mode = AES_MODE_CBC;
+      break;
+
+    case CRYPTO_AES_CTR:
+      mode = AES_MODE_CTR;
+      break;
+
+    default:
+      return -EINVAL;
+    }
+
+  return aes_cypher(req->dst, req->src, req->len, req->iv, ses->key,
+                    ses->keylen, mode, req->op == COP_ENCRYPT);
+#else
+  return -EINVAL;
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cryptodev_swinitialize
+ *
+ * Description:
+ *   Return the lower half that does the operations with the software AES
+ *   library or with aes_cypher().  See include/nuttx/crypto/cryptodev.h.
+ *
+ ****************************************************************************/
+
+FAR struct cryptodev_lowerhalf_s *cryptodev_swinitialize(void)
+{
+  return &g_swcrypto;
+}
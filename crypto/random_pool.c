@@ -49,8 +49,10 @@
 #include <errno.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/random.h>
 #include <nuttx/board.h>
+#include <nuttx/spinlock.h>
 
 #include <nuttx/crypto/blake2s.h>
 
@@ -65,6 +67,34 @@
 #define ROTL_32(x,n) ( ((x) << (n)) | ((x) >> (32-(n))) )
 #define ROTR_32(x,n) ( ((x) >> (n)) | ((x) << (32-(n))) )
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_CHACHA20
+#  ifdef CONFIG_SMP
+#    define RNG_NCPUS          CONFIG_SMP_NCPUS
+#  else
+#    define RNG_NCPUS          1
+#  endif
+
+#  ifndef CONFIG_CRYPTO_RANDOM_POOL_RESEED_SEC
+#    define CONFIG_CRYPTO_RANDOM_POOL_RESEED_SEC 300
+#  endif
+
+/* A ChaCha20 key is 8 words and produces blocks of 16 words */
+
+#  define CHACHA_KEYWORDS      8
+#  define CHACHA_BLOCKWORDS    16
+#  define CHACHA_BLOCKSIZE     (4 * CHACHA_BLOCKWORDS)
+
+#  define CHACHA_QR(a,b,c,d) \
+  do \
+    { \
+      a += b; d ^= a; d = ROTL_32(d, 16); \
+      c += d; b ^= c; b = ROTL_32(b, 12); \
+      a += b; d ^= a; d = ROTL_32(d, 8); \
+      c += d; b ^= c; b = ROTL_32(b, 7); \
+    } \
+  while (0)
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -93,6 +123,32 @@ struct rng_s
   struct blake2xs_rng_s blake2xs;
 };
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_CHACHA20
+/* The reseed state of the ChaCha20 generators */
+
+struct chacha_base_s
+{
+#ifdef CONFIG_SPINLOCK
+  spinlock_t lock;                  /* Protects newkey and generation */
+#endif
+  volatile uint32_t generation;     /* Zero until seeded, then counts the
+                                     * reseeds */
+  volatile clock_t reseedtime;      /* The time of the last reseed */
+};
+
+/* The ChaCha20 generator of one CPU.  key is only used by its CPU, with the
+ * local interrupts disabled.  newkey is set by a reseed and is moved to key
+ * (and erased) the next time that the CPU uses its generator.
+ */
+
+struct chacha_rng_s
+{
+  uint32_t key[CHACHA_KEYWORDS];
+  uint32_t newkey[CHACHA_KEYWORDS];
+  uint32_t generation;              /* Of the reseed of key */
+};
+#endif
+
 enum
 {
   POOL_SIZE = ENTROPY_POOL_SIZE,
@@ -108,6 +164,11 @@ enum
 
 static struct rng_s g_rng;
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_CHACHA20
+static struct chacha_base_s g_chacha_base;
+static struct chacha_rng_s g_chacha_rng[RNG_NCPUS];
+#endif
+
 #ifdef CONFIG_BOARD_ENTROPY_POOL
 /* Entropy pool structure can be provided by board source. Use for this is,
  * for example, allocate entropy pool from special area of RAM which content
@@ -374,6 +435,163 @@ static void rng_buf_internal(FAR void *bytes, size_t nbytes)
     }
 }
 
+/* The ChaCha20 random number generators.
+ *
+ * The BLAKE2Xs generator above needs the global lock of the pool and
+ * several BLAKE2s compressions per 32 bytes of output.  With
+ * CONFIG_CRYPTO_RANDOM_POOL_CHACHA20, getrandom() instead uses a ChaCha20
+ * generator per CPU.  Only reseeding takes the lock of the pool:  A base
+ * key is then taken from the BLAKE2Xs generator, a new key is derived from
+ * it for each CPU and the base key is erased at once, so that the output
+ * of one CPU cannot be recomputed from the state of another.  Each CPU
+ * starts to use its new key the next time that it is used.
+ *
+ * Each request first computes one ChaCha20 block with the key of the CPU.
+ * The first half of the block replaces the key ("fast key erasure"), so
+ * that earlier output cannot be recovered from the state, and the second
+ * half is either the output or the key for the rest of the output, which
+ * is then generated without disabling the interrupts.
+ */
+
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_CHACHA20
+static void chacha20_block(FAR const uint32_t *key, uint64_t counter,
+                           uint32_t nonce, FAR uint32_t *out)
+{
+  uint32_t x[CHACHA_BLOCKWORDS];
+  int i;
+
+  x[0]  = 0x61707865; /* "expand 32-byte k" */
+  x[1]  = 0x3320646e;
+  x[2]  = 0x79622d32;
+  x[3]  = 0x6b206574;
+  memcpy(&x[4], key, 4 * CHACHA_KEYWORDS);
+  x[12] = (uint32_t)counter;
+  x[13] = (uint32_t)(counter >> 32);
+  x[14] = nonce;
+  x[15] = 0;
+
+  memcpy(out, x, sizeof(x));
+
+  for (i = 0; i < 10; i++)
+    {
+      CHACHA_QR(out[0], out[4], out[8],  out[12]);
+      CHACHA_QR(out[1], out[5], out[9],  out[13]);
+      CHACHA_QR(out[2], out[6], out[10], out[14]);
+      CHACHA_QR(out[3], out[7], out[11], out[15]);
+      CHACHA_QR(out[0], out[5], out[10], out[15]);
+      CHACHA_QR(out[1], out[6], out[11], out[12]);
+      CHACHA_QR(out[2], out[7], out[8],  out[13]);
+      CHACHA_QR(out[3], out[4], out[9],  out[14]);
+    }
+
+  for (i = 0; i < CHACHA_BLOCKWORDS; i++)
+    {
+      out[i] += x[i];
+    }
+
+  explicit_bzero(x, sizeof(x));
+}
+
+static bool chacha_needreseed(void)
+{
+  return g_chacha_base.generation == 0 ||
+         g_rng.rd_newentr >= MAX_SEED_NEW_ENTROPY_WORDS ||
+         clock_systimer() - g_chacha_base.reseedtime >=
+         SEC2TICK(CONFIG_CRYPTO_RANDOM_POOL_RESEED_SEC);
+}
+
+/* Take a new base key from the BLAKE2Xs generator and derive the new key
+ * of each CPU from it.  rd_sem is held.
+ */
+
+static void chacha_reseed(void)
+{
+  uint32_t block[CHACHA_BLOCKWORDS];
+  uint32_t key[CHACHA_KEYWORDS];
+  irqstate_t flags;
+  int cpu;
+
+  rng_buf_internal(key, sizeof(key));
+
+  flags = spin_lock_save(&g_chacha_base.lock);
+  for (cpu = 0; cpu < RNG_NCPUS; cpu++)
+    {
+      chacha20_block(key, 0, cpu + 1, block);
+      memcpy(g_chacha_rng[cpu].newkey, block,
+             sizeof(g_chacha_rng[cpu].newkey));
+    }
+
+  if (++g_chacha_base.generation == 0)
+    {
+      g_chacha_base.generation = 1;
+    }
+
+  g_chacha_base.reseedtime = clock_systimer();
+  spin_unlock_restore(&g_chacha_base.lock, flags);
+
+  explicit_bzero(block, sizeof(block));
+  explicit_bzero(key, sizeof(key));
+}
+
+static void chacha_generate(FAR uint8_t *bytes, size_t nbytes)
+{
+  FAR struct chacha_rng_s *rng;
+  uint32_t block[CHACHA_BLOCKWORDS];
+  uint32_t key[CHACHA_KEYWORDS];
+  irqstate_t flags;
+  irqstate_t lock;
+  uint64_t counter;
+  size_t n;
+  int cpu;
+
+  /* With the interrupts disabled, the task cannot be moved to another CPU
+   * nor be preempted by a task using the generator of this CPU.
+   */
+
+  flags = up_irq_save();
+  cpu   = up_cpu_index();
+  rng   = &g_chacha_rng[cpu];
+
+  if (rng->generation != g_chacha_base.generation)
+    {
+      /* The generators were reseeded.  Take the new key of this CPU. */
+
+      lock = spin_lock_save(&g_chacha_base.lock);
+      memcpy(rng->key, rng->newkey, sizeof(rng->key));
+      explicit_bzero(rng->newkey, sizeof(rng->newkey));
+      rng->generation = g_chacha_base.generation;
+      spin_unlock_restore(&g_chacha_base.lock, lock);
+    }
+
+  chacha20_block(rng->key, 0, 0, block);
+  memcpy(rng->key, block, sizeof(rng->key));
+  up_irq_restore(flags);
+
+  if (nbytes <= sizeof(key))
+    {
+      memcpy(bytes, &block[CHACHA_KEYWORDS], nbytes);
+    }
+  else
+    {
+      memcpy(key, &block[CHACHA_KEYWORDS], sizeof(key));
+
+      for (counter = 1; nbytes > 0; counter++)
+        {
+          n = MIN(nbytes, CHACHA_BLOCKSIZE);
+          chacha20_block(key, counter, 0, block);
+          memcpy(bytes, block, n);
+
+          bytes  += n;
+          nbytes -= n;
+        }
+
+      explicit_bzero(key, sizeof(key));
+    }
+
+  explicit_bzero(block, sizeof(block));
+}
+#endif
+
 static void rng_init(void)
 {
   cryptinfo("Initializing RNG\n");
@@ -381,6 +599,14 @@ static void rng_init(void)
   memset(&g_rng, 0, sizeof(struct rng_s));
   nxsem_init(&g_rng.rd_sem, 0, 1);
 
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_CHACHA20
+  memset(&g_chacha_base, 0, sizeof(struct chacha_base_s));
+  memset(g_chacha_rng, 0, sizeof(g_chacha_rng));
+#ifdef CONFIG_SPINLOCK
+  spin_initialize(&g_chacha_base.lock, SP_UNLOCKED);
+#endif
+#endif
+
   /* We do not initialize output here because this is called
    * quite early in boot and there may not be enough entropy.
    *
@@ -518,6 +744,9 @@ void up_rngreseed(void)
       if (g_rng.rd_newentr >= MIN_SEED_NEW_ENTROPY_WORDS)
         {
           rng_reseed();
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_CHACHA20
+          chacha_reseed();
+#endif
         }
 
       nxsem_post(&g_rng.rd_sem);
@@ -541,6 +770,35 @@ void up_randompool_initialize(void)
 #endif
 }
 
+/****************************************************************************
+ * Name: up_rngbuf
+ *
+ * Description:
+ *   Fill a buffer with the output of the BLAKE2Xs generator of the entropy
+ *   pool, under the lock of the pool.  This is what getrandom() does
+ *   without CONFIG_CRYPTO_RANDOM_POOL_CHACHA20.
+ *
+ * Input Parameters:
+ *   bytes  - Buffer for returned random bytes
+ *   nbytes - Number of bytes requested.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void up_rngbuf(FAR void *bytes, size_t nbytes)
+{
+  int ret;
+
+  ret = nxsem_wait_uninterruptible(&g_rng.rd_sem);
+  if (ret >= 0)
+    {
+      rng_buf_internal(bytes, nbytes);
+      nxsem_post(&g_rng.rd_sem);
+    }
+}
+
 /****************************************************************************
  * Name: getrandom
  *
@@ -563,12 +821,27 @@ void up_randompool_initialize(void)
 
 void getrandom(FAR void *bytes, size_t nbytes)
 {
+#ifdef CONFIG_CRYPTO_RANDOM_POOL_CHACHA20
   int ret;
 
-  ret = nxsem_wait_uninterruptible(&g_rng.rd_sem);
-  if (ret >= 0)
+  if (chacha_needreseed())
     {
-      rng_buf_internal(bytes, nbytes);
+      ret = nxsem_wait_uninterruptible(&g_rng.rd_sem);
+      if (ret < 0)
+        {
+          return;
+        }
+
+      if (chacha_needreseed())
+        {
+          chacha_reseed();
+        }
+
       nxsem_post(&g_rng.rd_sem);
     }
+
+  chacha_generate(bytes, nbytes);
+#else
+  up_rngbuf(bytes, nbytes);
+#endif
 }
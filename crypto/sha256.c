@@ -0,0 +1,307 @@
+/****************************************************************************
+ * crypto/sha256.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+
+#include <nuttx/crypto/sha256.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define GETU32(p) \
+  (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | \
+   ((uint32_t)(p)[2] << 8)  |  (uint32_t)(p)[3])
+
+#define PUTU32(p, v) \
+  do \
+    { \
+      (p)[0] = (uint8_t)((v) >> 24); \
+      (p)[1] = (uint8_t)((v) >> 16); \
+      (p)[2] = (uint8_t)((v) >> 8); \
+      (p)[3] = (uint8_t)(v); \
+    } \
+  while (0)
+
+#define ROR32(v, n)   (((v) >> (n)) | ((v) << (32 - (n))))
+
+#define SIGMA0(x)     (ROR32(x, 2) ^ ROR32(x, 13) ^ ROR32(x, 22))
+#define SIGMA1(x)     (ROR32(x, 6) ^ ROR32(x, 11) ^ ROR32(x, 25))
+#define GAMMA0(x)     (ROR32(x, 7) ^ ROR32(x, 18) ^ ((x) >> 3))
+#define GAMMA1(x)     (ROR32(x, 17) ^ ROR32(x, 19) ^ ((x) >> 10))
+
+#define CH(x, y, z)   ((z) ^ ((x) & ((y) ^ (z))))
+#define MAJ(x, y, z)  (((x) & (y)) | ((z) & ((x) | (y))))
+
+/* The message schedule is kept in a ring of 16 words:  Word i replaces
+ * word i - 16, which is not needed anymore.
+ */
+
+#define SCHEDULE(w, i) \
+  ((w)[(i) & 15] += GAMMA1((w)[((i) - 2) & 15]) + (w)[((i) - 7) & 15] + \
+                    GAMMA0((w)[((i) - 15) & 15]))
+
+/* One round.  Instead of shifting the eight working variables, the
+ * callers rotate the names of the variables that they pass, so a round
+ * only updates d and h.
+ */
+
+#define ROUND(a, b, c, d, e, f, g, h, i, wi) \
+  do \
+    { \
+      uint32_t t1 = (h) + SIGMA1(e) + CH(e, f, g) + g_k[i] + (wi); \
+      (d) += t1; \
+      (h)  = t1 + SIGMA0(a) + MAJ(a, b, c); \
+    } \
+  while (0)
+
+#define ROUND8(i, wi) \
+  do \
+    { \
+      ROUND(a, b, c, d, e, f, g, h, (i) + 0, wi((i) + 0)); \
+      ROUND(h, a, b, c, d, e, f, g, (i) + 1, wi((i) + 1)); \
+      ROUND(g, h, a, b, c, d, e, f, (i) + 2, wi((i) + 2)); \
+      ROUND(f, g, h, a, b, c, d, e, (i) + 3, wi((i) + 3)); \
+      ROUND(e, f, g, h, a, b, c, d, (i) + 4, wi((i) + 4)); \
+      ROUND(d, e, f, g, h, a, b, c, (i) + 5, wi((i) + 5)); \
+      ROUND(c, d, e, f, g, h, a, b, (i) + 6, wi((i) + 6)); \
+      ROUND(b, c, d, e, f, g, h, a, (i) + 7, wi((i) + 7)); \
+    } \
+  while (0)
+
+#define WLOAD(i)      (w[i])
+#define WNEXT(i)      SCHEDULE(w, i)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint32_t g_k[64] =
+{
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+  0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+  0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+  0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+  0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+  0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+  0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+  0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+  0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const uint32_t g_h0[8] =
+{
+  0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+  0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sha256_transform
+ *
+ * Description:
+ *   Update the intermediate hash value with nblk blocks.  The rounds are
+ *   unrolled eight at a time, which is the period of the rotation of the
+ *   working variables, and the message schedule is computed as it is
+ *   consumed.
+ *
+ ****************************************************************************/
+
+static void sha256_transform(FAR uint32_t *hash, FAR const uint8_t *in,
+                             size_t nblk)
+{
+  uint32_t w[16];
+  uint32_t a;
+  uint32_t b;
+  uint32_t c;
+  uint32_t d;
+  uint32_t e;
+  uint32_t f;
+  uint32_t g;
+  uint32_t h;
+  int i;
+
+#ifdef CONFIG_CRYPTO_ARCH_SHA256
+  if (up_sha256_transform(hash, in, nblk) != -ENOSYS)
+    {
+      return;
+    }
+#endif
+
+  for (; nblk > 0; nblk--, in += SHA256_BLOCK_SIZE)
+    {
+      for (i = 0; i < 16; i++)
+        {
+          w[i] = GETU32(in + 4 * i);
+        }
+
+      a = hash[0];
+      b = hash[1];
+      c = hash[2];
+      d = hash[3];
+      e = hash[4];
+      f = hash[5];
+      g = hash[6];
+      h = hash[7];
+
+      ROUND8(0, WLOAD);
+      ROUND8(8, WLOAD);
+
+      for (i = 16; i < 64; i += 8)
+        {
+          ROUND8(i, WNEXT);
+        }
+
+      hash[0] += a;
+      hash[1] += b;
+      hash[2] += c;
+      hash[3] += d;
+      hash[4] += e;
+      hash[5] += f;
+      hash[6] += g;
+      hash[7] += h;
+    }
+
+  explicit_bzero(w, sizeof(w));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sha256_init
+ ****************************************************************************/
+
+void sha256_init(FAR struct sha256_state_s *state)
+{
+  memcpy(state->h, g_h0, sizeof(state->h));
+  state->nbytes = 0;
+}
+
+/****************************************************************************
+ * Name: sha256_update
+ ****************************************************************************/
+
+void sha256_update(FAR struct sha256_state_s *state, FAR const void *in,
+                   size_t len)
+{
+  FAR const uint8_t *src = in;
+  size_t used = state->nbytes % SHA256_BLOCK_SIZE;
+  size_t n;
+
+  state->nbytes += len;
+
+  /* Complete the partial block first */
+
+  if (used > 0)
+    {
+      n = SHA256_BLOCK_SIZE - used;
+      if (len < n)
+        {
+          memcpy(state->buf + used, src, len);
+          return;
+        }
+
+      memcpy(state->buf + used, src, n);
+      sha256_transform(state->h, state->buf, 1);
+      src += n;
+      len -= n;
+    }
+
+  /* Then hash all whole blocks at once and keep the rest */
+
+  n = len / SHA256_BLOCK_SIZE;
+  if (n > 0)
+    {
+      sha256_transform(state->h, src, n);
+      src += n * SHA256_BLOCK_SIZE;
+      len -= n * SHA256_BLOCK_SIZE;
+    }
+
+  memcpy(state->buf, src, len);
+}
+
+/****************************************************************************
+ * Name: sha256_final
+ ****************************************************************************/
+
+void sha256_final(FAR struct sha256_state_s *state, FAR uint8_t *digest)
+{
+  size_t used = state->nbytes % SHA256_BLOCK_SIZE;
+  uint64_t nbits = state->nbytes << 3;
+  int i;
+
+  /* Append the 1 bit, then zeros up to the 64-bit length of the message
+   * in bits at the end of a block.
+   */
+
+  state->buf[used++] = 0x80;
+  if (used > SHA256_BLOCK_SIZE - 8)
+    {
+      memset(state->buf + used, 0, SHA256_BLOCK_SIZE - used);
+      sha256_transform(state->h, state->buf, 1);
+      used = 0;
+    }
+
+  memset(state->buf + used, 0, SHA256_BLOCK_SIZE - 8 - used);
+  PUTU32(state->buf + SHA256_BLOCK_SIZE - 8, (uint32_t)(nbits >> 32));
+  PUTU32(state->buf + SHA256_BLOCK_SIZE - 4, (uint32_t)nbits);
+  sha256_transform(state->h, state->buf, 1);
+
+  for (i = 0; i < 8; i++)
+    {
+      PUTU32(digest + 4 * i, state->h[i]);
+    }
+
+  explicit_bzero(state, sizeof(*state));
+}
+
+/****************************************************************************
+ * Name: sha256
+ ****************************************************************************/
+
+void sha256(FAR const void *in, size_t len, FAR uint8_t *digest)
+{
+  struct sha256_state_s state;
+
+  sha256_init(&state);
+  sha256_update(&state, in, len);
+  sha256_final(&state, digest);
+}
@@ -44,11 +44,19 @@
 #include <string.h>
 #include <poll.h>
 #include <errno.h>
+#include <syslog.h>
+#include <crc16.h>
+#include <crc32.h>
 #include <debug.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/crypto/crypto.h>
+#include <nuttx/crypto/aes.h>
+#include <nuttx/crypto/blake2s.h>
+#include <nuttx/crypto/sha256.h>
+#include <nuttx/random.h>
 
 #ifdef CONFIG_CRYPTO_ALGTEST
 
@@ -62,6 +70,11 @@
 #  define ARRAY_SIZE(x) (sizeof(x) / sizeof((x)[0]))
 #endif
 
+/* Each benchmark runs for this long, on a buffer of this size */
+
+#define BENCH_MSEC    250
+#define BENCH_BUFSIZE 4096
+
 #if defined(CONFIG_CRYPTO_AES)
 
 /****************************************************************************
@@ -123,6 +136,598 @@ static int test_aes(void)
 }
 #endif
 
+#if defined(CONFIG_CRYPTO_SW_AES)
+static int do_test_swaes(FAR struct cipher_testvec *test, bool ctr,
+                         int encrypt)
+{
+  FAR struct aes_state_s *state = kmm_malloc(sizeof(struct aes_state_s));
+  FAR uint8_t *out = kmm_malloc(test->ilen);
+  uint8_t counter[AES_BLOCK_SIZE];
+  int res = -ENOMEM;
+
+  if (state != NULL && out != NULL)
+    {
+      res = aes_setupkey(state, (FAR const uint8_t *)test->key,
+                         test->klen);
+    }
+
+  if (res == OK)
+    {
+      memcpy(out, test->input, test->ilen);
+
+      if (ctr)
+        {
+          memcpy(counter, test->iv, AES_BLOCK_SIZE);
+          aes_ctr(state, counter, out, out, test->ilen);
+        }
+      else if (encrypt)
+        {
+          aes_encipher(state, out, test->ilen / AES_BLOCK_SIZE);
+        }
+      else
+        {
+          aes_decipher(state, out, test->ilen / AES_BLOCK_SIZE);
+        }
+
+      res = memcmp(out, test->result, test->rlen);
+    }
+
+  kmm_free(out);
+  kmm_free(state);
+  return res;
+}
+
+static int do_test_gcm(FAR struct aead_testvec *test)
+{
+  FAR struct aes_gcm_s *gcm = kmm_malloc(sizeof(struct aes_gcm_s));
+  FAR uint8_t *out = kmm_malloc(test->ilen);
+  uint8_t tag[AES_GCM_MAXTAG];
+  int res = -ENOMEM;
+
+  if (gcm != NULL && out != NULL)
+    {
+      res = aes_gcm_setkey(gcm, (FAR const uint8_t *)test->key,
+                           test->klen);
+    }
+
+  if (res == OK)
+    {
+      res = aes_gcm_encrypt(gcm, (FAR const uint8_t *)test->iv,
+                            test->ivlen, (FAR const uint8_t *)test->assoc,
+                            test->alen, (FAR const uint8_t *)test->input,
+                            out, test->ilen, tag, test->tlen);
+    }
+
+  if (res == OK)
+    {
+      res = memcmp(out, test->result, test->ilen) |
+            memcmp(tag, test->tag, test->tlen);
+    }
+
+  /* Decrypt in place */
+
+  if (res == OK)
+    {
+      res = aes_gcm_decrypt(gcm, (FAR const uint8_t *)test->iv,
+                            test->ivlen, (FAR const uint8_t *)test->assoc,
+                            test->alen, out, out, test->ilen,
+                            (FAR const uint8_t *)test->tag, test->tlen);
+    }
+
+  if (res == OK)
+    {
+      res = memcmp(out, test->input, test->ilen);
+    }
+
+  kmm_free(out);
+  kmm_free(gcm);
+  return res;
+}
+
+#define SWAES_TEST(ctr, encrypt, mode_str, count, template) \
+  for (i = 0; i < count; i++) { \
+    if (do_test_swaes(template + i, ctr, encrypt)) { \
+      crypterr("ERROR: Failed software " mode_str " test #%i\n", i); \
+      return -1; \
+    } \
+  }
+
+static int test_swaes(void)
+{
+  int i;
+
+  SWAES_TEST(false, CYPHER_ENCRYPT, "ECB encrypt",
+             ARRAY_SIZE(aes_enc_tv_template), aes_enc_tv_template)
+  SWAES_TEST(false, CYPHER_DECRYPT, "ECB decrypt",
+             ARRAY_SIZE(aes_dec_tv_template), aes_dec_tv_template)
+  SWAES_TEST(true, CYPHER_ENCRYPT, "CTR encrypt",
+             ARRAY_SIZE(aes_ctr_enc_tv_template), aes_ctr_enc_tv_template)
+  SWAES_TEST(true, CYPHER_DECRYPT, "CTR decrypt",
+             ARRAY_SIZE(aes_ctr_dec_tv_template), aes_ctr_dec_tv_template)
+
+  for (i = 0; i < ARRAY_SIZE(aes_gcm_tv_template); i++)
+    {
+      if (do_test_gcm(aes_gcm_tv_template + i))
+        {
+          crypterr("ERROR: Failed software GCM test #%i\n", i);
+          return -1;
+        }
+    }
+
+  return OK;
+}
+#endif
+
+#if defined(CONFIG_CRYPTO_ALGBENCH)
+/* A benchmarked operation.  Each call processes the same number of bytes. */
+
+typedef CODE void (*bench_func_t)(FAR void *arg);
+
+/****************************************************************************
+ * Name: bench_run
+ *
+ * Description:
+ *   Call a benchmarked operation repeatedly for BENCH_MSEC and return the
+ *   throughput in 1/100 MB/s.
+ *
+ * Input Parameters:
+ *   func - The operation
+ *   arg  - Passed to func()
+ *   size - The number of bytes processed by one call of func()
+ *
+ ****************************************************************************/
+
+static uint64_t bench_run(bench_func_t func, FAR void *arg, size_t size)
+{
+  clock_t start;
+  clock_t elapsed;
+  uint64_t nbytes = 0;
+
+  start = clock_systimer();
+
+  do
+    {
+      func(arg);
+      nbytes += size;
+      elapsed = clock_systimer() - start;
+    }
+  while (elapsed < MSEC2TICK(BENCH_MSEC));
+
+  /* Bytes per microsecond are MB/s */
+
+  return nbytes * 100 / TICK2USEC(elapsed);
+}
+#endif
+
+#if defined(CONFIG_CRYPTO_ALGBENCH) && defined(CONFIG_CRYPTO_SW_AES)
+/* The modes of the software AES library that are benchmarked */
+
+enum bench_aesmode_e
+{
+  BENCH_ECB_ENC = 0,
+  BENCH_ECB_DEC,
+  BENCH_CTR,
+  BENCH_GCM,
+  BENCH_NAESMODE
+};
+
+/* The state of the AES benchmark */
+
+struct bench_aes_s
+{
+  FAR struct aes_gcm_s *gcm;
+  FAR uint8_t *buf;
+  int mode;
+  uint8_t block[AES_BLOCK_SIZE];
+  uint8_t tag[AES_GCM_MAXTAG];
+};
+
+/****************************************************************************
+ * Name: bench_swaes_buf
+ *
+ * Description:
+ *   Process BENCH_BUFSIZE bytes with one mode of the software AES library.
+ *
+ ****************************************************************************/
+
+static void bench_swaes_buf(FAR void *arg)
+{
+  FAR struct bench_aes_s *ctx = (FAR struct bench_aes_s *)arg;
+  FAR struct aes_gcm_s *gcm = ctx->gcm;
+
+  switch (ctx->mode)
+    {
+      case BENCH_ECB_ENC:
+        aes_encipher(&gcm->aes, ctx->buf, BENCH_BUFSIZE / AES_BLOCK_SIZE);
+        break;
+
+      case BENCH_ECB_DEC:
+        aes_decipher(&gcm->aes, ctx->buf, BENCH_BUFSIZE / AES_BLOCK_SIZE);
+        break;
+
+      case BENCH_CTR:
+        aes_ctr(&gcm->aes, ctx->block, ctx->buf, ctx->buf, BENCH_BUFSIZE);
+        break;
+
+      default:  /* GCM encrypt */
+        aes_gcm_encrypt(gcm, ctx->block, 12, NULL, 0, ctx->buf, ctx->buf,
+                        BENCH_BUFSIZE, ctx->tag, AES_GCM_MAXTAG);
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: bench_swaes_mode
+ *
+ * Description:
+ *   Process a buffer with one mode of the software AES library for
+ *   BENCH_MSEC and print the throughput.
+ *
+ ****************************************************************************/
+
+static void bench_swaes_mode(FAR struct aes_gcm_s *gcm, FAR uint8_t *buf,
+                             int klen, int mode)
+{
+  static const FAR char * const names[BENCH_NAESMODE] =
+  {
+    "ECB-enc",
+    "ECB-dec",
+    "CTR",
+    "GCM"
+  };
+
+  struct bench_aes_s ctx;
+  uint64_t rate;
+
+  memset(&ctx, 0, sizeof(ctx));
+  ctx.gcm  = gcm;
+  ctx.buf  = buf;
+  ctx.mode = mode;
+
+  rate = bench_run(bench_swaes_buf, &ctx, BENCH_BUFSIZE);
+  syslog(LOG_NOTICE, "AES-%d %-7s %lu.%02lu MB/s\n", klen * 8, names[mode],
+         (unsigned long)(rate / 100), (unsigned long)(rate % 100));
+}
+
+/****************************************************************************
+ * Name: bench_swaes
+ *
+ * Description:
+ *   Measure the throughput of the software AES library for each mode and
+ *   key size.
+ *
+ ****************************************************************************/
+
+static void bench_swaes(void)
+{
+  static const uint8_t key[AES256_KEY_SIZE];
+  FAR struct aes_gcm_s *gcm = kmm_malloc(sizeof(struct aes_gcm_s));
+  FAR uint8_t *buf = kmm_zalloc(BENCH_BUFSIZE);
+  int klen;
+  int mode;
+
+  if (gcm != NULL && buf != NULL)
+    {
+      for (klen = AES128_KEY_SIZE; klen <= AES256_KEY_SIZE; klen += 8)
+        {
+          aes_gcm_setkey(gcm, key, klen);
+          for (mode = 0; mode < BENCH_NAESMODE; mode++)
+            {
+              bench_swaes_mode(gcm, buf, klen, mode);
+            }
+        }
+    }
+
+  kmm_free(buf);
+  kmm_free(gcm);
+}
+#endif
+
+#if defined(CONFIG_CRYPTO_ALGBENCH) && defined(CONFIG_DEV_URANDOM_RANDOM_POOL)
+/* The state of the random number benchmark */
+
+struct bench_random_s
+{
+  CODE void (*fill)(FAR void *, size_t);
+  FAR uint8_t *buf;
+  size_t size;
+};
+
+/****************************************************************************
+ * Name: bench_random_fill
+ *
+ * Description:
+ *   Request one block of random bytes.
+ *
+ ****************************************************************************/
+
+static void bench_random_fill(FAR void *arg)
+{
+  FAR struct bench_random_s *ctx = (FAR struct bench_random_s *)arg;
+
+  ctx->fill(ctx->buf, ctx->size);
+}
+
+/****************************************************************************
+ * Name: bench_random
+ *
+ * Description:
+ *   Compare the throughput of getrandom() with that of the BLAKE2Xs
+ *   generator of the entropy pool, from nonce sized to page sized requests.
+ *
+ ****************************************************************************/
+
+static void bench_random(void)
+{
+  static const uint16_t sizes[] =
+  {
+    16, 64, 512, BENCH_BUFSIZE
+  };
+
+  struct bench_random_s ctx;
+  uint64_t pool;
+  uint64_t rate;
+  int i;
+
+  ctx.buf = kmm_malloc(BENCH_BUFSIZE);
+  if (ctx.buf == NULL)
+    {
+      return;
+    }
+
+  for (i = 0; i < ARRAY_SIZE(sizes); i++)
+    {
+      ctx.size = sizes[i];
+      ctx.fill = up_rngbuf;
+      pool     = bench_run(bench_random_fill, &ctx, sizes[i]);
+      ctx.fill = getrandom;
+      rate     = bench_run(bench_random_fill, &ctx, sizes[i]);
+
+      syslog(LOG_NOTICE,
+             "getrandom %4u bytes %lu.%02lu MB/s (pool %lu.%02lu MB/s)\n",
+             sizes[i], (unsigned long)(rate / 100),
+             (unsigned long)(rate % 100), (unsigned long)(pool / 100),
+             (unsigned long)(pool % 100));
+    }
+
+  kmm_free(ctx.buf);
+}
+#endif
+
+#if defined(CONFIG_CRYPTO_SHA256)
+/****************************************************************************
+ * Name: test_sha256
+ *
+ * Description:
+ *   Hash each test message at once and byte by byte.
+ *
+ ****************************************************************************/
+
+static int test_sha256(void)
+{
+  FAR struct hash_testvec *test;
+  struct sha256_state_s state;
+  uint8_t digest[SHA256_DIGEST_SIZE];
+  size_t j;
+  int i;
+
+  for (i = 0; i < ARRAY_SIZE(sha256_tv_template); i++)
+    {
+      test = sha256_tv_template + i;
+
+      sha256(test->plaintext, test->psize, digest);
+      if (memcmp(digest, test->digest, SHA256_DIGEST_SIZE) != 0)
+        {
+          crypterr("ERROR: Failed SHA-256 test #%i\n", i);
+          return -1;
+        }
+
+      sha256_init(&state);
+      for (j = 0; j < test->psize; j++)
+        {
+          sha256_update(&state, test->plaintext + j, 1);
+        }
+
+      sha256_final(&state, digest);
+      if (memcmp(digest, test->digest, SHA256_DIGEST_SIZE) != 0)
+        {
+          crypterr("ERROR: Failed bytewise SHA-256 test #%i\n", i);
+          return -1;
+        }
+    }
+
+  return OK;
+}
+#endif
+
+#if defined(CONFIG_CRYPTO_ALGBENCH)
+/* The hash functions that are benchmarked */
+
+enum bench_hash_e
+{
+  BENCH_CRC32 = 0,
+  BENCH_CRC16,
+#ifdef CONFIG_CRYPTO_BLAKE2S
+  BENCH_BLAKE2S,
+#endif
+#ifdef CONFIG_CRYPTO_SHA256
+  BENCH_SHA256,
+#endif
+  BENCH_NHASH
+};
+
+/* The state of the hash benchmark */
+
+struct bench_hash_s
+{
+  int alg;
+  FAR const uint8_t *buf;
+  size_t size;
+  uint8_t digest[32];
+};
+
+/****************************************************************************
+ * Name: bench_hash_msg
+ *
+ * Description:
+ *   Hash one message of a size, which is fed to the hash function in
+ *   pieces of BENCH_BUFSIZE bytes, as a stream would be.
+ *
+ ****************************************************************************/
+
+static void bench_hash_msg(int alg, FAR const uint8_t *buf, size_t size,
+                           FAR uint8_t *digest)
+{
+  union
+  {
+#ifdef CONFIG_CRYPTO_BLAKE2S
+    blake2s_state blake2s;
+#endif
+#ifdef CONFIG_CRYPTO_SHA256
+    struct sha256_state_s sha256;
+#endif
+    uint32_t crc;
+  } ctx;
+
+  size_t n;
+
+  switch (alg)
+    {
+#ifdef CONFIG_CRYPTO_BLAKE2S
+      case BENCH_BLAKE2S:
+        blake2s_init(&ctx.blake2s, BLAKE2S_OUTBYTES);
+        break;
+#endif
+
+#ifdef CONFIG_CRYPTO_SHA256
+      case BENCH_SHA256:
+        sha256_init(&ctx.sha256);
+        break;
+#endif
+
+      default:
+        ctx.crc = 0;
+        break;
+    }
+
+  for (; size > 0; size -= n)
+    {
+      n = size < BENCH_BUFSIZE ? size : BENCH_BUFSIZE;
+
+      switch (alg)
+        {
+          case BENCH_CRC32:
+            ctx.crc = crc32part(buf, n, ctx.crc);
+            break;
+
+          case BENCH_CRC16:
+            ctx.crc = crc16part(buf, n, (uint16_t)ctx.crc);
+            break;
+
+#ifdef CONFIG_CRYPTO_BLAKE2S
+          case BENCH_BLAKE2S:
+            blake2s_update(&ctx.blake2s, buf, n);
+            break;
+#endif
+
+#ifdef CONFIG_CRYPTO_SHA256
+          case BENCH_SHA256:
+            sha256_update(&ctx.sha256, buf, n);
+            break;
+#endif
+        }
+    }
+
+  switch (alg)
+    {
+#ifdef CONFIG_CRYPTO_BLAKE2S
+      case BENCH_BLAKE2S:
+        blake2s_final(&ctx.blake2s, digest, BLAKE2S_OUTBYTES);
+        break;
+#endif
+
+#ifdef CONFIG_CRYPTO_SHA256
+      case BENCH_SHA256:
+        sha256_final(&ctx.sha256, digest);
+        break;
+#endif
+
+      default:
+        memcpy(digest, &ctx.crc, sizeof(ctx.crc));
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: bench_hash_run
+ *
+ * Description:
+ *   Hash one message with the benchmarked function.
+ *
+ ****************************************************************************/
+
+static void bench_hash_run(FAR void *arg)
+{
+  FAR struct bench_hash_s *ctx = (FAR struct bench_hash_s *)arg;
+
+  bench_hash_msg(ctx->alg, ctx->buf, ctx->size, ctx->digest);
+}
+
+/****************************************************************************
+ * Name: bench_hash
+ *
+ * Description:
+ *   Measure the throughput of the CRCs and of the hash functions from
+ *   packet sized to large messages.
+ *
+ ****************************************************************************/
+
+static void bench_hash(void)
+{
+  static const FAR char * const names[BENCH_NHASH] =
+  {
+    "CRC-32",
+    "CRC-16",
+#ifdef CONFIG_CRYPTO_BLAKE2S
+    "BLAKE2s",
+#endif
+#ifdef CONFIG_CRYPTO_SHA256
+    "SHA-256",
+#endif
+  };
+
+  static const uint32_t sizes[] =
+  {
+    64, 1024, 16384, 1048576
+  };
+
+  FAR uint8_t *buf = kmm_zalloc(BENCH_BUFSIZE);
+  struct bench_hash_s ctx;
+  uint64_t rate;
+  int i;
+
+  if (buf == NULL)
+    {
+      return;
+    }
+
+  ctx.buf = buf;
+  for (ctx.alg = 0; ctx.alg < BENCH_NHASH; ctx.alg++)
+    {
+      for (i = 0; i < ARRAY_SIZE(sizes); i++)
+        {
+          ctx.size = sizes[i];
+          rate     = bench_run(bench_hash_run, &ctx, sizes[i]);
+          syslog(LOG_NOTICE, "%-7s %7lu bytes %lu.%02lu MB/s\n",
+                 names[ctx.alg], (unsigned long)sizes[i],
+                 (unsigned long)(rate / 100), (unsigned long)(rate % 100));
+        }
+    }
+
+  kmm_free(buf);
+}
+#endif
+
 int crypto_test(void)
 {
 #if defined(CONFIG_CRYPTO_AES)
@@ -132,6 +737,32 @@ int crypto_test(void)
     }
 #endif
 
+#if defined(CONFIG_CRYPTO_SW_AES)
+  if (test_swaes())
+    {
+      return -1;
+    }
+#endif
+
+#if defined(CONFIG_CRYPTO_SHA256)
+  if (test_sha256())
+    {
+      return -1;
+    }
+#endif
+
+#if defined(CONFIG_CRYPTO_ALGBENCH) && defined(CONFIG_CRYPTO_SW_AES)
+  bench_swaes();
+#endif
+
+#if defined(CONFIG_CRYPTO_ALGBENCH) && defined(CONFIG_DEV_URANDOM_RANDOM_POOL)
+  bench_random();
+#endif
+
+#if defined(CONFIG_CRYPTO_ALGBENCH)
+  bench_hash();
+#endif
+
   return OK;
 }
 
@@ -60,13 +60,37 @@ struct cipher_testvec
   unsigned short rlen;
 };
 
+struct aead_testvec
+{
+  FAR char *key;
+  FAR char *iv;
+  FAR char *assoc;
+  FAR char *input;
+  FAR char *result;
+  FAR char *tag;
+  unsigned char klen;
+  unsigned char ivlen;
+  unsigned char alen;
+  unsigned char tlen;
+  unsigned short ilen;
+};
+
+struct hash_testvec
+{
+  FAR char *plaintext;
+  FAR char *digest;
+  unsigned short psize;
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
-#if defined(CONFIG_CRYPTO_AES)
+#if defined(CONFIG_CRYPTO_AES) || defined(CONFIG_CRYPTO_SW_AES)
 
-/* AES test vectors */
+/* AES test vectors.  The CBC vectors are only used with the AES of the
+ * architecture, because the software library has no CBC mode.
+ */
 
 static struct cipher_testvec aes_enc_tv_template[] =
 {
@@ -160,6 +184,7 @@ static struct cipher_testvec aes_dec_tv_template[] =
 #endif
 };
 
+#if defined(CONFIG_CRYPTO_AES)
 static struct cipher_testvec aes_cbc_enc_tv_template[] =
 {
 #ifndef CONFIG_CRYPTO_AES128_DISABLE
@@ -347,6 +372,7 @@ static struct cipher_testvec aes_cbc_dec_tv_template[] =
   },
 #endif
 };
+#endif /* CONFIG_CRYPTO_AES */
 
 static struct cipher_testvec aes_ctr_enc_tv_template[] =
 {
@@ -524,5 +550,116 @@ static struct cipher_testvec aes_ctr_dec_tv_template[] =
 #endif
 };
 
-#endif /* CONFIG_CRYPTO_AES */
+#endif /* CONFIG_CRYPTO_AES || CONFIG_CRYPTO_SW_AES */
+
+#if defined(CONFIG_CRYPTO_SW_AES)
+
+/* AES-GCM test vectors */
+
+static struct aead_testvec aes_gcm_tv_template[] =
+{
+#ifndef CONFIG_CRYPTO_AES128_DISABLE
+  { /* From the GCM specification, test case 2 */
+    .key  = "\x00\x00\x00\x00\x00\x00\x00\x00"
+        "\x00\x00\x00\x00\x00\x00\x00\x00",
+    .klen = 16,
+    .iv = "\x00\x00\x00\x00\x00\x00\x00\x00"
+        "\x00\x00\x00\x00",
+    .ivlen = 12,
+    .input  = "\x00\x00\x00\x00\x00\x00\x00\x00"
+        "\x00\x00\x00\x00\x00\x00\x00\x00",
+    .ilen = 16,
+    .result = "\x03\x88\xda\xce\x60\xb6\xa3\x92"
+        "\xf3\x28\xc2\xb9\x71\xb2\xfe\x78",
+    .tag = "\xab\x6e\x47\xd4\x2c\xec\x13\xbd"
+        "\xf5\x3a\x67\xb2\x12\x57\xbd\xdf",
+    .tlen = 16,
+  },
+  { /* From the GCM specification, test case 4 */
+    .key  = "\xfe\xff\xe9\x92\x86\x65\x73\x1c"
+        "\x6d\x6a\x8f\x94\x67\x30\x83\x08",
+    .klen = 16,
+    .iv = "\xca\xfe\xba\xbe\xfa\xce\xdb\xad"
+        "\xde\xca\xf8\x88",
+    .ivlen = 12,
+    .assoc = "\xfe\xed\xfa\xce\xde\xad\xbe\xef"
+        "\xfe\xed\xfa\xce\xde\xad\xbe\xef"
+        "\xab\xad\xda\xd2",
+    .alen = 20,
+    .input  = "\xd9\x31\x32\x25\xf8\x84\x06\xe5"
+        "\xa5\x59\x09\xc5\xaf\xf5\x26\x9a"
+        "\x86\xa7\xa9\x53\x15\x34\xf7\xda"
+        "\x2e\x4c\x30\x3d\x8a\x31\x8a\x72"
+        "\x1c\x3c\x0c\x95\x95\x68\x09\x53"
+        "\x2f\xcf\x0e\x24\x49\xa6\xb5\x25"
+        "\xb1\x6a\xed\xf5\xaa\x0d\xe6\x57"
+        "\xba\x63\x7b\x39",
+    .ilen = 60,
+    .result = "\x42\x83\x1e\xc2\x21\x77\x74\x24"
+        "\x4b\x72\x21\xb7\x84\xd0\xd4\x9c"
+        "\xe3\xaa\x21\x2f\x2c\x02\xa4\xe0"
+        "\x35\xc1\x7e\x23\x29\xac\xa1\x2e"
+        "\x21\xd5\x14\xb2\x54\x66\x93\x1c"
+        "\x7d\x8f\x6a\x5a\xac\x84\xaa\x05"
+        "\x1b\xa3\x0b\x39\x6a\x0a\xac\x97"
+        "\x3d\x58\xe0\x91",
+    .tag = "\x5b\xc9\x4f\xbc\x32\x21\xa5\xdb"
+        "\x94\xfa\xe9\x5a\xe7\x12\x1a\x47",
+    .tlen = 16,
+  },
+#endif
+#ifndef CONFIG_CRYPTO_AES256_DISABLE
+  { /* From the GCM specification, test case 14 */
+    .key  = "\x00\x00\x00\x00\x00\x00\x00\x00"
+        "\x00\x00\x00\x00\x00\x00\x00\x00"
+        "\x00\x00\x00\x00\x00\x00\x00\x00"
+        "\x00\x00\x00\x00\x00\x00\x00\x00",
+    .klen = 32,
+    .iv = "\x00\x00\x00\x00\x00\x00\x00\x00"
+        "\x00\x00\x00\x00",
+    .ivlen = 12,
+    .input  = "\x00\x00\x00\x00\x00\x00\x00\x00"
+        "\x00\x00\x00\x00\x00\x00\x00\x00",
+    .ilen = 16,
+    .result = "\xce\xa7\x40\x3d\x4d\x60\x6b\x6e"
+        "\x07\x4e\xc5\xd3\xba\xf3\x9d\x18",
+    .tag = "\xd0\xd1\xc8\xa7\x99\x99\x6b\xf0"
+        "\x26\x5b\x98\xb5\xd4\x8a\xb9\x19",
+    .tlen = 16,
+  },
+#endif
+};
+
+#endif /* CONFIG_CRYPTO_SW_AES */
+
+#if defined(CONFIG_CRYPTO_SHA256)
+static struct hash_testvec sha256_tv_template[] =
+{
+  { /* From FIPS 180-2, one block message */
+    .plaintext = "abc",
+    .psize = 3,
+    .digest = "\xba\x78\x16\xbf\x8f\x01\xcf\xea"
+        "\x41\x41\x40\xde\x5d\xae\x22\x23"
+        "\xb0\x03\x61\xa3\x96\x17\x7a\x9c"
+        "\xb4\x10\xff\x61\xf2\x00\x15\xad",
+  },
+  { /* The empty message */
+    .plaintext = "",
+    .psize = 0,
+    .digest = "\xe3\xb0\xc4\x42\x98\xfc\x1c\x14"
+        "\x9a\xfb\xf4\xc8\x99\x6f\xb9\x24"
+        "\x27\xae\x41\xe4\x64\x9b\x93\x4c"
+        "\xa4\x95\x99\x1b\x78\x52\xb8\x55",
+  },
+  { /* From FIPS 180-2, multi-block message */
+    .plaintext = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+    .psize = 56,
+    .digest = "\x24\x8d\x6a\x61\xd2\x06\x38\xb8"
+        "\xe5\xc0\x26\x93\x0c\x3e\x60\x39"
+        "\xa3\x3c\xe4\x59\x64\xff\x21\x67"
+        "\xf6\xec\xed\xd4\x19\xdb\x06\xc1",
+  },
+};
+
+#endif /* CONFIG_CRYPTO_SHA256 */
 #endif /* __CRYPTO_TESTMNGR_H */
@@ -135,6 +135,32 @@
 #  define CONFIG_MTD_SMART_SECTOR_SIZE 1024
 #endif
 
+#ifdef CONFIG_MTD_SMART_DATA_CACHE
+#  ifndef CONFIG_MTD_SMART_DATA_CACHE_SECTORS
+#    define CONFIG_MTD_SMART_DATA_CACHE_SECTORS 8
+#  endif
+#  ifndef CONFIG_MTD_SMART_DATA_READAHEAD
+#    define CONFIG_MTD_SMART_DATA_READAHEAD 4
+#  endif
+
+/* Don't let read-ahead displace more than half of the data cache */
+
+#  if CONFIG_MTD_SMART_DATA_READAHEAD > \
+      CONFIG_MTD_SMART_DATA_CACHE_SECTORS / 2
+#    define SMART_DCACHE_READAHEAD  (CONFIG_MTD_SMART_DATA_CACHE_SECTORS / 2)
+#  else
+#    define SMART_DCACHE_READAHEAD  CONFIG_MTD_SMART_DATA_READAHEAD
+#  endif
+#  if SMART_DCACHE_READAHEAD < 1
+#    undef SMART_DCACHE_READAHEAD
+#    define SMART_DCACHE_READAHEAD  1
+#  endif
+#endif
+
+#ifndef CONFIG_MTD_SMART_WEAR_BATCH
+#  define CONFIG_MTD_SMART_WEAR_BATCH 1
+#endif
+
 #ifndef offsetof
 #define offsetof(type, member) ( (size_t) &( ( (type *) 0)->member))
 #endif
@@ -233,6 +259,20 @@ struct smart_allocsector_s
 };
 #endif
 
+/* The data cache holds complete copies of recently read sectors.  An entry
+ * is only valid while the logical sector is still mapped to the same
+ * physical sector, so relocated sectors simply miss.
+ */
+
+#ifdef CONFIG_MTD_SMART_DATA_CACHE
+struct smart_dcache_s
+{
+  uint16_t              logical;          /* Logical sector (0xffff: unused) */
+  uint16_t              physical;         /* Physical sector read from */
+  uint32_t              lastuse;          /* Used to find the LRU entry */
+};
+#endif
+
 struct smart_struct_s
 {
   FAR struct mtd_dev_s *mtd;              /* Contained MTD interface */
@@ -287,6 +327,18 @@ struct smart_struct_s
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   FAR uint8_t          *erasecounts;      /* Number of erases for each erase block */
 #endif
+#ifdef CONFIG_MTD_SMART_DATA_CACHE
+  FAR struct smart_dcache_s *dcache;      /* Data cache entries */
+  FAR uint8_t          *dcachedata;       /* Data cache sector copies */
+  FAR uint8_t          *dcachebuf;        /* Read-ahead buffer */
+  uint32_t              dcacheuse;        /* Data cache access counter */
+  uint32_t              dcachehits;       /* Number of data cache hits */
+  uint32_t              dcachemisses;     /* Number of data cache misses */
+  uint32_t              dcachereadahead;  /* Number of sectors read ahead */
+#endif
+#if defined(CONFIG_MTD_SMART_WEAR_LEVEL) && CONFIG_MTD_SMART_WEAR_BATCH > 1
+  uint16_t              wearpending;      /* Deferred wear status writes */
+#endif
 #ifdef CONFIG_MTD_SMART_ALLOC_DEBUG
   size_t                bytesalloc;
   struct smart_alloc_s  alloc[SMART_MAX_ALLOCS];   /* Array of memory allocations */
@@ -425,6 +477,10 @@ static int     smart_writesector(FAR struct smart_struct_s *dev,
                  unsigned long arg);
 static inline int smart_allocsector(FAR struct smart_struct_s *dev,
                  unsigned long requested);
+#ifdef CONFIG_MTD_SMART_DATA_CACHE
+static void    smart_dcache_invalidate(FAR struct smart_struct_s *dev,
+                 uint16_t logsector);
+#endif
 static int     smart_readsector(FAR struct smart_struct_s *dev,
                  unsigned long arg);
 
@@ -433,6 +489,7 @@ static int     smart_validate_crc(FAR struct smart_struct_s *dev);
 #endif
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
 static int     smart_read_wearstatus(FAR struct smart_struct_s *dev);
+static int     smart_write_wearstatus(FAR struct smart_struct_s *dev);
 static int     smart_relocate_static_data(FAR struct smart_struct_s *dev,
                  uint16_t block);
 #endif
@@ -506,7 +563,27 @@ static int smart_open(FAR struct inode *inode)
 
 static int smart_close(FAR struct inode *inode)
 {
+#if defined(CONFIG_MTD_SMART_WEAR_LEVEL) && CONFIG_MTD_SMART_WEAR_BATCH > 1
+  FAR struct smart_struct_s *dev;
+#endif
+
   finfo("Entry\n");
+
+#if defined(CONFIG_MTD_SMART_WEAR_LEVEL) && CONFIG_MTD_SMART_WEAR_BATCH > 1
+#ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
+  dev = ((FAR struct smart_multiroot_device_s *)inode->i_private)->dev;
+#else
+  dev = (FAR struct smart_struct_s *)inode->i_private;
+#endif
+
+  /* Write any wear status updates that have been deferred */
+
+  if (dev->wearflags & SMART_WEARFLAGS_WRITE_NEEDED)
+    {
+      smart_write_wearstatus(dev);
+    }
+#endif
+
   return OK;
 }
 
@@ -1163,6 +1240,14 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
       dev->rwbuffer = NULL;
     }
 
+#ifdef CONFIG_MTD_SMART_DATA_CACHE
+  if (dev->dcache != NULL)
+    {
+      smart_free(dev, dev->dcache);
+      dev->dcache = NULL;
+    }
+#endif
+
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
   if (dev->wearstatus != NULL)
     {
@@ -1321,6 +1406,30 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
       goto errexit;
     }
 
+#ifdef CONFIG_MTD_SMART_DATA_CACHE
+  /* Allocate the data cache and its read-ahead buffer.  This is not fatal:
+   * Sectors will be read directly from the device if it fails.
+   */
+
+  allocsize = CONFIG_MTD_SMART_DATA_CACHE_SECTORS *
+              (sizeof(struct smart_dcache_s) + size) +
+              SMART_DCACHE_READAHEAD * size;
+  dev->dcache = (FAR struct smart_dcache_s *)
+    smart_malloc(dev, allocsize, "Data cache");
+  if (dev->dcache != NULL)
+    {
+      dev->dcachedata = (FAR uint8_t *)
+        &dev->dcache[CONFIG_MTD_SMART_DATA_CACHE_SECTORS];
+      dev->dcachebuf  = dev->dcachedata +
+                        CONFIG_MTD_SMART_DATA_CACHE_SECTORS * size;
+      smart_dcache_invalidate(dev, 0xffff);
+    }
+  else
+    {
+      fwarn("WARNING: Failed to allocate the data cache\n");
+    }
+#endif
+
   return OK;
 
   /* On error for any allocation, we jump here and free anything that had
@@ -2010,6 +2119,10 @@ static int smart_scan(FAR struct smart_struct_s *dev)
       goto err_out;
     }
 
+#ifdef CONFIG_MTD_SMART_DATA_CACHE
+  smart_dcache_invalidate(dev, 0xffff);
+#endif
+
   /* Initialize the device variables */
 
   totalsectors        = dev->totalsectors;
@@ -3109,6 +3222,12 @@ static inline int smart_llformat(FAR struct smart_struct_s *dev,
       return ret;
     }
 
+#ifdef CONFIG_MTD_SMART_DATA_CACHE
+  /* Everything that is cached is about to be erased */
+
+  smart_dcache_invalidate(dev, 0xffff);
+#endif
+
   /* Check for invalid format */
 
   if (dev->erasesize == 0 || dev->sectorsperblk == 0)
@@ -4214,6 +4333,9 @@ static int smart_write_wearstatus(struct smart_struct_s *dev)
   /* Now clear the NEEDS_WRITE wear status bit */
 
   dev->wearflags &= ~SMART_WEARFLAGS_WRITE_NEEDED;
+#if CONFIG_MTD_SMART_WEAR_BATCH > 1
+  dev->wearpending = 0;
+#endif
   ret = OK;
 
 errout:
@@ -4550,6 +4672,10 @@ static int smart_writesector(FAR struct smart_struct_s *dev,
 
   header = (FAR struct smart_sect_header_s *)dev->rwbuffer;
 
+#ifdef CONFIG_MTD_SMART_DATA_CACHE
+  smart_dcache_invalidate(dev, req->logsector);
+#endif
+
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
   /* Test if an adjustment to the wear levels is needed */
 
@@ -4920,6 +5046,264 @@ errout:
   return ret;
 }
 
+#ifdef CONFIG_MTD_SMART_DATA_CACHE
+/****************************************************************************
+ * Name: smart_dcache_invalidate
+ *
+ * Description:  Removes a logical sector from the data cache.  The whole
+ *               cache is invalidated if logsector is 0xffff.
+ *
+ ****************************************************************************/
+
+static void smart_dcache_invalidate(FAR struct smart_struct_s *dev,
+                                    uint16_t logsector)
+{
+  int x;
+
+  if (dev->dcache == NULL)
+    {
+      return;
+    }
+
+  for (x = 0; x < CONFIG_MTD_SMART_DATA_CACHE_SECTORS; x++)
+    {
+      if (logsector == 0xffff || dev->dcache[x].logical == logsector)
+        {
+          dev->dcache[x].logical = 0xffff;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: smart_dcache_find
+ *
+ * Description:  Returns the index of the data cache entry that holds the
+ *               logical sector as read from the physical sector, or -1 if
+ *               there is no such entry.
+ *
+ ****************************************************************************/
+
+static int smart_dcache_find(FAR struct smart_struct_s *dev,
+                             uint16_t logsector, uint16_t physsector)
+{
+  int x;
+
+  for (x = 0; x < CONFIG_MTD_SMART_DATA_CACHE_SECTORS; x++)
+    {
+      if (dev->dcache[x].logical == logsector &&
+          dev->dcache[x].physical == physsector)
+        {
+          dev->dcache[x].lastuse = ++dev->dcacheuse;
+          return x;
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: smart_dcache_insert
+ *
+ * Description:  Copies a sector into the data cache, replacing an unused
+ *               entry or else the least recently used entry.  Returns the
+ *               index of the entry.
+ *
+ ****************************************************************************/
+
+static int smart_dcache_insert(FAR struct smart_struct_s *dev,
+                               uint16_t logsector, uint16_t physsector,
+                               FAR const uint8_t *sector)
+{
+  uint32_t oldest = 0;
+  int victim = 0;
+  int x;
+
+  for (x = 0; x < CONFIG_MTD_SMART_DATA_CACHE_SECTORS; x++)
+    {
+      if (dev->dcache[x].logical == 0xffff)
+        {
+          victim = x;
+          break;
+        }
+
+      if (dev->dcacheuse - dev->dcache[x].lastuse > oldest)
+        {
+          oldest = dev->dcacheuse - dev->dcache[x].lastuse;
+          victim = x;
+        }
+    }
+
+  memcpy(&dev->dcachedata[victim * dev->sectorsize], sector,
+         dev->sectorsize);
+
+  dev->dcache[victim].logical  = logsector;
+  dev->dcache[victim].physical = physsector;
+  dev->dcache[victim].lastuse  = ++dev->dcacheuse;
+  return victim;
+}
+
+/****************************************************************************
+ * Name: smart_dcache_validate
+ *
+ * Description:  Validates a sector that was read from the device before it
+ *               is added to the data cache.
+ *
+ ****************************************************************************/
+
+static int smart_dcache_validate(FAR struct smart_struct_s *dev,
+                                 FAR const uint8_t *sector,
+                                 uint16_t logsector)
+{
+  FAR const struct smart_sect_header_s *header;
+
+  header = (FAR const struct smart_sect_header_s *)sector;
+  if (*(FAR const uint16_t *)header->logicalsector != logsector ||
+      (header->status & SMART_STATUS_COMMITTED) ==
+      (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED))
+    {
+      return -EIO;
+    }
+
+#ifdef CONFIG_MTD_SMART_ENABLE_CRC
+#if SMART_STATUS_VERSION == 1
+  if ((header->status & SMART_STATUS_CRC) ==
+      (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_CRC))
+    {
+      /* CRC not enabled for this sector */
+
+      return OK;
+    }
+#endif
+
+  /* The CRC is calculated over the read/write buffer */
+
+  memcpy(dev->rwbuffer, sector, dev->sectorsize);
+  return smart_validate_crc(dev);
+#else
+  return OK;
+#endif
+}
+
+/****************************************************************************
+ * Name: smart_dcache_fill
+ *
+ * Description:  Reads a sector into the data cache.  The following sectors
+ *               in the same erase block are read with the same MTD read
+ *               and those that are mapped to a logical sector are cached
+ *               too.  Returns the index of the requested sector's entry.
+ *
+ ****************************************************************************/
+
+static int smart_dcache_fill(FAR struct smart_struct_s *dev,
+                             uint16_t logsector, uint16_t physsector)
+{
+  FAR struct smart_sect_header_s *header;
+  FAR uint8_t *sector;
+  uint16_t nsectors;
+  uint16_t rdlog;
+  int index;
+  int ret;
+  int x;
+
+  /* Don't read past the end of the erase block */
+
+  nsectors = dev->sectorsperblk - (physsector % dev->sectorsperblk);
+  if (nsectors > SMART_DCACHE_READAHEAD)
+    {
+      nsectors = SMART_DCACHE_READAHEAD;
+    }
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+  /* Without the full sector map, verifying the mapping of the following
+   * sectors could require a scan of the device.
+   */
+
+  nsectors = 1;
+#endif
+
+  ret = MTD_BREAD(dev->mtd, physsector * dev->mtdblkspersector,
+                  nsectors * dev->mtdblkspersector, dev->dcachebuf);
+  if (ret != nsectors * dev->mtdblkspersector)
+    {
+      ferr("ERROR: Error reading phys sector %d\n", physsector);
+      return -EIO;
+    }
+
+  ret = smart_dcache_validate(dev, dev->dcachebuf, logsector);
+  if (ret < 0)
+    {
+      ferr("ERROR: Error in logical sector %d, phys=%d\n",
+           logsector, physsector);
+      return -EIO;
+    }
+
+  index = smart_dcache_insert(dev, logsector, physsector, dev->dcachebuf);
+
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
+  for (x = 1; x < nsectors; x++)
+    {
+      sector = &dev->dcachebuf[x * dev->sectorsize];
+      header = (FAR struct smart_sect_header_s *)sector;
+      rdlog  = *(FAR uint16_t *)header->logicalsector;
+
+      /* Only cache sectors that are currently mapped, that are not already
+       * cached, and that are valid.
+       */
+
+      if (rdlog < dev->totalsectors &&
+          dev->smap[rdlog] == physsector + x &&
+          smart_dcache_find(dev, rdlog, physsector + x) < 0 &&
+          smart_dcache_validate(dev, sector, rdlog) == OK)
+        {
+          smart_dcache_insert(dev, rdlog, physsector + x, sector);
+          dev->dcachereadahead++;
+        }
+    }
+#else
+  UNUSED(header);
+  UNUSED(sector);
+  UNUSED(rdlog);
+  UNUSED(x);
+#endif
+
+  return index;
+}
+
+/****************************************************************************
+ * Name: smart_dcache_read
+ *
+ * Description:  Reads data from a logical sector through the data cache.
+ *
+ ****************************************************************************/
+
+static int smart_dcache_read(FAR struct smart_struct_s *dev,
+                             FAR struct smart_read_write_s *req,
+                             uint16_t physsector)
+{
+  int index;
+
+  index = smart_dcache_find(dev, req->logsector, physsector);
+  if (index >= 0)
+    {
+      dev->dcachehits++;
+    }
+  else
+    {
+      dev->dcachemisses++;
+
+      index = smart_dcache_fill(dev, req->logsector, physsector);
+      if (index < 0)
+        {
+          return index;
+        }
+    }
+
+  memcpy((FAR char *)req->buffer, &dev->dcachedata[index * dev->sectorsize +
+         sizeof(struct smart_sect_header_s) + req->offset], req->count);
+  return req->count;
+}
+#endif /* CONFIG_MTD_SMART_DATA_CACHE */
+
 /****************************************************************************
  * Name: smart_readsector
  *
@@ -4972,6 +5356,14 @@ static int smart_readsector(FAR struct smart_struct_s *dev,
       goto errout;
     }
 
+#ifdef CONFIG_MTD_SMART_DATA_CACHE
+  if (dev->dcache != NULL)
+    {
+      ret = smart_dcache_read(dev, req, physsector);
+      goto errout;
+    }
+#endif
+
 #ifdef CONFIG_MTD_SMART_ENABLE_CRC
 
   /* When CRC is enabled, we read the entire sector into RAM so we can
@@ -5342,6 +5734,10 @@ static inline int smart_freesector(FAR struct smart_struct_s *dev,
 
   if ((logicalsector > 2) && (logicalsector < dev->totalsectors))
     {
+#ifdef CONFIG_MTD_SMART_DATA_CACHE
+      smart_dcache_invalidate(dev, logicalsector);
+#endif
+
       /* Validate the sector is actually allocated */
 
 #ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
@@ -5540,14 +5936,37 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
       if (dev->wearflags & SMART_WEARFLAGS_WRITE_NEEDED)
         {
-          /* Write new wear status bits to the device */
+          /* Write new wear status bits to the device.  With batching,
+           * this is deferred until a number of sectors have been written
+           * (or until the device is flushed or closed).
+           */
 
-          smart_write_wearstatus(dev);
+#if CONFIG_MTD_SMART_WEAR_BATCH > 1
+          if (++dev->wearpending >= CONFIG_MTD_SMART_WEAR_BATCH)
+#endif
+            {
+              smart_write_wearstatus(dev);
+            }
         }
 #endif
 
       goto ok_out;
 
+#if defined(CONFIG_MTD_SMART_WEAR_LEVEL) && CONFIG_MTD_SMART_WEAR_BATCH > 1
+    case BIOC_FLUSH:
+
+      /* Write any deferred wear status updates, then pass the command on
+       * to the MTD driver.
+       */
+
+      if (dev->wearflags & SMART_WEARFLAGS_WRITE_NEEDED)
+        {
+          smart_write_wearstatus(dev);
+        }
+
+      break;
+#endif
+
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
     case BIOC_GETPROCFSD:
 
@@ -5582,6 +6001,11 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 #endif
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
       procfs_data->uneven_wearcount = dev->uneven_wearcount;
+#endif
+#ifdef CONFIG_MTD_SMART_DATA_CACHE
+      procfs_data->cachehits      = dev->dcachehits;
+      procfs_data->cachemisses    = dev->dcachemisses;
+      procfs_data->cachereadahead = dev->dcachereadahead;
 #endif
       ret = OK;
       goto ok_out;
@@ -6289,6 +6713,12 @@ errout:
   smart_free(dev, dev->scache);
 #endif
   smart_free(dev, dev->rwbuffer);
+#ifdef CONFIG_MTD_SMART_DATA_CACHE
+  if (dev->dcache != NULL)
+    {
+      smart_free(dev, dev->dcache);
+    }
+#endif
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
   smart_free(dev, dev->wearstatus);
 #endif
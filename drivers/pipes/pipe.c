@@ -41,6 +41,7 @@
 
 #include <sys/types.h>
 
+#include <stdint.h>
 #include <stdio.h>
 #include <unistd.h>
 #include <fcntl.h>
@@ -60,6 +61,12 @@
 
 #define MAX_PIPES 32
 
+/* The pipe number of an anonymous pipe created by file_pipe().  Anonymous
+ * pipes do not use one of the MAX_PIPES minor numbers.
+ */
+
+#define PIPE_ANONYMOUS UINT8_MAX
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -91,6 +98,7 @@ static const struct file_operations pipe_fops =
 static sem_t  g_pipesem       = SEM_INITIALIZER(1);
 static uint32_t g_pipeset     = 0;
 static uint32_t g_pipecreated = 0;
+static uint32_t g_pipeanon    = 0;
 
 /****************************************************************************
  * Private Functions
@@ -142,18 +150,22 @@ static int pipe_close(FAR struct file *filep)
 {
   FAR struct inode *inode    = filep->f_inode;
   FAR struct pipe_dev_s *dev = inode->i_private;
+  int pipeno;
   int ret;
 
   DEBUGASSERT(dev);
 
-  /* Perform common close operations */
+  /* Perform common close operations.  The device structure of an
+   * anonymous pipe is freed on the last close.
+   */
 
+  pipeno = dev->d_pipeno;
   ret = pipecommon_close(filep);
-  if (ret == 0 && inode->i_crefs == 1)
+  if (ret == 0 && inode->i_crefs == 1 && pipeno != PIPE_ANONYMOUS)
     {
       /* Release the pipe when there are no further open references to it. */
 
-      pipe_free(dev->d_pipeno);
+      pipe_free(pipeno);
     }
 
   return ret;
@@ -290,4 +302,92 @@ errout:
   return ERROR;
 }
 
+/****************************************************************************
+ * Name: file_pipe
+ *
+ * Description:
+ *   Create an anonymous pipe and open it on a pair of detached file
+ *   structures.  filep[0] is opened for reading, filep[1] for writing.
+ *
+ *   Unlike pipe2(), no file descriptors are allocated and the pipe does not
+ *   remain in the pseudo-file system namespace:  The device is unlinked as
+ *   soon as both ends are open and is freed when both are closed.  This is
+ *   intended for use within the OS, for example to connect a pair of local
+ *   sockets.
+ *
+ * Input Parameters:
+ *   filep   - The file structures to open.  These must be zeroed.
+ *   bufsize - The size of the in-memory, circular buffer in bytes.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+int file_pipe(FAR struct file *filep[2], size_t bufsize)
+{
+  FAR struct pipe_dev_s *dev;
+  char devname[20];
+  int ret;
+
+  /* Allocate and initialize a new device structure instance */
+
+  dev = pipecommon_allocdev(bufsize);
+  if (dev == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  dev->d_pipeno = PIPE_ANONYMOUS;
+
+  /* Register the device under a temporary, unique name */
+
+  ret = nxsem_wait(&g_pipesem);
+  if (ret < 0)
+    {
+      pipecommon_freedev(dev);
+      return ret;
+    }
+
+  snprintf(devname, sizeof(devname), "/dev/pipea%lx",
+           (unsigned long)g_pipeanon++);
+
+  ret = register_driver(devname, &pipe_fops, 0666, (FAR void *)dev);
+  if (ret < 0)
+    {
+      nxsem_post(&g_pipesem);
+      pipecommon_freedev(dev);
+      return ret;
+    }
+
+  /* Open the write side first so that opening the read side cannot
+   * block.
+   */
+
+  ret = file_open(filep[1], devname, O_WRONLY);
+  if (ret >= 0)
+    {
+      ret = file_open(filep[0], devname, O_RDONLY);
+      if (ret < 0)
+        {
+          file_close(filep[1]);
+        }
+    }
+
+  /* Remove the name.  The device will be freed when the last reference to
+   * it is closed or, if the open failed, right now.
+   */
+
+  PIPE_UNLINK(dev->d_flags);
+  unregister_driver(devname);
+  if (ret < 0)
+    {
+      pipecommon_freedev(dev);
+    }
+
+  nxsem_post(&g_pipesem);
+  return ret < 0 ? ret : OK;
+}
+
 #endif /* CONFIG_DEV_PIPE_SIZE > 0 */
@@ -114,6 +114,304 @@ static void pipecommon_pollnotify(FAR struct pipe_dev_s *dev,
     }
 }
 
+/****************************************************************************
+ * Name: pipecommon_nbytes
+ *
+ * Description:
+ *   Return the number of bytes in the buffer.
+ *
+ ****************************************************************************/
+
+static inline size_t pipecommon_nbytes(FAR struct pipe_dev_s *dev)
+{
+  if (dev->d_wrndx < dev->d_rdndx)
+    {
+      return (dev->d_bufsize - dev->d_rdndx) + dev->d_wrndx;
+    }
+
+  return dev->d_wrndx - dev->d_rdndx;
+}
+
+/****************************************************************************
+ * Name: pipecommon_nspace
+ *
+ * Description:
+ *   Return the number of bytes that can be added to the buffer.  One byte
+ *   is always left unused so that a full buffer can be distinguished from
+ *   an empty one.
+ *
+ ****************************************************************************/
+
+static inline size_t pipecommon_nspace(FAR struct pipe_dev_s *dev)
+{
+  return dev->d_bufsize - 1 - pipecommon_nbytes(dev);
+}
+
+/****************************************************************************
+ * Name: pipecommon_rdcontig / pipecommon_wrcontig
+ *
+ * Description:
+ *   Return the number of bytes that can be removed from (or added to) the
+ *   buffer without wrapping around the end of the buffer.
+ *
+ ****************************************************************************/
+
+static inline size_t pipecommon_rdcontig(FAR struct pipe_dev_s *dev)
+{
+  if (dev->d_wrndx < dev->d_rdndx)
+    {
+      return dev->d_bufsize - dev->d_rdndx;
+    }
+
+  return dev->d_wrndx - dev->d_rdndx;
+}
+
+static inline size_t pipecommon_wrcontig(FAR struct pipe_dev_s *dev)
+{
+  size_t nspace = pipecommon_nspace(dev);
+  size_t ncontig = dev->d_bufsize - dev->d_wrndx;
+
+  return ncontig < nspace ? ncontig : nspace;
+}
+
+/****************************************************************************
+ * Name: pipecommon_rdadvance / pipecommon_wradvance
+ *
+ * Description:
+ *   Advance the read (or write) index after data has been removed from (or
+ *   added to) the buffer.
+ *
+ ****************************************************************************/
+
+static inline void pipecommon_rdadvance(FAR struct pipe_dev_s *dev,
+                                        size_t nbytes)
+{
+  size_t ndx = dev->d_rdndx + nbytes;
+
+  dev->d_rdndx = ndx >= dev->d_bufsize ? ndx - dev->d_bufsize : ndx;
+}
+
+static inline void pipecommon_wradvance(FAR struct pipe_dev_s *dev,
+                                        size_t nbytes)
+{
+  size_t ndx = dev->d_wrndx + nbytes;
+
+  dev->d_wrndx = ndx >= dev->d_bufsize ? ndx - dev->d_bufsize : ndx;
+}
+
+/****************************************************************************
+ * Name: pipecommon_copyout
+ *
+ * Description:
+ *   Remove up to 'len' bytes from the buffer.  At most two copies are
+ *   needed:  One up to the end of the buffer and one from the beginning.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_copyout(FAR struct pipe_dev_s *dev,
+                                 FAR uint8_t *buffer, size_t len)
+{
+  size_t nread = 0;
+  size_t ncopy;
+
+  while (nread < len && (ncopy = pipecommon_rdcontig(dev)) > 0)
+    {
+      if (ncopy > len - nread)
+        {
+          ncopy = len - nread;
+        }
+
+      memcpy(&buffer[nread], &dev->d_buffer[dev->d_rdndx], ncopy);
+      pipecommon_rdadvance(dev, ncopy);
+      nread += ncopy;
+    }
+
+  return nread;
+}
+
+/****************************************************************************
+ * Name: pipecommon_copyin
+ *
+ * Description:
+ *   Add up to 'len' bytes to the buffer.  At most two copies are needed.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_copyin(FAR struct pipe_dev_s *dev,
+                                FAR const uint8_t *buffer, size_t len)
+{
+  size_t nwritten = 0;
+  size_t ncopy;
+
+  while (nwritten < len && (ncopy = pipecommon_wrcontig(dev)) > 0)
+    {
+      if (ncopy > len - nwritten)
+        {
+          ncopy = len - nwritten;
+        }
+
+      memcpy(&dev->d_buffer[dev->d_wrndx], &buffer[nwritten], ncopy);
+      pipecommon_wradvance(dev, ncopy);
+      nwritten += ncopy;
+    }
+
+  return nwritten;
+}
+
+/****************************************************************************
+ * Name: pipecommon_wakeall
+ *
+ * Description:
+ *   Wake all threads waiting on d_rdsem or d_wrsem.
+ *
+ ****************************************************************************/
+
+static void pipecommon_wakeall(FAR sem_t *sem)
+{
+  int sval;
+
+  while (nxsem_getvalue(sem, &sval) == 0 && sval < 0)
+    {
+      nxsem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_wakereaders / pipecommon_wakewriters
+ *
+ * Description:
+ *   Notify all waiting readers that data has been added to the buffer (or
+ *   all waiting writers that data has been removed).
+ *
+ ****************************************************************************/
+
+static void pipecommon_wakereaders(FAR struct pipe_dev_s *dev)
+{
+  pipecommon_wakeall(&dev->d_rdsem);
+
+  /* Notify all poll/select waiters that they can read from the FIFO */
+
+  pipecommon_pollnotify(dev, POLLIN);
+}
+
+static void pipecommon_wakewriters(FAR struct pipe_dev_s *dev)
+{
+  pipecommon_wakeall(&dev->d_wrsem);
+
+  /* Notify all poll/select waiters that they can write to the FIFO */
+
+  pipecommon_pollnotify(dev, POLLOUT);
+}
+
+/****************************************************************************
+ * Name: pipecommon_waitdata
+ *
+ * Description:
+ *   Wait until there is data in the buffer and no splice() is draining
+ *   it.  The caller holds d_bfsem.
+ *
+ * Returned Value:
+ *   The number of bytes in the buffer (with d_bfsem still held), zero on
+ *   end-of-file, or a negated errno value.  d_bfsem has been released in
+ *   the latter two cases.
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_waitdata(FAR struct pipe_dev_s *dev, bool nonblock)
+{
+  int ret;
+
+  /* If the pipe is empty, then wait for something to be written to it */
+
+  while (dev->d_wrndx == dev->d_rdndx ||
+         (dev->d_flags & PIPE_FLAG_SPLICEOUT) != 0)
+    {
+      /* If O_NONBLOCK was set, then return EGAIN */
+
+      if (nonblock)
+        {
+          nxsem_post(&dev->d_bfsem);
+          return -EAGAIN;
+        }
+
+      /* If there are no writers on the pipe, then return end of file */
+
+      if (dev->d_wrndx == dev->d_rdndx && dev->d_nwriters <= 0)
+        {
+          nxsem_post(&dev->d_bfsem);
+          return 0;
+        }
+
+      /* Otherwise, wait for something to be written to the pipe */
+
+      sched_lock();
+      nxsem_post(&dev->d_bfsem);
+      ret = nxsem_wait(&dev->d_rdsem);
+      sched_unlock();
+
+      if (ret < 0 || (ret = nxsem_wait(&dev->d_bfsem)) < 0)
+        {
+          /* May fail because a signal was received or if the task was
+           * canceled.
+           */
+
+          return ret;
+        }
+    }
+
+  return pipecommon_nbytes(dev);
+}
+
+/****************************************************************************
+ * Name: pipecommon_waitspace
+ *
+ * Description:
+ *   Wait until there is space in the buffer and no splice() is filling
+ *   it.  The caller holds d_bfsem.
+ *
+ * Returned Value:
+ *   The number of bytes that can be added to the buffer (with d_bfsem
+ *   still held) or a negated errno value (with d_bfsem released).
+ *
+ ****************************************************************************/
+
+static ssize_t pipecommon_waitspace(FAR struct pipe_dev_s *dev,
+                                    bool nonblock)
+{
+  size_t nspace;
+  int ret;
+
+  while ((nspace = pipecommon_nspace(dev)) == 0 ||
+         (dev->d_flags & PIPE_FLAG_SPLICEIN) != 0)
+    {
+      /* If O_NONBLOCK was set, then return EGAIN */
+
+      if (nonblock)
+        {
+          nxsem_post(&dev->d_bfsem);
+          return -EAGAIN;
+        }
+
+      /* Wait for data to be removed from the pipe */
+
+      sched_lock();
+      nxsem_post(&dev->d_bfsem);
+      ret = nxsem_wait(&dev->d_wrsem);
+      sched_unlock();
+
+      if (ret < 0 || (ret = nxsem_wait(&dev->d_bfsem)) < 0)
+        {
+          /* Either call nxsem_wait may fail because a signal was
+           * received or if the task was canceled.
+           */
+
+          return ret;
+        }
+    }
+
+  return nspace;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -367,9 +665,10 @@ int pipecommon_close(FAR struct file *filep)
       dev->d_nwriters = 0;
       dev->d_nreaders = 0;
 
-#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
       /* If, in addition, we have been unlinked, then also need to free the
-       * device structure as well to prevent a memory leak.
+       * device structure as well to prevent a memory leak.  With
+       * CONFIG_DISABLE_PSEUDOFS_OPERATIONS, only the anonymous pipes of
+       * file_pipe() are unlinked.
        */
 
       if (PIPE_IS_UNLINKED(dev->d_flags))
@@ -377,7 +676,6 @@ int pipecommon_close(FAR struct file *filep)
           pipecommon_freedev(dev);
           return OK;
         }
-#endif
     }
 
   nxsem_post(&dev->d_bfsem);
@@ -392,11 +690,7 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 {
   FAR struct inode      *inode  = filep->f_inode;
   FAR struct pipe_dev_s *dev    = inode->i_private;
-#ifdef CONFIG_DEV_PIPEDUMP
-  FAR uint8_t           *start  = (FAR uint8_t *)buffer;
-#endif
-  ssize_t                nread  = 0;
-  int                    sval;
+  ssize_t                nread;
   int                    ret;
 
   DEBUGASSERT(dev);
@@ -420,68 +714,26 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
   /* If the pipe is empty, then wait for something to be written to it */
 
-  while (dev->d_wrndx == dev->d_rdndx)
-    {
-      /* If O_NONBLOCK was set, then return EGAIN */
-
-      if (filep->f_oflags & O_NONBLOCK)
-        {
-          nxsem_post(&dev->d_bfsem);
-          return -EAGAIN;
-        }
-
-      /* If there are no writers on the pipe, then return end of file */
-
-      if (dev->d_nwriters <= 0)
-        {
-          nxsem_post(&dev->d_bfsem);
-          return 0;
-        }
-
-      /* Otherwise, wait for something to be written to the pipe */
-
-      sched_lock();
-      nxsem_post(&dev->d_bfsem);
-      ret = nxsem_wait(&dev->d_rdsem);
-      sched_unlock();
-
-      if (ret < 0 || (ret = nxsem_wait(&dev->d_bfsem)) < 0)
-        {
-          /* May fail because a signal was received or if the task was
-           * canceled.
-           */
-
-          return ret;
-        }
-    }
-
-  /* Then return whatever is available in the pipe (which is at least one byte) */
-
-  nread = 0;
-  while ((size_t)nread < len && dev->d_wrndx != dev->d_rdndx)
+  nread = pipecommon_waitdata(dev, (filep->f_oflags & O_NONBLOCK) != 0);
+  if (nread <= 0)
     {
-      *buffer++ = dev->d_buffer[dev->d_rdndx];
-      if (++dev->d_rdndx >= dev->d_bufsize)
-        {
-          dev->d_rdndx = 0;
-        }
-
-      nread++;
+      return nread;
     }
 
-  /* Notify all waiting writers that bytes have been removed from the buffer */
+  /* Then return whatever is available in the pipe (which is at least one
+   * byte).
+   */
 
-  while (nxsem_getvalue(&dev->d_wrsem, &sval) == 0 && sval < 0)
-    {
-      nxsem_post(&dev->d_wrsem);
-    }
+  nread = pipecommon_copyout(dev, (FAR uint8_t *)buffer, len);
 
-  /* Notify all poll/select waiters that they can write to the FIFO */
+  /* Notify all waiting writers that bytes have been removed from the
+   * buffer.
+   */
 
-  pipecommon_pollnotify(dev, POLLOUT);
+  pipecommon_wakewriters(dev);
 
   nxsem_post(&dev->d_bfsem);
-  pipe_dumpbuffer("From PIPE:", start, nread);
+  pipe_dumpbuffer("From PIPE:", (FAR uint8_t *)buffer, nread);
   return nread;
 }
 
@@ -495,9 +747,7 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct inode      *inode    = filep->f_inode;
   FAR struct pipe_dev_s *dev      = inode->i_private;
   ssize_t                nwritten = 0;
-  ssize_t                last;
-  int                    nxtwrndx;
-  int                    sval;
+  ssize_t                nspace;
   int                    ret;
 
   DEBUGASSERT(dev);
@@ -550,100 +800,222 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
 
   /* Loop until all of the bytes have been written */
 
-  last = 0;
-  for (; ; )
+  while ((size_t)nwritten < len)
     {
-      /* Calculate the write index AFTER the next byte is written */
+      /* Wait for space in the buffer.  If O_NONBLOCK was set, then return
+       * partial bytes written or EGAIN.
+       */
 
-      nxtwrndx = dev->d_wrndx + 1;
-      if (nxtwrndx >= dev->d_bufsize)
+      nspace = pipecommon_waitspace(dev,
+                                    (filep->f_oflags & O_NONBLOCK) != 0);
+      if (nspace < 0)
         {
-          nxtwrndx = 0;
+          return nwritten == 0 ? nspace : nwritten;
         }
 
-      /* Would the next write overflow the circular buffer? */
+      /* Copy as much as will fit and notify all of the waiting readers
+       * that more data is available.
+       */
+
+      nwritten += pipecommon_copyin(dev,
+                                    (FAR const uint8_t *)&buffer[nwritten],
+                                    len - nwritten);
+      pipecommon_wakereaders(dev);
+    }
+
+  /* Return the number of bytes written */
+
+  nxsem_post(&dev->d_bfsem);
+  return len;
+}
+
+/****************************************************************************
+ * Name: pipecommon_splice
+ *
+ * Description:
+ *   Move data between a pipe and another file or socket without copying it
+ *   through a user buffer.  The data is read from (or written to) the other
+ *   file directly into (or from) the pipe's buffer.
+ *
+ * Input Parameters:
+ *   filep    - The pipe
+ *   fd       - The other file or socket descriptor
+ *   offset   - The file offset to use for the other file.  NULL means to
+ *              use and update its file position.
+ *   len      - The maximum number of bytes to move
+ *   nonblock - Don't wait for data (or space) in the pipe
+ *   topipe   - True: move data from 'fd' into the pipe.  False: move data
+ *              from the pipe to 'fd'.
+ *
+ * Returned Value:
+ *   The number of bytes moved, zero on end-of-file, or a negated errno
+ *   value.
+ *
+ ****************************************************************************/
+
+ssize_t pipecommon_splice(FAR struct file *filep, int fd,
+                          FAR off_t *offset, size_t len, bool nonblock,
+                          bool topipe)
+{
+  FAR struct inode      *inode  = filep->f_inode;
+  FAR struct pipe_dev_s *dev    = inode->i_private;
+  FAR struct file       *other  = NULL;
+  FAR uint8_t           *buffer;
+  ssize_t                nmoved = 0;
+  ssize_t                avail;
+  ssize_t                nxfr;
+  size_t                 ncontig;
+  uint8_t                flag;
+  int                    ret;
+
+  DEBUGASSERT(dev);
 
-      if (nxtwrndx != dev->d_rdndx)
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  if (offset != NULL)
+    {
+      ret = fs_getfilep(fd, &other);
+      if (ret < 0)
         {
-          /* No... copy the byte */
+          return ret;
+        }
+    }
 
-          dev->d_buffer[dev->d_wrndx] = *buffer++;
-          dev->d_wrndx = nxtwrndx;
+  if (topipe && dev->d_nreaders <= 0)
+    {
+      return -EPIPE;
+    }
 
-          /* Is the write complete? */
+  ret = nxsem_wait(&dev->d_bfsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
 
-          nwritten++;
-          if ((size_t)nwritten >= len)
-            {
-              /* Yes.. Notify all of the waiting readers that more data is available */
+  /* Wait for data (or space) in the pipe */
 
-              while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
-                {
-                  nxsem_post(&dev->d_rdsem);
-                }
+  avail = topipe ? pipecommon_waitspace(dev, nonblock) :
+                   pipecommon_waitdata(dev, nonblock);
+  if (avail <= 0)
+    {
+      return avail;
+    }
+
+  if ((size_t)avail < len)
+    {
+      len = avail;
+    }
 
-              /* Notify all poll/select waiters that they can read from the FIFO */
+  /* The transfer from (or to) the other file may block, so the pipe is
+   * not held while it is in progress.  Instead, the space at the write
+   * index (or the data at the read index) is reserved:  Other writers (or
+   * readers) wait until the splice completes, but the other end of the
+   * pipe may continue.  Neither index is moved by anyone else meanwhile.
+   */
 
-              pipecommon_pollnotify(dev, POLLIN);
+  flag = topipe ? PIPE_FLAG_SPLICEIN : PIPE_FLAG_SPLICEOUT;
+  dev->d_flags |= flag;
 
-              /* Return the number of bytes written */
+  /* Move the data in at most two pieces, stopping early on a short
+   * transfer.
+   */
 
-              nxsem_post(&dev->d_bfsem);
-              return len;
-            }
+  while ((size_t)nmoved < len)
+    {
+      if (topipe)
+        {
+          ncontig = pipecommon_wrcontig(dev);
+          buffer  = &dev->d_buffer[dev->d_wrndx];
         }
       else
         {
-          /* There is not enough room for the next byte.  Was anything written in this pass? */
+          ncontig = pipecommon_rdcontig(dev);
+          buffer  = &dev->d_buffer[dev->d_rdndx];
+        }
 
-          if (last < nwritten)
-            {
-              /* Yes.. Notify all of the waiting readers that more data is available */
+      if (ncontig > len - nmoved)
+        {
+          ncontig = len - nmoved;
+        }
 
-              while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
-                {
-                  nxsem_post(&dev->d_rdsem);
-                }
+      nxsem_post(&dev->d_bfsem);
 
-              /* Notify all poll/select waiters that they can read from the FIFO */
+      if (topipe)
+        {
+          nxfr = other != NULL ?
+            file_pread(other, buffer, ncontig, *offset + nmoved) :
+            nx_read(fd, buffer, ncontig);
+        }
+      else
+        {
+          nxfr = other != NULL ?
+            file_pwrite(other, buffer, ncontig, *offset + nmoved) :
+            nx_write(fd, buffer, ncontig);
+        }
 
-              pipecommon_pollnotify(dev, POLLIN);
-            }
+      pipecommon_semtake(&dev->d_bfsem);
 
-          last = nwritten;
+      if (nxfr < 0)
+        {
+          if (nmoved == 0)
+            {
+              nmoved = nxfr;
+            }
 
-          /* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
+          break;
+        }
 
-          if (filep->f_oflags & O_NONBLOCK)
-            {
-              if (nwritten == 0)
-                {
-                  nwritten = -EAGAIN;
-                }
+      if (topipe)
+        {
+          pipecommon_wradvance(dev, nxfr);
+        }
+      else
+        {
+          pipecommon_rdadvance(dev, nxfr);
+        }
 
-              nxsem_post(&dev->d_bfsem);
-              return nwritten;
-            }
+      nmoved += nxfr;
+      if ((size_t)nxfr < ncontig)
+        {
+          break;
+        }
+    }
 
-          /* There is more to be written.. wait for data to be removed fro
-           * the pipe
-           */
+  dev->d_flags &= ~flag;
 
-          sched_lock();
-          nxsem_post(&dev->d_bfsem);
-          ret = nxsem_wait(&dev->d_wrsem);
-          sched_unlock();
+  /* Wake the other end if anything was moved, and the writers (or
+   * readers) that waited for the reservation to be released.
+   */
 
-          if (ret < 0 || (ret = nxsem_wait(&dev->d_bfsem)) < 0)
-            {
-              /* Either call nxsem_wait may fail because a signal was
-               * received or if the task was canceled.
-               */
+  if (topipe)
+    {
+      if (nmoved > 0)
+        {
+          pipecommon_wakereaders(dev);
+        }
 
-              return nwritten == 0 ? (ssize_t)ret : nwritten;
-            }
+      pipecommon_wakeall(&dev->d_wrsem);
+    }
+  else
+    {
+      if (nmoved > 0)
+        {
+          pipecommon_wakewriters(dev);
         }
+
+      pipecommon_wakeall(&dev->d_rdsem);
     }
+
+  if (nmoved > 0 && offset != NULL)
+    {
+      *offset += nmoved;
+    }
+
+  nxsem_post(&dev->d_bfsem);
+  return nmoved;
 }
 
 /****************************************************************************
@@ -842,6 +1214,67 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         }
         break;
 
+      /* Set the size of the buffer */
+
+      case PIPEIOC_SETSIZE:
+        {
+          FAR uint8_t *buffer;
+          size_t nbytes;
+
+          /* The new buffer must hold all of the data that is already in
+           * the buffer.
+           */
+
+          nbytes = dev->d_buffer != NULL ? pipecommon_nbytes(dev) : 0;
+          if (arg < 2 || arg > CONFIG_DEV_PIPE_MAXSIZE)
+            {
+              ret = -EINVAL;
+            }
+          else if (nbytes >= arg || (dev->d_flags & PIPE_FLAG_SPLICE) != 0)
+            {
+              ret = -EBUSY;
+            }
+          else if (dev->d_buffer == NULL)
+            {
+              dev->d_bufsize = arg;
+              ret = OK;
+            }
+          else
+            {
+              buffer = (FAR uint8_t *)kmm_malloc(arg);
+              if (buffer == NULL)
+                {
+                  ret = -ENOMEM;
+                  break;
+                }
+
+              /* Move the data to the beginning of the new buffer */
+
+              pipecommon_copyout(dev, buffer, nbytes);
+              kmm_free(dev->d_buffer);
+
+              dev->d_buffer  = buffer;
+              dev->d_bufsize = arg;
+              dev->d_rdndx   = 0;
+              dev->d_wrndx   = nbytes;
+
+              /* There may be more space for the writers */
+
+              pipecommon_wakewriters(dev);
+              ret = OK;
+            }
+        }
+        break;
+
+      /* Get the size of the buffer */
+
+      case PIPEIOC_GETSIZE:
+        {
+          *(FAR int *)((uintptr_t)arg) = dev->d_bufsize;
+          ret = OK;
+        }
+        break;
+
       /* Free space in buffer */
 
       case FIONSPACE:
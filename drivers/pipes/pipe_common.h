@@ -98,6 +98,9 @@
 
 #define PIPE_FLAG_POLICY    (1 << 0) /* Bit 0: Policy=Free buffer when empty */
 #define PIPE_FLAG_UNLINKED  (1 << 1) /* Bit 1: The driver has been unlinked */
+#define PIPE_FLAG_SPLICEIN  (1 << 2) /* Bit 2: splice() is filling free space */
+#define PIPE_FLAG_SPLICEOUT (1 << 3) /* Bit 3: splice() is draining data */
+#define PIPE_FLAG_SPLICE    (PIPE_FLAG_SPLICEIN | PIPE_FLAG_SPLICEOUT)
 
 #define PIPE_POLICY_0(f)    do { (f) &= ~PIPE_FLAG_POLICY; } while (0)
 #define PIPE_POLICY_1(f)    do { (f) |= PIPE_FLAG_POLICY; } while (0)
@@ -171,6 +174,9 @@ int     pipecommon_close(FAR struct file *filep);
 ssize_t pipecommon_read(FAR struct file *, FAR char *, size_t);
 ssize_t pipecommon_write(FAR struct file *, FAR const char *, size_t);
 int     pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg);
+ssize_t pipecommon_splice(FAR struct file *filep, int fd,
+                          FAR off_t *offset, size_t len, bool nonblock,
+                          bool topipe);
 int     pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
                                bool setup);
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
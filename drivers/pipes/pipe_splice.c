@@ -0,0 +1,191 @@
+/****************************************************************************
+ * drivers/pipes/pipe_splice.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <errno.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "pipe_common.h"
+
+#ifdef CONFIG_PIPES
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: splice_getpipe
+ *
+ * Description:
+ *   Return the file structure for 'fd' if it refers to a pipe or FIFO.
+ *
+ ****************************************************************************/
+
+static FAR struct file *splice_getpipe(int fd)
+{
+  FAR struct file *filep;
+
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS ||
+      fs_getfilep(fd, &filep) < 0 || filep->f_inode == NULL)
+    {
+      return NULL;
+    }
+
+  /* Pipes and FIFOs are the only drivers that use these methods */
+
+  if (INODE_IS_DRIVER(filep->f_inode) &&
+      filep->f_inode->u.i_ops->read == pipecommon_read)
+    {
+      return filep;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: splice
+ *
+ * Description:
+ *   Move up to 'len' bytes between two file descriptors, at least one of
+ *   which must refer to a pipe or FIFO.  The data is transferred directly
+ *   between the pipe buffer and the other file (or socket), without first
+ *   copying it into a user buffer.
+ *
+ *   vmsplice() is not provided:  In a flat address space it would be
+ *   equivalent to write().
+ *
+ * Input Parameters:
+ *   fd_in   - The file descriptor to read from
+ *   off_in  - If fd_in is not a pipe:  The file offset to read from, or
+ *             NULL to read from the current file position.  Must be NULL
+ *             if fd_in is a pipe.
+ *   fd_out  - The file descriptor to write to
+ *   off_out - As off_in, but for fd_out
+ *   len     - The maximum number of bytes to move
+ *   flags   - SPLICE_F_NONBLOCK to not block on the pipe.  SPLICE_F_MOVE
+ *             and SPLICE_F_MORE are accepted but ignored.
+ *
+ * Returned Value:
+ *   The number of bytes moved, zero on end of input, or -1 with errno set
+ *   on failure:
+ *
+ *     EBADF  - A file descriptor is not valid or not open for the required
+ *              access
+ *     EINVAL - Neither descriptor refers to a pipe, both refer to the same
+ *              pipe, or 'flags' is invalid
+ *     ESPIPE - An offset was given for a pipe
+ *     EAGAIN - SPLICE_F_NONBLOCK was given and the pipe is empty (or full)
+ *
+ ****************************************************************************/
+
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out,
+               FAR off_t *off_out, size_t len, unsigned int flags)
+{
+  FAR struct file *pipein;
+  FAR struct file *pipeout;
+  ssize_t ret;
+  bool nonblock;
+
+  if ((flags & ~(SPLICE_F_MOVE | SPLICE_F_NONBLOCK | SPLICE_F_MORE)) != 0)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  pipein  = splice_getpipe(fd_in);
+  pipeout = splice_getpipe(fd_out);
+
+  if (pipein == NULL && pipeout == NULL)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  if ((pipein != NULL && off_in != NULL) ||
+      (pipeout != NULL && off_out != NULL))
+    {
+      ret = -ESPIPE;
+      goto errout;
+    }
+
+  if (pipein != NULL && pipeout != NULL &&
+      pipein->f_inode == pipeout->f_inode)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  /* Data is moved through the buffer of one pipe.  When both ends are
+   * pipes, the data is read from the first one and written to the second.
+   */
+
+  if (pipein != NULL)
+    {
+      if ((pipein->f_oflags & O_RDOK) == 0)
+        {
+          ret = -EBADF;
+          goto errout;
+        }
+
+      nonblock = (flags & SPLICE_F_NONBLOCK) != 0 ||
+                 (pipein->f_oflags & O_NONBLOCK) != 0;
+      ret = pipecommon_splice(pipein, fd_out, off_out, len, nonblock,
+                              false);
+    }
+  else
+    {
+      if ((pipeout->f_oflags & O_WROK) == 0)
+        {
+          ret = -EBADF;
+          goto errout;
+        }
+
+      nonblock = (flags & SPLICE_F_NONBLOCK) != 0 ||
+                 (pipeout->f_oflags & O_NONBLOCK) != 0;
+      ret = pipecommon_splice(pipeout, fd_in, off_in, len, nonblock,
+                              true);
+    }
+
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+  set_errno(-ret);
+  return ERROR;
+}
+
+#endif /* CONFIG_PIPES */
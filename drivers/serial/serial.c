@@ -82,6 +82,10 @@ static void    uart_pollnotify(FAR uart_dev_t *dev, pollevent_t eventset);
 /* Write support */
 
 static int     uart_putxmitchar(FAR uart_dev_t *dev, int ch, bool oktoblock);
+static ssize_t uart_putxmitbuf(FAR uart_dev_t *dev, FAR const char *buffer,
+                               size_t buflen, bool oktoblock);
+static size_t  uart_rawlen(FAR uart_dev_t *dev, FAR const char *buffer,
+                           size_t buflen);
 static inline ssize_t uart_irqwrite(FAR uart_dev_t *dev, FAR const char *buffer,
                                     size_t buflen);
 static int     uart_tcdrain(FAR uart_dev_t *dev, clock_t timeout);
@@ -338,6 +342,145 @@ err_out:
   return ret;
 }
 
+/************************************************************************************
+ * Name: uart_putxmitbuf
+ *
+ * Description:
+ *   Copy a block of characters into the TX buffer.  The characters are copied
+ *   with memcpy() in at most two contiguous chunks each time that there is
+ *   space in the TX buffer.
+ *
+ * Returned Value:
+ *   The number of characters added to the TX buffer.  If no characters could
+ *   be added, a negated errno value is returned as by uart_putxmitchar().
+ *
+ ************************************************************************************/
+
+static ssize_t uart_putxmitbuf(FAR uart_dev_t *dev, FAR const char *buffer,
+                               size_t buflen, bool oktoblock)
+{
+  FAR struct uart_buffer_s *txbuf = &dev->xmit;
+  size_t nwritten = 0;
+  size_t nspace;
+  int16_t head;
+  int16_t tail;
+  int ret = OK;
+
+#ifdef CONFIG_SMP
+  irqstate_t flags = enter_critical_section();
+#endif
+
+  while (nwritten < buflen)
+    {
+      /* How much contiguous space is there at the head of the TX buffer?
+       * One slot is always left empty to distinguish full from empty.
+       */
+
+      head = txbuf->head;
+      tail = txbuf->tail;
+
+      if (tail > head)
+        {
+          nspace = tail - head - 1;
+        }
+      else
+        {
+          nspace = txbuf->size - head - (tail == 0 ? 1 : 0);
+        }
+
+      if (nspace == 0)
+        {
+          /* The TX buffer is full.  Let uart_putxmitchar() wait for space
+           * (or fail) and add the next character.
+           */
+
+          ret = uart_putxmitchar(dev, buffer[nwritten], oktoblock);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          nwritten++;
+          continue;
+        }
+
+      if (nspace > buflen - nwritten)
+        {
+          nspace = buflen - nwritten;
+        }
+
+      memcpy(&txbuf->buffer[head], &buffer[nwritten], nspace);
+
+      /* Update the head index only after the data is in place */
+
+      head += nspace;
+      if (head >= txbuf->size)
+        {
+          head = 0;
+        }
+
+      txbuf->head = head;
+      nwritten   += nspace;
+    }
+
+#ifdef CONFIG_SMP
+  leave_critical_section(flags);
+#endif
+
+  return nwritten > 0 ? (ssize_t)nwritten : ret;
+}
+
+/************************************************************************************
+ * Name: uart_rawlen
+ *
+ * Description:
+ *   Return the number of characters at the beginning of 'buffer' that can be
+ *   written without any output post-processing.
+ *
+ ************************************************************************************/
+
+static size_t uart_rawlen(FAR uart_dev_t *dev, FAR const char *buffer,
+                          size_t buflen)
+{
+  size_t i;
+
+#ifdef CONFIG_SERIAL_TERMIOS
+  bool crmap = false;
+  bool nlmap = false;
+
+  if ((dev->tc_oflag & OPOST) != 0)
+    {
+      crmap = (dev->tc_oflag & OCRNL) != 0;
+      nlmap = (dev->tc_oflag & (ONLCR | ONLRET)) != 0;
+    }
+
+  if (!crmap && !nlmap)
+    {
+      return buflen;
+    }
+
+  for (i = 0; i < buflen; i++)
+    {
+      if ((crmap && buffer[i] == '\r') || (nlmap && buffer[i] == '\n'))
+        {
+          break;
+        }
+    }
+
+#else
+  if (!dev->isconsole)
+    {
+      return buflen;
+    }
+
+  for (i = 0; i < buflen && buffer[i] != '\n'; i++)
+    {
+    }
+#endif
+
+  return i;
+}
+
 /************************************************************************************
  * Name: uart_putc
  ************************************************************************************/
@@ -711,8 +854,12 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 #endif
   irqstate_t flags;
   ssize_t recvd = 0;
+  size_t nbytes;
+  int16_t head;
   int16_t tail;
+#ifdef CONFIG_SERIAL_TERMIOS
   char ch;
+#endif
   int ret;
 
   /* Only one user can access rxbuf->tail at a time */
@@ -763,29 +910,30 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
        */
 
       tail = rxbuf->tail;
-      if (rxbuf->head != tail)
+      head = rxbuf->head;
+      if (head != tail)
         {
-          /* Take the next character from the tail of the buffer */
+#ifdef CONFIG_SERIAL_TERMIOS
+          /* Do input processing if any is enabled */
 
-          ch = rxbuf->buffer[tail];
+          if (dev->tc_iflag & (INLCR | IGNCR | ICRNL))
+            {
+              /* Take the next character from the tail of the buffer */
 
-          /* Increment the tail index.  Most operations are done using the
-           * local variable 'tail' so that the final rxbuf->tail update
-           * is atomic.
-           */
+              ch = rxbuf->buffer[tail];
 
-          if (++tail >= rxbuf->size)
-            {
-              tail = 0;
-            }
+              /* Increment the tail index.  Most operations are done using
+               * the local variable 'tail' so that the final rxbuf->tail
+               * update is atomic.
+               */
 
-          rxbuf->tail = tail;
+              if (++tail >= rxbuf->size)
+                {
+                  tail = 0;
+                }
 
-#ifdef CONFIG_SERIAL_TERMIOS
-          /* Do input processing if any is enabled */
+              rxbuf->tail = tail;
 
-          if (dev->tc_iflag & (INLCR | IGNCR | ICRNL))
-            {
               /* \n -> \r or \r -> \n translation? */
 
               if ((ch == '\n') && (dev->tc_iflag & INLCR))
@@ -803,22 +951,50 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
                 {
                   continue;
                 }
+
+              /* Specifically not handled:
+               *
+               * All of the local modes; echo, line editing, etc.
+               * Anything to do with break or parity errors.
+               * ISTRIP - we should be 8-bit clean.
+               * IUCLC - Not Posix
+               * IXON/OXOFF - no xon/xoff flow control.
+               */
+
+              /* Store the received character */
+
+              *buffer++ = ch;
+              recvd++;
+              continue;
             }
+#endif
 
-          /* Specifically not handled:
-           *
-           * All of the local modes; echo, line editing, etc.
-           * Anything to do with break or parity errors.
-           * ISTRIP - we should be 8-bit clean.
-           * IUCLC - Not Posix
-           * IXON/OXOFF - no xon/xoff flow control.
+          /* No input processing is needed.  Copy all of the data up to the
+           * head index (or the end of the buffer) in one block.
+           */
+
+          nbytes = (head > tail ? head : rxbuf->size) - tail;
+          if (nbytes > buflen - (size_t)recvd)
+            {
+              nbytes = buflen - (size_t)recvd;
+            }
+
+          memcpy(buffer, &rxbuf->buffer[tail], nbytes);
+          buffer += nbytes;
+          recvd  += nbytes;
+
+          /* Then update the tail index.  Most operations are done using the
+           * local variable 'tail' so that the final rxbuf->tail update is
+           * atomic.
            */
-#endif
 
-          /* Store the received character */
+          tail += nbytes;
+          if (tail >= rxbuf->size)
+            {
+              tail = 0;
+            }
 
-          *buffer++ = ch;
-          recvd++;
+          rxbuf->tail = tail;
         }
 
 #ifdef CONFIG_DEV_SERIAL_FULLBLOCKS
@@ -1050,8 +1226,9 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct inode *inode    = filep->f_inode;
   FAR uart_dev_t   *dev      = inode->i_private;
   ssize_t           nwritten = buflen;
+  size_t            nraw;
   bool              oktoblock;
-  int               ret;
+  ssize_t           ret;
   char              ch;
 
   /* We may receive serial writes through this path from interrupt handlers and
@@ -1120,91 +1297,111 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
    */
 
   uart_disabletxint(dev);
-  for (; buflen; buflen--)
+  while (buflen > 0)
     {
-      ch  = *buffer++;
-      ret = OK;
-
-#ifdef CONFIG_SERIAL_TERMIOS
-      /* Do output post-processing */
+      /* Characters that need no output processing are copied into the TX
+       * buffer in blocks.
+       */
 
-      if ((dev->tc_oflag & OPOST) != 0)
+      nraw = uart_rawlen(dev, buffer, buflen);
+      if (nraw > 0)
         {
-          /* Mapping CR to NL? */
-
-          if ((ch == '\r') && (dev->tc_oflag & OCRNL) != 0)
+          ret = uart_putxmitbuf(dev, buffer, nraw, oktoblock);
+          if (ret > 0)
             {
-              ch = '\n';
+              buffer += ret;
+              buflen -= ret;
+              continue;
             }
+        }
+      else
+        {
+          ch  = *buffer;
+          ret = OK;
 
-          /* Are we interested in newline processing? */
+#ifdef CONFIG_SERIAL_TERMIOS
+          /* Do output post-processing */
 
-          if ((ch == '\n') && (dev->tc_oflag & (ONLCR | ONLRET)) != 0)
+          if ((dev->tc_oflag & OPOST) != 0)
             {
-              ret = uart_putxmitchar(dev, '\r', oktoblock);
-            }
+              /* Mapping CR to NL? */
 
-          /* Specifically not handled:
-           *
-           * OXTABS - primarily a full-screen terminal optimization
-           * ONOEOT - Unix interoperability hack
-           * OLCUC  - Not specified by POSIX
-           * ONOCR  - low-speed interactive optimization
-           */
-        }
+              if ((ch == '\r') && (dev->tc_oflag & OCRNL) != 0)
+                {
+                  ch = '\n';
+                }
+
+              /* Are we interested in newline processing? */
+
+              if ((ch == '\n') && (dev->tc_oflag & (ONLCR | ONLRET)) != 0)
+                {
+                  ret = uart_putxmitchar(dev, '\r', oktoblock);
+                }
+
+              /* Specifically not handled:
+               *
+               * OXTABS - primarily a full-screen terminal optimization
+               * ONOEOT - Unix interoperability hack
+               * OLCUC  - Not specified by POSIX
+               * ONOCR  - low-speed interactive optimization
+               */
+            }
 
 #else /* !CONFIG_SERIAL_TERMIOS */
-      /* If this is the console, convert \n -> \r\n */
+          /* If this is the console, convert \n -> \r\n */
 
-      if (dev->isconsole && ch == '\n')
-        {
-          ret = uart_putxmitchar(dev, '\r', oktoblock);
-        }
+          if (dev->isconsole && ch == '\n')
+            {
+              ret = uart_putxmitchar(dev, '\r', oktoblock);
+            }
 #endif
 
-      /* Put the character into the transmit buffer */
+          /* Put the character into the transmit buffer */
 
-      if (ret >= 0)
-        {
-          ret = uart_putxmitchar(dev, ch, oktoblock);
+          if (ret >= 0)
+            {
+              ret = uart_putxmitchar(dev, ch, oktoblock);
+            }
+
+          if (ret >= 0)
+            {
+              buffer++;
+              buflen--;
+              continue;
+            }
         }
 
-      /* uart_putxmitchar() might return an error under one of two
-       * conditions:  (1) The wait for buffer space might have been
-       * interrupted by a signal (ret should be -EINTR), (2) if
-       * CONFIG_SERIAL_REMOVABLE is defined, then uart_putxmitchar()
-       * might also return if the serial device was disconnected
-       * (with -ENOTCONN), or (3) if O_NONBLOCK is specified, then
-       * then uart_putxmitchar() might return -EAGAIN if the output
-       * TX buffer is full.
+      /* uart_putxmitchar() and uart_putxmitbuf() might return an error under
+       * one of three conditions:  (1) The wait for buffer space might have
+       * been interrupted by a signal (ret should be -EINTR), (2) if
+       * CONFIG_SERIAL_REMOVABLE is defined, then they might also return if
+       * the serial device was disconnected (with -ENOTCONN), or (3) if
+       * O_NONBLOCK is specified, then they might return -EAGAIN if the
+       * output TX buffer is full.
+       *
+       * POSIX requires that we return -1 and errno set if no data was
+       * transferred.  Otherwise, we return the number of bytes in the
+       * interrupted transfer.
        */
 
-      if (ret < 0)
+      if (buflen < (size_t)nwritten)
         {
-          /* POSIX requires that we return -1 and errno set if no data was
-           * transferred.  Otherwise, we return the number of bytes in the
-           * interrupted transfer.
+          /* Some data was transferred.  Return the number of bytes that
+           * were successfully transferred.
            */
 
-          if (buflen < (size_t)nwritten)
-            {
-              /* Some data was transferred.  Return the number of bytes that
-               * were successfully transferred.
-               */
-
-              nwritten -= buflen;
-            }
-          else
-            {
-              /* No data was transferred. Return the negated errno value.
-               * The VFS layer will set the errno value appropriately).
-               */
-
-              nwritten = ret;
-            }
+          nwritten -= buflen;
+        }
+      else
+        {
+          /* No data was transferred. Return the negated errno value.
+           * The VFS layer will set the errno value appropriately).
+           */
 
-          break;
+          nwritten = ret;
         }
+
+      break;
     }
 
   if (dev->xmit.head != dev->xmit.tail)
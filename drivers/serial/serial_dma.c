@@ -41,6 +41,8 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <string.h>
+#include <assert.h>
 #include <debug.h>
 
 #include <nuttx/serial/serial.h>
@@ -135,6 +137,67 @@ static int uart_recvchars_signo(FAR uart_dev_t *dev)
 }
 #endif
 
+/****************************************************************************
+ * Name: uart_copyin
+ *
+ * Description:
+ *   Copy a block of received data into the RX circular buffer.  Data that
+ *   does not fit is discarded, as is done by uart_recvchars().
+ *
+ * Returned Value:
+ *   The number of bytes added to the RX circular buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA
+static size_t uart_copyin(FAR struct uart_buffer_s *rxbuf,
+                          FAR const char *buffer, size_t buflen)
+{
+  size_t nwritten = 0;
+  size_t nspace;
+  int16_t head = rxbuf->head;
+  int16_t tail = rxbuf->tail;
+
+  while (nwritten < buflen)
+    {
+      /* One slot is always left empty to distinguish full from empty */
+
+      if (tail > head)
+        {
+          nspace = tail - head - 1;
+        }
+      else
+        {
+          nspace = rxbuf->size - head - (tail == 0 ? 1 : 0);
+        }
+
+      if (nspace == 0)
+        {
+          break;
+        }
+
+      if (nspace > buflen - nwritten)
+        {
+          nspace = buflen - nwritten;
+        }
+
+      memcpy(&rxbuf->buffer[head], &buffer[nwritten], nspace);
+      nwritten += nspace;
+
+      head += nspace;
+      if (head >= rxbuf->size)
+        {
+          head = 0;
+        }
+    }
+
+  /* Update the head index only after the data is in place */
+
+  rxbuf->head = head;
+  return nwritten;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -408,4 +471,128 @@ void uart_recvchars_done(FAR uart_dev_t *dev)
 }
 #endif
 
+/****************************************************************************
+ * Name: uart_recvchars_pingpong
+ *
+ * Description:
+ *   Move the data received into a circular (ping-pong) RX DMA buffer into
+ *   the RX circular buffer.  Unlike uart_recvchars_dma(), the DMA does not
+ *   target the RX circular buffer directly, so the DMA never has to be
+ *   stopped and restarted when the reader frees space.  The data is moved
+ *   with memcpy() in large blocks.
+ *
+ * Input Parameters:
+ *   dev    - The serial device
+ *   pp     - The circular DMA buffer
+ *   dmapos - The offset in the DMA buffer at which the DMA controller will
+ *            store the next byte.  A value equal to the size of the buffer
+ *            is treated as zero.
+ *
+ * Assumptions:
+ *   Called from the DMA or UART interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA
+void uart_recvchars_pingpong(FAR uart_dev_t *dev,
+                             FAR struct uart_dmapingpong_s *pp,
+                             size_t dmapos)
+{
+  FAR struct uart_buffer_s *rxbuf = &dev->recv;
+#ifdef CONFIG_SERIAL_IFLOWCONTROL
+  unsigned int nbuffered;
+#endif
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGSTP)
+  int signo = 0;
+#endif
+  size_t nbytes = 0;
+  size_t length;
+
+  DEBUGASSERT(dmapos <= pp->size);
+
+  if (dmapos >= pp->size)
+    {
+      dmapos = 0;
+    }
+
+  /* The new data is either in one contiguous region or it wraps around the
+   * end of the DMA buffer.
+   */
+
+  while (pp->offset != dmapos)
+    {
+      length = (dmapos > pp->offset ? dmapos : pp->size) - pp->offset;
+
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGSTP)
+      /* REVISIT:  As in uart_recvchars_done(), the signal character is not
+       * removed from the data.
+       */
+
+      if (dev->pid >= 0 && signo == 0)
+        {
+          signo = uart_check_signo(&pp->buffer[pp->offset], length);
+        }
+#endif
+
+      nbytes += uart_copyin(rxbuf, &pp->buffer[pp->offset], length);
+
+      pp->offset += length;
+      if (pp->offset >= pp->size)
+        {
+          pp->offset = 0;
+        }
+    }
+
+#ifdef CONFIG_SERIAL_IFLOWCONTROL
+  /* How many bytes are buffered */
+
+  if (rxbuf->head >= rxbuf->tail)
+    {
+      nbuffered = rxbuf->head - rxbuf->tail;
+    }
+  else
+    {
+      nbuffered = rxbuf->size - rxbuf->tail + rxbuf->head;
+    }
+
+#ifdef CONFIG_SERIAL_IFLOWCONTROL_WATERMARKS
+  /* Is the level now above the watermark level that we need to report? */
+
+  if (nbuffered >= (CONFIG_SERIAL_IFLOWCONTROL_UPPER_WATERMARK *
+                    rxbuf->size) / 100)
+#else
+  /* Is the RX buffer full? */
+
+  if (nbuffered >= rxbuf->size - 1)
+#endif
+    {
+      /* Let the lower level driver know.  It will probably activate RX
+       * flow control.
+       */
+
+      uart_rxflowcontrol(dev, nbuffered, true);
+    }
+#endif
+
+  /* If any bytes were added to the buffer, inform any waiters there is new
+   * incoming data available.
+   */
+
+  if (nbytes)
+    {
+      uart_datareceived(dev);
+    }
+
+#if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGSTP)
+  /* Send the signal if necessary */
+
+  if (signo != 0)
+    {
+      kill(dev->pid, signo);
+      uart_reset_sem(dev);
+    }
+#endif
+}
+#endif
+
 #endif /* CONFIG_SERIAL_TXDMA || CONFIG_SERIAL_RXDMA */
@@ -69,6 +69,9 @@
 
 void uart_xmitchars(FAR uart_dev_t *dev)
 {
+#if CONFIG_SERIAL_TXWAKEUP_WATERMARK > 0
+  unsigned int nfree;
+#endif
   uint16_t nbytes = 0;
 
 #ifdef CONFIG_SMP
@@ -106,6 +109,26 @@ void uart_xmitchars(FAR uart_dev_t *dev)
       uart_disabletxint(dev);
     }
 
+#if CONFIG_SERIAL_TXWAKEUP_WATERMARK > 0
+  /* Don't wake up the waiters until the free space has reached the
+   * watermark level.
+   */
+
+  if (dev->xmit.head >= dev->xmit.tail)
+    {
+      nfree = dev->xmit.size - (dev->xmit.head - dev->xmit.tail);
+    }
+  else
+    {
+      nfree = dev->xmit.tail - dev->xmit.head;
+    }
+
+  if (nfree * 100 < CONFIG_SERIAL_TXWAKEUP_WATERMARK * dev->xmit.size)
+    {
+      nbytes = 0;
+    }
+#endif
+
   /* If any bytes were removed from the buffer, inform any waiters that
    * there is space available.
    */
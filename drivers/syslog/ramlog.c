@@ -56,13 +56,36 @@
 #include <nuttx/arch.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/syslog/ramlog.h>
 
 #include <nuttx/irq.h>
 
 #ifdef CONFIG_RAMLOG
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The memory barrier is only provided with spinlock support */
+
+#ifndef SP_DMB
+#  define SP_DMB()
+#endif
+
+/* In the multiple reader mode, the head and tail are free-running 32-bit
+ * positions.  The buffer size must be a power of two so that the buffer
+ * index stays continuous when the positions wrap around.
+ */
+
+#if defined(CONFIG_RAMLOG_MULTIREADER) && defined(CONFIG_RAMLOG_SYSLOG)
+#  if (CONFIG_RAMLOG_BUFSIZE & (CONFIG_RAMLOG_BUFSIZE - 1)) != 0
+#    error CONFIG_RAMLOG_BUFSIZE must be a power of two
+#  endif
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -72,8 +95,12 @@ struct ramlog_dev_s
 #ifndef CONFIG_RAMLOG_NONBLOCKING
   volatile uint8_t  rl_nwaiters;     /* Number of threads waiting for data */
 #endif
+#ifdef CONFIG_RAMLOG_MULTIREADER
+  FAR struct ramlog_header_s *rl_header; /* Head and tail positions */
+#else
   volatile uint16_t rl_head;         /* The head index (where data is added) */
   volatile uint16_t rl_tail;         /* The tail index (where data is removed) */
+#endif
   sem_t             rl_exclsem;      /* Enforces mutually exclusive access */
 #ifndef CONFIG_RAMLOG_NONBLOCKING
   sem_t             rl_waitsem;      /* Used to wait for data */
@@ -100,14 +127,29 @@ static int     ramlog_readnotify(FAR struct ramlog_dev_s *priv);
 #endif
 static void    ramlog_pollnotify(FAR struct ramlog_dev_s *priv,
                                  pollevent_t eventset);
-static ssize_t ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch);
+static size_t  ramlog_addbuf(FAR struct ramlog_dev_s *priv,
+                             FAR const char *buffer, size_t len);
+static ssize_t ramlog_copyout(FAR struct ramlog_dev_s *priv,
+                              FAR struct file *filep, FAR char *buffer,
+                              size_t len);
+static bool    ramlog_readable(FAR struct ramlog_dev_s *priv,
+                               FAR struct file *filep);
+static ssize_t ramlog_addstring(FAR struct ramlog_dev_s *priv,
+                                FAR const char *buffer, size_t len);
 
 /* Character driver methods */
 
+#ifdef CONFIG_RAMLOG_MULTIREADER
+static int     ramlog_open(FAR struct file *filep);
+#endif
 static ssize_t ramlog_read(FAR struct file *filep, FAR char *buffer,
                            size_t buflen);
 static ssize_t ramlog_write(FAR struct file *filep, FAR const char *buffer,
                             size_t buflen);
+#ifdef CONFIG_RAMLOG_MULTIREADER
+static int     ramlog_ioctl(FAR struct file *filep, int cmd,
+                            unsigned long arg);
+#endif
 static int     ramlog_poll(FAR struct file *filep, FAR struct pollfd *fds,
                            bool setup);
 
@@ -117,12 +159,20 @@ static int     ramlog_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
 static const struct file_operations g_ramlogfops =
 {
+#ifdef CONFIG_RAMLOG_MULTIREADER
+  ramlog_open,  /* open */
+#else
   NULL,         /* open */
+#endif
   NULL,         /* close */
   ramlog_read,  /* read */
   ramlog_write, /* write */
   NULL,         /* seek */
+#ifdef CONFIG_RAMLOG_MULTIREADER
+  ramlog_ioctl, /* ioctl */
+#else
   NULL,         /* ioctl */
+#endif
   ramlog_poll   /* poll */
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   , NULL        /* unlink */
@@ -134,7 +184,22 @@ static const struct file_operations g_ramlogfops =
  */
 
 #ifdef CONFIG_RAMLOG_SYSLOG
+#ifdef CONFIG_RAMLOG_MULTIREADER
+static struct
+{
+  struct ramlog_header_s header;
+  char buffer[CONFIG_RAMLOG_BUFSIZE];
+} g_sysbuffer =
+{
+  {
+    0,                           /* rh_head */
+    0,                           /* rh_tail */
+    CONFIG_RAMLOG_BUFSIZE        /* rh_size */
+  }
+};
+#else
 static char g_sysbuffer[CONFIG_RAMLOG_BUFSIZE];
+#endif
 
 /* This is the device structure for the console or syslogging function.  It
  * must be statically initialized because the RAMLOG ramlog_putc function
@@ -146,14 +211,22 @@ static struct ramlog_dev_s g_sysdev =
 #ifndef CONFIG_RAMLOG_NONBLOCKING
   0,                             /* rl_nwaiters */
 #endif
+#ifdef CONFIG_RAMLOG_MULTIREADER
+  &g_sysbuffer.header,           /* rl_header */
+#else
   0,                             /* rl_head */
   0,                             /* rl_tail */
+#endif
   SEM_INITIALIZER(1),            /* rl_exclsem */
 #ifndef CONFIG_RAMLOG_NONBLOCKING
   SEM_INITIALIZER(0),            /* rl_waitsem */
 #endif
   CONFIG_RAMLOG_BUFSIZE,         /* rl_bufsize */
+#ifdef CONFIG_RAMLOG_MULTIREADER
+  g_sysbuffer.buffer             /* rl_buffer */
+#else
   g_sysbuffer                    /* rl_buffer */
+#endif
 };
 #endif
 
@@ -217,43 +290,402 @@ static void ramlog_pollnotify(FAR struct ramlog_dev_s *priv,
 }
 
 /****************************************************************************
- * Name: ramlog_addchar
+ * Name: ramlog_addbuf
+ *
+ * Description:
+ *   Copy a block of data into the circular buffer.  In the multiple reader
+ *   mode, the oldest data is overwritten and all of the data is always
+ *   accepted.  Otherwise, data that does not fit is not accepted.
+ *
+ * Returned Value:
+ *   The number of bytes accepted.
+ *
  ****************************************************************************/
 
-static ssize_t ramlog_addchar(FAR struct ramlog_dev_s *priv, char ch)
+static size_t ramlog_addbuf(FAR struct ramlog_dev_s *priv,
+                            FAR const char *buffer, size_t len)
 {
+#ifdef CONFIG_RAMLOG_MULTIREADER
+  FAR struct ramlog_header_s *header = priv->rl_header;
+  size_t nwritten = len;
+  uint32_t head;
+#else
+  size_t nwritten = 0;
+  size_t head;
+  size_t tail;
+#endif
   irqstate_t flags;
-  size_t nexthead;
+  size_t index;
+  size_t ncopy;
 
   /* Disable interrupts (in case we are NOT called from interrupt handler) */
 
   flags = enter_critical_section();
 
-  /* Calculate the write index AFTER the next byte is written */
+#ifdef CONFIG_RAMLOG_MULTIREADER
+  /* Only the last rl_bufsize bytes can be kept */
 
-  nexthead = priv->rl_head + 1;
-  if (nexthead >= priv->rl_bufsize)
+  head = header->rh_head;
+  if (len > priv->rl_bufsize)
     {
-      nexthead = 0;
+      buffer += len - priv->rl_bufsize;
+      head   += len - priv->rl_bufsize;
+      len     = priv->rl_bufsize;
     }
 
-  /* Would the next write overflow the circular buffer? */
+  /* Move the tail past the data that is about to be overwritten before
+   * overwriting it.  Readers that are copying that data check the tail
+   * after the copy.
+   */
 
-  if (nexthead == priv->rl_tail)
+  if (head + len - header->rh_tail > priv->rl_bufsize)
     {
-      /* Yes... Return an indication that nothing was saved in the buffer. */
+      header->rh_tail = head + len - priv->rl_bufsize;
+      SP_DMB();
+    }
 
-      leave_critical_section(flags);
-      return -EBUSY;
+  /* Copy the data, wrapping around the end of the buffer if necessary */
+
+  index = head & (priv->rl_bufsize - 1);
+  ncopy = priv->rl_bufsize - index;
+  if (ncopy > len)
+    {
+      ncopy = len;
     }
 
-  /* No... copy the byte and re-enable interrupts */
+  memcpy(&priv->rl_buffer[index], buffer, ncopy);
+  memcpy(priv->rl_buffer, &buffer[ncopy], len - ncopy);
+
+  /* Then publish the new data */
+
+  SP_DMB();
+  header->rh_head = head + len;
+
+#else
+  while (nwritten < len)
+    {
+      /* How much contiguous space is there at the head?  One byte is
+       * always left empty to distinguish full from empty.
+       */
+
+      head = priv->rl_head;
+      tail = priv->rl_tail;
+
+      if (tail > head)
+        {
+          ncopy = tail - head - 1;
+        }
+      else
+        {
+          ncopy = priv->rl_bufsize - head - (tail == 0 ? 1 : 0);
+        }
+
+      if (ncopy == 0)
+        {
+          /* The buffer is full */
+
+          break;
+        }
+
+      if (ncopy > len - nwritten)
+        {
+          ncopy = len - nwritten;
+        }
+
+      memcpy(&priv->rl_buffer[head], &buffer[nwritten], ncopy);
+      nwritten += ncopy;
+
+      index = head + ncopy;
+      if (index >= priv->rl_bufsize)
+        {
+          index = 0;
+        }
+
+      priv->rl_head = index;
+    }
+#endif
 
-  priv->rl_buffer[priv->rl_head] = ch;
-  priv->rl_head = nexthead;
   leave_critical_section(flags);
+  return nwritten;
+}
+
+/****************************************************************************
+ * Name: ramlog_copyout
+ *
+ * Description:
+ *   Copy as much data as is available to this reader, up to 'len' bytes,
+ *   to the user buffer.  In the multiple reader mode, the data is not
+ *   removed from the circular buffer and the position of the reader is
+ *   kept in filep->f_pos.  A reader that has fallen behind the writer
+ *   skips the data that has been overwritten.
+ *
+ * Returned Value:
+ *   The number of bytes copied.  Zero if there is no data.
+ *
+ * Assumptions:
+ *   The caller holds rl_exclsem.
+ *
+ ****************************************************************************/
+
+static ssize_t ramlog_copyout(FAR struct ramlog_dev_s *priv,
+                              FAR struct file *filep, FAR char *buffer,
+                              size_t len)
+{
+#ifdef CONFIG_RAMLOG_MULTIREADER
+  FAR struct ramlog_header_s *header = priv->rl_header;
+  uint32_t pos = (uint32_t)filep->f_pos;
+  uint32_t index;
+  uint32_t head;
+  uint32_t tail;
+#else
+  size_t head;
+  size_t tail;
+#endif
+  size_t nread = 0;
+  size_t ncopy;
+
+  while (nread < len)
+    {
+#ifdef CONFIG_RAMLOG_MULTIREADER
+      head = header->rh_head;
+      SP_DMB();
+
+      /* Skip any data that was overwritten before it could be read */
+
+      tail = header->rh_tail;
+      if ((int32_t)(tail - pos) > 0)
+        {
+          pos = tail;
+        }
+
+      if (pos == head)
+        {
+          break;
+        }
+
+      ncopy = priv->rl_bufsize - (pos & (priv->rl_bufsize - 1));
+      if (ncopy > head - pos)
+        {
+          ncopy = head - pos;
+        }
+
+      if (ncopy > len - nread)
+        {
+          ncopy = len - nread;
+        }
+
+      index = pos & (priv->rl_bufsize - 1);
+      memcpy(&buffer[nread], &priv->rl_buffer[index], ncopy);
+
+      /* If the writer overwrote the data while it was being copied, then
+       * discard the copy and continue with the oldest data.
+       */
+
+      SP_DMB();
+      tail = header->rh_tail;
+      if ((int32_t)(tail - pos) > 0)
+        {
+          continue;
+        }
+
+      pos   += ncopy;
+      nread += ncopy;
+#else
+      head = priv->rl_head;
+      tail = priv->rl_tail;
+
+      if (head == tail)
+        {
+          break;
+        }
+
+      ncopy = (head > tail ? head : priv->rl_bufsize) - tail;
+      if (ncopy > len - nread)
+        {
+          ncopy = len - nread;
+        }
+
+      memcpy(&buffer[nread], &priv->rl_buffer[tail], ncopy);
+      nread += ncopy;
+
+      /* Increment the tail index */
+
+      tail += ncopy;
+      if (tail >= priv->rl_bufsize)
+        {
+          tail = 0;
+        }
+
+      priv->rl_tail = tail;
+#endif
+    }
+
+#ifdef CONFIG_RAMLOG_MULTIREADER
+  filep->f_pos = (off_t)pos;
+#endif
+
+  return nread;
+}
+
+/****************************************************************************
+ * Name: ramlog_readable
+ *
+ * Description:
+ *   Return true if there is data for this reader.
+ *
+ ****************************************************************************/
+
+static bool ramlog_readable(FAR struct ramlog_dev_s *priv,
+                            FAR struct file *filep)
+{
+#ifdef CONFIG_RAMLOG_MULTIREADER
+  return (uint32_t)filep->f_pos != priv->rl_header->rh_head;
+#else
+  return priv->rl_head != priv->rl_tail;
+#endif
+}
+
+/****************************************************************************
+ * Name: ramlog_addstring
+ *
+ * Description:
+ *   Add a block of data to the RAM log and wake up any readers.  Data is
+ *   copied in blocks; only carriage returns and linefeeds need special
+ *   handling with CONFIG_RAMLOG_CRLF.
+ *
+ ****************************************************************************/
+
+static ssize_t ramlog_addstring(FAR struct ramlog_dev_s *priv,
+                                FAR const char *buffer, size_t len)
+{
+  int readers_waken;
+  size_t nwritten;
+  size_t nrun;
+  size_t ncopy;
+
+  /* This function may be called from an interrupt handler!  Semaphores
+   * cannot be used!
+   *
+   * The write logic only needs to modify the rl_head index.  Therefore,
+   * there is a difference in the way that rl_head and rl_tail are
+   * protected: rl_tail is protected with a semaphore; rl_head is protected
+   * by disabling interrupts.
+   */
+
+  for (nwritten = 0; nwritten < len; )
+    {
+#ifdef CONFIG_RAMLOG_CRLF
+      /* Ignore carriage returns */
+
+      if (buffer[nwritten] == '\r')
+        {
+          nwritten++;
+          continue;
+        }
+
+      /* Pre-pend a carriage before a linefeed */
+
+      if (buffer[nwritten] == '\n')
+        {
+          if (ramlog_addbuf(priv, "\r\n", 2) < 2)
+            {
+              /* The buffer is full.  The remaining data to be written is
+               * dropped on the floor.
+               */
+
+              break;
+            }
+
+          nwritten++;
+          continue;
+        }
+
+      /* Find the run of characters that need no processing */
+
+      for (nrun = 1;
+           nwritten + nrun < len && buffer[nwritten + nrun] != '\r' &&
+           buffer[nwritten + nrun] != '\n';
+           nrun++)
+        {
+        }
+#else
+      nrun = len - nwritten;
+#endif
+
+      ncopy     = ramlog_addbuf(priv, &buffer[nwritten], nrun);
+      nwritten += ncopy;
+
+      if (ncopy < nrun)
+        {
+          /* The buffer is full.  The remaining data to be written is
+           * dropped on the floor.
+           */
+
+          break;
+        }
+    }
+
+  /* Was anything written? */
+
+  if (nwritten > 0)
+    {
+      readers_waken = 0;
+
+#ifndef CONFIG_RAMLOG_NONBLOCKING
+      /* Are there threads waiting for read data? */
+
+      readers_waken = ramlog_readnotify(priv);
+#endif
+
+      /* If there are multiple readers, some of them might block despite
+       * POLLIN because first reader might read all data. Favor readers
+       * and notify poll waiters only if no reader was awaken, even if the
+       * latter may starve.
+       *
+       * This also implies we do not have to make these two notify
+       * operations a critical section.
+       */
+
+      if (readers_waken == 0)
+        {
+          /* Notify all poll/select waiters that they can read from the
+           * FIFO
+           */
+
+          ramlog_pollnotify(priv, POLLIN);
+        }
+    }
+
+  /* We always have to return the number of bytes requested and NOT the
+   * number of bytes that were actually written.  Otherwise, callers
+   * probably retry, causing same error condition again.
+   */
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: ramlog_open
+ *
+ * Description:
+ *   In the multiple reader mode, a new reader starts with the oldest data
+ *   in the buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_RAMLOG_MULTIREADER
+static int ramlog_open(FAR struct file *filep)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct ramlog_dev_s *priv;
+
+  DEBUGASSERT(inode && inode->i_private);
+  priv = (FAR struct ramlog_dev_s *)inode->i_private;
+
+  filep->f_pos = (off_t)priv->rl_header->rh_tail;
   return OK;
 }
+#endif
 
 /****************************************************************************
  * Name: ramlog_read
@@ -264,7 +696,7 @@ static ssize_t ramlog_read(FAR struct file *filep, FAR char *buffer, size_t len)
   FAR struct inode *inode = filep->f_inode;
   FAR struct ramlog_dev_s *priv;
   ssize_t nread;
-  char ch;
+  ssize_t ncopy;
   int ret;
 
   /* Some sanity checking */
@@ -290,9 +722,14 @@ static ssize_t ramlog_read(FAR struct file *filep, FAR char *buffer, size_t len)
 
   for (nread = 0; (size_t)nread < len; )
     {
-      /* Get the next byte from the buffer */
+      /* Get the available data from the buffer */
 
-      if (priv->rl_head == priv->rl_tail)
+      ncopy = ramlog_copyout(priv, filep, &buffer[nread], len - nread);
+      if (ncopy > 0)
+        {
+          nread += ncopy;
+        }
+      else
         {
           /* The circular buffer is empty. */
 
@@ -373,26 +810,6 @@ static ssize_t ramlog_read(FAR struct file *filep, FAR char *buffer, size_t len)
             }
 #endif /* CONFIG_RAMLOG_NONBLOCKING */
         }
-      else
-        {
-          /* The circular buffer is not empty, get the next byte from the
-           * tail index.
-           */
-
-          ch = priv->rl_buffer[priv->rl_tail];
-
-          /* Increment the tail index. */
-
-          if (++priv->rl_tail >= priv->rl_bufsize)
-            {
-              priv->rl_tail = 0;
-            }
-
-          /* Add the character to the user buffer. */
-
-          buffer[nread] = ch;
-          nread++;
-        }
     }
 
   /* Relinquish the mutual exclusion semaphore */
@@ -423,104 +840,47 @@ static ssize_t ramlog_write(FAR struct file *filep, FAR const char *buffer, size
 {
   FAR struct inode *inode = filep->f_inode;
   FAR struct ramlog_dev_s *priv;
-  int readers_waken;
-  ssize_t nwritten;
-  char ch;
-  int ret;
 
   /* Some sanity checking */
 
   DEBUGASSERT(inode && inode->i_private);
   priv = (FAR struct ramlog_dev_s *)inode->i_private;
 
-  /* Loop until all of the bytes have been written.  This function may be
-   * called from an interrupt handler!  Semaphores cannot be used!
-   *
-   * The write logic only needs to modify the rl_head index.  Therefore,
-   * there is a difference in the way that rl_head and rl_tail are protected:
-   * rl_tail is protected with a semaphore; rl_head is protected by disabling
-   * interrupts.
-   */
-
-  for (nwritten = 0; (size_t)nwritten < len; nwritten++)
-    {
-      /* Get the next character to output */
-
-      ch = buffer[nwritten];
-
-      /* Ignore carriage returns */
-
-#ifdef CONFIG_RAMLOG_CRLF
-      if (ch == '\r')
-        {
-          continue;
-        }
-
-      /* Pre-pend a carriage before a linefeed */
-
-      if (ch == '\n')
-        {
-          ret = ramlog_addchar(priv, '\r');
-          if (ret < 0)
-            {
-              /* The buffer is full and nothing was saved.  The remaining
-               * data to be written is dropped on the floor.
-               */
-
-              break;
-            }
-        }
-#endif
-
-      /* Then output the character */
+  return ramlog_addstring(priv, buffer, len);
+}
 
-      ret = ramlog_addchar(priv, ch);
-      if (ret < 0)
-        {
-          /* The buffer is full and nothing was saved.  The remaining
-           * data to be written is dropped on the floor.
-           */
+/****************************************************************************
+ * Name: ramlog_ioctl
+ *
+ * Description:
+ *   In the multiple reader mode, support mmap() of the RAM log:  The mapped
+ *   region is a struct ramlog_header_s followed by the circular buffer.
+ *
+ ****************************************************************************/
 
-          break;
-        }
-    }
+#ifdef CONFIG_RAMLOG_MULTIREADER
+static int ramlog_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct ramlog_dev_s *priv;
+  FAR void **ppv = (FAR void**)((uintptr_t)arg);
 
-  /* Was anything written? */
+  DEBUGASSERT(inode && inode->i_private);
+  priv = (FAR struct ramlog_dev_s *)inode->i_private;
 
-  if (nwritten > 0)
+  if (cmd == FIOC_MMAP && ppv != NULL)
     {
-      readers_waken = 0;
-
-#ifndef CONFIG_RAMLOG_NONBLOCKING
-      /* Are there threads waiting for read data? */
-
-      readers_waken = ramlog_readnotify(priv);
-#endif
-
-      /* If there are multiple readers, some of them might block despite
-       * POLLIN because first reader might read all data. Favor readers
-       * and notify poll waiters only if no reader was awaken, even if the
-       * latter may starve.
-       *
-       * This also implies we do not have to make these two notify
-       * operations a critical section.
+      /* Return the address of the header, which is followed by the
+       * circular buffer.
        */
 
-      if (readers_waken == 0)
-        {
-          /* Notify all poll/select waiters that they can read from the FIFO */
-
-          ramlog_pollnotify(priv, POLLIN);
-        }
+      *ppv = (FAR void *)priv->rl_header;
+      return OK;
     }
 
-  /* We always have to return the number of bytes requested and NOT the
-   * number of bytes that were actually written.  Otherwise, callers
-   * probably retry, causing same error condition again.
-   */
-
-  return len;
+  return -ENOTTY;
 }
+#endif
 
 /****************************************************************************
  * Name: ramlog_poll
@@ -532,7 +892,9 @@ int ramlog_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
   FAR struct ramlog_dev_s *priv;
   pollevent_t eventset;
   irqstate_t flags;
+#ifndef CONFIG_RAMLOG_MULTIREADER
   size_t next_head;
+#endif
   int ret;
   int i;
 
@@ -583,6 +945,11 @@ int ramlog_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
       eventset = 0;
 
       flags = enter_critical_section();
+#ifdef CONFIG_RAMLOG_MULTIREADER
+      /* The buffer is never full.  The oldest data is overwritten. */
+
+      eventset |= POLLOUT;
+#else
       next_head = priv->rl_head + 1;
       if (next_head >= priv->rl_bufsize)
         {
@@ -595,10 +962,11 @@ int ramlog_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup)
        {
          eventset |= POLLOUT;
        }
+#endif
 
       /* Check if the receive buffer is not empty. */
 
-      if (priv->rl_head != priv->rl_tail)
+      if (ramlog_readable(priv, filep))
        {
          eventset |= POLLIN;
        }
@@ -654,7 +1022,13 @@ int ramlog_register(FAR const char *devpath, FAR char *buffer, size_t buflen)
 
   /* Sanity checking */
 
+#ifdef CONFIG_RAMLOG_MULTIREADER
+  DEBUGASSERT(devpath && buffer &&
+              buflen > sizeof(struct ramlog_header_s) &&
+              ((uintptr_t)buffer & (sizeof(uint32_t) - 1)) == 0);
+#else
   DEBUGASSERT(devpath && buffer && buflen > 1);
+#endif
 
   /* Allocate a RAM logging device structure */
 
@@ -674,6 +1048,27 @@ int ramlog_register(FAR const char *devpath, FAR char *buffer, size_t buflen)
       nxsem_setprotocol(&priv->rl_waitsem, SEM_PRIO_NONE);
 #endif
 
+#ifdef CONFIG_RAMLOG_MULTIREADER
+      /* The header with the head and tail positions is kept at the
+       * beginning of the buffer so that the whole log can be mapped.
+       */
+
+      priv->rl_header  = (FAR struct ramlog_header_s *)buffer;
+      buffer          += sizeof(struct ramlog_header_s);
+      buflen          -= sizeof(struct ramlog_header_s);
+
+      /* Use the largest power of two that fits in the rest of the buffer */
+
+      while ((buflen & (buflen - 1)) != 0)
+        {
+          buflen &= buflen - 1;
+        }
+
+      priv->rl_header->rh_head = 0;
+      priv->rl_header->rh_tail = 0;
+      priv->rl_header->rh_size = buflen;
+#endif
+
       priv->rl_bufsize = buflen;
       priv->rl_buffer  = buffer;
 
@@ -720,7 +1115,8 @@ int ramlog_putc(int ch)
 {
   FAR struct ramlog_dev_s *priv = &g_sysdev;
   int readers_waken = 0;
-  int ret;
+  char buf[2];
+  size_t len;
 
 #ifdef CONFIG_RAMLOG_CRLF
   /* Ignore carriage returns.  But return success. */
@@ -729,29 +1125,27 @@ int ramlog_putc(int ch)
     {
       return ch;
     }
+#endif
+
+  /* Add the character to the RAMLOG */
 
+  len    = 0;
+#ifdef CONFIG_RAMLOG_CRLF
   /* Pre-pend a newline with a carriage return */
 
   if (ch == '\n')
     {
-      ret = ramlog_addchar(priv, '\r');
-      if (ret < 0)
-        {
-          /* The buffer is full and nothing was saved. */
-
-          return ret;
-        }
+      buf[len++] = '\r';
     }
 #endif
 
-  /* Add the character to the RAMLOG */
+  buf[len++] = ch;
 
-  ret = ramlog_addchar(priv, ch);
-  if (ret < 0)
+  if (ramlog_addbuf(priv, buf, len) < len)
     {
       /* The buffer is full and 'ch' was not saved. */
 
-      return ret;
+      return -EBUSY;
     }
 
 #ifndef CONFIG_RAMLOG_NONBLOCKING
@@ -782,4 +1176,21 @@ int ramlog_putc(int ch)
 }
 #endif
 
+/****************************************************************************
+ * Name: ramlog_syslog_write
+ *
+ * Description:
+ *   This is the low-level, multiple byte, system logging interface.  The
+ *   data is copied into the RAM log in blocks and the readers are woken up
+ *   once.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_RAMLOG_SYSLOG) && defined(CONFIG_SYSLOG_WRITE)
+ssize_t ramlog_syslog_write(FAR const char *buffer, size_t buflen)
+{
+  return ramlog_addstring(&g_sysdev, buffer, buflen);
+}
+#endif
+
 #endif /* CONFIG_RAMLOG */
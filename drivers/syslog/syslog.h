@@ -43,6 +43,8 @@
 #include <nuttx/config.h>
 
 #include <stdbool.h>
+#include <stdarg.h>
+#include <time.h>
 
 /****************************************************************************
  * Public Data
@@ -248,6 +250,48 @@ int syslog_flush_intbuffer(FAR const struct syslog_channel_s *channel,
                            bool force);
 #endif
 
+/****************************************************************************
+ * Name: syslog_add_deferred
+ *
+ * Description:
+ *   Store a message as a binary record to be formatted and output later by
+ *   a worker on the low priority work queue.  The record is added to a
+ *   per-CPU ring buffer without taking any lock.  If the ring buffer is
+ *   full, the message is dropped and counted.
+ *
+ * Input Parameters:
+ *   priority - The message priority
+ *   ts       - The time stamp of the message (if CONFIG_SYSLOG_TIMESTAMP)
+ *   fmt      - The format string.  It is not copied and must remain valid.
+ *   ap       - The arguments.  Not modified.
+ *
+ * Returned Value:
+ *   Zero (OK) if the message was stored or dropped.  A negated errno value
+ *   is returned if the message cannot be deferred and must be formatted
+ *   immediately.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+int syslog_add_deferred(int priority, FAR const struct timespec *ts,
+                        FAR const IPTR char *fmt, FAR va_list *ap);
+#endif
+
+/****************************************************************************
+ * Name: syslog_flush_deferred
+ *
+ * Description:
+ *   Format and output any deferred records immediately.
+ *
+ * Assumptions:
+ *   The drain worker is not running concurrently.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+void syslog_flush_deferred(void);
+#endif
+
 /****************************************************************************
  * Name: syslog_putc
  *
@@ -82,6 +82,10 @@ static const struct syslog_channel_s g_default_channel =
 {
   ramlog_putc,
   ramlog_putc,
+#ifdef CONFIG_SYSLOG_WRITE
+  NULL,
+  ramlog_syslog_write
+#endif
 };
 #elif defined(CONFIG_SYSLOG_RPMSG)
 static const struct syslog_channel_s g_default_channel =
@@ -0,0 +1,948 @@
+/****************************************************************************
+ * drivers/syslog/syslog_deferred.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <syslog.h>
+#include <time.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/init.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/streams.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/syslog/syslog.h>
+
+#include "syslog.h"
+
+#ifdef CONFIG_SYSLOG_DEFERRED
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_SYSLOG_DEFERRED_BUFSIZE & \
+     (CONFIG_SYSLOG_DEFERRED_BUFSIZE - 1)) != 0
+#  error CONFIG_SYSLOG_DEFERRED_BUFSIZE must be a power of two
+#endif
+
+/* A record never wraps around the end of the ring buffer.  A record of
+ * more than half of the buffer may not fit at any position, even in an
+ * empty buffer, and would always be dropped.
+ */
+
+#if CONFIG_SYSLOG_DEFERRED_RECSIZE > CONFIG_SYSLOG_DEFERRED_BUFSIZE / 2
+#  error CONFIG_SYSLOG_DEFERRED_RECSIZE must not exceed half of BUFSIZE
+#endif
+
+#ifdef CONFIG_SMP
+#  define SYSLOG_NRINGS          CONFIG_SMP_NCPUS
+#else
+#  define SYSLOG_NRINGS          1
+#endif
+
+/* The memory barrier is only provided with spinlock support */
+
+#ifndef SP_DMB
+#  define SP_DMB()
+#endif
+
+/* Records are stored in units of one argument, which keeps every record
+ * (and every argument within it) suitably aligned.
+ */
+
+#define SYSLOG_RECALIGN          sizeof(union syslog_arg_u)
+#define SYSLOG_ALIGNUP(n)        \
+  (((n) + SYSLOG_RECALIGN - 1) & ~(SYSLOG_RECALIGN - 1))
+
+#define SYSLOG_RINGWORDS         \
+  (CONFIG_SYSLOG_DEFERRED_BUFSIZE / SYSLOG_RECALIGN)
+#define SYSLOG_RECWORDS          \
+  (SYSLOG_ALIGNUP(CONFIG_SYSLOG_DEFERRED_RECSIZE) / SYSLOG_RECALIGN)
+#define SYSLOG_RINGMASK          (CONFIG_SYSLOG_DEFERRED_BUFSIZE - 1)
+
+/* The size of the header of a record, not including any arguments */
+
+#define SYSLOG_HDRSIZE           offsetof(struct syslog_record_s, args)
+
+/* The priority value that marks the unused space at the end of the ring
+ * buffer when a record would not fit there.
+ */
+
+#define SYSLOG_PADDING           0xff
+
+/* The longest conversion specification that can be re-created from a
+ * record, including '*' widths and precisions expanded to numbers.
+ */
+
+#define SYSLOG_SPECLEN           32
+#define SYSLOG_INTLEN            11
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The type of the argument consumed by one conversion specification */
+
+enum syslog_argtype_e
+{
+  SYSLOG_ARG_NONE = 0,           /* "%%" */
+  SYSLOG_ARG_INT,                /* d, i, o, u, x, X, c with no length */
+  SYSLOG_ARG_LONG,               /* ... with 'l' */
+#ifdef CONFIG_HAVE_LONG_LONG
+  SYSLOG_ARG_LLONG,              /* ... with 'll' */
+#endif
+  SYSLOG_ARG_SIZE,               /* ... with 'z' */
+  SYSLOG_ARG_INTMAX,             /* ... with 'j' */
+  SYSLOG_ARG_PTRDIFF,            /* ... with 't' */
+#ifdef CONFIG_HAVE_DOUBLE
+  SYSLOG_ARG_DOUBLE,             /* e, E, f, F, g, G, a, A */
+#endif
+  SYSLOG_ARG_PTR,                /* p */
+  SYSLOG_ARG_STRING              /* s.  The string is copied */
+};
+
+/* One parsed conversion specification */
+
+struct syslog_conv_s
+{
+  uint8_t type;                  /* See enum syslog_argtype_e */
+  bool starwidth;                /* The width is given by an int argument */
+  bool starprec;                 /* The precision is given by an int argument */
+};
+
+/* One stored argument */
+
+union syslog_arg_u
+{
+  int i;
+  long l;
+#ifdef CONFIG_HAVE_LONG_LONG
+  long long ll;
+#endif
+  size_t z;                      /* Also the offset of a copied string */
+  intmax_t j;
+  ptrdiff_t t;
+#ifdef CONFIG_HAVE_DOUBLE
+  double d;
+#endif
+  FAR void *p;
+};
+
+/* One log record.  The arguments are followed by the copies of any string
+ * arguments.
+ */
+
+struct syslog_record_s
+{
+  uint16_t len;                  /* Size of the record, including padding */
+  uint8_t priority;              /* Message priority or SYSLOG_PADDING */
+  uint8_t nargs;                 /* Number of stored arguments */
+  FAR const IPTR char *fmt;      /* The format string */
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  struct timespec ts;            /* The time the message was logged */
+#endif
+  union syslog_arg_u args[1];    /* Actual size is nargs */
+};
+
+/* The record ring buffer of one CPU.  It is written only by its CPU, with
+ * local interrupts disabled, and read only by one drain worker at a time
+ * (see g_syslog_draining), so no lock is needed.  The indices run freely
+ * and are reduced modulo the buffer size when used.
+ */
+
+struct syslog_ring_s
+{
+  volatile uint32_t head;        /* Producer index */
+  volatile uint32_t tail;        /* Consumer index */
+  volatile uint32_t ndropped;    /* Number of records dropped */
+  uint32_t nreported;            /* Number of dropped records reported */
+  union syslog_arg_u buffer[SYSLOG_RINGWORDS];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct syslog_ring_s g_syslog_rings[SYSLOG_NRINGS];
+static struct work_s g_syslog_work;
+
+/* The work item may be queued again while the drain worker runs, and so
+ * run on another thread of the low priority work queue at the same time.
+ * Only one of them drains the ring buffers.
+ */
+
+static bool g_syslog_draining;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_parse_conv
+ *
+ * Description:
+ *   Parse the conversion specification that follows a '%' in a format
+ *   string.
+ *
+ * Input Parameters:
+ *   fmt  - The character after the '%'
+ *   conv - The location to return the parsed specification
+ *
+ * Returned Value:
+ *   The character after the conversion specification, or NULL if the
+ *   specification is not supported by deferred formatting.
+ *
+ ****************************************************************************/
+
+static FAR const char *syslog_parse_conv(FAR const char *fmt,
+                                         FAR struct syslog_conv_s *conv)
+{
+  char lenmod = '\0';
+
+  conv->type      = SYSLOG_ARG_INT;
+  conv->starwidth = false;
+  conv->starprec  = false;
+
+  if (*fmt == '%')
+    {
+      conv->type = SYSLOG_ARG_NONE;
+      return fmt + 1;
+    }
+
+  /* Flags */
+
+  while (*fmt == '-' || *fmt == '+' || *fmt == ' ' || *fmt == '#' ||
+         *fmt == '0')
+    {
+      fmt++;
+    }
+
+  /* Field width */
+
+  if (*fmt == '*')
+    {
+      conv->starwidth = true;
+      fmt++;
+    }
+  else
+    {
+      while (isdigit(*fmt))
+        {
+          fmt++;
+        }
+    }
+
+  /* Precision */
+
+  if (*fmt == '.')
+    {
+      fmt++;
+      if (*fmt == '*')
+        {
+          conv->starprec = true;
+          fmt++;
+        }
+      else
+        {
+          while (isdigit(*fmt))
+            {
+              fmt++;
+            }
+        }
+    }
+
+  /* Length modifier.  'L' (long double) is not supported. */
+
+  switch (*fmt)
+    {
+      case 'h':
+        fmt++;
+        if (*fmt == 'h')
+          {
+            fmt++;
+          }
+        break;
+
+      case 'l':
+        fmt++;
+        lenmod = 'l';
+        if (*fmt == 'l')
+          {
+            fmt++;
+            lenmod = 'q';
+          }
+        break;
+
+      case 'z':
+      case 'j':
+      case 't':
+        lenmod = *fmt++;
+        break;
+
+      default:
+        break;
+    }
+
+  /* Conversion specifier */
+
+  switch (*fmt)
+    {
+      case 'd':
+      case 'i':
+      case 'o':
+      case 'u':
+      case 'x':
+      case 'X':
+        switch (lenmod)
+          {
+            case 'l':
+              conv->type = SYSLOG_ARG_LONG;
+              break;
+
+            case 'q':
+#ifdef CONFIG_HAVE_LONG_LONG
+              conv->type = SYSLOG_ARG_LLONG;
+              break;
+#else
+              return NULL;
+#endif
+
+            case 'z':
+              conv->type = SYSLOG_ARG_SIZE;
+              break;
+
+            case 'j':
+              conv->type = SYSLOG_ARG_INTMAX;
+              break;
+
+            case 't':
+              conv->type = SYSLOG_ARG_PTRDIFF;
+              break;
+
+            default:
+              break;
+          }
+        break;
+
+      case 'c':
+        break;
+
+#ifdef CONFIG_HAVE_DOUBLE
+      case 'e':
+      case 'E':
+      case 'f':
+      case 'F':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':
+        if (lenmod != '\0' && lenmod != 'l')
+          {
+            return NULL;
+          }
+
+        conv->type = SYSLOG_ARG_DOUBLE;
+        break;
+#endif
+
+      case 's':
+        conv->type = SYSLOG_ARG_STRING;
+        break;
+
+      case 'p':
+        conv->type = SYSLOG_ARG_PTR;
+        break;
+
+      default:
+
+        /* Including %n, which cannot be deferred */
+
+        return NULL;
+    }
+
+  return fmt + 1;
+}
+
+/****************************************************************************
+ * Name: syslog_count_args
+ *
+ * Description:
+ *   Return the number of arguments consumed by a format string, or a
+ *   negated errno value if it cannot be formatted later.
+ *
+ ****************************************************************************/
+
+static int syslog_count_args(FAR const IPTR char *fmt)
+{
+  FAR const char *start;
+  struct syslog_conv_s conv;
+  int nargs = 0;
+
+  while (*fmt != '\0')
+    {
+      if (*fmt++ != '%')
+        {
+          continue;
+        }
+
+      start = fmt - 1;
+      fmt   = syslog_parse_conv(fmt, &conv);
+      if (fmt == NULL ||
+          fmt - start + 2 * SYSLOG_INTLEN >= SYSLOG_SPECLEN)
+        {
+          return -ENOTSUP;
+        }
+
+      if (conv.type != SYSLOG_ARG_NONE)
+        {
+          nargs += 1 + conv.starwidth + conv.starprec;
+        }
+    }
+
+  return nargs;
+}
+
+/****************************************************************************
+ * Name: syslog_ring_add
+ *
+ * Description:
+ *   Copy a record into the ring buffer of this CPU, or count it as dropped
+ *   if the ring buffer is full.
+ *
+ ****************************************************************************/
+
+static void syslog_ring_add(FAR const struct syslog_record_s *rec)
+{
+  FAR struct syslog_ring_s *ring;
+  FAR struct syslog_record_s *pad;
+  irqstate_t flags;
+  uint32_t head;
+  uint32_t pos;
+  uint32_t skip;
+
+  /* Disabling local interrupts is enough to keep other producers on this
+   * CPU out.  Producers on other CPUs use their own ring.
+   */
+
+  flags = up_irq_save();
+  ring  = &g_syslog_rings[up_cpu_index()];
+
+  /* A record never wraps around the end of the buffer.  If it does not fit
+   * there, the remaining space is skipped.
+   */
+
+  head = ring->head;
+  pos  = head & SYSLOG_RINGMASK;
+  skip = CONFIG_SYSLOG_DEFERRED_BUFSIZE - pos;
+  if (skip >= rec->len)
+    {
+      skip = 0;
+    }
+
+  if (head - ring->tail + skip + rec->len > CONFIG_SYSLOG_DEFERRED_BUFSIZE)
+    {
+      ring->ndropped++;
+    }
+  else
+    {
+      if (skip > 0)
+        {
+          pad           = (FAR struct syslog_record_s *)
+                          ((FAR uint8_t *)ring->buffer + pos);
+          pad->len      = skip;
+          pad->priority = SYSLOG_PADDING;
+          head         += skip;
+          pos           = 0;
+        }
+
+      memcpy((FAR uint8_t *)ring->buffer + pos, rec, rec->len);
+
+      /* The record must be complete before the drain worker can see it */
+
+      SP_DMB();
+      ring->head = head + rec->len;
+    }
+
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: syslog_format_record
+ *
+ * Description:
+ *   Format one record to a stream.
+ *
+ ****************************************************************************/
+
+static void syslog_format_record(FAR struct lib_outstream_s *stream,
+                                 FAR const struct syslog_record_s *rec)
+{
+  FAR const union syslog_arg_u *arg = rec->args;
+  FAR const char *ptr = rec->fmt;
+  FAR const char *start;
+  struct syslog_conv_s conv;
+  char spec[SYSLOG_SPECLEN];
+  int len;
+
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  /* Pre-pend the message with the time that it was logged */
+
+  lib_sprintf(stream, "[%5d.%06d] ",
+              rec->ts.tv_sec, rec->ts.tv_nsec / 1000);
+#endif
+
+#ifdef CONFIG_SYSLOG_PREFIX
+  /* Pre-pend the prefix, if available */
+
+  lib_sprintf(stream, "%s", CONFIG_SYSLOG_PREFIX_STRING);
+#endif
+
+  while (*ptr != '\0')
+    {
+      /* Output the text up to the next conversion specification */
+
+      if (*ptr != '%')
+        {
+          stream->put(stream, *ptr++);
+          continue;
+        }
+
+      start = ptr;
+      ptr   = syslog_parse_conv(ptr + 1, &conv);
+      if (conv.type == SYSLOG_ARG_NONE)
+        {
+          stream->put(stream, '%');
+          continue;
+        }
+
+      /* Re-create the conversion specification, replacing each '*' with
+       * the stored width or precision.  Its length was checked when the
+       * record was created.
+       */
+
+      for (len = 0; start < ptr; start++)
+        {
+          if (*start == '*')
+            {
+              len += snprintf(&spec[len], SYSLOG_SPECLEN - len, "%d",
+                              (arg++)->i);
+            }
+          else
+            {
+              spec[len++] = *start;
+            }
+        }
+
+      spec[len] = '\0';
+
+      switch (conv.type)
+        {
+          case SYSLOG_ARG_INT:
+            lib_sprintf(stream, spec, arg->i);
+            break;
+
+          case SYSLOG_ARG_LONG:
+            lib_sprintf(stream, spec, arg->l);
+            break;
+
+#ifdef CONFIG_HAVE_LONG_LONG
+          case SYSLOG_ARG_LLONG:
+            lib_sprintf(stream, spec, arg->ll);
+            break;
+#endif
+
+          case SYSLOG_ARG_SIZE:
+            lib_sprintf(stream, spec, arg->z);
+            break;
+
+          case SYSLOG_ARG_INTMAX:
+            lib_sprintf(stream, spec, arg->j);
+            break;
+
+          case SYSLOG_ARG_PTRDIFF:
+            lib_sprintf(stream, spec, arg->t);
+            break;
+
+#ifdef CONFIG_HAVE_DOUBLE
+          case SYSLOG_ARG_DOUBLE:
+            lib_sprintf(stream, spec, arg->d);
+            break;
+#endif
+
+          case SYSLOG_ARG_PTR:
+            lib_sprintf(stream, spec, arg->p);
+            break;
+
+          case SYSLOG_ARG_STRING:
+            lib_sprintf(stream, spec, (FAR const char *)rec + arg->z);
+            break;
+        }
+
+      arg++;
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_drain
+ *
+ * Description:
+ *   Format and output all of the records in all of the ring buffers.
+ *
+ ****************************************************************************/
+
+static void syslog_drain(void)
+{
+  FAR struct syslog_ring_s *ring;
+  FAR struct syslog_record_s *rec;
+  struct lib_syslogstream_s stream;
+  uint32_t ndropped;
+  uint32_t tail;
+  int i;
+
+  for (i = 0; i < SYSLOG_NRINGS; i++)
+    {
+      ring = &g_syslog_rings[i];
+      tail = ring->tail;
+
+      while (tail != ring->head)
+        {
+          /* Don't read the record before the producer has finished it */
+
+          SP_DMB();
+
+          rec = (FAR struct syslog_record_s *)
+                ((FAR uint8_t *)ring->buffer + (tail & SYSLOG_RINGMASK));
+          if (rec->priority != SYSLOG_PADDING)
+            {
+              syslogstream_create(&stream);
+              syslog_format_record(&stream.public, rec);
+#ifdef CONFIG_SYSLOG_BUFFER
+              syslogstream_destroy(&stream);
+#endif
+            }
+
+          /* Then release the space to the producer */
+
+          tail += rec->len;
+          SP_DMB();
+          ring->tail = tail;
+        }
+
+      /* Report any records that were lost since the last time */
+
+      ndropped = ring->ndropped;
+      if (ndropped != ring->nreported)
+        {
+          syslogstream_create(&stream);
+          lib_sprintf(&stream.public, "[syslog: %lu records dropped]\n",
+                      (unsigned long)(ndropped - ring->nreported));
+#ifdef CONFIG_SYSLOG_BUFFER
+          syslogstream_destroy(&stream);
+#endif
+          ring->nreported = ndropped;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: syslog_pending
+ *
+ * Description:
+ *   Return true if any of the ring buffers holds records.
+ *
+ ****************************************************************************/
+
+static bool syslog_pending(void)
+{
+  int i;
+
+  for (i = 0; i < SYSLOG_NRINGS; i++)
+    {
+      if (g_syslog_rings[i].tail != g_syslog_rings[i].head)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: syslog_drain_worker
+ ****************************************************************************/
+
+static void syslog_drain_worker(FAR void *arg)
+{
+  irqstate_t flags;
+
+  /* If another worker thread is already draining, it will also output the
+   * records that caused this worker to be queued.
+   */
+
+  flags = enter_critical_section();
+  if (g_syslog_draining)
+    {
+      leave_critical_section(flags);
+      return;
+    }
+
+  g_syslog_draining = true;
+  leave_critical_section(flags);
+
+  for (; ; )
+    {
+      syslog_drain();
+
+      /* Records that were added while draining may have been left to this
+       * worker.  Check again before giving up the drain.
+       */
+
+      flags = enter_critical_section();
+      if (!syslog_pending())
+        {
+          g_syslog_draining = false;
+          leave_critical_section(flags);
+          break;
+        }
+
+      leave_critical_section(flags);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: syslog_add_deferred
+ *
+ * Description:
+ *   Store a message as a binary record:  The format string pointer, the raw
+ *   arguments and copies of any string arguments.  The record is added to
+ *   the ring buffer of the current CPU without taking any lock, and is
+ *   formatted and output later by a worker on the low priority work queue.
+ *   If the ring buffer is full, the message is dropped and counted.
+ *
+ *   The format string itself is not copied, so it must remain valid.  This
+ *   is the case for the string literals used with syslog().
+ *
+ * Input Parameters:
+ *   priority - The message priority
+ *   ts       - The time stamp of the message (if CONFIG_SYSLOG_TIMESTAMP)
+ *   fmt      - The format string
+ *   ap       - The arguments.  Not modified.
+ *
+ * Returned Value:
+ *   Zero (OK) if the message was stored or dropped.  A negated errno value
+ *   is returned if the message cannot be deferred and must be formatted
+ *   immediately.
+ *
+ ****************************************************************************/
+
+int syslog_add_deferred(int priority, FAR const struct timespec *ts,
+                        FAR const IPTR char *fmt, FAR va_list *ap)
+{
+  union syslog_arg_u recbuf[SYSLOG_RECWORDS];
+  FAR struct syslog_record_s *rec = (FAR struct syslog_record_s *)recbuf;
+  FAR union syslog_arg_u *arg;
+  FAR const char *ptr;
+  FAR const char *str;
+  struct syslog_conv_s conv;
+  size_t reclen;
+  size_t len;
+  va_list copy;
+  int nargs;
+
+  /* The work queue must be running to drain the buffer */
+
+  if (!OSINIT_OS_READY())
+    {
+      return -EAGAIN;
+    }
+
+  nargs = syslog_count_args(fmt);
+  if (nargs < 0)
+    {
+      return nargs;
+    }
+
+  reclen = SYSLOG_HDRSIZE + nargs * sizeof(union syslog_arg_u);
+  if (nargs > UINT8_MAX || reclen >= CONFIG_SYSLOG_DEFERRED_RECSIZE)
+    {
+      return -E2BIG;
+    }
+
+  rec->priority = priority;
+  rec->nargs    = nargs;
+  rec->fmt      = fmt;
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+  rec->ts       = *ts;
+#endif
+
+  /* Fetch the arguments.  Strings are copied after the arguments, and
+   * truncated if the record is full.
+   */
+
+  arg = rec->args;
+  va_copy(copy, *ap);
+
+  for (ptr = fmt; *ptr != '\0'; )
+    {
+      if (*ptr++ != '%')
+        {
+          continue;
+        }
+
+      ptr = syslog_parse_conv(ptr, &conv);
+      if (conv.type == SYSLOG_ARG_NONE)
+        {
+          continue;
+        }
+
+      if (conv.starwidth)
+        {
+          (arg++)->i = va_arg(copy, int);
+        }
+
+      if (conv.starprec)
+        {
+          (arg++)->i = va_arg(copy, int);
+        }
+
+      switch (conv.type)
+        {
+          case SYSLOG_ARG_INT:
+            arg->i = va_arg(copy, int);
+            break;
+
+          case SYSLOG_ARG_LONG:
+            arg->l = va_arg(copy, long);
+            break;
+
+#ifdef CONFIG_HAVE_LONG_LONG
+          case SYSLOG_ARG_LLONG:
+            arg->ll = va_arg(copy, long long);
+            break;
+#endif
+
+          case SYSLOG_ARG_SIZE:
+            arg->z = va_arg(copy, size_t);
+            break;
+
+          case SYSLOG_ARG_INTMAX:
+            arg->j = va_arg(copy, intmax_t);
+            break;
+
+          case SYSLOG_ARG_PTRDIFF:
+            arg->t = va_arg(copy, ptrdiff_t);
+            break;
+
+#ifdef CONFIG_HAVE_DOUBLE
+          case SYSLOG_ARG_DOUBLE:
+            arg->d = va_arg(copy, double);
+            break;
+#endif
+
+          case SYSLOG_ARG_PTR:
+            arg->p = va_arg(copy, FAR void *);
+            break;
+
+          case SYSLOG_ARG_STRING:
+            str = va_arg(copy, FAR const char *);
+            if (str == NULL)
+              {
+                str = "(null)";
+              }
+
+            if (reclen >= CONFIG_SYSLOG_DEFERRED_RECSIZE)
+              {
+                /* No space at all.  The previous string filled the record,
+                 * so re-use its terminator as an empty string.
+                 */
+
+                arg->z = reclen - 1;
+                break;
+              }
+
+            len = strlen(str);
+            if (len > CONFIG_SYSLOG_DEFERRED_RECSIZE - reclen - 1)
+              {
+                len = CONFIG_SYSLOG_DEFERRED_RECSIZE - reclen - 1;
+              }
+
+            memcpy((FAR char *)rec + reclen, str, len);
+            ((FAR char *)rec)[reclen + len] = '\0';
+            arg->z  = reclen;
+            reclen += len + 1;
+            break;
+        }
+
+      arg++;
+    }
+
+  va_end(copy);
+
+  rec->len = SYSLOG_ALIGNUP(reclen);
+  syslog_ring_add(rec);
+
+  /* Make sure that the drain worker will run */
+
+  if (work_available(&g_syslog_work))
+    {
+      work_queue(LPWORK, &g_syslog_work, syslog_drain_worker, NULL, 0);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: syslog_flush_deferred
+ *
+ * Description:
+ *   Format and output any deferred records immediately.  This is used by
+ *   syslog_flush() when the system crashes.
+ *
+ * Assumptions:
+ *   The drain worker is not running concurrently (the other CPUs have been
+ *   stopped).
+ *
+ ****************************************************************************/
+
+void syslog_flush_deferred(void)
+{
+  syslog_drain();
+}
+
+#endif /* CONFIG_SYSLOG_DEFERRED */
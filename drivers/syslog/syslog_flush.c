@@ -81,6 +81,12 @@ int syslog_flush(void)
 {
   DEBUGASSERT(g_syslog_channel != NULL);
 
+#ifdef CONFIG_SYSLOG_DEFERRED
+  /* Format any messages that are still waiting for the drain worker */
+
+  syslog_flush_deferred();
+#endif
+
 #ifdef CONFIG_SYSLOG_INTBUFFER
   /* Flush any characters that may have been added to the interrupt
    * buffer.
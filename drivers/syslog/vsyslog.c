@@ -49,6 +49,8 @@
 #include <nuttx/streams.h>
 #include <nuttx/syslog/syslog.h>
 
+#include "syslog.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -64,6 +66,11 @@
  *   some compilers and passing of structures in the NuttX sycalls does
  *   not work.
  *
+ *   The number of bytes output is returned.  If CONFIG_SYSLOG_DEFERRED is
+ *   enabled and the message was deferred (or dropped because the buffer
+ *   was full), zero is returned instead:  The message is formatted later
+ *   and its length is not known.
+ *
  ****************************************************************************/
 
 int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
@@ -110,6 +117,26 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
     }
 #endif
 
+#ifdef CONFIG_SYSLOG_DEFERRED
+  /* Unless this is an emergency, let the drain worker format the message
+   * later.  Fall back to formatting it now if it cannot be deferred.
+   */
+
+  if (priority != LOG_EMERG)
+    {
+#ifdef CONFIG_SYSLOG_TIMESTAMP
+      ret = syslog_add_deferred(priority, &ts, fmt, ap);
+#else
+      ret = syslog_add_deferred(priority, NULL, fmt, ap);
+#endif
+
+      if (ret >= 0)
+        {
+          return 0;
+        }
+    }
+#endif
+
   /* Wrap the low-level output in a stream object and let lib_vsprintf
    * do the work.  NOTE that emergency priority output is handled
    * differently.. it will use the SYSLOG emergency stream.
@@ -53,6 +53,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/dirent.h>
 #include <nuttx/fs/ioctl.h>
@@ -61,6 +62,14 @@
 
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_CROMFS)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_CROMFS_CACHE_NBLOCKS
+#  define CONFIG_FS_CROMFS_CACHE_NBLOCKS 0
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -70,11 +79,27 @@
 struct cromfs_file_s
 {
   FAR const struct cromfs_node_s *ff_node;  /* The open file node */
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS == 0
   uint32_t ff_offset;                       /* Cached block offset (zero means none) */
   uint16_t ff_ulen;                         /* Length of decompressed data in cache */
   FAR uint8_t *ff_buffer;                   /* Cached, decompressed data */
+#endif
 };
 
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+/* This structure describes one block in the cache of decompressed blocks
+ * that is shared by all open files.
+ */
+
+struct cromfs_cache_s
+{
+  uint32_t cc_offset;                       /* Block offset (zero means none) */
+  uint32_t cc_lastuse;                      /* Used to find the LRU block */
+  uint16_t cc_ulen;                         /* Length of decompressed data */
+  FAR uint8_t *cc_buffer;                   /* Decompressed data */
+};
+#endif
+
 /* This is the form of the callback from cromfs_foreach_node(): */
 
 typedef CODE int (*cromfs_foreach_t)(FAR const struct cromfs_volume_s *fs,
@@ -114,6 +139,11 @@ static int      cromfs_comparenode(FAR const struct cromfs_volume_s *fs,
 static int      cromfs_findnode(FAR const struct cromfs_volume_s *fs,
                                 FAR const struct cromfs_node_s **node,
                                 FAR const char *relpath);
+static int      cromfs_blkcopy(FAR const struct cromfs_volume_s *fs,
+                               FAR struct cromfs_file_s *ff,
+                               FAR const uint8_t *src, uint16_t clen,
+                               uint16_t ulen, unsigned int copyoffs,
+                               unsigned int copysize, FAR uint8_t *dest);
 
 /* Common file system methods */
 
@@ -193,6 +223,22 @@ const struct mountpt_operations cromfs_operations =
 
 extern const struct cromfs_volume_s g_cromfs_image;
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+/* Since there is only a single CROMFS image, there is also a single cache
+ * of decompressed blocks.  Block buffers are allocated when first needed
+ * and freed when the last mount of the image is unmounted.
+ */
+
+static struct cromfs_cache_s g_cromfs_cache[CONFIG_FS_CROMFS_CACHE_NBLOCKS];
+static sem_t g_cromfs_cachesem = SEM_INITIALIZER(1);
+static uint32_t g_cromfs_cacheuse;
+static unsigned int g_cromfs_nmounts;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -477,6 +523,120 @@ static int cromfs_findnode(FAR const struct cromfs_volume_s *fs,
     }
 }
 
+/****************************************************************************
+ * Name: cromfs_blkcopy
+ *
+ * Description:
+ *   Copy data from a compressed block to the user buffer.  The block is
+ *   only decompressed if it is not already in the cache.
+ *
+ ****************************************************************************/
+
+static int cromfs_blkcopy(FAR const struct cromfs_volume_s *fs,
+                          FAR struct cromfs_file_s *ff,
+                          FAR const uint8_t *src, uint16_t clen,
+                          uint16_t ulen, unsigned int copyoffs,
+                          unsigned int copysize, FAR uint8_t *dest)
+{
+  uint32_t voloffs = cromfs_addr2offset(fs, src);
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+  FAR struct cromfs_cache_s *cc = NULL;
+  uint32_t age = 0;
+  int ret;
+  int i;
+
+  ret = nxsem_wait_uninterruptible(&g_cromfs_cachesem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Look for the block in the cache.  Remember an unused or the least
+   * recently used entry in case it is not there.
+   */
+
+  for (i = 0; i < CONFIG_FS_CROMFS_CACHE_NBLOCKS; i++)
+    {
+      FAR struct cromfs_cache_s *entry = &g_cromfs_cache[i];
+
+      if (entry->cc_offset == voloffs)
+        {
+          cc = entry;
+          break;
+        }
+
+      if (entry->cc_offset == 0)
+        {
+          age = UINT32_MAX;
+          cc  = entry;
+        }
+      else if (g_cromfs_cacheuse - entry->cc_lastuse >= age)
+        {
+          age = g_cromfs_cacheuse - entry->cc_lastuse;
+          cc  = entry;
+        }
+    }
+
+  if (cc->cc_offset != voloffs)
+    {
+      if (cc->cc_buffer == NULL)
+        {
+          cc->cc_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
+          if (cc->cc_buffer == NULL)
+            {
+              nxsem_post(&g_cromfs_cachesem);
+              return -ENOMEM;
+            }
+        }
+
+      cc->cc_ulen   = lzf_decompress(src, clen, cc->cc_buffer,
+                                     fs->cv_bsize);
+      cc->cc_offset = voloffs;
+    }
+
+  cc->cc_lastuse = ++g_cromfs_cacheuse;
+
+  finfo("voloffs=%lu ulen=%u cc_ulen=%u copyoffs=%u copysize=%u\n",
+        (unsigned long)voloffs, ulen, cc->cc_ulen, copyoffs, copysize);
+  DEBUGASSERT(cc->cc_ulen >= (copyoffs + copysize));
+
+  memcpy(dest, &cc->cc_buffer[copyoffs], copysize);
+  nxsem_post(&g_cromfs_cachesem);
+#else
+  /* If the whole block is needed and it is not in the file's buffer, then
+   * we can decompress directly into the user buffer.
+   */
+
+  if (copyoffs == 0 && copysize == ulen && voloffs != ff->ff_offset)
+    {
+      finfo("voloffs=%lu ulen=%u\n", (unsigned long)voloffs, ulen);
+      lzf_decompress(src, clen, dest, fs->cv_bsize);
+      return OK;
+    }
+
+  /* No, we will need to decompress into the our intermediate
+   * decompression buffer.
+   */
+
+  if (voloffs != ff->ff_offset)
+    {
+      ff->ff_ulen   = lzf_decompress(src, clen, ff->ff_buffer,
+                                     fs->cv_bsize);
+      ff->ff_offset = voloffs;
+    }
+
+  finfo("voloffs=%lu ulen=%u ff_ulen=%u copyoffs=%u copysize=%u\n",
+        (unsigned long)voloffs, ulen, ff->ff_ulen, copyoffs, copysize);
+  DEBUGASSERT(ff->ff_ulen >= (copyoffs + copysize));
+
+  /* Then copy to user buffer */
+
+  memcpy(dest, &ff->ff_buffer[copyoffs], copysize);
+#endif
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: cromfs_open
  ****************************************************************************/
@@ -545,6 +705,7 @@ static int cromfs_open(FAR struct file *filep, FAR const char *relpath,
       return -ENOMEM;
     }
 
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS == 0
   /* Create a file buffer to support partial sector accesses */
 
   ff->ff_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
@@ -553,6 +714,7 @@ static int cromfs_open(FAR struct file *filep, FAR const char *relpath,
       kmm_free(ff);
       return -ENOMEM;
     }
+#endif
 
   /* Save the node in the open file instance */
 
@@ -578,11 +740,13 @@ static int cromfs_close(FAR struct file *filep)
   /* Get the open file instance from the file structure */
 
   ff = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Free all resources consumed by the opened file */
 
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS == 0
   kmm_free(ff->ff_buffer);
+#endif
   kmm_free(ff);
 
   return OK;
@@ -609,6 +773,7 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   uint16_t clen;
   unsigned int copysize;
   unsigned int copyoffs;
+  int ret;
 
   finfo("Read %d bytes from offset %d\n", buflen, filep->f_pos);
   DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
@@ -624,7 +789,7 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   /* Get the open file instance from the file structure */
 
   ff = (FAR struct cromfs_file_s *)filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Check for a read past the end of the file */
 
@@ -727,82 +892,31 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
         }
       else
         {
-          /* If the source of the data is at the beginning of the compressed
-           * data buffer and if the uncompressed data would not overrun the
-           * buffer, then we can decompress directly into the user buffer.
+          /* Decompress the block (unless it is already cached) and copy
+           * the requested part of it to the user buffer.
            */
 
-          if (filep->f_pos <= blkoffs && ulen <= remaining)
-            {
-              uint32_t voloffs;
-
-              copyoffs = 0;
-              copysize = ulen;
-
-              /* Get the address and offset in the CROMFS image to obtain
-               * the data.  Check if we already have this offset in the
-               * cache.
-               */
-
-              src     = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
-                {
-                  unsigned int decomplen;
-
-                  decomplen = lzf_decompress(src, clen, dest, fs->cv_bsize);
-
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
-                }
+          copyoffs = (blkoffs >= filep->f_pos) ? 0 : filep->f_pos - blkoffs;
+          DEBUGASSERT(ulen > copyoffs);
+          copysize = ulen - copyoffs;
 
-              finfo("voloffs=%lu blkoffs=%lu ulen=%u ff_offset=%u copysize=%u\n",
-                    (unsigned long)voloffs, (unsigned long)blkoffs, ulen,
-                    ff->ff_offset, copysize);
-              DEBUGASSERT(ff->ff_ulen >= copysize);
-            }
-          else
+          if (copysize > remaining)  /* Clip to the size really needed */
             {
-              uint32_t voloffs;
-
-              /* No, we will need to decompress into the our intermediate
-               * decompression buffer.
-               */
-
-              copyoffs = (blkoffs >= filep->f_pos) ? 0 : filep->f_pos - blkoffs;
-              DEBUGASSERT(ulen > copyoffs);
-              copysize = ulen - copyoffs;
-
-              if (copysize > remaining)  /* Clip to the size really needed */
-                {
-                  copysize = remaining;
-                }
-
-              DEBUGASSERT((copyoffs + copysize) <=  fs->cv_bsize);
-
-              src = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
-                {
-                  unsigned int decomplen;
-
-                  decomplen = lzf_decompress(src, clen, ff->ff_buffer,
-                                             fs->cv_bsize);
-
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
-                }
-
-              finfo("voloffs=%lu blkoffs=%lu ulen=%u clen=%u ff_offset=%u "
-                    "copyoffs=%u copysize=%u\n",
-                    (unsigned long)voloffs, (unsigned long)blkoffs, ulen,
-                    clen, ff->ff_offset, copyoffs, copysize);
-              DEBUGASSERT(ff->ff_ulen >= (copyoffs + copysize));
+              copysize = remaining;
+            }
 
-              /* Then copy to user buffer */
+          DEBUGASSERT((copyoffs + copysize) <=  fs->cv_bsize);
 
-              memcpy(dest, &ff->ff_buffer[copyoffs], copysize);
+          src = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
+          ret = cromfs_blkcopy(fs, ff, src, clen, ulen, copyoffs, copysize,
+                               dest);
+          if (ret < 0)
+            {
+              return ret;
             }
+
+          finfo("blkoffs=%lu ulen=%u clen=%u copyoffs=%u copysize=%u\n",
+                (unsigned long)blkoffs, ulen, clen, copyoffs, copysize);
         }
 
       /* Adjust pointers counts and offset */
@@ -857,7 +971,7 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
   /* Get the open file instance from the file structure */
 
   oldff = oldp->f_priv;
-  DEBUGASSERT(oldff->ff_node != NULL && oldff->ff_buffer != NULL);
+  DEBUGASSERT(oldff->ff_node != NULL);
 
   /* Allocate and initialize an new open file instance referring to the
    * same node.
@@ -869,6 +983,7 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
       return -ENOMEM;
     }
 
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS == 0
   /* Create a file buffer to support partial sector accesses */
 
   newff->ff_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
@@ -877,6 +992,9 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
       kmm_free(newff);
       return -ENOMEM;
     }
+#else
+  UNUSED(fs);
+#endif
 
   /* Save the node in the open file instance */
 
@@ -914,7 +1032,7 @@ static int cromfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
    */
 
   ff              = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   inode           = filep->f_inode;
   fs              = inode->i_private;
@@ -1112,6 +1230,12 @@ static int cromfs_bind(FAR struct inode *blkdriver, const void *data,
   DEBUGASSERT(blkdriver == NULL && handle != NULL);
   DEBUGASSERT(g_cromfs_image.cv_magic == CROMFS_MAGIC);
 
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+  nxsem_wait_uninterruptible(&g_cromfs_cachesem);
+  g_cromfs_nmounts++;
+  nxsem_post(&g_cromfs_cachesem);
+#endif
+
   /* Return the new file system handle */
 
   *handle = (FAR void *)&g_cromfs_image;
@@ -1129,8 +1253,33 @@ static int cromfs_bind(FAR struct inode *blkdriver, const void *data,
 static int cromfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
                         unsigned int flags)
 {
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+  int i;
+#endif
+
   finfo("handle: %p blkdriver: %p flags: %02x\n",
         handle, blkdriver, flags);
+
+#if CONFIG_FS_CROMFS_CACHE_NBLOCKS > 0
+  /* Release the cached blocks when the last mount goes away */
+
+  nxsem_wait_uninterruptible(&g_cromfs_cachesem);
+  if (g_cromfs_nmounts > 0 && --g_cromfs_nmounts == 0)
+    {
+      for (i = 0; i < CONFIG_FS_CROMFS_CACHE_NBLOCKS; i++)
+        {
+          if (g_cromfs_cache[i].cc_buffer != NULL)
+            {
+              kmm_free(g_cromfs_cache[i].cc_buffer);
+            }
+
+          memset(&g_cromfs_cache[i], 0, sizeof(struct cromfs_cache_s));
+        }
+    }
+
+  nxsem_post(&g_cromfs_cachesem);
+#endif
+
   return OK;
 }
 
@@ -42,6 +42,8 @@
 #include <sys/types.h>
 #include <sys/mman.h>
 #include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
 #include <stdint.h>
 #include <errno.h>
 #include <debug.h>
@@ -189,12 +191,29 @@ FAR void *mmap(FAR void *start, size_t length, int prot, int flags,
    * in memory. (casting to uintptr_t first eliminates complaints on some
    * architectures where the sizeof long is different from the size of
    * a pointer).
+   *
+   * A private mapping that cannot be written is indistinguishable from a
+   * shared mapping, so it can also refer directly to the file's memory
+   * rather than to a copy.  But only if that memory never moves, as for a
+   * regular file on an XIP ROMFS volume.  Other file systems may move the
+   * memory of a file, for example tmpfs when a write extends the file.
    */
 
   if ((flags & MAP_PRIVATE) == 0)
     {
       ret = ioctl(fd, FIOC_MMAP, (unsigned long)((uintptr_t)&addr));
     }
+  else if ((prot & PROT_WRITE) == 0)
+    {
+      struct statfs fsbuf;
+      struct stat buf;
+
+      if (fstat(fd, &buf) >= 0 && S_ISREG(buf.st_mode) &&
+          fstatfs(fd, &fsbuf) >= 0 && fsbuf.f_type == ROMFS_MAGIC)
+        {
+          ret = ioctl(fd, FIOC_MMAP, (unsigned long)((uintptr_t)&addr));
+        }
+    }
 
   if (ret < 0)
     {
@@ -207,7 +226,7 @@ FAR void *mmap(FAR void *start, size_t length, int prot, int flags,
        * do much better in the KERNEL build using the MMU.
        */
 
-      return rammap(fd, length, offset);
+      return rammap(fd, length, offset, prot, flags);
 #else
       /* Error out.  The errno value was already set by ioctl() */
 
@@ -0,0 +1,149 @@
+/****************************************************************************
+ * fs/mmap/fs_msync.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/mman.h>
+
+#include <stdint.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+#include "fs_rammap.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: msync
+ *
+ * Description:
+ *   Write the changes made to a MAP_SHARED mapping back to the mapped file.
+ *
+ *   Mappings that refer directly to the media (see mmap()) and regions
+ *   that are not writable or that are mapped MAP_PRIVATE need no
+ *   synchronization.
+ *
+ * Input Parameters:
+ *   addr    The start of the range to synchronize
+ *   len     The length of the range to synchronize
+ *   flags   MS_ASYNC or MS_SYNC, optionally with MS_INVALIDATE.  With
+ *           MS_SYNC, the file is also flushed to the media.  The data is
+ *           written before returning in either case.
+ *
+ * Returned Value:
+ *   On success, msync() returns 0, on failure -1, and errno is set:
+ *
+ *     EINVAL
+ *       'flags' is invalid
+ *
+ ****************************************************************************/
+
+int msync(FAR void *addr, size_t len, int flags)
+{
+#ifdef CONFIG_FS_RAMMAP
+  FAR struct fs_rammap_s *curr;
+  uintptr_t end;
+  int ret;
+#endif
+  int errcode;
+
+  if ((flags & (MS_ASYNC | MS_SYNC)) == (MS_ASYNC | MS_SYNC) ||
+      (flags & ~(MS_ASYNC | MS_SYNC | MS_INVALIDATE)) != 0)
+    {
+      errcode = EINVAL;
+      goto errout;
+    }
+
+#ifdef CONFIG_FS_RAMMAP
+  /* Find the region containing this address */
+
+  rammap_initialize();
+  ret = nxsem_wait(&g_rammaps.exclsem);
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout;
+    }
+
+  for (curr = g_rammaps.head; curr; curr = curr->flink)
+    {
+      if ((uintptr_t)addr >= (uintptr_t)curr->addr &&
+          (uintptr_t)addr < (uintptr_t)curr->addr + curr->length)
+        {
+          break;
+        }
+    }
+
+  /* A range that is not in a copied region is a direct mapping of the
+   * media.  There is nothing to synchronize.
+   */
+
+  if (!curr)
+    {
+      nxsem_post(&g_rammaps.exclsem);
+      return OK;
+    }
+
+  /* Clip the range to the region and write it back */
+
+  end = (uintptr_t)curr->addr + curr->length;
+  if (len > end - (uintptr_t)addr)
+    {
+      len = end - (uintptr_t)addr;
+    }
+
+  ret = rammap_writeback(curr, addr, len);
+  if (ret >= 0 && (flags & MS_SYNC) != 0 &&
+      (curr->flags & RAMMAP_FLAG_WRITEBACK) != 0)
+    {
+      ret = file_fsync(&curr->file);
+      if (ret == -EINVAL || ret == -ENOSYS)
+        {
+          /* The file system does not support sync */
+
+          ret = OK;
+        }
+    }
+
+  nxsem_post(&g_rammaps.exclsem);
+
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout;
+    }
+#endif
+
+  return OK;
+
+errout:
+  set_errno(errcode);
+  return ERROR;
+}
@@ -93,13 +93,19 @@
  *   2. If CONFIG_FS_RAMMAP is defined in the configuration, then mmap() will
  *      support simulation of memory mapped files by copying files whole
  *      into RAM.  munmap() is required in this case to free the allocated
- *      memory holding the shared copy of the file.
+ *      memory holding the shared copy of the file.  The memory is freed
+ *      when the last mapping of the region is removed.  Changes to a
+ *      MAP_SHARED, writable mapping are written back to the file then.
+ *
+ *      A mapping is removed when the range covers all of it.  Otherwise,
+ *      only the end of the only mapping of a region can be unmapped.
+ *
+ *      A mapping that refers directly to the memory of a file (case 1)
+ *      may exist at the same time.  munmap() does nothing for it.
  *
  * Input Parameters:
- *   start   The start address of the mapping to delete.  For this
- *           simplified munmap() implementation, the *must* be the start
- *           address of the memory region (the same address returned by
- *           mmap()).
+ *   start   The start address of the range to delete.  It must be within
+ *           a memory region returned by mmap().
  *   length  The length region to be umapped.
  *
  * Returned Value:
@@ -110,20 +116,23 @@
 
 int munmap(FAR void *start, size_t length)
 {
+  FAR struct fs_rammapping_s *prevmap;
+  FAR struct fs_rammapping_s *mapping;
   FAR struct fs_rammap_s *prev;
   FAR struct fs_rammap_s *curr;
   FAR void *newaddr;
-  unsigned int offset;
+  uintptr_t end;
+  size_t offset;
   int ret;
   int errcode;
 
-  /* Find a region containing this start and length in the list of regions */
+  /* Find the region containing this start address */
 
   rammap_initialize();
   ret = nxsem_wait(&g_rammaps.exclsem);
   if (ret < 0)
     {
-      errcode = ret;
+      errcode = -ret;
       goto errout;
     }
 
@@ -131,75 +140,122 @@ int munmap(FAR void *start, size_t length)
 
   for (prev = NULL, curr = g_rammaps.head; curr; prev = curr, curr = curr->flink)
     {
-      /* Does this region include any part of the specified range? */
-
-      if ((uintptr_t)start < (uintptr_t)curr->addr + curr->length &&
-          (uintptr_t)start + length >= (uintptr_t)curr->addr)
+      if ((uintptr_t)start >= (uintptr_t)curr->addr &&
+          (uintptr_t)start < (uintptr_t)curr->addr + curr->length)
         {
           break;
         }
     }
 
-  /* Did we find the region */
+  /* Did we find the region?  If not, the range may refer directly to the
+   * memory of a file (such as a file on an XIP ROMFS volume), which does
+   * not have to be unmapped.  As on other systems, it is not an error to
+   * unmap a range that contains no mapping.
+   */
 
   if (!curr)
     {
-      ferr("ERROR: Region not found\n");
-      errcode = EINVAL;
-      goto errout_with_semaphore;
+      finfo("Region not found\n");
+      nxsem_post(&g_rammaps.exclsem);
+      return OK;
     }
 
-  /* Get the offset from the beginning of the region and the actual number
-   * of bytes to "unmap".  All mappings must extend to the end of the region.
-   * There is no support for free a block of memory but leaving a block of
-   * memory at the end.  This is a consequence of using kumm_realloc() to
-   * simulate the unmapping.
-   */
+  /* The range must lie within the region */
 
-  offset = start - curr->addr;
-  if (offset + length < curr->length)
+  offset = (FAR uint8_t *)start - (FAR uint8_t *)curr->addr;
+  if (length == 0 || length > curr->length - offset)
     {
-      ferr("ERROR: Cannot umap without unmapping to the end\n");
-      errcode = ENOSYS;
+      ferr("ERROR: Range is not within the region\n");
+      errcode = EINVAL;
       goto errout_with_semaphore;
     }
 
-  /* Okay.. the region is beging umapped to the end.  Make sure the length
-   * indicates that.
-   */
+  end = (uintptr_t)start + length;
 
-  length = curr->length - offset;
+  /* Is there a mapping of the region that is removed entirely? */
 
-  /* Are we unmapping the entire region (offset == 0)? */
+  for (prevmap = NULL, mapping = curr->mappings;
+       mapping != NULL;
+       prevmap = mapping, mapping = mapping->flink)
+    {
+      if ((uintptr_t)mapping->addr >= (uintptr_t)start &&
+          (uintptr_t)mapping->addr + mapping->length <= end)
+        {
+          break;
+        }
+    }
 
-  if (length >= curr->length)
+  if (mapping != NULL)
     {
-      /* Yes.. remove the mapping from the list */
+      /* Yes.. remove it.  The region persists until the last mapping of it
+       * is removed.
+       */
 
-      if (prev)
+      if (prevmap)
         {
-          prev->flink = curr->flink;
+          prevmap->flink = mapping->flink;
         }
       else
         {
-          g_rammaps.head = curr->flink;
+          curr->mappings = mapping->flink;
         }
 
-      /* Then free the region */
+      kmm_free(mapping);
 
-      kumm_free(curr);
+      if (curr->mappings == NULL)
+        {
+          /* That was the last mapping.  Remove the region from the list */
+
+          if (prev)
+            {
+              prev->flink = curr->flink;
+            }
+          else
+            {
+              g_rammaps.head = curr->flink;
+            }
+
+          /* Then write back and free the region */
+
+          rammap_release(curr);
+        }
+
+      nxsem_post(&g_rammaps.exclsem);
+      return OK;
+    }
+
+  /* No.. We have been asked to "unmap' only a portion of a mapping.  That
+   * is only possible at the end of the only mapping of the region:  There
+   * is no support for freeing a block of memory but leaving a block of
+   * memory at the end.  This is a consequence of using kumm_realloc() to
+   * simulate the unmapping.
+   */
+
+  mapping = curr->mappings;
+  if (mapping->flink != NULL ||
+      (uintptr_t)start <= (uintptr_t)mapping->addr ||
+      end < (uintptr_t)mapping->addr + mapping->length)
+    {
+      ferr("ERROR: Cannot umap without unmapping to the end\n");
+      errcode = ENOSYS;
+      goto errout_with_semaphore;
     }
 
-  /* No.. We have been asked to "unmap' only a portion of the memory
-   * (offset > 0).
+  /* Write back the part being unmapped and keep the first 'offset' bytes
+   * of the region.
    */
 
-  else
+  rammap_writeback(curr, start, curr->length - offset);
+
+  newaddr = kumm_realloc(curr, sizeof(struct fs_rammap_s) + offset);
+  DEBUGASSERT(newaddr == (FAR void *)curr);
+  UNUSED(newaddr); /* May not be used */
+
+  curr->length    = offset;
+  mapping->length = (FAR uint8_t *)start - (FAR uint8_t *)mapping->addr;
+  if (curr->datalen > offset)
     {
-      newaddr = kumm_realloc(curr->addr, sizeof(struct fs_rammap_s) + length);
-      DEBUGASSERT(newaddr == (FAR void *)(curr->addr));
-      UNUSED(newaddr); /* May not be used */
-      curr->length = length;
+      curr->datalen = offset;
     }
 
   nxsem_post(&g_rammaps.exclsem);
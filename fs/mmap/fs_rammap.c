@@ -42,7 +42,9 @@
 #include <sys/types.h>
 #include <sys/mman.h>
 
+#include <stdbool.h>
 #include <string.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <errno.h>
 #include <debug.h>
@@ -90,17 +92,125 @@ void rammap_initialize(void)
     }
 }
 
+/****************************************************************************
+ * Name: rammap_writeback
+ *
+ * Description:
+ *   Write part of a MAP_SHARED, writable region back to the mapped file.
+ *   Only the part of the region that was read from the file is written, so
+ *   that the file is not extended.  The caller must hold g_rammaps.exclsem.
+ *
+ * Input Parameters:
+ *   map     The region
+ *   addr    The start of the range to write back
+ *   length  The length of the range to write back
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int rammap_writeback(FAR struct fs_rammap_s *map, FAR const void *addr,
+                     size_t length)
+{
+  FAR const uint8_t *wrbuffer = (FAR const uint8_t *)addr;
+  size_t pos = wrbuffer - (FAR const uint8_t *)map->addr;
+  off_t offset;
+  ssize_t nwritten;
+
+  if ((map->flags & RAMMAP_FLAG_WRITEBACK) == 0 || pos >= map->datalen)
+    {
+      return OK;
+    }
+
+  /* The region beyond the end of the file was zero-filled by rammap() and
+   * is not written back.
+   */
+
+  if (length > map->datalen - pos)
+    {
+      length = map->datalen - pos;
+    }
+
+  offset = map->offset + pos;
+  while (length > 0)
+    {
+      nwritten = file_pwrite(&map->file, wrbuffer, length, offset);
+      if (nwritten < 0)
+        {
+          if (nwritten == -EINTR)
+            {
+              continue;
+            }
+
+          ferr("ERROR: Write failed: offset=%d errno=%d\n",
+               (int)offset, (int)nwritten);
+          return (int)nwritten;
+        }
+
+      wrbuffer += nwritten;
+      length   -= nwritten;
+      offset   += nwritten;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: rammap_release
+ *
+ * Description:
+ *   Write back a region if necessary, release the file and inode references
+ *   that it holds, and free it and its mappings.  The region must already
+ *   have been removed from the list.
+ *
+ * Input Parameters:
+ *   map     The region to be released
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void rammap_release(FAR struct fs_rammap_s *map)
+{
+  FAR struct fs_rammapping_s *mapping;
+
+  if ((map->flags & RAMMAP_FLAG_WRITEBACK) != 0)
+    {
+      rammap_writeback(map, map->addr, map->length);
+      file_close(&map->file);
+    }
+
+  if (map->inode != NULL)
+    {
+      inode_release(map->inode);
+    }
+
+  while ((mapping = map->mappings) != NULL)
+    {
+      map->mappings = mapping->flink;
+      kmm_free(mapping);
+    }
+
+  kumm_free(map);
+}
+
 /****************************************************************************
  * Name: rammmap
  *
  * Description:
  *   Support simulation of memory mapped files by copying files into RAM.
+ *   If the same part of the file is already mapped, the existing region is
+ *   shared.
  *
  * Input Parameters:
  *   fd      file descriptor of the backing file -- required.
  *   length  The length of the mapping.  For exception #1 above, this length
  *           ignored:  The entire underlying media is always accessible.
  *   offset  The offset into the file to map
+ *   prot    The requested memory protection
+ *   flags   The mapping flags (MAP_SHARED or MAP_PRIVATE)
  *
  * Returned Value:
  *   On success, rammmap() returns a pointer to the mapped area. On error, the
@@ -115,37 +225,110 @@ void rammap_initialize(void)
  *
  ****************************************************************************/
 
-FAR void *rammap(int fd, size_t length, off_t offset)
+FAR void *rammap(int fd, size_t length, off_t offset, int prot, int flags)
 {
+  FAR struct fs_rammapping_s *mapping;
   FAR struct fs_rammap_s *map;
+  FAR struct file *filep;
   FAR uint8_t *alloc;
   FAR uint8_t *rdbuffer;
+  bool writeback;
+  bool shared;
   ssize_t nread;
-  off_t fpos;
+  size_t remaining;
   int errcode;
   int ret;
 
-  /* There is a major design flaw that I have not yet thought of fix for:
-   * The goal is to have a single region of memory that represents a single
-   * file and can be shared by many threads.  That is, given a filename a
-   * thread should be able to open the file, get a file descriptor, and
-   * call mmap() to get a memory region.  Different file descriptors opened
-   * with the same file path should get the same memory region when mapped.
-   *
-   * The design flaw is that I don't have sufficient knowledge to know that
-   * these different file descriptors map to the same file.  So, for the time
-   * being, a new memory region is created each time that rammap() is called.
-   * Not very useful!
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout;
+    }
+
+  /* A writable, private mapping needs its own copy of the file.  Any other
+   * mapping can share a region with other mappings of the same file.
    */
 
-  /* Allocate a region of memory of the specified size */
+  writeback = (flags & MAP_SHARED) != 0 && (prot & PROT_WRITE) != 0;
+  shared    = (flags & MAP_PRIVATE) == 0 || (prot & PROT_WRITE) == 0;
+
+  if (writeback && (filep->f_oflags & O_WROK) == 0)
+    {
+      errcode = EACCES;
+      goto errout;
+    }
+
+  /* Each mapping is recorded in the region that it maps */
+
+  mapping = (FAR struct fs_rammapping_s *)
+    kmm_malloc(sizeof(struct fs_rammapping_s));
+  if (mapping == NULL)
+    {
+      errcode = ENOMEM;
+      goto errout;
+    }
+
+  mapping->length = length;
+
+  rammap_initialize();
+  ret = nxsem_wait(&g_rammaps.exclsem);
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout_with_mapping;
+    }
+
+  /* Is this part of the file already mapped? */
+
+  if (shared)
+    {
+      for (map = g_rammaps.head; map != NULL; map = map->flink)
+        {
+          if ((map->flags & RAMMAP_FLAG_SHARED) != 0 &&
+              map->inode == filep->f_inode &&
+              map->offset <= offset &&
+              map->offset + map->length >= offset + length)
+            {
+              break;
+            }
+        }
+
+      if (map != NULL)
+        {
+          /* Yes.. If changes must now be written back to the file, then
+           * the region needs its own reference to the file.
+           */
+
+          if (writeback && (map->flags & RAMMAP_FLAG_WRITEBACK) == 0)
+            {
+              ret = file_dup2(filep, &map->file);
+              if (ret < 0)
+                {
+                  errcode = -ret;
+                  goto errout_with_semaphore;
+                }
+
+              map->flags |= RAMMAP_FLAG_WRITEBACK;
+            }
+
+          mapping->addr  = (FAR uint8_t *)map->addr + (offset - map->offset);
+          mapping->flink = map->mappings;
+          map->mappings  = mapping;
+          nxsem_post(&g_rammaps.exclsem);
+
+          return mapping->addr;
+        }
+    }
+
+  /* No.. Allocate a region of memory of the specified size */
 
   alloc = (FAR uint8_t *)kumm_malloc(sizeof(struct fs_rammap_s) + length);
   if (!alloc)
     {
       ferr("ERROR: Region allocation failed, length: %d\n", (int)length);
       errcode = ENOMEM;
-      goto errout;
+      goto errout_with_semaphore;
     }
 
   /* Initialize the region */
@@ -155,27 +338,19 @@ FAR void *rammap(int fd, size_t length, off_t offset)
   map->addr   = alloc + sizeof(struct fs_rammap_s);
   map->length = length;
   map->offset = offset;
+  map->flags  = shared ? RAMMAP_FLAG_SHARED : 0;
 
-  /* Seek to the specified file offset */
-
-  fpos = lseek(fd, offset,  SEEK_SET);
-  if (fpos == (off_t)-1)
-    {
-      /* Seek failed... errno has already been set, but EINVAL is probably
-       * the correct response.
-       */
-
-      ferr("ERROR: Seek to position %d failed\n", (int)offset);
-      errcode = EINVAL;
-      goto errout_with_region;
-    }
-
-  /* Read the file data into the memory region */
+  /* Read the file data into the memory region.  In the flat address space
+   * there is no way to fault in parts of the region on first access, so
+   * all of it is read now.  The lock is held so that other mappers of the
+   * same region wait for it to be filled rather than read it again.
+   */
 
-  rdbuffer = map->addr;
-  while (length > 0)
+  rdbuffer  = map->addr;
+  remaining = length;
+  while (remaining > 0)
     {
-      nread = nx_read(fd, rdbuffer, length);
+      nread = file_pread(filep, rdbuffer, remaining, offset);
       if (nread < 0)
         {
           /* Handle the special case where the read was interrupted by a
@@ -192,6 +367,8 @@ FAR void *rammap(int fd, size_t length, off_t offset)
               errcode = (int)-nread;
               goto errout_with_region;
             }
+
+          continue;
         }
 
       /* Check for end of file. */
@@ -203,33 +380,68 @@ FAR void *rammap(int fd, size_t length, off_t offset)
 
       /* Increment number of bytes read */
 
-      rdbuffer += nread;
-      length   -= nread;
+      rdbuffer  += nread;
+      remaining -= nread;
+      offset    += nread;
     }
 
   /* Zero any memory beyond the amount read from the file */
 
-  memset(rdbuffer, 0, length);
+  memset(rdbuffer, 0, remaining);
+  map->datalen = length - remaining;
 
-  /* Add the buffer to the list of regions */
+  /* Hold a reference to the inode so that the key remains valid.  A
+   * MAP_SHARED, writable region also needs the file to write back to.
+   */
 
-  rammap_initialize();
-  ret = nxsem_wait(&g_rammaps.exclsem);
+  if (writeback)
+    {
+      ret = file_dup2(filep, &map->file);
+      if (ret < 0)
+        {
+          errcode = -ret;
+          goto errout_with_region;
+        }
+
+      map->flags |= RAMMAP_FLAG_WRITEBACK;
+    }
+
+  ret = inode_addref(filep->f_inode);
   if (ret < 0)
     {
       errcode = -ret;
-      goto errout_with_region;
+      goto errout_with_file;
     }
 
+  map->inode = filep->f_inode;
+
+  mapping->addr  = map->addr;
+  mapping->flink = NULL;
+  map->mappings  = mapping;
+
+  /* Add the buffer to the list of regions */
+
   map->flink  = g_rammaps.head;
   g_rammaps.head = map;
 
   nxsem_post(&g_rammaps.exclsem);
   return map->addr;
 
+errout_with_file:
+  if ((map->flags & RAMMAP_FLAG_WRITEBACK) != 0)
+    {
+      file_close(&map->file);
+    }
+
 errout_with_region:
   kumm_free(alloc);
 
+errout_with_semaphore:
+  nxsem_post(&g_rammaps.exclsem);
+
+errout_with_mapping:
+  kmm_free(mapping);
+
 errout:
   set_errno(errcode);
   return MAP_FAILED;
@@ -46,9 +46,19 @@
 
 #include <sys/types.h>
 #include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
 
 #ifdef CONFIG_FS_RAMMAP
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Values for the fs_rammap_s flags field */
+
+#define RAMMAP_FLAG_SHARED    (1 << 0) /* Region may be shared by mappers */
+#define RAMMAP_FLAG_WRITEBACK (1 << 1) /* msync() writes region to the file */
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -65,17 +75,36 @@
  * - All of the file must be present in memory.  This limits the size of
  *   files that may be memory mapped (especially on MCUs with no significant
  *   RAM resources).
- * - All mapped files are read-only.  You can write to the in-memory image,
- *   but the file contents will not change.
+ * - Changes to a MAP_SHARED mapping are written to the file only by
+ *   msync() or when the last mapping of the region is removed.  Changes
+ *   made to the file with write() are not seen by existing regions.
  * - There are not access privileges.
+ *
+ * Regions are identified by the inode of the mapped file and the file
+ * offset, so that mappings of the same part of the same file share the same
+ * memory.  A region that is mapped privately and writable is never shared.
+ * Each mapping of a region is recorded so that munmap() can tell when one
+ * of them is removed entirely.
  */
 
+struct fs_rammapping_s
+{
+  FAR struct fs_rammapping_s *flink; /* Implements a singly linked list */
+  FAR void           *addr;        /* Address returned by mmap() */
+  size_t              length;      /* Length of the mapping */
+};
+
 struct fs_rammap_s
 {
   struct fs_rammap_s *flink;       /* Implements a singly linked list */
   FAR void           *addr;        /* Start of allocated memory */
   size_t              length;      /* Length of region */
+  size_t              datalen;     /* Length of the file data in the region */
   off_t               offset;      /* File offset */
+  FAR struct inode   *inode;       /* The mapped file (holds a reference) */
+  FAR struct fs_rammapping_s *mappings; /* The mappings of the region */
+  uint8_t             flags;       /* See RAMMAP_FLAG_* definitions */
+  struct file         file;        /* Used to write back shared mappings */
 };
 
 /* This structure defines all "mapped" files */
@@ -115,17 +144,60 @@ extern struct fs_allmaps_s g_rammaps;
 
 void rammap_initialize(void);
 
+/****************************************************************************
+ * Name: rammap_writeback
+ *
+ * Description:
+ *   Write part of a MAP_SHARED, writable region back to the mapped file.
+ *   Only the part of the region that was read from the file is written, so
+ *   that the file is not extended.  The caller must hold g_rammaps.exclsem.
+ *
+ * Input Parameters:
+ *   map     The region
+ *   addr    The start of the range to write back
+ *   length  The length of the range to write back
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int rammap_writeback(FAR struct fs_rammap_s *map, FAR const void *addr,
+                     size_t length);
+
+/****************************************************************************
+ * Name: rammap_release
+ *
+ * Description:
+ *   Write back a region if necessary, release the file and inode references
+ *   that it holds, and free it and its mappings.  The region must already
+ *   have been removed from the list.
+ *
+ * Input Parameters:
+ *   map     The region to be released
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void rammap_release(FAR struct fs_rammap_s *map);
+
 /****************************************************************************
  * Name: rammmap
  *
  * Description:
  *   Support simulation of memory mapped files by copying files into RAM.
+ *   If the same part of the file is already mapped, the existing region is
+ *   shared.
  *
  * Input Parameters:
  *   fd      file descriptor of the backing file -- required.
  *   length  The length of the mapping.  For exception #1 above, this length
  *           ignored:  The entire underlying media is always accessible.
  *   offset  The offset into the file to map
+ *   prot    The requested memory protection
+ *   flags   The mapping flags (MAP_SHARED or MAP_PRIVATE)
  *
  * Returned Value:
  *   On success, rammmap() returns a pointer to the mapped area. On error, the
@@ -140,7 +212,7 @@ void rammap_initialize(void);
  *
  ****************************************************************************/
 
-FAR void *rammap(int fd, size_t length, off_t offset);
+FAR void *rammap(int fd, size_t length, off_t offset, int prot, int flags);
 
 #endif /* CONFIG_FS_RAMMAP */
 #endif /* __FS_MMAP_RAMMAP_H */
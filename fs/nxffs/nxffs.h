@@ -50,9 +50,14 @@
 #include <stdbool.h>
 
 #include <nuttx/mtd/mtd.h>
+#include <nuttx/fs/fs.h>
 #include <nuttx/fs/nxffs.h>
 #include <nuttx/semaphore.h>
 
+#ifdef CONFIG_NXFFS_BGPACK
+#  include <nuttx/wqueue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -133,7 +138,9 @@
  *    open flag is not supported.
  * 6. The re-packing process occurs only during a write when the free FLASH
  *    memory at the end of the FLASH is exhausted.  Thus, occasionally, file
- *    writing may take a long time.
+ *    writing may take a long time.  CONFIG_NXFFS_BGPACK mitigates this by
+ *    also packing the volume on the low priority work queue when it is
+ *    idle.
  * 7. Another limitation is that there can be only a single NXFFS volume
  *    mounted at any time.  This has to do with the fact that we bind to
  *    an MTD driver (instead of a block driver) and bypass all of the normal
@@ -185,6 +192,17 @@
 
 #define NXFFS_NERASED             128
 
+/* Background packing */
+
+#ifdef CONFIG_NXFFS_BGPACK
+#  ifndef CONFIG_NXFFS_BGPACK_IDLEMS
+#    define CONFIG_NXFFS_BGPACK_IDLEMS 500
+#  endif
+#  ifndef CONFIG_NXFFS_BGPACK_THRESHOLD
+#    define CONFIG_NXFFS_BGPACK_THRESHOLD 25
+#  endif
+#endif
+
 /* Quasi-standard definitions */
 
 #ifndef MIN
@@ -302,6 +320,14 @@ struct nxffs_volume_s
   FAR struct nxffs_ofile_s *ofiles;    /* A singly-linked list of open files */
   FAR uint8_t              *cache;     /* On cached erase block for general I/O */
   FAR uint8_t              *pack;      /* A full erase block to support packing */
+#ifdef CONFIG_NXFFS_BGPACK
+  struct work_s             bgwork;    /* Supports background packing */
+  clock_t                   lastio;    /* Time of the last write or delete */
+  bool                      bgenable;  /* True: Background packing is enabled */
+  bool                      bgdirty;   /* True: Inodes deleted since last pack */
+  bool                      bgactive;  /* True: Pack started by the bg worker */
+  struct fs_gcstats_s       gcstats;   /* Packing statistics */
+#endif
 };
 
 /* This structure describes the state of the blocks on the NXFFS volume */
@@ -1082,6 +1108,99 @@ int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name);
 
 int nxffs_pack(FAR struct nxffs_volume_s *volume);
 
+/****************************************************************************
+ * Name: nxffs_bgpack_schedule
+ *
+ * Description:
+ *   Note write or delete activity on the volume and (re-)schedule the
+ *   background packing work.  Packing will not actually be performed until
+ *   the volume has been idle for CONFIG_NXFFS_BGPACK_IDLEMS milliseconds.
+ *
+ * Input Parameters:
+ *   volume - The volume that was modified.
+ *   dirty  - True: An inode was deleted, so there may be FLASH to recover.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Defined in nxffs_bgpack.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BGPACK
+void nxffs_bgpack_schedule(FAR struct nxffs_volume_s *volume, bool dirty);
+#endif
+
+/****************************************************************************
+ * Name: nxffs_bgpack_ioctl
+ *
+ * Description:
+ *   Handle the FIOC_BGGC and FIOC_GCSTATS IOCTL commands.  The caller holds
+ *   the volume exclsem.
+ *
+ * Input Parameters:
+ *   volume - The volume of interest
+ *   cmd    - The IOCTL command
+ *   arg    - The IOCTL argument
+ *
+ * Returned Value:
+ *   Zero on success; -ENOTTY if the command is not a background packing
+ *   command.
+ *
+ * Defined in nxffs_bgpack.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BGPACK
+int nxffs_bgpack_ioctl(FAR struct nxffs_volume_s *volume, int cmd,
+                       unsigned long arg);
+#endif
+
+/****************************************************************************
+ * Name: nxffs_bgpack_stop
+ *
+ * Description:
+ *   Disable background packing of a volume that is being unmounted.  The
+ *   pending work is cancelled and a pack that is in progress is waited
+ *   for.
+ *
+ * Input Parameters:
+ *   volume - The volume being unmounted
+ *
+ * Returned Value:
+ *   None
+ *
+ * Defined in nxffs_bgpack.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_BGPACK
+void nxffs_bgpack_stop(FAR struct nxffs_volume_s *volume);
+#endif
+
+/****************************************************************************
+ * Name: nxffs_gcstats
+ *
+ * Description:
+ *   Return the packing statistics of the NXFFS volume.  This is used by the
+ *   procfs file system.
+ *
+ * Input Parameters:
+ *   index - The index of the volume.  There is only volume 0.
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -ENOENT is returned if there is no
+ *   volume with this index.
+ *
+ * Defined in nxffs_bgpack.c
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NXFFS_BGPACK) && defined(CONFIG_NXFFS_PREALLOCATED)
+int nxffs_gcstats(int index, FAR struct fs_gcstats_s *stats);
+#endif
+
 /****************************************************************************
  * Standard mountpoint operation methods
  *
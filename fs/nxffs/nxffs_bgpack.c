@@ -0,0 +1,342 @@
+/****************************************************************************
+ * fs/nxffs/nxffs_bgpack.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/fs/ioctl.h>
+
+#include "nxffs.h"
+
+#ifdef CONFIG_NXFFS_BGPACK
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define NXFFS_BGPACK_IDLE  MSEC2TICK(CONFIG_NXFFS_BGPACK_IDLEMS)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_bgpack_needed
+ *
+ * Description:
+ *   Return true if the free FLASH at the end of the volume has fallen below
+ *   the configured threshold.
+ *
+ ****************************************************************************/
+
+static bool nxffs_bgpack_needed(FAR struct nxffs_volume_s *volume)
+{
+  off_t volsize = volume->nblocks * volume->geo.blocksize;
+  off_t avail   = volsize - volume->froffset;
+
+  if (avail <= 0)
+    {
+      return true;
+    }
+
+  return (avail * 100) / volsize < CONFIG_NXFFS_BGPACK_THRESHOLD;
+}
+
+/****************************************************************************
+ * Name: nxffs_bgpack_worker
+ *
+ * Description:
+ *   Runs on the low priority work queue.  If the volume has been idle for
+ *   long enough and there is no writer, pack the volume.
+ *
+ *   Packing cannot be broken into smaller steps:  Until the pass completes,
+ *   inodes that have been moved are also still present at their old
+ *   location.  So the whole pass is done here, while holding the volume,
+ *   but it is done only when no writer is waiting for it.
+ *
+ ****************************************************************************/
+
+static void nxffs_bgpack_worker(FAR void *arg)
+{
+  FAR struct nxffs_volume_s *volume = (FAR struct nxffs_volume_s *)arg;
+  clock_t elapsed;
+  int ret;
+
+  DEBUGASSERT(volume != NULL);
+
+  /* Don't compete with a writer.  The work will be re-scheduled when the
+   * writer closes the file.  Note that wrsem is ALWAYS taken before
+   * exclsem.
+   *
+   * Nothing else is done without holding both:  That is how
+   * nxffs_bgpack_stop() knows that the work will not re-queue itself.
+   */
+
+  ret = nxsem_trywait(&volume->wrsem);
+  if (ret < 0)
+    {
+      return;
+    }
+
+  ret = nxsem_wait(&volume->exclsem);
+  if (ret < 0)
+    {
+      goto errout_with_wrsem;
+    }
+
+  if (!volume->bgenable)
+    {
+      goto errout_with_exclsem;
+    }
+
+  /* Has the volume been idle for long enough?  If not, try again when it
+   * might have been.
+   */
+
+  elapsed = clock_systimer() - volume->lastio;
+  if (elapsed < NXFFS_BGPACK_IDLE)
+    {
+      work_queue(LPWORK, &volume->bgwork, nxffs_bgpack_worker, volume,
+                 NXFFS_BGPACK_IDLE - elapsed);
+      goto errout_with_exclsem;
+    }
+
+  if (volume->bgdirty && nxffs_bgpack_needed(volume))
+    {
+      finfo("Background pack: froffset=%ld\n", (long)volume->froffset);
+
+      volume->bgactive = true;
+      ret = nxffs_pack(volume);
+      volume->bgactive = false;
+
+      if (ret < 0)
+        {
+          ferr("ERROR: Background pack failed: %d\n", ret);
+        }
+      else
+        {
+          volume->bgdirty = false;
+        }
+    }
+
+errout_with_exclsem:
+  nxsem_post(&volume->exclsem);
+
+errout_with_wrsem:
+  nxsem_post(&volume->wrsem);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_bgpack_schedule
+ *
+ * Description:
+ *   Note write or delete activity on the volume and (re-)schedule the
+ *   background packing work.  Packing will not actually be performed until
+ *   the volume has been idle for CONFIG_NXFFS_BGPACK_IDLEMS milliseconds.
+ *
+ * Input Parameters:
+ *   volume - The volume that was modified.
+ *   dirty  - True: An inode was deleted, so there may be FLASH to recover.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxffs_bgpack_schedule(FAR struct nxffs_volume_s *volume, bool dirty)
+{
+  volume->lastio = clock_systimer();
+  if (dirty)
+    {
+      volume->bgdirty = true;
+    }
+
+  /* If the work is already pending, it will notice the new lastio value
+   * and postpone itself.
+   */
+
+  if (volume->bgenable && volume->bgdirty && work_available(&volume->bgwork))
+    {
+      work_queue(LPWORK, &volume->bgwork, nxffs_bgpack_worker, volume,
+                 NXFFS_BGPACK_IDLE);
+    }
+}
+
+/****************************************************************************
+ * Name: nxffs_bgpack_ioctl
+ *
+ * Description:
+ *   Handle the FIOC_BGGC and FIOC_GCSTATS IOCTL commands.  The caller holds
+ *   the volume exclsem.
+ *
+ * Input Parameters:
+ *   volume - The volume of interest
+ *   cmd    - The IOCTL command
+ *   arg    - The IOCTL argument
+ *
+ * Returned Value:
+ *   Zero on success; -ENOTTY if the command is not a background packing
+ *   command.
+ *
+ ****************************************************************************/
+
+int nxffs_bgpack_ioctl(FAR struct nxffs_volume_s *volume, int cmd,
+                       unsigned long arg)
+{
+  switch (cmd)
+    {
+      /* Enable or disable background packing.
+       * IN:  Non-zero to enable, zero to disable.
+       * OUT: None
+       */
+
+      case FIOC_BGGC:
+        {
+          volume->bgenable = (arg != 0);
+          if (volume->bgenable)
+            {
+              nxffs_bgpack_schedule(volume, false);
+            }
+          else
+            {
+              work_cancel(LPWORK, &volume->bgwork);
+            }
+        }
+        break;
+
+      /* Return packing statistics.
+       * IN:  A pointer to a writable instance of struct fs_gcstats_s
+       * OUT: The statistics
+       */
+
+      case FIOC_GCSTATS:
+        {
+          FAR struct fs_gcstats_s *stats =
+            (FAR struct fs_gcstats_s *)((uintptr_t)arg);
+
+          if (stats == NULL)
+            {
+              return -EINVAL;
+            }
+
+          memcpy(stats, &volume->gcstats, sizeof(struct fs_gcstats_s));
+          stats->gc_bgenabled = volume->bgenable;
+        }
+        break;
+
+      default:
+        return -ENOTTY;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxffs_bgpack_stop
+ *
+ * Description:
+ *   Disable background packing of a volume that is being unmounted.  The
+ *   pending work is cancelled and a pack that is in progress is waited
+ *   for.
+ *
+ * Input Parameters:
+ *   volume - The volume being unmounted
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxffs_bgpack_stop(FAR struct nxffs_volume_s *volume)
+{
+  /* The worker holds wrsem and exclsem while it runs, so taking them waits
+   * for it.  A worker that was already dequeued but has not yet taken them
+   * will find background packing disabled and return without re-queuing.
+   */
+
+  nxsem_wait_uninterruptible(&volume->wrsem);
+  nxsem_wait_uninterruptible(&volume->exclsem);
+
+  volume->bgenable = false;
+  work_cancel(LPWORK, &volume->bgwork);
+
+  nxsem_post(&volume->exclsem);
+  nxsem_post(&volume->wrsem);
+}
+
+/****************************************************************************
+ * Name: nxffs_gcstats
+ *
+ * Description:
+ *   Return the packing statistics of the NXFFS volume.  This is used by the
+ *   procfs file system.
+ *
+ * Input Parameters:
+ *   index - The index of the volume.  There is only volume 0.
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -ENOENT is returned if there is no
+ *   volume with this index.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_PREALLOCATED
+int nxffs_gcstats(int index, FAR struct fs_gcstats_s *stats)
+{
+  FAR struct nxffs_volume_s *volume = &g_volume;
+  int ret;
+
+  /* The volume will not have been initialized if NXFFS has never been
+   * mounted.
+   */
+
+  if (index != 0 || volume->mtd == NULL)
+    {
+      return -ENOENT;
+    }
+
+  ret = nxsem_wait(&volume->exclsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  nxffs_bgpack_ioctl(volume, FIOC_GCSTATS, (unsigned long)stats);
+  nxsem_post(&volume->exclsem);
+  return OK;
+}
+#endif
+
+#endif /* CONFIG_NXFFS_BGPACK */
@@ -189,6 +189,12 @@ int nxffs_initialize(FAR struct mtd_dev_s *mtd)
   nxsem_init(&volume->exclsem, 0, 1);
   nxsem_init(&volume->wrsem, 0, 1);
 
+#ifdef CONFIG_NXFFS_BGPACK
+  /* Background packing is enabled by default */
+
+  volume->bgenable = true;
+#endif
+
   /* Get the volume geometry. (casting to uintptr_t first eliminates
    * complaints on some architectures where the sizeof long is different
    * from the size of a pointer).
@@ -538,6 +544,12 @@ int nxffs_bind(FAR struct inode *blkdriver, FAR const void *data,
 
   DEBUGASSERT(g_volume.cache);
   *handle = &g_volume;
+
+#ifdef CONFIG_NXFFS_BGPACK
+  /* Background packing was disabled when the volume was last unmounted */
+
+  g_volume.bgenable = true;
+#endif
 #endif
   return OK;
 }
@@ -565,6 +577,17 @@ int nxffs_unbind(FAR void *handle, FAR struct inode **blkdriver,
       return -ENOSYS;
     }
 
-  return g_volume.ofiles ? -EBUSY : OK;
+  if (g_volume.ofiles)
+    {
+      return -EBUSY;
+    }
+
+#ifdef CONFIG_NXFFS_BGPACK
+  /* Background packing must not touch the volume once it is unmounted */
+
+  nxffs_bgpack_stop(&g_volume);
+#endif
+
+  return OK;
 #endif
 }
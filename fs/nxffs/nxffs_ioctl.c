@@ -91,7 +91,9 @@ int nxffs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       goto errout;
     }
 
-  /* Only a reformat and optimize commands are supported */
+  /* Only reformat, optimize, and background packing commands are
+   * supported
+   */
 
   if (cmd == FIOC_REFORMAT)
     {
@@ -121,6 +123,16 @@ int nxffs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
     }
   else
     {
+#ifdef CONFIG_NXFFS_BGPACK
+      /* Background packing controls and statistics */
+
+      ret = nxffs_bgpack_ioctl(volume, cmd, arg);
+      if (ret != -ENOTTY)
+        {
+          goto errout_with_semaphore;
+        }
+#endif
+
       /* Command not recognized, forward to the MTD driver */
 
       ret = MTD_IOCTL(volume->mtd, cmd, arg);
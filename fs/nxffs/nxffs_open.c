@@ -908,6 +908,13 @@ static inline int nxffs_wrclose(FAR struct nxffs_volume_s *volume,
 
 errout:
   nxsem_post(&volume->wrsem);
+
+#ifdef CONFIG_NXFFS_BGPACK
+  /* And for background packing, once it has been idle for a while */
+
+  nxffs_bgpack_schedule(volume, false);
+#endif
+
   return ret;
 }
 
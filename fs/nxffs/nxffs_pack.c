@@ -48,6 +48,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
 
 #include "nxffs.h"
 
@@ -1248,11 +1249,7 @@ static inline int nxffs_packwriter(FAR struct nxffs_volume_s *volume,
 }
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: nxffs_pack
+ * Name: nxffs_packvolume
  *
  * Description:
  *   Pack and re-write the filesystem in order to free up memory at the end
@@ -1267,7 +1264,7 @@ static inline int nxffs_packwriter(FAR struct nxffs_volume_s *volume,
  *
  ****************************************************************************/
 
-int nxffs_pack(FAR struct nxffs_volume_s *volume)
+static int nxffs_packvolume(FAR struct nxffs_volume_s *volume)
 {
   struct nxffs_pack_s pack;
   FAR struct nxffs_wrfile_s *wrfile;
@@ -1589,6 +1586,10 @@ start_pack:
           goto errout_with_pack;
         }
 
+#ifdef CONFIG_NXFFS_BGPACK
+      volume->gcstats.gc_erases++;
+#endif
+
       /* Write the packed I/O block to FLASH */
 
       ret = MTD_BWRITE(volume->mtd, pack.block0, volume->blkper, volume->pack);
@@ -1605,3 +1606,62 @@ errout_with_pack:
   nxffs_freeentry(&pack.dest.entry);
   return ret;
 }
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_pack
+ *
+ * Description:
+ *   Pack and re-write the filesystem in order to free up memory at the end
+ *   of FLASH.
+ *
+ * Input Parameters:
+ *   volume - The volume to be packed.
+ *
+ * Returned Value:
+ *   Zero on success; Otherwise, a negated errno value is returned to
+ *   indicate the nature of the failure.
+ *
+ ****************************************************************************/
+
+int nxffs_pack(FAR struct nxffs_volume_s *volume)
+{
+#ifdef CONFIG_NXFFS_BGPACK
+  FAR struct fs_gcstats_s *stats = &volume->gcstats;
+  off_t froffset = volume->froffset;
+  clock_t start = clock_systimer();
+  uint32_t elapsed;
+  int ret;
+
+  ret     = nxffs_packvolume(volume);
+  elapsed = TICK2MSEC(clock_systimer() - start);
+
+  if (volume->bgactive)
+    {
+      /* Packed in the background:  This is time that a writer would
+       * otherwise have been stalled.
+       */
+
+      stats->gc_bgsteps++;
+      stats->gc_bgtime += elapsed;
+
+      if (ret >= 0 && volume->froffset < froffset)
+        {
+          stats->gc_reclaimed += (froffset - volume->froffset) /
+                                 volume->geo.blocksize;
+        }
+    }
+  else
+    {
+      stats->gc_fgruns++;
+      stats->gc_fgstall += elapsed;
+    }
+
+  return ret;
+#else
+  return nxffs_packvolume(volume);
+#endif
+}
@@ -129,6 +129,14 @@ int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name)
       ferr("ERROR: Failed to write block %d: %d\n",
            volume->ioblock, ret);
     }
+#ifdef CONFIG_NXFFS_BGPACK
+  else
+    {
+      /* The FLASH used by the inode can now be recovered by packing */
+
+      nxffs_bgpack_schedule(volume, true);
+    }
+#endif
 
 errout_with_entry:
   nxffs_freeentry(&entry);
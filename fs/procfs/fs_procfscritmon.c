@@ -56,6 +56,7 @@
 
 #include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/procfs.h>
 
@@ -81,6 +82,7 @@
 struct critmon_file_s
 {
   struct procfs_file_s  base;   /* Base open file structure */
+  bool spinlocks;               /* True: /proc/spinlocks */
   unsigned int linesize;        /* Number of valid characters in line[] */
   char line[CRITMON_LINELEN];   /* Pre-allocated buffer for formatted lines */
 };
@@ -100,6 +102,10 @@ static int     critmon_dup(FAR const struct file *oldp,
                  FAR struct file *newp);
 static int     critmon_stat(FAR const char *relpath, FAR struct stat *buf);
 
+/* Helpers */
+
+static bool    critmon_relpath(FAR const char *relpath);
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -130,6 +136,26 @@ const struct procfs_operations critmon_operations =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: critmon_relpath
+ *
+ * Description:
+ *   Return true if relpath names one of the files of this module.
+ *
+ ****************************************************************************/
+
+static bool critmon_relpath(FAR const char *relpath)
+{
+#ifdef CONFIG_SCHED_CRITMONITOR_SPINLOCKS
+  if (strcmp(relpath, "spinlocks") == 0)
+    {
+      return true;
+    }
+#endif
+
+  return strcmp(relpath, "critmon") == 0;
+}
+
 /****************************************************************************
  * Name: critmon_open
  ****************************************************************************/
@@ -153,9 +179,11 @@ static int critmon_open(FAR struct file *filep, FAR const char *relpath,
       return -EACCES;
     }
 
-  /* "critmon" is the only acceptable value for the relpath */
+  /* "critmon" and "spinlocks" are the only acceptable values for the
+   * relpath.
+   */
 
-  if (strcmp(relpath, "critmon") != 0)
+  if (!critmon_relpath(relpath))
     {
       ferr("ERROR: relpath is '%s'\n", relpath);
       return -ENOENT;
@@ -170,6 +198,8 @@ static int critmon_open(FAR struct file *filep, FAR const char *relpath,
       return -ENOMEM;
     }
 
+  attr->spinlocks = (strcmp(relpath, "spinlocks") == 0);
+
   /* Save the attributes as the open-specific state in filep->f_priv */
 
   filep->f_priv = (FAR void *)attr;
@@ -272,6 +302,50 @@ static ssize_t critmon_read_cpu(FAR struct critmon_file_s *attr,
   return totalsize;
 }
 
+/****************************************************************************
+ * Name: critmon_read_spinlock
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_SPINLOCKS
+static ssize_t critmon_read_spinlock(FAR struct critmon_file_s *attr,
+                                     FAR char *buffer, size_t buflen,
+                                     FAR off_t *offset,
+                                     FAR struct spin_monitor_s *monitor)
+{
+  struct timespec maxtime;
+  unsigned long count;
+  size_t linesize;
+
+  /* Convert the maximum hold time */
+
+  if (monitor->max > 0)
+    {
+      up_critmon_convert(monitor->max, &maxtime);
+    }
+  else
+    {
+      maxtime.tv_sec = 0;
+      maxtime.tv_nsec = 0;
+    }
+
+  count = monitor->count;
+
+  /* Reset the statistics */
+
+  monitor->max   = 0;
+  monitor->count = 0;
+
+  /* Generate output for the maximum hold time and the number of times that
+   * the lock was taken.
+   */
+
+  linesize = snprintf(attr->line, CRITMON_LINELEN, "%s,%lu.%09lu,%lu\n",
+                      monitor->name, (unsigned long)maxtime.tv_sec,
+                      (unsigned long)maxtime.tv_nsec, count);
+  return procfs_memcpy(attr->line, linesize, buffer, buflen, offset);
+}
+#endif
+
 /****************************************************************************
  * Name: critmon_read
  ****************************************************************************/
@@ -296,6 +370,41 @@ static ssize_t critmon_read(FAR struct file *filep, FAR char *buffer,
   ret    = 0;
   offset = filep->f_pos;
 
+#ifdef CONFIG_SCHED_CRITMONITOR_SPINLOCKS
+  if (attr->spinlocks)
+    {
+      int i;
+
+      /* Get the statistics of each monitored lock */
+
+      for (i = 0; i < CONFIG_SCHED_CRITMONITOR_NSPINLOCKS; i++)
+        {
+          ssize_t nbytes;
+
+          if (g_spin_monitor[i].lock == NULL)
+            {
+              continue;
+            }
+
+          nbytes = critmon_read_spinlock(attr, buffer + ret, buflen - ret,
+                                         &offset, &g_spin_monitor[i]);
+
+          ret += nbytes;
+          if (ret >= buflen)
+            {
+              break;
+            }
+        }
+
+      if (ret > 0)
+        {
+          filep->f_pos += ret;
+        }
+
+      return ret;
+    }
+#endif
+
 #ifdef CONFIG_SMP
   /* Get the status for each CPU  */
 
@@ -375,15 +484,17 @@ static int critmon_dup(FAR const struct file *oldp, FAR struct file *newp)
 
 static int critmon_stat(const char *relpath, struct stat *buf)
 {
-  /* "critmon" is the only acceptable value for the relpath */
+  /* "critmon" and "spinlocks" are the only acceptable values for the
+   * relpath.
+   */
 
-  if (strcmp(relpath, "critmon") != 0)
+  if (!critmon_relpath(relpath))
     {
       ferr("ERROR: relpath is '%s'\n", relpath);
       return -ENOENT;
     }
 
-  /* "critmon" is the name for a read-only file */
+  /* "critmon" and "spinlocks" are the names of read-only files */
 
   memset(buf, 0, sizeof(struct stat));
   buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
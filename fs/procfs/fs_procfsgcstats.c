@@ -0,0 +1,326 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsgcstats.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    (defined(CONFIG_NXFFS_BGPACK) || defined(CONFIG_SPIFFS_BGGC))
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define GCSTATS_LINELEN 64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct gcstats_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  procfs_gcstats_t getstats;      /* Returns the statistics of a volume */
+  char line[GCSTATS_LINELEN];     /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: gcstats_line
+ *
+ * Description:
+ *   Format line 'i' of the statistics of volume 'volndx'.
+ *
+ ****************************************************************************/
+
+static size_t gcstats_line(FAR char *line, int volndx, int i,
+                           FAR const struct fs_gcstats_s *stats)
+{
+  switch (i)
+    {
+      case 0:
+        return snprintf(line, GCSTATS_LINELEN,
+                        "Volume %d background GC: %s\n", volndx,
+                        stats->gc_bgenabled ? "enabled" : "disabled");
+
+      case 1:
+        return snprintf(line, GCSTATS_LINELEN,
+                        "  Background steps:   %lu\n",
+                        (unsigned long)stats->gc_bgsteps);
+
+      case 2:
+        return snprintf(line, GCSTATS_LINELEN,
+                        "  Writer GC runs:     %lu\n",
+                        (unsigned long)stats->gc_fgruns);
+
+      case 3:
+        return snprintf(line, GCSTATS_LINELEN,
+                        "  Blocks reclaimed:   %lu\n",
+                        (unsigned long)stats->gc_reclaimed);
+
+      case 4:
+        return snprintf(line, GCSTATS_LINELEN,
+                        "  Blocks erased:      %lu\n",
+                        (unsigned long)stats->gc_erases);
+
+      case 5:
+        return snprintf(line, GCSTATS_LINELEN,
+                        "  Writer stall (ms):  %lu\n",
+                        (unsigned long)stats->gc_fgstall);
+
+      default:
+        return snprintf(line, GCSTATS_LINELEN,
+                        "  Stall avoided (ms): %lu\n",
+                        (unsigned long)stats->gc_bgtime);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: procfs_gcstats_open
+ *
+ * Description:
+ *   Open a read-only procfs file that reports the garbage collection
+ *   statistics of the volumes of a FLASH file system.
+ *
+ * Input Parameters:
+ *   filep    - The file being opened
+ *   relpath  - The relative path that was opened
+ *   oflags   - The open flags
+ *   name     - The relative path of the procfs file of the file system
+ *   getstats - Returns the statistics of the mounted volume with an index
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure
+ *
+ ****************************************************************************/
+
+int procfs_gcstats_open(FAR struct file *filep, FAR const char *relpath,
+                        int oflags, FAR const char *name,
+                        procfs_gcstats_t getstats)
+{
+  FAR struct gcstats_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  if (strcmp(relpath, name) != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct gcstats_file_s *)
+    kmm_zalloc(sizeof(struct gcstats_file_s));
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  procfile->getstats = getstats;
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: procfs_gcstats_close
+ ****************************************************************************/
+
+int procfs_gcstats_close(FAR struct file *filep)
+{
+  FAR struct gcstats_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct gcstats_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: procfs_gcstats_read
+ ****************************************************************************/
+
+ssize_t procfs_gcstats_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen)
+{
+  FAR struct gcstats_file_s *procfile;
+  struct fs_gcstats_s stats;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  int volndx;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct gcstats_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  totalsize = 0;
+  copysize  = 0;
+
+  /* Loop through each mounted volume printing the statistics */
+
+  for (volndx = 0;
+       totalsize < buflen && procfile->getstats(volndx, &stats) >= 0;
+       volndx++)
+    {
+      for (i = 0; i < 7 && totalsize < buflen; i++)
+        {
+          buffer += copysize;
+          buflen -= copysize;
+
+          linesize   = gcstats_line(procfile->line, volndx, i, &stats);
+          copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                     buflen, &offset);
+          totalsize += copysize;
+        }
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: procfs_gcstats_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+int procfs_gcstats_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct gcstats_file_s *oldattr;
+  FAR struct gcstats_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct gcstats_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct gcstats_file_s *)
+    kmm_malloc(sizeof(struct gcstats_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct gcstats_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: procfs_gcstats_stat
+ *
+ * Description:
+ *   Return information about the procfs file of a file system.  'name' is
+ *   the only acceptable value of 'relpath'.
+ *
+ ****************************************************************************/
+
+int procfs_gcstats_stat(FAR const char *relpath, FAR const char *name,
+                        FAR struct stat *buf)
+{
+  if (strcmp(relpath, name) != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* This is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS && ... */
@@ -56,6 +56,15 @@
 
 #define MEMINFO_LINELEN 54
 
+/* The statistics of the spinning on the heap locks can be shown for the
+ * heaps whose structures are accessible here.
+ */
+
+#if defined(CONFIG_SEM_ADAPTIVE) && \
+    (defined(CONFIG_MM_KERNEL_HEAP) || defined(CONFIG_BUILD_FLAT))
+#  define MEMINFO_SPINSTATS 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -388,6 +397,62 @@ static ssize_t meminfo_read(FAR struct file *filep, FAR char *buffer,
     }
 #endif
 
+#ifdef MEMINFO_SPINSTATS
+  if (totalsize < buflen)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      /* Followed by the statistics of the spinning on the heap locks:  How
+       * often a caller spun, took the lock while spinning, or gave up.
+       */
+
+      linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                            "\n              spin    acquire    give up\n");
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+#ifdef CONFIG_MM_KERNEL_HEAP
+  if (totalsize < buflen)
+    {
+      FAR struct sem_spinstats_s *stats = &g_kmmheap.mm_spinstats;
+
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                            "Klock: %11lu%11lu%11lu\n",
+                            (unsigned long)stats->ss_nspin,
+                            (unsigned long)stats->ss_nacquire,
+                            (unsigned long)stats->ss_ngiveup);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+#endif
+
+#ifdef CONFIG_BUILD_FLAT
+  if (totalsize < buflen)
+    {
+      FAR struct sem_spinstats_s *stats = &g_mmheap.mm_spinstats;
+
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = snprintf(procfile->line, MEMINFO_LINELEN,
+                            "Ulock: %11lu%11lu%11lu\n",
+                            (unsigned long)stats->ss_nspin,
+                            (unsigned long)stats->ss_nacquire,
+                            (unsigned long)stats->ss_ngiveup);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+#endif
+#endif
+
   /* Update the file offset */
 
   filep->f_pos += totalsize;
@@ -416,6 +416,20 @@ static ssize_t romfs_read(FAR struct file *filep, FAR char *buffer,
       buflen = bytesleft;
     }
 
+  /* In XIP mode, the whole file is directly addressable.  Copy the data
+   * in one step without going through the sector logic.
+   */
+
+  if (rm->rm_xipbase)
+    {
+      memcpy(userbuffer,
+             rm->rm_xipbase + rf->rf_startoffset + filep->f_pos, buflen);
+
+      filep->f_pos += buflen;
+      romfs_semgive(rm);
+      return buflen;
+    }
+
   /* Loop until either (1) all data has been transferred, or (2) an
    * error occurs.
    */
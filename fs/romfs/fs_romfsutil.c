@@ -866,11 +866,24 @@ int romfs_parsefilename(struct romfs_mountpt_s *rm, uint32_t offset,
   uint16_t chunklen;
   bool     done;
 
+  offset += ROMFS_FHDR_NAME;
+
+  /* In XIP mode, the name can be copied directly from the media */
+
+  if (rm->rm_xipbase)
+    {
+      FAR const char *name = (FAR const char *)rm->rm_xipbase + offset;
+
+      namelen = strnlen(name, NAME_MAX);
+      memcpy(pname, name, namelen);
+      pname[namelen] = '\0';
+      return OK;
+    }
+
   /* Loop until the whole name is obtained or until NAME_MAX characters
    * of the name have been parsed.
    */
 
-  offset += ROMFS_FHDR_NAME;
   for (namelen = 0, done = false; namelen < NAME_MAX && !done; )
     {
       /* Read the sector into memory */
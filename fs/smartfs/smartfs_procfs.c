@@ -844,6 +844,11 @@ static size_t smartfs_status_read(FAR struct file *filep, FAR char *buffer,
                                          "Sectors Per Block: %d\nSector Utilization:%d%%\n"
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
                                          "Uneven Wear Count: %d\n"
+#endif
+#ifdef CONFIG_MTD_SMART_DATA_CACHE
+                                         "Cache Hits:        %lu\n"
+                                         "Cache Misses:      %lu\n"
+                                         "Read-ahead Sectors:%lu\n"
 #endif
                   ,
                   procfs_data.formatversion, procfs_data.namelen,
@@ -854,6 +859,11 @@ static size_t smartfs_status_read(FAR struct file *filep, FAR char *buffer,
                   procfs_data.sectorsperblk, utilization
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
                   , procfs_data.uneven_wearcount
+#endif
+#ifdef CONFIG_MTD_SMART_DATA_CACHE
+                  , (unsigned long)procfs_data.cachehits
+                  , (unsigned long)procfs_data.cachemisses
+                  , (unsigned long)procfs_data.cachereadahead
 #endif
            );
         }
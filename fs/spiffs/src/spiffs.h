@@ -59,6 +59,11 @@ extern "C"
 
 #include <nuttx/semaphore.h>
 #include <nuttx/mtd/mtd.h>
+#include <nuttx/fs/fs.h>
+
+#ifdef CONFIG_SPIFFS_BGGC
+#  include <nuttx/wqueue.h>
+#endif
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -156,6 +161,13 @@ struct spiffs_s
   int16_t lu_blkndx;                /* Cursor when searching, block index */
   int16_t max_erase_count;          /* Max erase count amongst all blocks */
   uint8_t pages_per_block;          /* Pages per block */
+#ifdef CONFIG_SPIFFS_BGGC
+  bool bgenable;                    /* True: Background GC is enabled */
+  FAR struct spiffs_s *flink;       /* Supports a singly linked list of volumes */
+  struct work_s bgwork;             /* Supports background garbage collection */
+  clock_t lastio;                   /* Time of the last modification */
+  struct fs_gcstats_s gcstats;      /* Garbage collection statistics */
+#endif
 };
 
 /* This structure represents the state of an open file */
@@ -331,6 +343,27 @@ ssize_t spiffs_fobj_read(FAR struct spiffs_s *fs,
 void spiffs_fobj_free(FAR struct spiffs_s *fs,
                       FAR struct spiffs_file_s *fobj, bool unlink);
 
+/****************************************************************************
+ * Name: spiffs_gcstats
+ *
+ * Description:
+ *   Return the garbage collection statistics of the mounted SPIFFS volume
+ *   with the given index.  This is used by the procfs file system.
+ *
+ * Input Parameters:
+ *   index - The index of the volume in the list of mounted volumes
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -ENOENT is returned if there is no
+ *   volume with this index.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPIFFS_BGGC
+int spiffs_gcstats(int index, FAR struct fs_gcstats_s *stats);
+#endif
+
 #if defined(__cplusplus)
 }
 #endif
@@ -81,19 +81,13 @@ FAR static FAR struct spiffs_cache_page_s *
   FAR struct spiffs_cache_page_s *cp;
   int i;
 
-  cache = spiffs_get_cache(fs);
-  if ((cache->cpage_use_map & cache->cpage_use_mask) == 0)
-    {
-      return 0;
-    }
+  /* Only read cache pages are in the hash chains */
 
-  for (i = 0; i < cache->cpage_count; i++)
+  cache = spiffs_get_cache(fs);
+  for (i = cache->hash[SPIFFS_CACHE_HASH(pgndx)]; i >= 0; i = cp->hnext)
     {
       cp = spiffs_get_cache_page_hdr(fs, cache, i);
-
-      if ((cache->cpage_use_map & (1 << i)) != 0 &&
-          (cp->flags & SPIFFS_CACHE_FLAG_TYPE_WR) == 0 &&
-           cp->pgndx == pgndx)
+      if (cp->pgndx == pgndx)
         {
           cp->last_access = cache->last_access;
           return cp;
@@ -103,6 +97,46 @@ FAR static FAR struct spiffs_cache_page_s *
   return NULL;
 }
 
+/****************************************************************************
+ * Name: spiffs_cache_page_unhash
+ *
+ * Description:
+ *  Remove a read cache page from its hash chain
+ *
+ * Input Parameters:
+ *   fs    - A reference to the SPIFFS volume object instance
+ *   cp    - The read cache page to be removed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void spiffs_cache_page_unhash(FAR struct spiffs_s *fs,
+                                     FAR struct spiffs_cache_page_s *cp)
+{
+  FAR struct spiffs_cache_s *cache;
+  FAR struct spiffs_cache_page_s *prev;
+  FAR int16_t *link;
+
+  cache = spiffs_get_cache(fs);
+  link  = &cache->hash[SPIFFS_CACHE_HASH(cp->pgndx)];
+
+  while (*link >= 0)
+    {
+      if (*link == cp->cpndx)
+        {
+          *link = cp->hnext;
+          break;
+        }
+
+      prev = spiffs_get_cache_page_hdr(fs, cache, *link);
+      link = &prev->hnext;
+    }
+
+  cp->hnext = -1;
+}
+
 /****************************************************************************
  * Name: spiffs_cache_page_free
  *
@@ -130,7 +164,7 @@ static int spiffs_cache_page_free(FAR struct spiffs_s *fs, int cpndx,
   cache = spiffs_get_cache(fs);
   cp    = spiffs_get_cache_page_hdr(fs, cache, cpndx);
 
-  if (cache->cpage_use_map & (1 << cpndx))
+  if (cp->flags != 0)
     {
       if (write_back &&
           (cp->flags & SPIFFS_CACHE_FLAG_TYPE_WR) == 0 &&
@@ -156,10 +190,15 @@ static int spiffs_cache_page_free(FAR struct spiffs_s *fs, int cpndx,
         {
           spiffs_cacheinfo("Free cache page %d pgndx %04x\n",
                            cpndx, cp->pgndx);
+
+          spiffs_cache_page_unhash(fs, cp);
         }
 
-      cache->cpage_use_map &= ~(1 << cpndx);
-      cp->flags = 0;
+      /* Return the page to the free list */
+
+      cp->flags       = 0;
+      cp->hnext       = cache->freelist;
+      cache->freelist = cpndx;
     }
 
   return ret;
@@ -193,7 +232,7 @@ static int spiffs_cache_page_remove_oldest(FAR struct spiffs_s *fs,
 
   /* Don't remove any cache pages unless there are no free cache pages */
 
-  if ((cache->cpage_use_map & cache->cpage_use_mask) != cache->cpage_use_mask)
+  if (cache->freelist >= 0)
     {
       /* At least one free cpage */
 
@@ -232,12 +271,11 @@ static int spiffs_cache_page_remove_oldest(FAR struct spiffs_s *fs,
  *
  * Description:
  *   Allocates a new cached page and returns it, or null if all cache pages
- *   are busy.
+ *   are busy.  The caller must set the flags of the page to a non-zero
+ *   value.
  *
  * Input Parameters:
  *   fs         - A reference to the SPIFFS volume object instance
- *   cpndx      - Cache page index
- *   write_back - True:  Write dirty pages back to hardware
  *
  * Returned Value:
  *   A reference to the allocated cache page.  NULL is returned if we were
@@ -249,39 +287,176 @@ static FAR struct spiffs_cache_page_s *
   spiffs_cache_page_allocate(FAR struct spiffs_s *fs)
 {
   FAR struct spiffs_cache_s *cache;
-  int i;
+  FAR struct spiffs_cache_page_s *cp;
 
   /* Check if any cache pages are available */
 
   cache = spiffs_get_cache(fs);
-  if (cache->cpage_use_map == 0xffffffff)
+  if (cache->freelist < 0)
     {
       /* No.. Out of cache memory */
 
       return NULL;
     }
 
-  /* Search for a free cache page */
+  /* Take the first page from the free list */
 
-  for (i = 0; i < cache->cpage_count; i++)
+  cp              = spiffs_get_cache_page_hdr(fs, cache, cache->freelist);
+  cache->freelist = cp->hnext;
+  cp->hnext       = -1;
+  cp->last_access = cache->last_access;
+  return cp;
+}
+
+/****************************************************************************
+ * Name: spiffs_cache_page_load
+ *
+ * Description:
+ *   Allocates a read cache page for the given FLASH page, removing the
+ *   oldest read cache page if necessary, and fills it either from FLASH or
+ *   from a copy of the page that has already been read.
+ *
+ * Input Parameters:
+ *   fs    - A reference to the SPIFFS volume object instance
+ *   pgndx - The FLASH page index
+ *   src   - A copy of the FLASH page or NULL to read it from FLASH
+ *   cpp   - The location to return the cache page.  NULL is returned if
+ *           no cache page could be allocated.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; A negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+static int spiffs_cache_page_load(FAR struct spiffs_s *fs, int16_t pgndx,
+                                  FAR const uint8_t *src,
+                                  FAR struct spiffs_cache_page_s **cpp)
+{
+  FAR struct spiffs_cache_s *cache;
+  FAR struct spiffs_cache_page_s *cp;
+  FAR uint8_t *mem;
+  int ret;
+
+  /* This operation will always free one cache page (unless all already
+   * free), the result code stems from the write operation of the possibly
+   * freed cache page
+   */
+
+  ret = spiffs_cache_page_remove_oldest(fs, SPIFFS_CACHE_FLAG_TYPE_WR, 0);
+
+  /* Allocate a new cache page */
+
+  cp = spiffs_cache_page_allocate(fs);
+  if (cp != NULL)
     {
-      if ((cache->cpage_use_map & (1 << i)) == 0)
-        {
-          FAR struct spiffs_cache_page_s *cp;
+      cache     = spiffs_get_cache(fs);
+      mem       = spiffs_get_cache_page(fs, cache, cp->cpndx);
 
-          /* We found one */
+      if (src != NULL)
+        {
+          memcpy(mem, src, SPIFFS_GEO_PAGE_SIZE(fs));
+        }
+      else
+        {
+          ret = spiffs_mtd_read(fs, SPIFFS_PAGE_TO_PADDR(fs, pgndx),
+                                SPIFFS_GEO_PAGE_SIZE(fs), mem);
+          if (ret < 0)
+            {
+              cp->hnext       = cache->freelist;
+              cache->freelist = cp->cpndx;
+              *cpp            = NULL;
+              return ret;
+            }
 
-          cp                    = spiffs_get_cache_page_hdr(fs, cache, i);
-          cache->cpage_use_map |= (1 << i);
-          cp->last_access       = cache->last_access;
-          return cp;
+          ret = OK;
         }
+
+      cp->flags = SPIFFS_CACHE_FLAG_WRTHRU;
+      cp->pgndx = pgndx;
+      cp->hnext = cache->hash[SPIFFS_CACHE_HASH(pgndx)];
+      cache->hash[SPIFFS_CACHE_HASH(pgndx)] = cp->cpndx;
+
+      spiffs_cacheinfo("Allocated cache page %d for pgndx %04x\n",
+                       cp->cpndx, cp->pgndx);
     }
 
-  /* Out of cache entries */
+  *cpp = cp;
+  return ret;
+}
 
-  return NULL;
+#if CONFIG_SPIFFS_CACHE_READAHEAD > 1
+/****************************************************************************
+ * Name: spiffs_cache_readahead
+ *
+ * Description:
+ *   Read several consecutive FLASH pages, beginning with pgndx, with a
+ *   single MTD read and add those that are not already cached to the
+ *   cache.  This is done when data pages are read sequentially.  The read
+ *   does not go past the end of the block because the next block begins
+ *   with object lookup pages.
+ *
+ * Input Parameters:
+ *   fs    - A reference to the SPIFFS volume object instance
+ *   pgndx - The first FLASH page index to read
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; A negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+static int spiffs_cache_readahead(FAR struct spiffs_s *fs, int16_t pgndx)
+{
+  FAR struct spiffs_cache_s *cache = spiffs_get_cache(fs);
+  FAR struct spiffs_cache_page_s *cp;
+  int npages;
+  int ret;
+  int i;
+
+  npages = SPIFFS_GEO_PAGES_PER_BLOCK(fs) -
+           (pgndx % SPIFFS_GEO_PAGES_PER_BLOCK(fs));
+  npages = MIN(npages, CONFIG_SPIFFS_CACHE_READAHEAD);
+
+  /* Don't let read-ahead displace more than half of the cache */
+
+  npages = MIN(npages, cache->cpage_count / 2);
+  if (npages < 2)
+    {
+      return spiffs_cache_page_load(fs, pgndx, NULL, &cp);
+    }
+
+  spiffs_cacheinfo("Read-ahead pgndx %04x npages %d\n", pgndx, npages);
+
+  ret = spiffs_mtd_read(fs, SPIFFS_PAGE_TO_PADDR(fs, pgndx),
+                        npages * SPIFFS_GEO_PAGE_SIZE(fs), cache->rabuffer);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0, ret = OK; i < npages && ret >= 0; i++)
+    {
+      /* Pages that are already cached may be more recent than what was
+       * just read.
+       */
+
+      if (spiffs_cache_page_get(fs, pgndx + i) == NULL)
+        {
+          ret = spiffs_cache_page_load(fs, pgndx + i,
+                                       &cache->rabuffer[i *
+                                         SPIFFS_GEO_PAGE_SIZE(fs)],
+                                       &cp);
+          if (cp == NULL)
+            {
+              break;
+            }
+        }
+    }
+
+  return ret;
 }
+#endif
 
 /****************************************************************************
  * Public Functions
@@ -304,49 +479,66 @@ static FAR struct spiffs_cache_page_s *
 
 void spiffs_cache_initialize(FAR struct spiffs_s *fs)
 {
-  FAR struct spiffs_cache_s *cp;
-  struct spiffs_cache_s cache;
-  uint32_t cache_mask = 0;
-  uint32_t sz;
-  int i;
+  FAR struct spiffs_cache_s *cache;
+  FAR struct spiffs_cache_page_s *cp;
+  FAR uint8_t *mem;
+  size_t avail;
   int cache_entries;
+  int i;
 
-  sz            = fs->cache_size;
-  cache_entries = (sz - sizeof(struct spiffs_cache_s)) /
-                  (SPIFFS_CACHE_PAGE_SIZE(fs));
-
-  if (fs->cache == 0)
+  if (fs->cache == 0 || fs->cache_size < sizeof(struct spiffs_cache_s))
     {
       return;
     }
 
-  if (cache_entries <= 0)
+  cache = spiffs_get_cache(fs);
+  memset(cache, 0, sizeof(struct spiffs_cache_s));
+
+  mem   = (FAR uint8_t *)fs->cache + sizeof(struct spiffs_cache_s);
+  avail = fs->cache_size - sizeof(struct spiffs_cache_s);
+
+#if CONFIG_SPIFFS_CACHE_READAHEAD > 1
+  /* Set aside a buffer for multi-page reads, but only if the cache is big
+   * enough that read-ahead would not just thrash it.
+   */
+
+  if (avail >= CONFIG_SPIFFS_CACHE_READAHEAD *
+               (SPIFFS_GEO_PAGE_SIZE(fs) + 2 * SPIFFS_CACHE_PAGE_SIZE(fs)))
     {
-      return;
+      cache->rabuffer = mem;
+      cache->ranext   = -1;
+      mem            += CONFIG_SPIFFS_CACHE_READAHEAD *
+                        SPIFFS_GEO_PAGE_SIZE(fs);
+      avail          -= CONFIG_SPIFFS_CACHE_READAHEAD *
+                        SPIFFS_GEO_PAGE_SIZE(fs);
     }
+#endif
 
-  for (i = 0; i < cache_entries; i++)
+  cache_entries = avail / SPIFFS_CACHE_PAGE_SIZE(fs);
+  if (cache_entries > SPIFFS_CACHE_MAXPAGES)
     {
-      cache_mask <<= 1;
-      cache_mask |= 1;
+      cache_entries = SPIFFS_CACHE_MAXPAGES;
     }
 
-  memset(&cache, 0, sizeof(struct spiffs_cache_s));
-  cache.cpage_count    = cache_entries;
-  cache.cpages         = (FAR uint8_t *)
-    ((FAR uint8_t *)fs->cache + sizeof(struct spiffs_cache_s));
+  cache->cpage_count = cache_entries;
+  cache->cpages      = mem;
+  cache->freelist    = -1;
+
+  for (i = 0; i < SPIFFS_CACHE_NHASH; i++)
+    {
+      cache->hash[i] = -1;
+    }
 
-  cache.cpage_use_map  = 0xffffffff;
-  cache.cpage_use_mask = cache_mask;
-  memcpy(fs->cache, &cache, sizeof(struct spiffs_cache_s));
+  memset(cache->cpages, 0, cache_entries * SPIFFS_CACHE_PAGE_SIZE(fs));
 
-  cp = spiffs_get_cache(fs);
-  memset(cp->cpages, 0, cp->cpage_count * SPIFFS_CACHE_PAGE_SIZE(fs));
+  /* Put all of the cache pages in the free list */
 
-  cp->cpage_use_map &= ~(cp->cpage_use_mask);
-  for (i = 0; i < cache.cpage_count; i++)
+  for (i = cache_entries - 1; i >= 0; i--)
     {
-      spiffs_get_cache_page_hdr(fs, cp, i)->cpndx = i;
+      cp              = spiffs_get_cache_page_hdr(fs, cache, i);
+      cp->cpndx       = i;
+      cp->hnext       = cache->freelist;
+      cache->freelist = i;
     }
 }
 
@@ -399,19 +591,20 @@ ssize_t spiffs_cache_read(FAR struct spiffs_s *fs, uint8_t op, int16_t objid,
 {
   FAR struct spiffs_cache_s *cache;
   FAR struct spiffs_cache_page_s *cp;
+  FAR uint8_t *mem;
+  int16_t pgndx;
   int ret = OK;
 
   spiffs_cacheinfo("op=%02x, objid=%04x addr=%ld len=%lu\n",
                    op, objid, (long)addr, (unsigned long)len);
 
+  pgndx = SPIFFS_PADDR_TO_PAGE(fs, addr);
   cache = spiffs_get_cache(fs);
-  cp    = spiffs_cache_page_get(fs, SPIFFS_PADDR_TO_PAGE(fs, addr));
+  cp    = spiffs_cache_page_get(fs, pgndx);
 
   cache->last_access++;
   if (cp != NULL)
     {
-      FAR uint8_t *mem;
-
       /* We've already got a cache page */
 
 #ifdef CONFIG_SPIFFS_CACHEDBG
@@ -440,45 +633,44 @@ ssize_t spiffs_cache_read(FAR struct spiffs_s *fs, uint8_t op, int16_t objid,
           fs->cache_misses++;
 #endif
 
-          /* This operation will always free one cache page (unless all
-           * already free), the result code stems from the write operation
-           * of the possibly freed cache page
+#if CONFIG_SPIFFS_CACHE_READAHEAD > 1
+          /* If this continues a sequential read of data pages, then read
+           * the following pages too.
            */
 
-          ret = spiffs_cache_page_remove_oldest(fs,
-                                                SPIFFS_CACHE_FLAG_TYPE_WR,
-                                                0);
-
-          /* Allocate a new cache page */
+          if ((op & SPIFFS_OP_TYPE_MASK) == SPIFFS_OP_T_OBJ_DA &&
+              cache->rabuffer != NULL && pgndx == cache->ranext)
+            {
+              ret = spiffs_cache_readahead(fs, pgndx);
+              cp  = spiffs_cache_page_get(fs, pgndx);
+            }
+          else
+#endif
+            {
+              ret = spiffs_cache_page_load(fs, pgndx, NULL, &cp);
+            }
 
-          cp = spiffs_cache_page_allocate(fs);
           if (cp != NULL)
             {
-              FAR uint8_t *mem;
-
-              cp->flags = SPIFFS_CACHE_FLAG_WRTHRU;
-              cp->pgndx = SPIFFS_PADDR_TO_PAGE(fs, addr);
-
-              spiffs_cacheinfo("Allocated cache page %d for pgndx %04x\n",
-                               cp->cpndx, cp->pgndx);
-
-              ret = spiffs_mtd_read(fs, addr -
-                                    SPIFFS_PADDR_TO_PAGE_OFFSET(fs, addr),
-                                    SPIFFS_GEO_PAGE_SIZE(fs),
-                                    spiffs_get_cache_page(fs, cache, cp->cpndx));
-
               mem = spiffs_get_cache_page(fs, cache, cp->cpndx);
               memcpy(dest, &mem[SPIFFS_PADDR_TO_PAGE_OFFSET(fs, addr)], len);
             }
-          else
+          else if (ret >= 0)
             {
               /* This will never happen, last resort for sake of symmetry */
 
-             ret = spiffs_mtd_read(fs, addr, len, dest);
+              ret = spiffs_mtd_read(fs, addr, len, dest);
             }
         }
     }
 
+#if CONFIG_SPIFFS_CACHE_READAHEAD > 1
+  if ((op & SPIFFS_OP_TYPE_MASK) == SPIFFS_OP_T_OBJ_DA)
+    {
+      cache->ranext = pgndx + 1;
+    }
+#endif
+
   if (ret < 0)
     {
       ferr("ERROR: spiffs_mtd_read: failed: %d\n", ret);
@@ -599,24 +791,16 @@ FAR struct spiffs_cache_page_s *
   FAR struct spiffs_cache_s *cache = spiffs_get_cache(fs);
   int i;
 
-  if ((cache->cpage_use_map & cache->cpage_use_mask) == 0)
-    {
-      /* All cache pages free, no cache page can be assigned to the ID */
-
-      return NULL;
-    }
-
   /* Look at each cache index */
 
   for (i = 0; i < cache->cpage_count; i++)
     {
       FAR struct spiffs_cache_page_s *cp;
 
-      /* Is this page available?  Is is writable?  Do the object IDs match? */
+      /* Is this a write cache page?  Do the object IDs match? */
 
       cp = spiffs_get_cache_page_hdr(fs, cache, i);
-      if ((cache->cpage_use_map & (1 << i)) &&
-          (cp->flags & SPIFFS_CACHE_FLAG_TYPE_WR) &&
+      if ((cp->flags & SPIFFS_CACHE_FLAG_TYPE_WR) != 0 &&
            cp->objid == fobj->objid)
         {
           /* Yes... return the cache page reference */
@@ -721,3 +905,71 @@ void spiffs_cache_page_release(FAR struct spiffs_s *fs,
       cp->objid = 0;
     }
 }
+
+#if CONFIG_SPIFFS_LOOKUP_HINTS > 0
+/****************************************************************************
+ * Name: spiffs_cache_hint_get
+ *
+ * Description:
+ *   Return the page index where the page with the given object ID and span
+ *   index was last found.  The caller must verify the page before using it.
+ *
+ * Input Parameters:
+ *   fs    - A reference to the SPIFFS volume object instance
+ *   objid - The object ID (SPIFFS_OBJID_FREE for a name lookup)
+ *   spndx - The span index (or the hash of the name)
+ *
+ * Returned Value:
+ *   The page index of the hint; zero is returned if there is no hint.
+ *
+ ****************************************************************************/
+
+int16_t spiffs_cache_hint_get(FAR struct spiffs_s *fs, int16_t objid,
+                              int16_t spndx)
+{
+  FAR struct spiffs_cache_s *cache = spiffs_get_cache(fs);
+  FAR struct spiffs_cache_hint_s *hint;
+
+  hint = &cache->hints[((uint16_t)objid * 31 + (uint16_t)spndx) %
+                       CONFIG_SPIFFS_LOOKUP_HINTS];
+
+  if (hint->pgndx != 0 && hint->objid == objid && hint->spndx == spndx)
+    {
+      return hint->pgndx;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: spiffs_cache_hint_set
+ *
+ * Description:
+ *   Remember where the page with the given object ID and span index was
+ *   found.  This replaces any older hint in the same slot.
+ *
+ * Input Parameters:
+ *   fs    - A reference to the SPIFFS volume object instance
+ *   objid - The object ID (SPIFFS_OBJID_FREE for a name lookup)
+ *   spndx - The span index (or the hash of the name)
+ *   pgndx - The page index where the page was found
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void spiffs_cache_hint_set(FAR struct spiffs_s *fs, int16_t objid,
+                           int16_t spndx, int16_t pgndx)
+{
+  FAR struct spiffs_cache_s *cache = spiffs_get_cache(fs);
+  FAR struct spiffs_cache_hint_s *hint;
+
+  hint = &cache->hints[((uint16_t)objid * 31 + (uint16_t)spndx) %
+                       CONFIG_SPIFFS_LOOKUP_HINTS];
+
+  hint->objid = objid;
+  hint->spndx = spndx;
+  hint->pgndx = pgndx;
+}
+#endif
@@ -60,6 +60,25 @@ extern "C"
 #define SPIFFS_CACHE_FLAG_DATA        (1 << 4)
 #define SPIFFS_CACHE_FLAG_TYPE_WR     (1 << 7)
 
+/* The maximum number of cache pages */
+
+#define SPIFFS_CACHE_MAXPAGES         1024
+
+/* Read cache pages are found via a hash table indexed by the FLASH page
+ * index.  This must be a power of two.
+ */
+
+#define SPIFFS_CACHE_NHASH            64
+#define SPIFFS_CACHE_HASH(pgndx)      ((uint16_t)(pgndx) & (SPIFFS_CACHE_NHASH - 1))
+
+#ifndef CONFIG_SPIFFS_CACHE_READAHEAD
+#  define CONFIG_SPIFFS_CACHE_READAHEAD 0
+#endif
+
+#ifndef CONFIG_SPIFFS_LOOKUP_HINTS
+#  define CONFIG_SPIFFS_LOOKUP_HINTS 0
+#endif
+
 #define SPIFFS_CACHE_PAGE_SIZE(fs) \
   (sizeof(struct spiffs_cache_page_s) + SPIFFS_GEO_PAGE_SIZE(fs))
 
@@ -98,8 +117,9 @@ extern "C"
 
 struct spiffs_cache_page_s
 {
-  uint8_t flags;             /* Cache flags */
-  uint8_t cpndx;             /* Cache page index */
+  uint8_t flags;             /* Cache flags (zero if the page is free) */
+  uint16_t cpndx;            /* Cache page index */
+  int16_t hnext;             /* Next page in the hash chain or free list */
   uint32_t last_access;      /* Last access of this cache page */
   union
     {
@@ -117,15 +137,35 @@ struct spiffs_cache_page_s
     };
 };
 
+#if CONFIG_SPIFFS_LOOKUP_HINTS > 0
+/* Remembers where the page for an object ID and span index was last
+ * found.  Hints are only hints:  They are always verified before use.
+ */
+
+struct spiffs_cache_hint_s
+{
+  int16_t objid;             /* Object ID (SPIFFS_OBJID_FREE for a name) */
+  int16_t spndx;             /* Span index (or hash of the name) */
+  int16_t pgndx;             /* Page index where it was found (0 if none) */
+};
+#endif
+
 /* Cache structure */
 
 struct spiffs_cache_s
 {
-  uint8_t cpage_count;
-  uint32_t last_access;
-  uint32_t cpage_use_map;
-  uint32_t cpage_use_mask;
-  FAR uint8_t *cpages;
+  uint16_t cpage_count;      /* Number of cache pages */
+  int16_t freelist;          /* First free cache page (-1 if none) */
+  uint32_t last_access;      /* Incremented on each cache access */
+  int16_t hash[SPIFFS_CACHE_NHASH]; /* Heads of the read page hash chains */
+  FAR uint8_t *cpages;       /* The cache pages */
+#if CONFIG_SPIFFS_CACHE_READAHEAD > 1
+  FAR uint8_t *rabuffer;     /* Multi-page read buffer (NULL if none) */
+  int16_t ranext;            /* Next data page of a sequential read */
+#endif
+#if CONFIG_SPIFFS_LOOKUP_HINTS > 0
+  struct spiffs_cache_hint_s hints[CONFIG_SPIFFS_LOOKUP_HINTS];
+#endif
 };
 
 /****************************************************************************
@@ -275,6 +315,49 @@ FAR struct spiffs_cache_page_s *
 void spiffs_cache_page_release(FAR struct spiffs_s *fs,
                                FAR struct spiffs_cache_page_s *cp);
 
+#if CONFIG_SPIFFS_LOOKUP_HINTS > 0
+/****************************************************************************
+ * Name: spiffs_cache_hint_get
+ *
+ * Description:
+ *   Return the page index where the page with the given object ID and span
+ *   index was last found.  The caller must verify the page before using it.
+ *
+ * Input Parameters:
+ *   fs    - A reference to the SPIFFS volume object instance
+ *   objid - The object ID (SPIFFS_OBJID_FREE for a name lookup)
+ *   spndx - The span index (or the hash of the name)
+ *
+ * Returned Value:
+ *   The page index of the hint; zero is returned if there is no hint.
+ *
+ ****************************************************************************/
+
+int16_t spiffs_cache_hint_get(FAR struct spiffs_s *fs, int16_t objid,
+                              int16_t spndx);
+
+/****************************************************************************
+ * Name: spiffs_cache_hint_set
+ *
+ * Description:
+ *   Remember where the page with the given object ID and span index was
+ *   found.  This replaces any older hint in the same slot.
+ *
+ * Input Parameters:
+ *   fs    - A reference to the SPIFFS volume object instance
+ *   objid - The object ID (SPIFFS_OBJID_FREE for a name lookup)
+ *   spndx - The span index (or the hash of the name)
+ *   pgndx - The page index where the page was found
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void spiffs_cache_hint_set(FAR struct spiffs_s *fs, int16_t objid,
+                           int16_t spndx, int16_t pgndx);
+#endif
+
 #if defined(__cplusplus)
 }
 #endif
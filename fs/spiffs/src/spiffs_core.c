@@ -324,6 +324,84 @@ static int spiffs_find_objhdr_pgndx_callback(FAR struct spiffs_s *fs, int16_t ob
   return SPIFFS_VIS_COUNTINUE;
 }
 
+#if CONFIG_SPIFFS_LOOKUP_HINTS > 0
+/****************************************************************************
+ * Name: spiffs_objlu_check_hint
+ *
+ * Description:
+ *   Apply the same checks to a single page that spiffs_foreach_objlu()
+ *   would apply when it visits the page.  This is used to verify a lookup
+ *   hint before the hint is used in place of a full object lookup scan.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the page matches; SPIFFS_VIS_COUNTINUE is
+ *   returned if it does not; A negated errno value is returned on any
+ *   failure.
+ *
+ ****************************************************************************/
+
+static int spiffs_objlu_check_hint(FAR struct spiffs_s *fs, int16_t pgndx,
+                                   uint8_t flags, int16_t objid,
+                                   spiffs_callback_t cb,
+                                   FAR const void *user_const,
+                                   FAR void *user_var)
+{
+  int16_t blkndx;
+  int16_t lu_objid;
+  int entry;
+  int ret;
+
+  blkndx = SPIFFS_BLOCK_FOR_PAGE(fs, pgndx);
+  entry  = SPIFFS_OBJ_LOOKUP_ENTRY_FOR_PAGE(fs, pgndx);
+
+  if (entry < 0 || pgndx >= SPIFFS_GEO_PAGE_COUNT(fs))
+    {
+      return SPIFFS_VIS_COUNTINUE;
+    }
+
+  /* The object lookup entries of a block are contiguous in the object
+   * lookup pages at the beginning of the block.
+   */
+
+  ret = spiffs_cache_read(fs, SPIFFS_OP_T_OBJ_LU | SPIFFS_OP_C_READ, 0,
+                          SPIFFS_BLOCK_TO_PADDR(fs, blkndx) +
+                          entry * sizeof(int16_t),
+                          sizeof(int16_t), (FAR uint8_t *)&lu_objid);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if ((flags & SPIFFS_VIS_CHECK_ID) != 0 && lu_objid != objid)
+    {
+      return SPIFFS_VIS_COUNTINUE;
+    }
+
+  return cb(fs, lu_objid, blkndx, entry, user_const, user_var);
+}
+
+/****************************************************************************
+ * Name: spiffs_name_hash
+ *
+ * Description:
+ *   Hash an object name for use as a lookup hint key.
+ *
+ ****************************************************************************/
+
+static int16_t spiffs_name_hash(FAR const uint8_t *name)
+{
+  uint16_t hash = 5381;
+  int i;
+
+  for (i = 0; i < CONFIG_SPIFFS_NAME_MAX && name[i] != '\0'; i++)
+    {
+      hash = (hash << 5) + hash + name[i];
+    }
+
+  return (int16_t)hash;
+}
+#endif
+
 /****************************************************************************
  * Name: spiffs_objlu_find_free_objid_bitmap_callback
  *
@@ -747,6 +825,7 @@ int spiffs_erase_block(FAR struct spiffs_s *fs, int16_t blkndx)
   uint32_t addr = SPIFFS_BLOCK_TO_PADDR(fs, blkndx);
   int32_t size  = SPIFFS_GEO_BLOCK_SIZE(fs);
   int ret;
+  int i;
 
   /* Here we ignore the return value and just try erasing the block */
 
@@ -761,6 +840,13 @@ int spiffs_erase_block(FAR struct spiffs_s *fs, int16_t blkndx)
       size -= SPIFFS_GEO_EBLOCK_SIZE(fs);
     }
 
+  /* Remove the erased pages from the cache */
+
+  for (i = 0; i < SPIFFS_GEO_PAGES_PER_BLOCK(fs); i++)
+    {
+      spiffs_cache_drop_page(fs, SPIFFS_PAGE_FOR_BLOCK(fs, blkndx) + i);
+    }
+
   fs->free_blocks++;
 
   /* Register erase count for this block */
@@ -969,6 +1055,31 @@ int spiffs_objlu_find_id_and_span(FAR struct spiffs_s *fs, int16_t objid,
   int entry;
   int ret;
 
+#if CONFIG_SPIFFS_LOOKUP_HINTS > 0
+  int16_t hint;
+
+  /* Try where the page was last found before scanning all of the object
+   * lookup pages.
+   */
+
+  hint = spiffs_cache_hint_get(fs, objid, spndx);
+  if (hint != 0 &&
+      spiffs_objlu_check_hint(fs, hint, SPIFFS_VIS_CHECK_ID, objid,
+                              spiffs_objlu_find_id_and_span_callback,
+                              exclusion_pgndx ? &exclusion_pgndx : 0,
+                              &spndx) == OK)
+    {
+      if (pgndx != NULL)
+        {
+          *pgndx = hint;
+        }
+
+      fs->lu_blkndx = SPIFFS_BLOCK_FOR_PAGE(fs, hint);
+      fs->lu_entry  = SPIFFS_OBJ_LOOKUP_ENTRY_FOR_PAGE(fs, hint);
+      return OK;
+    }
+#endif
+
   ret = spiffs_foreach_objlu(fs, fs->lu_blkndx, fs->lu_entry,
                              SPIFFS_VIS_CHECK_ID, objid,
                              spiffs_objlu_find_id_and_span_callback,
@@ -985,6 +1096,15 @@ int spiffs_objlu_find_id_and_span(FAR struct spiffs_s *fs, int16_t objid,
       return ret;
     }
 
+#if CONFIG_SPIFFS_LOOKUP_HINTS > 0
+  if (ret >= 0)
+    {
+      spiffs_cache_hint_set(fs, objid, spndx,
+                            SPIFFS_OBJ_LOOKUP_ENTRY_TO_PGNDX(fs, blkndx,
+                                                             entry));
+    }
+#endif
+
   if (pgndx != NULL)
     {
       *pgndx = SPIFFS_OBJ_LOOKUP_ENTRY_TO_PGNDX(fs, blkndx, entry);
@@ -2683,6 +2803,31 @@ int spiffs_find_objhdr_pgndx(FAR struct spiffs_s *fs,
   int entry;
   int ret;
 
+#if CONFIG_SPIFFS_LOOKUP_HINTS > 0
+  int16_t namehash = spiffs_name_hash(name);
+  int16_t hint;
+
+  /* Try where the object header was last found before scanning all of the
+   * object lookup pages.
+   */
+
+  hint = spiffs_cache_hint_get(fs, SPIFFS_OBJID_FREE, namehash);
+  if (hint != 0 &&
+      spiffs_objlu_check_hint(fs, hint, 0, 0,
+                              spiffs_find_objhdr_pgndx_callback,
+                              name, 0) == OK)
+    {
+      if (pgndx != NULL)
+        {
+          *pgndx = hint;
+        }
+
+      fs->lu_blkndx = SPIFFS_BLOCK_FOR_PAGE(fs, hint);
+      fs->lu_entry  = SPIFFS_OBJ_LOOKUP_ENTRY_FOR_PAGE(fs, hint);
+      return OK;
+    }
+#endif
+
   ret = spiffs_foreach_objlu(fs, fs->lu_blkndx, fs->lu_entry,
                              0, 0, spiffs_find_objhdr_pgndx_callback,
                              name, 0, &blkndx, &entry);
@@ -2697,6 +2842,15 @@ int spiffs_find_objhdr_pgndx(FAR struct spiffs_s *fs,
       return ret;
     }
 
+#if CONFIG_SPIFFS_LOOKUP_HINTS > 0
+  if (ret >= 0)
+    {
+      spiffs_cache_hint_set(fs, SPIFFS_OBJID_FREE, namehash,
+                            SPIFFS_OBJ_LOOKUP_ENTRY_TO_PGNDX(fs, blkndx,
+                                                             entry));
+    }
+#endif
+
   if (pgndx != NULL)
     {
       *pgndx = SPIFFS_OBJ_LOOKUP_ENTRY_TO_PGNDX(fs, blkndx, entry);
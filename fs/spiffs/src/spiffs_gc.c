@@ -48,8 +48,11 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
+#include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
+
 #include "spiffs.h"
 #include "spiffs_core.h"
 #include "spiffs_cache.h"
@@ -103,7 +106,6 @@ struct spiffs_gc_s
 static int spiffs_gc_erase_block(FAR struct spiffs_s *fs, int16_t blkndx)
 {
   int ret;
-  int i;
 
   spiffs_gcinfo("Erase block=%04x\n", blkndx);
 
@@ -114,13 +116,12 @@ static int spiffs_gc_erase_block(FAR struct spiffs_s *fs, int16_t blkndx)
     {
       ferr("ERROR: spiffs_erase_block() blkndx=%d failed: %d\n", blkndx, ret);
     }
-
-  /* Then remove the pages from the cache. */
-
-  for (i = 0; i < SPIFFS_GEO_PAGES_PER_BLOCK(fs); i++)
+#ifdef CONFIG_SPIFFS_BGGC
+  else
     {
-      spiffs_cache_drop_page(fs, SPIFFS_PAGE_FOR_BLOCK(fs, blkndx) + i);
+      fs->gcstats.gc_erases++;
     }
+#endif
 
   return ret;
 }
@@ -949,6 +950,53 @@ static int spiffs_gc_clean(FAR struct spiffs_s *fs, int16_t blkndx)
   return ret;
 }
 
+/****************************************************************************
+ * Name: spiffs_gc_reclaim
+ *
+ * Description:
+ *   Move all live pages out of the candidate block, update the page
+ *   statistics, and erase the block.
+ *
+ * Input Parameters:
+ *   fs     - A reference to the SPIFFS volume object instance
+ *   blkndx - The candidate block to be reclaimed
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; A negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+static int spiffs_gc_reclaim(FAR struct spiffs_s *fs, int16_t blkndx)
+{
+  int ret;
+
+  ret = spiffs_gc_clean(fs, blkndx);
+
+  spiffs_gcinfo("Cleaning block %d, result=%d\n", blkndx, ret);
+
+  if (ret < 0)
+    {
+      ferr("ERROR: spiffs_gc_clean() failed: %d\n", ret);
+      return ret;
+    }
+
+  ret = spiffs_gc_epage_stats(fs, blkndx);
+  if (ret < 0)
+    {
+      ferr("ERROR: spiffs_gc_epage_stats() failed: %d\n", ret);
+      return ret;
+    }
+
+  ret = spiffs_gc_erase_block(fs, blkndx);
+  if (ret < 0)
+    {
+      ferr("ERROR: spiffs_gc_erase_block() failed: %d\n", ret);
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1112,6 +1160,9 @@ int spiffs_gc_check(FAR struct spiffs_s *fs, off_t len)
 {
   int32_t free_pages;
   uint32_t needed_pages;
+#ifdef CONFIG_SPIFFS_BGGC
+  clock_t start;
+#endif
   int tries = 0;
   int ret;
 
@@ -1191,29 +1242,22 @@ int spiffs_gc_check(FAR struct spiffs_s *fs, off_t len)
 #endif
       cand = cands[0];
 
-      ret = spiffs_gc_clean(fs, cand);
-
-      spiffs_gcinfo("Cleaning block %d, result=%d\n", cand, ret);
+#ifdef CONFIG_SPIFFS_BGGC
+      start = clock_systimer();
+#endif
 
+      ret = spiffs_gc_reclaim(fs, cand);
       if (ret < 0)
         {
-          ferr("ERROR: spiffs_gc_clean() failed: %d\n", ret);
           return ret;
         }
 
-      ret = spiffs_gc_epage_stats(fs, cand);
-      if (ret < 0)
-        {
-          ferr("ERROR: spiffs_gc_epage_stats() failed: %d\n", ret);
-          return ret;
-        }
+#ifdef CONFIG_SPIFFS_BGGC
+      /* The writer was stalled while this block was reclaimed */
 
-      ret = spiffs_gc_erase_block(fs, cand);
-      if (ret < 0)
-        {
-          ferr("ERROR: spiffs_gc_erase_block() failed: %d\n", ret);
-          return ret;
-        }
+      fs->gcstats.gc_fgruns++;
+      fs->gcstats.gc_fgstall += TICK2MSEC(clock_systimer() - start);
+#endif
 
       free_pages = (SPIFFS_GEO_PAGES_PER_BLOCK(fs) -
                     SPIFFS_OBJ_LOOKUP_PAGES(fs)) * (SPIFFS_GEO_BLOCK_COUNT(fs) - 2) -
@@ -1249,3 +1293,68 @@ int spiffs_gc_check(FAR struct spiffs_s *fs, off_t len)
 
   return ret;
 }
+
+/****************************************************************************
+ * Name: spiffs_gc_step
+ *
+ * Description:
+ *   Perform one bounded step of garbage collection:  Erase one block in
+ *   which all pages are deleted or, if there is no such block, reclaim the
+ *   best candidate block.  This is used for background garbage collection
+ *   when the volume is idle; each step moves at most one block's worth of
+ *   pages.
+ *
+ * Input Parameters:
+ *   fs - A reference to the SPIFFS volume object instance
+ *
+ * Returned Value:
+ *   One is returned if a block was reclaimed; zero is returned if there is
+ *   nothing that can be reclaimed.  A negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int spiffs_gc_step(FAR struct spiffs_s *fs)
+{
+  FAR int16_t *cands;
+  int count;
+  int ret;
+
+  /* First, look for a block in which every page has been deleted.  Such a
+   * block can be erased without moving anything.
+   */
+
+  ret = spiffs_gc_quick(fs, 0);
+  if (ret >= 0)
+    {
+      return 1;
+    }
+  else if (ret != -ENODATA)
+    {
+      return ret;
+    }
+
+  /* There is nothing to be gained by moving pages around if nothing has
+   * been deleted.
+   */
+
+  if (fs->deleted_pages == 0)
+    {
+      return 0;
+    }
+
+  ret = spiffs_gc_find_candidate(fs, &cands, &count, false);
+  if (ret < 0)
+    {
+      ferr("ERROR: spiffs_gc_find_candidate() failed: %d\n", ret);
+      return ret;
+    }
+
+  if (count == 0)
+    {
+      return 0;
+    }
+
+  ret = spiffs_gc_reclaim(fs, cands[0]);
+  return ret < 0 ? ret : 1;
+}
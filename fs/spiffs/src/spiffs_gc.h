@@ -126,6 +126,28 @@ int spiffs_gc_quick(FAR struct spiffs_s *fs, uint16_t max_free_pages);
 
 int spiffs_gc_check(FAR struct spiffs_s *fs, off_t len);
 
+/****************************************************************************
+ * Name: spiffs_gc_step
+ *
+ * Description:
+ *   Perform one bounded step of garbage collection:  Erase one block in
+ *   which all pages are deleted or, if there is no such block, reclaim the
+ *   best candidate block.  This is used for background garbage collection
+ *   when the volume is idle; each step moves at most one block's worth of
+ *   pages.
+ *
+ * Input Parameters:
+ *   fs - A reference to the SPIFFS volume object instance
+ *
+ * Returned Value:
+ *   One is returned if a block was reclaimed; zero is returned if there is
+ *   nothing that can be reclaimed.  A negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int spiffs_gc_step(FAR struct spiffs_s *fs);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -0,0 +1,97 @@
+/****************************************************************************
+ * fs/spiffs/src/spiffs_procfs.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "spiffs.h"
+
+#if defined(CONFIG_FS_PROCFS) && defined(CONFIG_SPIFFS_BGGC) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_SPIFFS)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int spiffs_procfs_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int spiffs_procfs_stat(FAR const char *relpath,
+                 FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_procfs.c -- this structure is explicitly externed there.  All but
+ * open() and stat() are the common methods in fs_procfsgcstats.c.
+ */
+
+const struct procfs_operations spiffs_procfsoperations =
+{
+  spiffs_procfs_open,    /* open */
+  procfs_gcstats_close,  /* close */
+  procfs_gcstats_read,   /* read */
+  NULL,                  /* write */
+  procfs_gcstats_dup,    /* dup */
+  NULL,                  /* opendir */
+  NULL,                  /* closedir */
+  NULL,                  /* readdir */
+  NULL,                  /* rewinddir */
+  spiffs_procfs_stat     /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spiffs_procfs_open
+ ****************************************************************************/
+
+static int spiffs_procfs_open(FAR struct file *filep,
+                              FAR const char *relpath, int oflags,
+                              mode_t mode)
+{
+  return procfs_gcstats_open(filep, relpath, oflags, "fs/spiffs",
+                             spiffs_gcstats);
+}
+
+/****************************************************************************
+ * Name: spiffs_procfs_stat
+ ****************************************************************************/
+
+static int spiffs_procfs_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  return procfs_gcstats_stat(relpath, "fs/spiffs", buf);
+}
+
+#endif /* CONFIG_FS_PROCFS && CONFIG_SPIFFS_BGGC &&
+        * !CONFIG_FS_PROCFS_EXCLUDE_SPIFFS */
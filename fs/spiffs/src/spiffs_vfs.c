@@ -57,6 +57,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/clock.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/dirent.h>
 #include <nuttx/fs/ioctl.h>
@@ -74,6 +75,25 @@
 #define spiffs_lock_volume(fs)       (spiffs_lock_reentrant(&fs->exclsem))
 #define spiffs_unlock_volume(fs)     (spiffs_unlock_reentrant(&fs->exclsem))
 
+/* Background garbage collection */
+
+#ifdef CONFIG_SPIFFS_BGGC
+#  ifndef CONFIG_SPIFFS_BGGC_IDLEMS
+#    define CONFIG_SPIFFS_BGGC_IDLEMS 500
+#  endif
+#  ifndef CONFIG_SPIFFS_BGGC_BUDGETMS
+#    define CONFIG_SPIFFS_BGGC_BUDGETMS 50
+#  endif
+#  ifndef CONFIG_SPIFFS_BGGC_FREEBLOCKS
+#    define CONFIG_SPIFFS_BGGC_FREEBLOCKS 4
+#  endif
+
+#  define SPIFFS_BGGC_IDLE           MSEC2TICK(CONFIG_SPIFFS_BGGC_IDLEMS)
+#  define SPIFFS_BGGC_BUDGET         MSEC2TICK(CONFIG_SPIFFS_BGGC_BUDGETMS)
+#else
+#  define spiffs_bggc_schedule(fs)
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -82,6 +102,12 @@
 
 static int  spiffs_lock_reentrant(FAR struct spiffs_sem_s *sem);
 static void spiffs_unlock_reentrant(FAR struct spiffs_sem_s *sem);
+#ifdef CONFIG_SPIFFS_BGGC
+static void spiffs_bggc_worker(FAR void *arg);
+static void spiffs_bggc_schedule(FAR struct spiffs_s *fs);
+static void spiffs_bggc_register(FAR struct spiffs_s *fs);
+static void spiffs_bggc_unregister(FAR struct spiffs_s *fs);
+#endif
 
 /* File system operations */
 
@@ -157,6 +183,20 @@ const struct mountpt_operations spiffs_operations =
   spiffs_stat,       /* stat */
 };
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SPIFFS_BGGC
+/* A list of all mounted volumes.  g_spiffs_volsem protects the list and is
+ * also held while a volume is being collected in the background so that
+ * the volume cannot be unmounted underneath the collector.
+ */
+
+static FAR struct spiffs_s *g_spiffs_volumes;
+static sem_t g_spiffs_volsem = SEM_INITIALIZER(1);
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -236,6 +276,194 @@ static void spiffs_unlock_reentrant(FAR struct spiffs_sem_s *rsem)
     }
 }
 
+#ifdef CONFIG_SPIFFS_BGGC
+/****************************************************************************
+ * Name: spiffs_bggc_worker
+ *
+ * Description:
+ *   Runs on the low priority work queue.  If the volume has been idle for
+ *   long enough, reclaim blocks one at a time until enough blocks are free,
+ *   there is nothing left to reclaim, or the time budget is consumed.  In
+ *   the latter case, the work is re-queued so that other work (and any
+ *   waiting writer) gets a chance to run.
+ *
+ ****************************************************************************/
+
+static void spiffs_bggc_worker(FAR void *arg)
+{
+  FAR struct spiffs_s *fs = (FAR struct spiffs_s *)arg;
+  FAR struct spiffs_s *curr;
+  clock_t elapsed;
+  clock_t start;
+  bool more = false;
+  int ret;
+
+  ret = nxsem_wait_uninterruptible(&g_spiffs_volsem);
+  if (ret < 0)
+    {
+      return;
+    }
+
+  /* Make sure that the volume was not unmounted after this work was
+   * de-queued.
+   */
+
+  for (curr = g_spiffs_volumes; curr != NULL && curr != fs;
+       curr = curr->flink)
+    {
+    }
+
+  if (curr == NULL)
+    {
+      goto errout_with_volsem;
+    }
+
+  /* Has the volume been idle for long enough?  If not, try again when it
+   * might have been.
+   */
+
+  elapsed = clock_systimer() - fs->lastio;
+  if (elapsed < SPIFFS_BGGC_IDLE)
+    {
+      work_queue(LPWORK, &fs->bgwork, spiffs_bggc_worker, fs,
+                 SPIFFS_BGGC_IDLE - elapsed);
+      goto errout_with_volsem;
+    }
+
+  ret = spiffs_lock_volume(fs);
+  if (ret < 0)
+    {
+      goto errout_with_volsem;
+    }
+
+  start = clock_systimer();
+  while (fs->bgenable && fs->free_blocks < CONFIG_SPIFFS_BGGC_FREEBLOCKS)
+    {
+      ret = spiffs_gc_step(fs);
+      if (ret <= 0)
+        {
+          if (ret < 0)
+            {
+              ferr("ERROR: spiffs_gc_step() failed: %d\n", ret);
+            }
+
+          break;
+        }
+
+      fs->gcstats.gc_reclaimed++;
+
+      if (clock_systimer() - start >= SPIFFS_BGGC_BUDGET)
+        {
+          more = true;
+          break;
+        }
+    }
+
+  fs->gcstats.gc_bgsteps++;
+  fs->gcstats.gc_bgtime += TICK2MSEC(clock_systimer() - start);
+
+  if (more)
+    {
+      /* Out of time, but not finished.  Work queued with no delay goes to
+       * the end of the queue, behind any other pending work.
+       */
+
+      work_queue(LPWORK, &fs->bgwork, spiffs_bggc_worker, fs, 0);
+    }
+
+  spiffs_unlock_volume(fs);
+
+errout_with_volsem:
+  nxsem_post(&g_spiffs_volsem);
+}
+
+/****************************************************************************
+ * Name: spiffs_bggc_schedule
+ *
+ * Description:
+ *   Note modification of the volume and (re-)schedule the background
+ *   garbage collection.  The caller holds the volume lock.
+ *
+ ****************************************************************************/
+
+static void spiffs_bggc_schedule(FAR struct spiffs_s *fs)
+{
+  fs->lastio = clock_systimer();
+
+  /* If the work is already pending, it will notice the new lastio value
+   * and postpone itself.
+   */
+
+  if (fs->bgenable && work_available(&fs->bgwork))
+    {
+      work_queue(LPWORK, &fs->bgwork, spiffs_bggc_worker, fs,
+                 SPIFFS_BGGC_IDLE);
+    }
+}
+
+/****************************************************************************
+ * Name: spiffs_bggc_register
+ *
+ * Description:
+ *   Add a volume to the list of mounted volumes and enable background
+ *   garbage collection on it.
+ *
+ ****************************************************************************/
+
+static void spiffs_bggc_register(FAR struct spiffs_s *fs)
+{
+  nxsem_wait_uninterruptible(&g_spiffs_volsem);
+  fs->flink        = g_spiffs_volumes;
+  g_spiffs_volumes = fs;
+  fs->bgenable     = true;
+  nxsem_post(&g_spiffs_volsem);
+}
+
+/****************************************************************************
+ * Name: spiffs_bggc_unregister
+ *
+ * Description:
+ *   Remove a volume from the list of mounted volumes and cancel any
+ *   background garbage collection.  This will wait for any collection that
+ *   is in progress to complete.  It must not be called while holding the
+ *   volume lock.
+ *
+ ****************************************************************************/
+
+static void spiffs_bggc_unregister(FAR struct spiffs_s *fs)
+{
+  FAR struct spiffs_s *prev = NULL;
+  FAR struct spiffs_s *curr;
+
+  nxsem_wait_uninterruptible(&g_spiffs_volsem);
+
+  for (curr = g_spiffs_volumes; curr != NULL; curr = curr->flink)
+    {
+      if (curr == fs)
+        {
+          if (prev == NULL)
+            {
+              g_spiffs_volumes = fs->flink;
+            }
+          else
+            {
+              prev->flink = fs->flink;
+            }
+
+          break;
+        }
+
+      prev = curr;
+    }
+
+  fs->flink    = NULL;
+  fs->bgenable = false;
+  work_cancel(LPWORK, &fs->bgwork);
+
+  nxsem_post(&g_spiffs_volsem);
+}
+#endif /* CONFIG_SPIFFS_BGGC */
+
 /****************************************************************************
  * Name: spiffs_readdir_callback
  ****************************************************************************/
@@ -840,6 +1068,7 @@ success_with_lock:
   /* Update the file position */
 
   filep->f_pos += nwritten;
+  spiffs_bggc_schedule(fs);
 
   /* Release our access to the volume */
 
@@ -1074,6 +1303,52 @@ static int spiffs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
         break;
 #endif
 
+#ifdef CONFIG_SPIFFS_BGGC
+      /* Enable or disable background garbage collection.
+       * IN:  Non-zero to enable, zero to disable.
+       * OUT: None
+       */
+
+      case FIOC_BGGC:
+        {
+          fs->bgenable = (arg != 0);
+          if (fs->bgenable)
+            {
+              spiffs_bggc_schedule(fs);
+            }
+          else
+            {
+              work_cancel(LPWORK, &fs->bgwork);
+            }
+
+          ret = OK;
+        }
+        break;
+
+      /* Return garbage collection statistics.
+       * IN:  A pointer to a writable instance of struct fs_gcstats_s
+       * OUT: The statistics
+       */
+
+      case FIOC_GCSTATS:
+        {
+          FAR struct fs_gcstats_s *stats =
+            (FAR struct fs_gcstats_s *)((uintptr_t)arg);
+
+          if (stats == NULL)
+            {
+              ret = -EINVAL;
+            }
+          else
+            {
+              memcpy(stats, &fs->gcstats, sizeof(struct fs_gcstats_s));
+              stats->gc_bgenabled = fs->bgenable;
+              ret = OK;
+            }
+        }
+        break;
+#endif
+
       default:
 
         /* Pass through to the contained MTD driver */
@@ -1291,6 +1566,7 @@ static int spiffs_truncate(FAR struct file *filep, off_t length)
       filep->f_pos = fsize;
     }
 
+  spiffs_bggc_schedule(fs);
   spiffs_unlock_volume(fs);
   return spiffs_map_errno(ret);
 }
@@ -1445,9 +1721,12 @@ static int spiffs_bind(FAR struct inode *mtdinode, FAR const void *data,
   addrmask   = (sizeof(FAR void *) - 1);
   cache_size = (CONFIG_SPIFFS_CACHE_SIZE + addrmask) & ~addrmask;
 
-  /* Don't let the cache size exceed the maximum that is needed */
+  /* Don't let the cache size exceed the maximum that can be used */
 
-  cache_max  = SPIFFS_GEO_PAGE_SIZE(fs) << 5;
+  cache_max  = sizeof(struct spiffs_cache_s) +
+               (CONFIG_SPIFFS_CACHE_READAHEAD * SPIFFS_GEO_PAGE_SIZE(fs)) +
+               MIN(fs->total_pages, SPIFFS_CACHE_MAXPAGES) *
+               SPIFFS_CACHE_PAGE_SIZE(fs);
   if (cache_size > cache_max)
     {
       cache_size = cache_max;
@@ -1526,6 +1805,12 @@ static int spiffs_bind(FAR struct inode *mtdinode, FAR const void *data,
     }
 #endif
 
+#ifdef CONFIG_SPIFFS_BGGC
+  /* Enable background garbage collection */
+
+  spiffs_bggc_register(fs);
+#endif
+
   /* Return the new file system handle */
 
   *handle = (FAR void *)fs;
@@ -1557,6 +1842,14 @@ static int spiffs_unbind(FAR void *handle, FAR struct inode **mtdinode,
         handle, mtdinode, flags);
   DEBUGASSERT(fs != NULL);
 
+#ifdef CONFIG_SPIFFS_BGGC
+  /* Stop background garbage collection.  This must be done before the
+   * volume is locked because it waits for any collection in progress.
+   */
+
+  spiffs_bggc_unregister(fs);
+#endif
+
   /* Lock the file system */
 
   spiffs_lock_volume(fs);
@@ -1566,6 +1859,9 @@ static int spiffs_unbind(FAR void *handle, FAR struct inode **mtdinode,
   if (!dq_empty(&fs->objq) && (flags & MNT_FORCE) == 0)
     {
       fwarn("WARNING: Open files and umount not forced\n");
+#ifdef CONFIG_SPIFFS_BGGC
+      spiffs_bggc_register(fs);
+#endif
       ret = -EBUSY;
       goto errout_with_lock;
     }
@@ -1762,6 +2058,7 @@ static int spiffs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
 
   /* Release the lock on the volume */
 
+  spiffs_bggc_schedule(fs);
   spiffs_unlock_volume(fs);
   return OK;
 
@@ -1970,3 +2267,52 @@ errout_with_lock:
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
+
+/****************************************************************************
+ * Name: spiffs_gcstats
+ *
+ * Description:
+ *   Return the garbage collection statistics of the mounted SPIFFS volume
+ *   with the given index.  This is used by the procfs file system.
+ *
+ * Input Parameters:
+ *   index - The index of the volume in the list of mounted volumes
+ *   stats - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -ENOENT is returned if there is no
+ *   volume with this index.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPIFFS_BGGC
+int spiffs_gcstats(int index, FAR struct fs_gcstats_s *stats)
+{
+  FAR struct spiffs_s *fs;
+  int ret;
+
+  ret = nxsem_wait_uninterruptible(&g_spiffs_volsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (fs = g_spiffs_volumes; fs != NULL && index > 0; fs = fs->flink)
+    {
+      index--;
+    }
+
+  if (fs == NULL)
+    {
+      ret = -ENOENT;
+    }
+  else
+    {
+      memcpy(stats, &fs->gcstats, sizeof(struct fs_gcstats_s));
+      stats->gc_bgenabled = fs->bgenable;
+    }
+
+  nxsem_post(&g_spiffs_volsem);
+  return ret;
+}
+#endif
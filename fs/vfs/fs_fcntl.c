@@ -48,6 +48,7 @@
 #include <nuttx/sched.h>
 #include <nuttx/cancelpt.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/net/net.h>
 
 #include "inode/inode.h"
@@ -235,6 +236,46 @@ int file_vfcntl(FAR struct file *filep, int cmd, va_list ap)
         ret = -ENOSYS; /* Not implemented */
         break;
 
+#ifdef CONFIG_PIPES
+      case F_SETPIPE_SZ:
+        /* Change the capacity of the pipe referred to by fd to be at least
+         * arg bytes.  The actual capacity is returned.
+         */
+
+        {
+          int size = va_arg(ap, int);
+
+          ret = file_ioctl(filep, PIPEIOC_SETSIZE, size + 1);
+          if (ret < 0)
+            {
+              ret = ret == -ENOTTY ? -EBADF : ret;
+              break;
+            }
+        }
+
+        /* Fall through to return the new capacity */
+
+      case F_GETPIPE_SZ:
+        /* Return the capacity of the pipe referred to by fd */
+
+        {
+          int size;
+
+          ret = file_ioctl(filep, PIPEIOC_GETSIZE,
+                           (unsigned long)((uintptr_t)&size));
+          if (ret < 0)
+            {
+              ret = ret == -ENOTTY ? -EBADF : ret;
+              break;
+            }
+
+          /* One byte of the buffer is never used */
+
+          ret = size - 1;
+        }
+        break;
+#endif
+
       default:
         break;
     }
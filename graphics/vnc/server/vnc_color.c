@@ -42,6 +42,7 @@
 #include <stdint.h>
 #include <assert.h>
 #include <errno.h>
+#include <debug.h>
 
 #include "vnc_server.h"
 
@@ -416,3 +417,131 @@ int vnc_colors(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect,
 
   return ncolors;
 }
+
+/****************************************************************************
+ * Name: vnc_convert_tile
+ *
+ * Description:
+ *  Convert a tile of the local framebuffer to the remote framebuffer color
+ *  format.
+ *
+ * Input Parameters:
+ *   session  - An instance of the session structure.
+ *   colorfmt - The remote framebuffer color format.
+ *   x, y     - The upper left position of the tile.
+ *   width    - The width of the tile in pixels.
+ *   height   - The height of the tile in rows.
+ *   pixels   - Receives the width * height remote pixels.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the color format is not supported.
+ *
+ ****************************************************************************/
+
+#ifdef VNC_ENCODE_PIXELS
+int vnc_convert_tile(FAR struct vnc_session_s *session, uint8_t colorfmt,
+                     nxgl_coord_t x, nxgl_coord_t y, nxgl_coord_t width,
+                     nxgl_coord_t height, FAR uint32_t *pixels)
+{
+  FAR const lfb_color_t *rowstart;
+  FAR const lfb_color_t *src;
+  FAR const lfb_color_t *end;
+
+  rowstart = (FAR const lfb_color_t *)
+    (session->fb + RFB_STRIDE * y + RFB_BYTESPERPIXEL * x);
+
+  for (; height > 0; height--)
+    {
+      src = rowstart;
+      end = src + width;
+
+      switch (colorfmt)
+        {
+          case FB_FMT_RGB8_222:
+            while (src < end)
+              {
+                *pixels++ = vnc_convert_rgb8_222(*src++);
+              }
+            break;
+
+          case FB_FMT_RGB8_332:
+            while (src < end)
+              {
+                *pixels++ = vnc_convert_rgb8_332(*src++);
+              }
+            break;
+
+          case FB_FMT_RGB16_555:
+            while (src < end)
+              {
+                *pixels++ = vnc_convert_rgb16_555(*src++);
+              }
+            break;
+
+          case FB_FMT_RGB16_565:
+            while (src < end)
+              {
+                *pixels++ = vnc_convert_rgb16_565(*src++);
+              }
+            break;
+
+          case FB_FMT_RGB32:
+            while (src < end)
+              {
+                *pixels++ = vnc_convert_rgb32_888(*src++);
+              }
+            break;
+
+          default:
+            gerr("ERROR: Unrecognized color format: %d\n", colorfmt);
+            return -EINVAL;
+        }
+
+      rowstart = (FAR const lfb_color_t *)
+        ((uintptr_t)rowstart + RFB_STRIDE);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: vnc_put_pixel
+ *
+ * Description:
+ *  Store the 'nbytes' least significant bytes of a remote pixel in the
+ *  byte order of the remote framebuffer.
+ *
+ * Input Parameters:
+ *   dest      - The location to store the pixel.
+ *   pixel     - The pixel in the remote framebuffer color format.
+ *   nbytes    - The number of bytes to store (1-4).
+ *   bigendian - True: Store in big-endian order.
+ *
+ * Returned Value:
+ *   The location following the pixel.
+ *
+ ****************************************************************************/
+
+FAR uint8_t *vnc_put_pixel(FAR uint8_t *dest, uint32_t pixel,
+                           unsigned int nbytes, bool bigendian)
+{
+  unsigned int i;
+
+  if (bigendian)
+    {
+      for (i = nbytes; i > 0; i--)
+        {
+          *dest++ = (uint8_t)(pixel >> ((i - 1) << 3));
+        }
+    }
+  else
+    {
+      for (i = 0; i < nbytes; i++)
+        {
+          *dest++ = (uint8_t)(pixel >> (i << 3));
+        }
+    }
+
+  return dest;
+}
+#endif
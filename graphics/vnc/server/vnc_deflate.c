@@ -0,0 +1,394 @@
+/****************************************************************************
+ * graphics/vnc/server/vnc_deflate.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#include "vnc_server.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Limits of LZ77 matches in the deflate format */
+
+#define DEFLATE_MINMATCH  3
+#define DEFLATE_MAXMATCH  258
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Base values and extra bits of the length codes 257-285 */
+
+static const uint16_t g_lenbase[29] =
+{
+  3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+
+static const uint8_t g_lenextra[29] =
+{
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+  3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+/* Base values and extra bits of the distance codes 0-29 */
+
+static const uint16_t g_distbase[30] =
+{
+  1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+  257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193,
+  12289, 16385, 24577
+};
+
+static const uint8_t g_distextra[30] =
+{
+  0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+  7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_deflate_putbits
+ *
+ * Description:
+ *   Append 'nbits' bits to the output, least significant bit first.
+ *
+ ****************************************************************************/
+
+static void vnc_deflate_putbits(FAR struct vnc_deflate_s *zs,
+                                uint32_t value, unsigned int nbits)
+{
+  zs->bitbuf |= value << zs->nbits;
+  zs->nbits  += nbits;
+
+  while (zs->nbits >= 8)
+    {
+      DEBUGASSERT(zs->outpos < zs->outlen);
+      zs->out[zs->outpos++] = (uint8_t)zs->bitbuf;
+      zs->bitbuf >>= 8;
+      zs->nbits   -= 8;
+    }
+}
+
+/****************************************************************************
+ * Name: vnc_deflate_putcode
+ *
+ * Description:
+ *   Append a Huffman code.  Huffman codes are packed starting with the
+ *   most significant bit.
+ *
+ ****************************************************************************/
+
+static void vnc_deflate_putcode(FAR struct vnc_deflate_s *zs,
+                                uint32_t code, unsigned int nbits)
+{
+  uint32_t reversed = 0;
+  unsigned int i;
+
+  for (i = 0; i < nbits; i++)
+    {
+      reversed = (reversed << 1) | (code & 1);
+      code   >>= 1;
+    }
+
+  vnc_deflate_putbits(zs, reversed, nbits);
+}
+
+/****************************************************************************
+ * Name: vnc_deflate_putsym
+ *
+ * Description:
+ *   Append a literal/length symbol using the fixed Huffman code.
+ *
+ ****************************************************************************/
+
+static void vnc_deflate_putsym(FAR struct vnc_deflate_s *zs,
+                               unsigned int sym)
+{
+  if (sym < 144)
+    {
+      vnc_deflate_putcode(zs, 0x30 + sym, 8);
+    }
+  else if (sym < 256)
+    {
+      vnc_deflate_putcode(zs, 0x190 + sym - 144, 9);
+    }
+  else if (sym < 280)
+    {
+      vnc_deflate_putcode(zs, sym - 256, 7);
+    }
+  else
+    {
+      vnc_deflate_putcode(zs, 0xc0 + sym - 280, 8);
+    }
+}
+
+/****************************************************************************
+ * Name: vnc_deflate_putmatch
+ *
+ * Description:
+ *   Append a length/distance pair.
+ *
+ ****************************************************************************/
+
+static void vnc_deflate_putmatch(FAR struct vnc_deflate_s *zs,
+                                 unsigned int len, unsigned int dist)
+{
+  int code;
+
+  for (code = 28; g_lenbase[code] > len; code--)
+    {
+    }
+
+  vnc_deflate_putsym(zs, 257 + code);
+  vnc_deflate_putbits(zs, len - g_lenbase[code], g_lenextra[code]);
+
+  for (code = 29; g_distbase[code] > dist; code--)
+    {
+    }
+
+  vnc_deflate_putcode(zs, code, 5);
+  vnc_deflate_putbits(zs, dist - g_distbase[code], g_distextra[code]);
+}
+
+/****************************************************************************
+ * Name: vnc_deflate_hash
+ *
+ * Description:
+ *   Hash the three bytes at the start of a possible match.
+ *
+ ****************************************************************************/
+
+static inline unsigned int vnc_deflate_hash(FAR const uint8_t *data)
+{
+  uint32_t value = ((uint32_t)data[0] << 16) |
+                   ((uint32_t)data[1] << 8) | data[2];
+
+  return (value * 2654435761u) >> (32 - VNC_DEFLATE_HBITS);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_deflate_reset
+ *
+ * Description:
+ *  Start a new zlib stream for a new connection.
+ *
+ * Input Parameters:
+ *   zs - The zlib stream state.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void vnc_deflate_reset(FAR struct vnc_deflate_s *zs)
+{
+  zs->started = false;
+  zs->nbits   = 0;
+  zs->bitbuf  = 0;
+  zs->wend    = 0;
+  memset(zs->head, 0, sizeof(zs->head));
+}
+
+/****************************************************************************
+ * Name: vnc_deflate_input
+ *
+ * Description:
+ *  Return the buffer for the next VNC_DEFLATE_MAXIN bytes of uncompressed
+ *  data.  The data is compressed in place by vnc_deflate().
+ *
+ * Input Parameters:
+ *   zs - The zlib stream state.
+ *
+ * Returned Value:
+ *   The input buffer.
+ *
+ ****************************************************************************/
+
+FAR uint8_t *vnc_deflate_input(FAR struct vnc_deflate_s *zs)
+{
+  unsigned int delta;
+  int i;
+
+  /* Keep only the last VNC_DEFLATE_WSIZE bytes of history, which leaves
+   * room for VNC_DEFLATE_MAXIN bytes of new data.
+   */
+
+  if (zs->wend > VNC_DEFLATE_WSIZE)
+    {
+      delta = zs->wend - VNC_DEFLATE_WSIZE;
+      memmove(zs->window, &zs->window[delta], VNC_DEFLATE_WSIZE);
+
+      for (i = 0; i < VNC_DEFLATE_HSIZE; i++)
+        {
+          zs->head[i] = zs->head[i] > delta ? zs->head[i] - delta : 0;
+        }
+
+      zs->wend = VNC_DEFLATE_WSIZE;
+    }
+
+  return &zs->window[zs->wend];
+}
+
+/****************************************************************************
+ * Name: vnc_deflate
+ *
+ * Description:
+ *  Compress the data written to the buffer returned by vnc_deflate_input()
+ *  and flush the stream to a byte boundary (Z_SYNC_FLUSH).
+ *
+ *  The data is compressed as one block with the fixed Huffman codes.  Each
+ *  position is looked up in a hash table of the last position with the
+ *  same three bytes, and the match with that position is used if it is at
+ *  least three bytes long.
+ *
+ * Input Parameters:
+ *   zs     - The zlib stream state.
+ *   inlen  - The number of bytes in the input buffer.
+ *   out    - The output buffer.
+ *   outlen - The size of the output buffer.  This must be at least
+ *            VNC_DEFLATE_BOUND(inlen) bytes.
+ *
+ * Returned Value:
+ *   The number of compressed bytes in the output buffer.
+ *
+ ****************************************************************************/
+
+size_t vnc_deflate(FAR struct vnc_deflate_s *zs, size_t inlen,
+                   FAR uint8_t *out, size_t outlen)
+{
+  FAR const uint8_t *window = zs->window;
+  unsigned int pos;
+  unsigned int end;
+  unsigned int cand;
+  unsigned int dist = 0;
+  unsigned int len;
+  unsigned int max;
+  unsigned int hash;
+
+  DEBUGASSERT(inlen <= VNC_DEFLATE_MAXIN &&
+              outlen >= VNC_DEFLATE_BOUND(inlen));
+
+  zs->out    = out;
+  zs->outlen = outlen;
+  zs->outpos = 0;
+
+  /* The zlib header precedes the first block:  Deflate with a 32 KB
+   * window, no preset dictionary and the fastest compression level.
+   */
+
+  if (!zs->started)
+    {
+      vnc_deflate_putbits(zs, 0x78, 8);
+      vnc_deflate_putbits(zs, 0x01, 8);
+      zs->started = true;
+    }
+
+  /* BFINAL = 0, BTYPE = 01 (fixed Huffman codes) */
+
+  vnc_deflate_putbits(zs, 2, 3);
+
+  pos = zs->wend;
+  end = zs->wend + inlen;
+
+  while (pos < end)
+    {
+      len = 0;
+
+      if (end - pos >= DEFLATE_MINMATCH)
+        {
+          hash = vnc_deflate_hash(&window[pos]);
+          cand = zs->head[hash];
+          zs->head[hash] = pos + 1;
+
+          if (cand != 0)
+            {
+              cand--;
+              dist = pos - cand;
+
+              if (dist <= VNC_DEFLATE_WSIZE)
+                {
+                  max = MIN(DEFLATE_MAXMATCH, end - pos);
+                  while (len < max && window[cand + len] == window[pos + len])
+                    {
+                      len++;
+                    }
+                }
+            }
+        }
+
+      if (len >= DEFLATE_MINMATCH)
+        {
+          vnc_deflate_putmatch(zs, len, dist);
+
+          /* Remember the positions inside of the match too */
+
+          for (max = pos + len, pos++;
+               pos < max && end - pos >= DEFLATE_MINMATCH;
+               pos++)
+            {
+              zs->head[vnc_deflate_hash(&window[pos])] = pos + 1;
+            }
+
+          pos = max;
+        }
+      else
+        {
+          vnc_deflate_putsym(zs, window[pos]);
+          pos++;
+        }
+    }
+
+  /* End of block */
+
+  vnc_deflate_putsym(zs, 256);
+
+  /* Sync flush:  An empty stored block that aligns the output to a byte
+   * boundary, so that the client can decode everything sent so far.
+   */
+
+  vnc_deflate_putbits(zs, 0, 3);
+  if (zs->nbits > 0)
+    {
+      vnc_deflate_putbits(zs, 0, 8 - zs->nbits);
+    }
+
+  vnc_deflate_putbits(zs, 0x0000, 16);
+  vnc_deflate_putbits(zs, 0xffff, 16);
+
+  zs->wend = end;
+  return zs->outpos;
+}
@@ -0,0 +1,458 @@
+/****************************************************************************
+ * graphics/vnc/server/vnc_hextile.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#if defined(CONFIG_VNCSERVER_DEBUG) && !defined(CONFIG_DEBUG_GRAPHICS)
+#  undef  CONFIG_DEBUG_ERROR
+#  undef  CONFIG_DEBUG_WARN
+#  undef  CONFIG_DEBUG_INFO
+#  undef  CONFIG_DEBUG_GRAPHICS_ERROR
+#  undef  CONFIG_DEBUG_GRAPHICS_WARN
+#  undef  CONFIG_DEBUG_GRAPHICS_INFO
+#  define CONFIG_DEBUG_ERROR          1
+#  define CONFIG_DEBUG_WARN           1
+#  define CONFIG_DEBUG_INFO           1
+#  define CONFIG_DEBUG_GRAPHICS       1
+#  define CONFIG_DEBUG_GRAPHICS_ERROR 1
+#  define CONFIG_DEBUG_GRAPHICS_WARN  1
+#  define CONFIG_DEBUG_GRAPHICS_INFO  1
+#endif
+#include <debug.h>
+
+#include "vnc_server.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of colors counted to pick the background of a tile */
+
+#define HEXTILE_NCOLORS 8
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The state carried from one tile of a rectangle to the next */
+
+struct vnc_hextile_s
+{
+  uint8_t bytesperpixel;       /* Bytes per remote pixel */
+  bool bigendian;              /* True: Big-endian pixels */
+  bool bgvalid;                /* True: The client has the background */
+  bool fgvalid;                /* True: The client has the foreground */
+  uint32_t bg;                 /* Background of the previous tile */
+  uint32_t fg;                 /* Foreground of the previous tile */
+  size_t nbytes;               /* Bytes pending in the update buffer */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_hextile_colors
+ *
+ * Description:
+ *   Pick the most frequent of the first HEXTILE_NCOLORS colors of a tile
+ *   as the background.
+ *
+ * Returned Value:
+ *   The number of colors in the tile, or HEXTILE_NCOLORS + 1 if there are
+ *   more.  For two colors, the other color is returned in 'fg'.
+ *
+ ****************************************************************************/
+
+static int vnc_hextile_colors(FAR const uint32_t *pixels,
+                              unsigned int npixels, FAR uint32_t *bg,
+                              FAR uint32_t *fg)
+{
+  uint32_t colors[HEXTILE_NCOLORS];
+  uint16_t counts[HEXTILE_NCOLORS];
+  int ncolors = 0;
+  int maxndx = 0;
+  int ndx;
+  bool more = false;
+  unsigned int i;
+
+  for (i = 0; i < npixels; i++)
+    {
+      for (ndx = 0; ndx < ncolors; ndx++)
+        {
+          if (colors[ndx] == pixels[i])
+            {
+              counts[ndx]++;
+              break;
+            }
+        }
+
+      if (ndx < ncolors)
+        {
+          continue;
+        }
+
+      if (ncolors < HEXTILE_NCOLORS)
+        {
+          colors[ncolors] = pixels[i];
+          counts[ncolors] = 1;
+          ncolors++;
+        }
+      else
+        {
+          more = true;
+        }
+    }
+
+  for (ndx = 1; ndx < ncolors; ndx++)
+    {
+      if (counts[ndx] > counts[maxndx])
+        {
+          maxndx = ndx;
+        }
+    }
+
+  *bg = colors[maxndx];
+  *fg = colors[ncolors > 1 ? maxndx ^ 1 : maxndx];
+  return more ? HEXTILE_NCOLORS + 1 : ncolors;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_tile
+ *
+ * Description:
+ *   Encode one tile into the tile buffer.  Non-background pixels are
+ *   covered greedily:  From each pixel that is not yet covered, the widest
+ *   run of its color is extended downward as far as possible.  The tile is
+ *   sent raw if that is not larger.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   hextile - The state carried from the previous tile.
+ *   width   - The width of the tile.
+ *   height  - The height of the tile.
+ *
+ * Returned Value:
+ *   The size of the encoded tile.
+ *
+ ****************************************************************************/
+
+static size_t vnc_hextile_tile(FAR struct vnc_session_s *session,
+                               FAR struct vnc_hextile_s *hextile,
+                               unsigned int width, unsigned int height)
+{
+  FAR const uint32_t *pixels = session->pixels;
+  FAR uint8_t *start = session->tilebuf;
+  FAR uint8_t *limit;
+  FAR uint8_t *dest;
+  FAR uint8_t *nsubrects;
+  uint16_t covered[VNC_HEXTILE_SIZE];
+  unsigned int ps = hextile->bytesperpixel;
+  unsigned int subsize;
+  unsigned int x;
+  unsigned int y;
+  unsigned int x2;
+  unsigned int y2;
+  unsigned int i;
+  uint32_t pixel;
+  uint32_t bg;
+  uint32_t fg;
+  uint16_t mask;
+  bool colored;
+  int ncolors;
+
+  ncolors = vnc_hextile_colors(pixels, width * height, &bg, &fg);
+  colored = ncolors > 2;
+
+  /* The encoding must be smaller than the raw tile */
+
+  limit = start + 1 + width * height * ps;
+  dest  = start + 1;
+  *start = 0;
+
+  if (!hextile->bgvalid || hextile->bg != bg)
+    {
+      *start |= RFB_HEXTILE_BACK;
+      dest    = vnc_put_pixel(dest, bg, ps, hextile->bigendian);
+    }
+
+  if (ncolors == 1)
+    {
+      /* A solid tile.  The foreground of the previous tile remains
+       * valid.
+       */
+
+      hextile->bg      = bg;
+      hextile->bgvalid = true;
+      return dest - start;
+    }
+
+  *start |= RFB_HEXTILE_ANY;
+  if (colored)
+    {
+      *start |= RFB_HEXTILE_COLORED;
+    }
+  else if (!hextile->fgvalid || hextile->fg != fg)
+    {
+      *start |= RFB_HEXTILE_FORE;
+      dest    = vnc_put_pixel(dest, fg, ps, hextile->bigendian);
+    }
+
+  nsubrects  = dest++;
+  *nsubrects = 0;
+  subsize    = colored ? ps + 2 : 2;
+  memset(covered, 0, sizeof(covered));
+
+  for (y = 0; y < height; y++)
+    {
+      for (x = 0; x < width; x++)
+        {
+          pixel = pixels[y * width + x];
+          if (pixel == bg || (covered[y] & (1 << x)) != 0)
+            {
+              continue;
+            }
+
+          if (dest + subsize >= limit || *nsubrects == 255)
+            {
+              goto raw;
+            }
+
+          /* The widest run of this color... */
+
+          for (x2 = x + 1;
+               x2 < width && pixels[y * width + x2] == pixel &&
+               (covered[y] & (1 << x2)) == 0;
+               x2++)
+            {
+            }
+
+          mask = ((1 << (x2 - x)) - 1) << x;
+
+          /* ...extended downward */
+
+          for (y2 = y + 1; y2 < height; y2++)
+            {
+              for (i = x; i < x2; i++)
+                {
+                  if (pixels[y2 * width + i] != pixel)
+                    {
+                      break;
+                    }
+                }
+
+              if (i < x2 || (covered[y2] & mask) != 0)
+                {
+                  break;
+                }
+
+              covered[y2] |= mask;
+            }
+
+          if (colored)
+            {
+              dest = vnc_put_pixel(dest, pixel, ps, hextile->bigendian);
+            }
+
+          *dest++ = (uint8_t)((x << 4) | y);
+          *dest++ = (uint8_t)(((x2 - x - 1) << 4) | (y2 - y - 1));
+          (*nsubrects)++;
+
+          x = x2 - 1;
+        }
+    }
+
+  hextile->bg      = bg;
+  hextile->bgvalid = true;
+  hextile->fg      = fg;
+  hextile->fgvalid = !colored;
+  return dest - start;
+
+raw:
+
+  /* Neither the background nor the foreground can be carried over from a
+   * raw tile.
+   */
+
+  dest   = start;
+  *dest++ = RFB_HEXTILE_RAW;
+
+  for (i = 0; i < width * height; i++)
+    {
+      dest = vnc_put_pixel(dest, pixels[i], ps, hextile->bigendian);
+    }
+
+  hextile->bgvalid = false;
+  hextile->fgvalid = false;
+  return dest - start;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_write
+ *
+ * Description:
+ *   Append data to the update buffer, sending the buffer whenever it is
+ *   full.
+ *
+ ****************************************************************************/
+
+static int vnc_hextile_write(FAR struct vnc_session_s *session,
+                             FAR struct vnc_hextile_s *hextile,
+                             FAR const uint8_t *src, size_t size)
+{
+  size_t nbytes;
+  int ret;
+
+  while (size > 0)
+    {
+      nbytes = MIN(size, VNCSERVER_UPDATE_BUFSIZE - hextile->nbytes);
+      memcpy(&session->outbuf[hextile->nbytes], src, nbytes);
+
+      hextile->nbytes += nbytes;
+      src             += nbytes;
+      size            -= nbytes;
+
+      if (hextile->nbytes == VNCSERVER_UPDATE_BUFSIZE)
+        {
+          ret = vnc_send(session, session->outbuf, hextile->nbytes);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          hextile->nbytes = 0;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_hextile
+ *
+ * Description:
+ *  Send the framebuffer update using the Hextile encoding.
+ *
+ *  The whole update region is sent as one rectangle.  The tiles of the
+ *  rectangle are streamed through the update buffer, so once the
+ *  rectangle header is sent, all of its tiles must follow in the same
+ *  pixel format.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; A negated errno value is returned on failure that
+ *   indicates the nature of the failure.  A failure is only returned
+ *   in cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+int vnc_hextile(FAR struct vnc_session_s *session,
+                FAR struct nxgl_rect_s *rect)
+{
+  FAR struct rfb_framebufferupdate_s *update;
+  struct vnc_hextile_s hextile;
+  nxgl_coord_t width;
+  nxgl_coord_t height;
+  nxgl_coord_t x;
+  nxgl_coord_t y;
+  uint8_t colorfmt;
+  size_t size;
+  int ret;
+
+  /* Set up characteristics of the client pixel format to use on this
+   * update.
+   */
+
+  colorfmt              = session->colorfmt;
+  hextile.bytesperpixel = (session->bpp + 7) >> 3;
+  hextile.bigendian     = session->bigendian;
+  hextile.bgvalid       = false;
+  hextile.fgvalid       = false;
+  hextile.bg            = 0;
+  hextile.fg            = 0;
+
+  /* Format the FramebufferUpdate message */
+
+  update          = (FAR struct rfb_framebufferupdate_s *)session->outbuf;
+  update->msgtype = RFB_FBUPDATE_MSG;
+  update->padding = 0;
+  rfb_putbe16(update->nrect, 1);
+
+  rfb_putbe16(update->rect[0].xpos, rect->pt1.x);
+  rfb_putbe16(update->rect[0].ypos, rect->pt1.y);
+  rfb_putbe16(update->rect[0].width, rect->pt2.x - rect->pt1.x + 1);
+  rfb_putbe16(update->rect[0].height, rect->pt2.y - rect->pt1.y + 1);
+  rfb_putbe32(update->rect[0].encoding, RFB_ENCODING_HEXTILE);
+
+  hextile.nbytes = VNCSERVER_UPDATE_HDRSIZE;
+
+  /* Then the tiles in left-to-right, top-to-bottom order */
+
+  for (y = rect->pt1.y; y <= rect->pt2.y; y += VNC_HEXTILE_SIZE)
+    {
+      height = MIN(VNC_HEXTILE_SIZE, rect->pt2.y - y + 1);
+
+      for (x = rect->pt1.x; x <= rect->pt2.x; x += VNC_HEXTILE_SIZE)
+        {
+          width = MIN(VNC_HEXTILE_SIZE, rect->pt2.x - x + 1);
+
+          ret = vnc_convert_tile(session, colorfmt, x, y, width, height,
+                                 session->pixels);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          size = vnc_hextile_tile(session, &hextile, width, height);
+          ret  = vnc_hextile_write(session, &hextile, session->tilebuf,
+                                   size);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  ret = vnc_send(session, session->outbuf, hextile.nbytes);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  updinfo("Sent Hextile {(%d, %d),(%d, %d)}\n",
+          rect->pt1.x, rect->pt1.y, rect->pt2.x, rect->pt2.y);
+  return OK;
+}
@@ -529,6 +529,6 @@ int vnc_client_pixelformat(FAR struct vnc_session_s *session,
       return -ENOSYS;
     }
 
-  session->change = true;
+  session->depth = pixelfmt->depth;
   return OK;
 }
@@ -265,7 +265,7 @@ static size_t vnc_copy32(FAR struct vnc_session_s *session,
       srcleft = (FAR lfb_color_t *)((uintptr_t)srcleft + RFB_STRIDE);
     }
 
-  return (size_t)((uintptr_t)srcleft - (uintptr_t)update->rect[0].data);
+  return (size_t)((uintptr_t)dest - (uintptr_t)update->rect[0].data);
 }
 
 /****************************************************************************
@@ -293,7 +293,6 @@ static size_t vnc_copy32(FAR struct vnc_session_s *session,
 int vnc_raw(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect)
 {
   FAR struct rfb_framebufferupdate_s *update;
-  FAR const uint8_t *src;
   nxgl_coord_t srcwidth;
   nxgl_coord_t srcheight;
   nxgl_coord_t destwidth;
@@ -307,8 +306,8 @@ int vnc_raw(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect)
   unsigned int bytesperpixel;
   unsigned int maxwidth;
   size_t size;
-  ssize_t nsent;
   uint8_t colorfmt;
+  int ret;
 
   union
   {
@@ -469,8 +468,7 @@ int vnc_raw(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect)
 
           /* We are ready to send the update packet to the VNC client */
 
-          size += SIZEOF_RFB_FRAMEBUFFERUPDATE_S(SIZEOF_RFB_RECTANGE_S(0));
-          src   = session->outbuf;
+          size += VNCSERVER_UPDATE_HDRSIZE;
 
           /* At the very last most, make certain that the color format
            * has not changed asynchronously.
@@ -478,26 +476,11 @@ int vnc_raw(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect)
 
           if (colorfmt == session->colorfmt)
             {
-              /* Okay send until all of the bytes are out.  This may
-               * loop for the case where TCP write buffering is enabled
-               * and there are a limited number of IOBs available.
-               */
-
-              do
+              ret = vnc_send(session, session->outbuf, size);
+              if (ret < 0)
                 {
-                  nsent = psock_send(&session->connect, src, size, 0);
-                  if (nsent < 0)
-                    {
-                      gerr("ERROR: Send FrameBufferUpdate failed: %d\n",
-                           (int)nsent);
-                      return (int)nsent;
-                    }
-
-                  DEBUGASSERT(nsent <= size);
-                  src  += nsent;
-                  size -= nsent;
+                  return ret;
                 }
-              while (size > 0);
 
               updinfo("Sent {(%d, %d),(%d, %d)}\n",
                       x, y, x + updwidth -1, y + updheight - 1);
@@ -507,3 +490,47 @@ int vnc_raw(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect)
 
   return OK;
 }
+
+/****************************************************************************
+ * Name: vnc_send
+ *
+ * Description:
+ *  Send a buffer to the VNC client.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   buf     - The data to send.
+ *   size    - The number of bytes to send.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; A negated errno value is returned on a network
+ *   failure.
+ *
+ ****************************************************************************/
+
+int vnc_send(FAR struct vnc_session_s *session, FAR const uint8_t *buf,
+             size_t size)
+{
+  ssize_t nsent;
+
+  /* Send until all of the bytes are out.  This may loop for the case where
+   * TCP write buffering is enabled and there are a limited number of IOBs
+   * available.
+   */
+
+  while (size > 0)
+    {
+      nsent = psock_send(&session->connect, buf, size, 0);
+      if (nsent < 0)
+        {
+          gerr("ERROR: Send FrameBufferUpdate failed: %d\n", (int)nsent);
+          return (int)nsent;
+        }
+
+      DEBUGASSERT(nsent <= size);
+      buf  += nsent;
+      size -= nsent;
+    }
+
+  return OK;
+}
@@ -292,19 +292,26 @@ int vnc_receiver(FAR struct vnc_session_s *session)
                 }
               else
                 {
-                  /* Enqueue the update */
+                  /* Changes are sent as they occur, so only requests for
+                   * the full content of a region need to be handled.
+                   */
 
                   update = (FAR struct rfb_fbupdatereq_s *)session->inbuf;
-
-                  rect.pt1.x = rfb_getbe16(update->xpos);
-                  rect.pt1.y = rfb_getbe16(update->ypos);
-                  rect.pt2.x = rect.pt1.x + rfb_getbe16(update->width);
-                  rect.pt2.y = rect.pt1.y + rfb_getbe16(update->height);
-
-                  ret = vnc_update_rectangle(session, &rect, false);
-                  if (ret < 0)
+                  if (update->incremental == 0)
                     {
-                      gerr("ERROR: Failed to queue update: %d\n", ret);
+                      rect.pt1.x = rfb_getbe16(update->xpos);
+                      rect.pt1.y = rfb_getbe16(update->ypos);
+                      rect.pt2.x = rect.pt1.x +
+                                   rfb_getbe16(update->width) - 1;
+                      rect.pt2.y = rect.pt1.y +
+                                   rfb_getbe16(update->height) - 1;
+
+                      ret = vnc_update_rectangle(session, &rect, false);
+                      if (ret < 0)
+                        {
+                          gerr("ERROR: Failed to queue update: %d\n",
+                               ret);
+                        }
                     }
                 }
             }
@@ -469,9 +476,12 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
 
   /* Assume that there are no common encodings (other than RAW) */
 
-  session->rre = false;
+  session->rre      = false;
+  session->encoding = RFB_ENCODING_RAW;
 
-  /* Loop for each client supported encoding */
+  /* Loop for each client supported encoding.  The encodings are listed in
+   * the order of preference of the client.
+   */
 
   nencodings = rfb_getbe16(encodings->nencodings);
   for (i = 0; i < nencodings; i++)
@@ -486,9 +496,26 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
         {
           session->rre = true;
         }
+
+      /* Use the first of Hextile or ZRLE that the client lists */
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+      else if (encoding == RFB_ENCODING_HEXTILE &&
+               session->encoding == RFB_ENCODING_RAW)
+        {
+          session->encoding = RFB_ENCODING_HEXTILE;
+        }
+#endif
+
+#ifdef CONFIG_VNCSERVER_ZRLE
+      else if (encoding == RFB_ENCODING_ZRLE &&
+               session->encoding == RFB_ENCODING_RAW)
+        {
+          session->encoding = RFB_ENCODING_ZRLE;
+        }
+#endif
     }
 
-  session->change = true;
   return OK;
 }
 
@@ -104,8 +104,6 @@ FAR struct vnc_session_s *g_vnc_sessions[RFB_MAX_DISPLAYS];
 static void vnc_reset_session(FAR struct vnc_session_s *session,
                               FAR uint8_t *fb, int display)
 {
-  int i;
-
   /* Close any open sockets */
 
   if (session->state >= VNCSERVER_CONNECTED)
@@ -119,26 +117,29 @@ static void vnc_reset_session(FAR struct vnc_session_s *session,
   memset(&session->connect, 0, sizeof(struct socket));
   memset(&session->listen, 0, sizeof(struct socket));
 
-  /* Put all of the pre-allocated update structures into the freelist */
+  /* Forget all marked tiles.  The new client will request the whole
+   * screen.
+   */
 
-  sq_init(&session->updqueue);
-  sq_init(&session->updfree);
+  memset(session->dirty, 0, sizeof(session->dirty));
+#ifdef CONFIG_VNCSERVER_SHADOWFB
+  memset(session->forced, 0, sizeof(session->forced));
+#endif
+  session->damaged = false;
+  nxsem_reset(&session->updsem, 0);
 
-  for (i = 0; i < CONFIG_VNCSERVER_NUPDATES; i++)
-    {
-      sq_addlast((FAR sq_entry_t *)&session->updpool[i], &session->updfree);
-    }
+#ifdef CONFIG_VNCSERVER_ZRLE
+  /* Each connection has its own zlib stream */
 
-  /* Set the INITIALIZED state */
+  vnc_deflate_reset(&session->zstream);
+#endif
 
-  nxsem_reset(&session->freesem, CONFIG_VNCSERVER_NUPDATES);
-  nxsem_reset(&session->queuesem, 0);
+  /* Set the INITIALIZED state */
 
-  session->fb      = fb;
-  session->display = display;
-  session->state   = VNCSERVER_INITIALIZED;
-  session->nwhupd  = 0;
-  session->change  = true;
+  session->fb       = fb;
+  session->display  = display;
+  session->state    = VNCSERVER_INITIALIZED;
+  session->encoding = RFB_ENCODING_RAW;
 
   /* Careful not to disturb the keyboard/mouse callouts set by
    * vnc_fbinitialize().  Client related data left in garbage state.
@@ -290,9 +291,24 @@ int vnc_server(int argc, FAR char *argv[])
       goto errout_with_fb;
     }
 
+#ifdef CONFIG_VNCSERVER_SHADOWFB
+  /* Allocate the shadow framebuffer.  Like the framebuffer, it starts out
+   * cleared.
+   */
+
+  session->shadow = (FAR uint8_t *)kmm_zalloc(RFB_SIZE);
+  if (session->shadow == NULL)
+    {
+      gerr("ERROR: Failed to allocate shadow framebuffer: %lu KB\n",
+           (unsigned long)(RFB_SIZE / 1024));
+      kmm_free(session);
+      ret = -ENOMEM;
+      goto errout_with_fb;
+    }
+#endif
+
   g_vnc_sessions[display] = session;
-  nxsem_init(&session->freesem, 0, CONFIG_VNCSERVER_NUPDATES);
-  nxsem_init(&session->queuesem, 0, 0);
+  nxsem_init(&session->updsem, 0, 0);
 
   /* Inform any waiter that we have started */
 
@@ -145,16 +145,26 @@
 #  define CONFIG_VNCSERVER_INBUFFER_SIZE 80
 #endif
 
-#ifndef CONFIG_VNCSERVER_NUPDATES
-#  define CONFIG_VNCSERVER_NUPDATES 48
-#endif
-
 #ifndef CONFIG_VNCSERVER_UPDATE_BUFSIZE
 #  define CONFIG_VNCSERVER_UPDATE_BUFSIZE 4096
 #endif
 
+#ifndef CONFIG_VNCSERVER_ZRLE_WINDOW
+#  define CONFIG_VNCSERVER_ZRLE_WINDOW 4096
+#endif
+
+#if defined(CONFIG_VNCSERVER_ZRLE) && CONFIG_VNCSERVER_UPDATE_BUFSIZE < 512
+#  error CONFIG_VNCSERVER_ZRLE requires CONFIG_VNCSERVER_UPDATE_BUFSIZE >= 512
+#endif
+
+/* The update buffer holds the FramebufferUpdate header with one rectangle
+ * header, followed by up to CONFIG_VNCSERVER_UPDATE_BUFSIZE bytes of data.
+ */
+
+#define VNCSERVER_UPDATE_HDRSIZE \
+  SIZEOF_RFB_FRAMEBUFFERUPDATE_S(SIZEOF_RFB_RECTANGE_S(0))
 #define VNCSERVER_UPDATE_BUFSIZE \
-  (CONFIG_VNCSERVER_UPDATE_BUFSIZE + SIZEOF_RFB_FRAMEBUFFERUPDATE_S(0))
+  (CONFIG_VNCSERVER_UPDATE_BUFSIZE + VNCSERVER_UPDATE_HDRSIZE)
 
 /* Local framebuffer characteristics in bytes */
 
@@ -162,6 +172,59 @@
 #define RFB_STRIDE          (RFB_BYTESPERPIXEL * CONFIG_VNCSERVER_SCREENWIDTH)
 #define RFB_SIZE            (RFB_STRIDE * CONFIG_VNCSERVER_SCREENHEIGHT)
 
+/* Damage tracking.  The local framebuffer is divided into tiles of
+ * VNC_TILESIZE x VNC_TILESIZE pixels.  Each tile is represented by one bit
+ * in a bitmap with VNC_TILEWORDS 32-bit words per row of tiles.
+ */
+
+#define VNC_TILESHIFT       4
+#define VNC_TILESIZE        (1 << VNC_TILESHIFT)
+#define VNC_TILECOLS \
+  ((CONFIG_VNCSERVER_SCREENWIDTH + VNC_TILESIZE - 1) >> VNC_TILESHIFT)
+#define VNC_TILEROWS \
+  ((CONFIG_VNCSERVER_SCREENHEIGHT + VNC_TILESIZE - 1) >> VNC_TILESHIFT)
+#define VNC_TILEWORDS       ((VNC_TILECOLS + 31) >> 5)
+
+/* Encoder tiles.  Hextile tiles are 16x16 pixels.  ZRLE tiles are at most
+ * 64 pixels wide and are limited here to VNC_ZRLE_TILEHEIGHT rows, each
+ * tile being sent as a separate rectangle.
+ */
+
+#define VNC_HEXTILE_SIZE    16
+#define VNC_ZRLE_TILEWIDTH  64
+#define VNC_ZRLE_TILEHEIGHT 16
+
+#if defined(CONFIG_VNCSERVER_ZRLE)
+#  define VNC_ENCODE_PIXELS (VNC_ZRLE_TILEWIDTH * VNC_ZRLE_TILEHEIGHT)
+#elif defined(CONFIG_VNCSERVER_HEXTILE)
+#  define VNC_ENCODE_PIXELS (VNC_HEXTILE_SIZE * VNC_HEXTILE_SIZE)
+#endif
+
+/* The Hextile tile buffer must hold one raw tile of 32-bit pixels plus
+ * the subencoding mask.
+ */
+
+#define VNC_HEXTILE_BUFSIZE (VNC_HEXTILE_SIZE * VNC_HEXTILE_SIZE * 4 + 1)
+
+/* Deflate.  The window holds VNC_DEFLATE_WSIZE bytes of history plus the
+ * uncompressed data of one ZRLE tile (the subencoding type, a palette of up
+ * to 16 pixels and one CPIXEL per pixel at most).
+ */
+
+#define VNC_DEFLATE_WSIZE   CONFIG_VNCSERVER_ZRLE_WINDOW
+#define VNC_DEFLATE_MAXIN \
+  (1 + 16 * 4 + VNC_ZRLE_TILEWIDTH * VNC_ZRLE_TILEHEIGHT * 4)
+#define VNC_DEFLATE_HBITS   10
+#define VNC_DEFLATE_HSIZE   (1 << VNC_DEFLATE_HBITS)
+
+/* The worst case size of the compressed output of 'n' input bytes.  Fixed
+ * Huffman codes never take more than 9 bits per byte.  The remainder
+ * covers the zlib header, the block header and end-of-block code, and the
+ * empty stored block of the sync flush.
+ */
+
+#define VNC_DEFLATE_BOUND(n) ((((n) * 9) + 7) / 8 + 12)
+
 /* RFB Port Number */
 
 #define RFB_PORT_BASE       5900
@@ -219,16 +282,23 @@ enum vnc_server_e
   VNCSERVER_STOPPED            /* The updater has stopped */
 };
 
-/* This structure is used to queue FrameBufferUpdate event.  It includes a
- * pointer to support singly linked list.
- */
+/* The state of the single zlib stream of a ZRLE connection */
 
-struct vnc_fbupdate_s
+#ifdef CONFIG_VNCSERVER_ZRLE
+struct vnc_deflate_s
 {
-  FAR struct vnc_fbupdate_s *flink;
-  bool whupd;                  /* True: whole screen update */
-  struct nxgl_rect_s rect;     /* The enqueued update rectangle */
+  bool started;                /* True: The zlib header has been sent */
+  uint8_t nbits;               /* Number of bits in bitbuf */
+  uint16_t wend;               /* End of the data in window[] */
+  uint32_t bitbuf;             /* Pending output bits, LSB first */
+  FAR uint8_t *out;            /* Output buffer of the current call */
+  size_t outlen;               /* Size of the output buffer */
+  size_t outpos;               /* Bytes written to the output buffer */
+
+  uint16_t head[VNC_DEFLATE_HSIZE];  /* Last position + 1 of each hash */
+  uint8_t window[VNC_DEFLATE_WSIZE + VNC_DEFLATE_MAXIN];
 };
+#endif
 
 struct vnc_session_s
 {
@@ -237,16 +307,16 @@ struct vnc_session_s
   struct socket listen;        /* Listen socket */
   struct socket connect;       /* Connected socket */
   volatile uint8_t state;      /* See enum vnc_server_e */
-  volatile uint8_t nwhupd;     /* Number of whole screen updates queued */
-  volatile bool change;        /* True: Frambebuffer data change since last whole screen update */
 
   /* Display geometry and color characteristics */
 
   uint8_t display;             /* Display number (for debug) */
   volatile uint8_t colorfmt;   /* Remote color format (See include/nuttx/fb.h) */
   volatile uint8_t bpp;        /* Remote bits per pixel */
+  volatile uint8_t depth;      /* Remote color depth */
   volatile bool bigendian;     /* True: Remote expect data in big-endian format */
   volatile bool rre;           /* True: Remote supports RRE encoding */
+  volatile int32_t encoding;   /* Preferred Hextile, ZRLE or RAW encoding */
   FAR uint8_t *fb;             /* Allocated local frame buffer */
 
   /* VNC client input support */
@@ -259,13 +329,32 @@ struct vnc_session_s
 
   pthread_t updater;           /* Updater thread ID */
 
-  /* Update list information */
+  /* Damage tracking.  dirty[] holds the tiles with changed framebuffer
+   * data and forced[] the tiles requested by the client.  The updater
+   * moves both to its private copies updtiles[] and updforced[].
+   */
+
+  uint32_t dirty[VNC_TILEROWS][VNC_TILEWORDS];
+  uint32_t updtiles[VNC_TILEROWS][VNC_TILEWORDS];
+#ifdef CONFIG_VNCSERVER_SHADOWFB
+  uint32_t forced[VNC_TILEROWS][VNC_TILEWORDS];
+  uint32_t updforced[VNC_TILEROWS][VNC_TILEWORDS];
+  FAR uint8_t *shadow;         /* The framebuffer as last sent */
+#endif
+  volatile bool damaged;       /* True: Tiles are waiting for the updater */
+  sem_t updsem;                /* Wakes up the updater */
 
-  struct vnc_fbupdate_s updpool[CONFIG_VNCSERVER_NUPDATES];
-  sq_queue_t updfree;
-  sq_queue_t updqueue;
-  sem_t freesem;
-  sem_t queuesem;
+  /* Encoder state */
+
+#ifdef VNC_ENCODE_PIXELS
+  uint32_t pixels[VNC_ENCODE_PIXELS];       /* Tile in the remote format */
+#endif
+#ifdef CONFIG_VNCSERVER_HEXTILE
+  uint8_t tilebuf[VNC_HEXTILE_BUFSIZE];     /* One encoded Hextile tile */
+#endif
+#ifdef CONFIG_VNCSERVER_ZRLE
+  struct vnc_deflate_s zstream;             /* The ZRLE zlib stream */
+#endif
 
   /* I/O buffers for misc network send/receive */
 
@@ -438,12 +527,14 @@ int vnc_stop_updater(FAR struct vnc_session_s *session);
  * Name: vnc_update_rectangle
  *
  * Description:
- *  Queue an update of the specified rectangular region on the display.
+ *  Mark the tiles of the specified rectangular region on the display for
+ *  the next update.
  *
  * Input Parameters:
  *   session - An instance of the session structure.
  *   rect    - The rectanglular region to be updated.
- *   change  - True: Frame buffer data has changed
+ *   change  - True: Frame buffer data has changed.  False: The region was
+ *             requested by the client and must be sent even if unchanged.
  *
  * Returned Value:
  *   Zero (OK) is returned on success; a negated errno value is returned on
@@ -514,6 +605,130 @@ int vnc_rre(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect);
 
 int vnc_raw(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect);
 
+/****************************************************************************
+ * Name: vnc_hextile
+ *
+ * Description:
+ *  Send the framebuffer update using the Hextile encoding.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; A negated errno value is returned on failure that
+ *   indicates the nature of the failure.  A failure is only returned
+ *   in cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_HEXTILE
+int vnc_hextile(FAR struct vnc_session_s *session,
+                FAR struct nxgl_rect_s *rect);
+#endif
+
+/****************************************************************************
+ * Name: vnc_zrle
+ *
+ * Description:
+ *  Send the framebuffer update using the ZRLE encoding.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; A negated errno value is returned on failure that
+ *   indicates the nature of the failure.  A failure is only returned
+ *   in cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_ZRLE
+int vnc_zrle(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect);
+#endif
+
+/****************************************************************************
+ * Name: vnc_deflate_reset
+ *
+ * Description:
+ *  Start a new zlib stream for a new connection.
+ *
+ * Input Parameters:
+ *   zs - The zlib stream state.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_ZRLE
+void vnc_deflate_reset(FAR struct vnc_deflate_s *zs);
+#endif
+
+/****************************************************************************
+ * Name: vnc_deflate_input
+ *
+ * Description:
+ *  Return the buffer for the next VNC_DEFLATE_MAXIN bytes of uncompressed
+ *  data.  The data is compressed in place by vnc_deflate().
+ *
+ * Input Parameters:
+ *   zs - The zlib stream state.
+ *
+ * Returned Value:
+ *   The input buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_ZRLE
+FAR uint8_t *vnc_deflate_input(FAR struct vnc_deflate_s *zs);
+#endif
+
+/****************************************************************************
+ * Name: vnc_deflate
+ *
+ * Description:
+ *  Compress the data written to the buffer returned by vnc_deflate_input()
+ *  and flush the stream to a byte boundary (Z_SYNC_FLUSH).
+ *
+ * Input Parameters:
+ *   zs     - The zlib stream state.
+ *   inlen  - The number of bytes in the input buffer.
+ *   out    - The output buffer.
+ *   outlen - The size of the output buffer.  This must be at least
+ *            VNC_DEFLATE_BOUND(inlen) bytes.
+ *
+ * Returned Value:
+ *   The number of compressed bytes in the output buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_VNCSERVER_ZRLE
+size_t vnc_deflate(FAR struct vnc_deflate_s *zs, size_t inlen,
+                   FAR uint8_t *out, size_t outlen);
+#endif
+
+/****************************************************************************
+ * Name: vnc_send
+ *
+ * Description:
+ *  Send a buffer to the VNC client.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   buf     - The data to send.
+ *   size    - The number of bytes to send.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; A negated errno value is returned on a network
+ *   failure.
+ *
+ ****************************************************************************/
+
+int vnc_send(FAR struct vnc_session_s *session, FAR const uint8_t *buf,
+             size_t size);
+
 /****************************************************************************
  * Name: vnc_key_map
  *
@@ -559,6 +774,55 @@ uint16_t vnc_convert_rgb16_555(lfb_color_t rgb);
 uint16_t vnc_convert_rgb16_565(lfb_color_t rgb);
 uint32_t vnc_convert_rgb32_888(lfb_color_t rgb);
 
+/****************************************************************************
+ * Name: vnc_convert_tile
+ *
+ * Description:
+ *  Convert a tile of the local framebuffer to the remote framebuffer color
+ *  format.
+ *
+ * Input Parameters:
+ *   session  - An instance of the session structure.
+ *   colorfmt - The remote framebuffer color format.
+ *   x, y     - The upper left position of the tile.
+ *   width    - The width of the tile in pixels.
+ *   height   - The height of the tile in rows.
+ *   pixels   - Receives the width * height remote pixels.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the color format is not supported.
+ *
+ ****************************************************************************/
+
+#ifdef VNC_ENCODE_PIXELS
+int vnc_convert_tile(FAR struct vnc_session_s *session, uint8_t colorfmt,
+                     nxgl_coord_t x, nxgl_coord_t y, nxgl_coord_t width,
+                     nxgl_coord_t height, FAR uint32_t *pixels);
+#endif
+
+/****************************************************************************
+ * Name: vnc_put_pixel
+ *
+ * Description:
+ *  Store the 'nbytes' least significant bytes of a remote pixel in the
+ *  byte order of the remote framebuffer.
+ *
+ * Input Parameters:
+ *   dest      - The location to store the pixel.
+ *   pixel     - The pixel in the remote framebuffer color format.
+ *   nbytes    - The number of bytes to store (1-4).
+ *   bigendian - True: Store in big-endian order.
+ *
+ * Returned Value:
+ *   The location following the pixel.
+ *
+ ****************************************************************************/
+
+#ifdef VNC_ENCODE_PIXELS
+FAR uint8_t *vnc_put_pixel(FAR uint8_t *dest, uint32_t pixel,
+                           unsigned int nbytes, bool bigendian);
+#endif
+
 /****************************************************************************
  * Name: vnc_colors
  *
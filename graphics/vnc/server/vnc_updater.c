@@ -27,7 +27,6 @@
 #include <string.h>
 #include <sched.h>
 #include <pthread.h>
-#include <queue.h>
 #include <assert.h>
 #include <errno.h>
 
@@ -50,21 +49,10 @@
 
 #include "vnc_server.h"
 
-/****************************************************************************
- * Pre-processor Definitions
- ****************************************************************************/
-
-#undef VNCSERVER_SEM_DEBUG          /* Define to dump queue/semaphore state */
-#undef VNCSERVER_SEM_DEBUG_SILENT   /* Define to dump only suspicious conditions */
-
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-#ifdef VNCSERVER_SEM_DEBUG
-static sem_t g_errsem = SEM_INITIALIZER(1);
-#endif
-
 /* A rectangle represent the entire local framebuffer */
 
 static const struct nxgl_rect_s g_wholescreen =
@@ -84,256 +72,356 @@ static const struct nxgl_rect_s g_wholescreen =
  ****************************************************************************/
 
 /****************************************************************************
- * Name: vnc_sem_debug
+ * Name: vnc_test_tile, vnc_set_tile, and vnc_clear_tile
  *
  * Description:
- *   Dump information about the freesem to verify that it is sync.
- *
- * Input Parameters:
- *   session - A reference to the VNC session structure.
- *
- * Returned Value:
- *   A non-NULL structure pointer should always be returned.  This function
- *   will wait if no structure is available.
+ *   Test, set, or clear the bit of one tile in a tile bitmap.
  *
  ****************************************************************************/
 
-#ifdef VNCSERVER_SEM_DEBUG
-static void vnc_sem_debug(FAR struct vnc_session_s *session,
-                          FAR const char *msg, unsigned int unattached)
+static inline bool vnc_test_tile(FAR uint32_t *map, unsigned int col)
 {
-  FAR struct vnc_fbupdate_s *update;
-  int nqueued;
-  int nfree;
-  int freesem;
-  int queuesem;
-  int freecount;
-  int queuecount;
-  int freewaiting;
-  int queuewaiting;
-  int ret;
-
-  ret = nxsem_wait_uninterruptible(&g_errsem);
-  if (ret < 0)
-    {
-      /* Should happen only on task cancellation */
-
-      DEBUGASSERT(ret == -ECANCELED);
-      return;
-    }
-
-  /* Count structures in the list */
-
-  nqueued      = sq_count(&session->updqueue);
-  nfree        = sq_count(&session->updfree);
-
-  freesem      = session->freesem.semcount;
-  queuesem     = session->queuesem.semcount;
-
-  freecount    = freesem  > 0 ? freesem   : 0;
-  queuecount   = queuesem > 0 ? queuesem  : 0;
-
-  freewaiting  = freesem  < 0 ? -freesem  : 0;
-  queuewaiting = queuesem < 0 ? -queuesem : 0;
-
-#ifdef VNCSERVER_SEM_DEBUG_SILENT
-  /* This dumps most false alarms in the case where:
-   *
-   * - Updater was waiting on a semaphore (count is -1)
-   * - New update added to the queue (queue count is 1)
-   * - queuesem posted.  Wakes up Updater and the count is 0.
-   */
+  return (map[col >> 5] & ((uint32_t)1 << (col & 31))) != 0;
+}
 
-  if ((nqueued + nfree) != (freecount + queuecount))
-#endif
-    {
-      syslog(LOG_INFO, "FREESEM DEBUG:    %s\n", msg);
-      syslog(LOG_INFO, "  Free list:\n");
-      syslog(LOG_INFO, "    semcount:     %d\n", freecount);
-      syslog(LOG_INFO, "    queued nodes: %u\n", nfree);
-      syslog(LOG_INFO, "    waiting:      %u\n", freewaiting);
-      syslog(LOG_INFO, "  Qeued Updates:\n");
-      syslog(LOG_INFO, "    semcount:     %d\n", queuecount);
-      syslog(LOG_INFO, "    queued nodes: %u\n", nqueued);
-      syslog(LOG_INFO, "    waiting:      %u\n", queuewaiting);
-      syslog(LOG_INFO, "  Unqueued:       %u\n", unattached);
-    }
+static inline void vnc_set_tile(FAR uint32_t *map, unsigned int col)
+{
+  map[col >> 5] |= (uint32_t)1 << (col & 31);
+}
 
-  nxsem_post(&g_errsem);
+static inline void vnc_clear_tile(FAR uint32_t *map, unsigned int col)
+{
+  map[col >> 5] &= ~((uint32_t)1 << (col & 31));
 }
-#else
-#  define vnc_sem_debug(s,m,u)
-#endif
 
 /****************************************************************************
- * Name: vnc_alloc_update
+ * Name: vnc_diff_tiles
  *
  * Description:
- *   Allocate one update structure by taking it from the freelist.
+ *   Compare each changed tile with the shadow framebuffer.  Changed rows
+ *   are copied to the shadow framebuffer.  Tiles that did not change are
+ *   dropped unless they were requested by the client.
  *
  * Input Parameters:
  *   session - A reference to the VNC session structure.
  *
  * Returned Value:
- *   A non-NULL structure pointer should always be returned.  This function
- *   will wait if no structure is available.
+ *   None
  *
  ****************************************************************************/
 
-static FAR struct vnc_fbupdate_s *
-vnc_alloc_update(FAR struct vnc_session_s *session)
+#ifdef CONFIG_VNCSERVER_SHADOWFB
+static void vnc_diff_tiles(FAR struct vnc_session_s *session)
 {
-  FAR struct vnc_fbupdate_s *update;
-
-  /* Reserve one element from the free list.  Lock the scheduler to assure
-   * that the sq_remfirst() and the successful return from nxsem_wait are
-   * atomic.  Of course, the scheduler will be unlocked while we wait.
-   */
+  FAR uint32_t *tiles;
+  FAR uint32_t *forced;
+  unsigned int row;
+  unsigned int col;
+  nxgl_coord_t y;
+  nxgl_coord_t yend;
+  size_t offset;
+  size_t width;
+  bool changed;
+  bool wanted;
+  int nskipped = 0;
+
+  for (row = 0; row < VNC_TILEROWS; row++)
+    {
+      tiles  = session->updtiles[row];
+      forced = session->updforced[row];
 
-  sched_lock();
-  vnc_sem_debug(session, "Before alloc", 0);
+      for (col = 0; col < VNC_TILECOLS; col++)
+        {
+          wanted = vnc_test_tile(forced, col);
+          if (!wanted && !vnc_test_tile(tiles, col))
+            {
+              continue;
+            }
 
-  nxsem_wait_uninterruptible(&session->freesem);
+          /* Compare the tile row-by-row, copying the rows that changed.
+           * Tiles requested by the client are compared too so that the
+           * shadow framebuffer matches what the client has.
+           */
 
-  /* It is reserved.. go get it */
+          y      = row << VNC_TILESHIFT;
+          yend   = MIN(y + VNC_TILESIZE, CONFIG_VNCSERVER_SCREENHEIGHT);
+          offset = RFB_STRIDE * y +
+                   RFB_BYTESPERPIXEL * (col << VNC_TILESHIFT);
+          width  = RFB_BYTESPERPIXEL *
+                   MIN(VNC_TILESIZE, CONFIG_VNCSERVER_SCREENWIDTH -
+                                     (col << VNC_TILESHIFT));
+          changed = false;
 
-  update = (FAR struct vnc_fbupdate_s *)sq_remfirst(&session->updfree);
+          for (; y < yend; y++, offset += RFB_STRIDE)
+            {
+              if (memcmp(session->fb + offset, session->shadow + offset,
+                         width) != 0)
+                {
+                  memcpy(session->shadow + offset, session->fb + offset,
+                         width);
+                  changed = true;
+                }
+            }
 
-  vnc_sem_debug(session, "After alloc", 1);
-  sched_unlock();
+          if (changed || wanted)
+            {
+              vnc_set_tile(tiles, col);
+            }
+          else
+            {
+              vnc_clear_tile(tiles, col);
+              nskipped++;
+            }
+        }
+    }
 
-  DEBUGASSERT(update != NULL);
-  return update;
+  updinfo("Skipped %d unchanged tiles\n", nskipped);
+  UNUSED(nskipped);
 }
+#endif
 
 /****************************************************************************
- * Name: vnc_free_update
+ * Name: vnc_requeue_tiles
  *
  * Description:
- *  Free one update structure by returning it from the freelist.
+ *   The encoders stop early when the client changes the pixel format in
+ *   the middle of a rectangle.  Mark the tiles of the rectangle that was
+ *   being sent and all tiles after it for the next pass.  With the shadow
+ *   framebuffer these tiles already match the shadow, so they are marked
+ *   as requested by the client in order to be sent even if unchanged.
  *
  * Input Parameters:
  *   session - A reference to the VNC session structure.
+ *   row     - The first tile row of the rectangle that was being sent.
+ *   col     - The first tile column of the rectangle that was being sent.
+ *   nrows   - The number of tile rows of the rectangle.
+ *   ncols   - The number of tile columns of the rectangle.
  *
  * Returned Value:
  *   None
  *
  ****************************************************************************/
 
-static void vnc_free_update(FAR struct vnc_session_s *session,
-                            FAR struct vnc_fbupdate_s *update)
+static void vnc_requeue_tiles(FAR struct vnc_session_s *session,
+                              unsigned int row, unsigned int col,
+                              unsigned int nrows, unsigned int ncols)
 {
-  /* Reserve one element from the free list.  Lock the scheduler to assure
-   * that the sq_addlast() and the nxsem_post() are atomic.
-   */
+  FAR uint32_t (*map)[VNC_TILEWORDS];
+  unsigned int r;
+  unsigned int c;
 
-  sched_lock();
-  vnc_sem_debug(session, "Before free", 1);
+#ifdef CONFIG_VNCSERVER_SHADOWFB
+  map = session->forced;
+#else
+  map = session->dirty;
+#endif
 
-  /* Put the entry into the free list */
+  /* The rows below the first row of the rectangle were cleared when the
+   * run was extended downward.  Mark them again.
+   */
 
-  sq_addlast((FAR sq_entry_t *)update, &session->updfree);
+  for (r = row + 1; r < row + nrows; r++)
+    {
+      for (c = col; c < col + ncols; c++)
+        {
+          vnc_set_tile(session->updtiles[r], c);
+        }
+    }
 
-  /* Post the semaphore to indicate the availability of one more update */
+  /* Every tile before the rectangle has been sent */
 
-  nxsem_post(&session->freesem);
+  sched_lock();
+  for (r = row; r < VNC_TILEROWS; r++)
+    {
+      for (c = r == row ? col : 0; c < VNC_TILECOLS; c++)
+        {
+          if (vnc_test_tile(session->updtiles[r], c))
+            {
+              vnc_set_tile(map[r], c);
+            }
+        }
+    }
 
-  vnc_sem_debug(session, "After free", 0);
-  DEBUGASSERT(session->freesem.semcount <= CONFIG_VNCSERVER_NUPDATES);
+  if (!session->damaged)
+    {
+      session->damaged = true;
+      nxsem_post(&session->updsem);
+    }
 
   sched_unlock();
 }
 
 /****************************************************************************
- * Name: vnc_remove_queue
+ * Name: vnc_send_rectangle
  *
  * Description:
- *  Remove one entry from the list of queued rectangles, waiting if
- *  necessary if the queue is empty.
+ *   Send one rectangle using the best encoding supported by the client.
  *
  * Input Parameters:
  *   session - A reference to the VNC session structure.
+ *   rect    - The rectangle to send.
  *
  * Returned Value:
- *   A non-NULL structure pointer should always be returned.  This function
- *   will wait if no structure is available.
+ *   Zero (OK) on success; a negated errno value on failure.
  *
  ****************************************************************************/
 
-static FAR struct vnc_fbupdate_s *
-vnc_remove_queue(FAR struct vnc_session_s *session)
+static int vnc_send_rectangle(FAR struct vnc_session_s *session,
+                              FAR struct nxgl_rect_s *rect)
 {
-  FAR struct vnc_fbupdate_s *rect;
-
-  /* Reserve one element from the list of queued rectangle.  Lock the
-   * scheduler to assure that the sq_remfirst() and the successful return
-   * from nxsem_wait are atomic.  Of course, the scheduler will be unlocked
-   * while we wait.
-   */
-
-  sched_lock();
-  vnc_sem_debug(session, "Before remove", 0);
+  int ret;
 
-  nxsem_wait_uninterruptible(&session->queuesem);
+  updinfo("Sending {(%d, %d),(%d, %d)}\n",
+          rect->pt1.x, rect->pt1.y, rect->pt2.x, rect->pt2.y);
 
-  /* It is reserved.. go get it */
+  switch (session->encoding)
+    {
+#ifdef CONFIG_VNCSERVER_ZRLE
+      case RFB_ENCODING_ZRLE:
+        return vnc_zrle(session, rect);
+#endif
 
-  rect = (FAR struct vnc_fbupdate_s *)sq_remfirst(&session->updqueue);
+#ifdef CONFIG_VNCSERVER_HEXTILE
+      case RFB_ENCODING_HEXTILE:
+        return vnc_hextile(session, rect);
+#endif
 
-  vnc_sem_debug(session, "After remove", 0);
-  DEBUGASSERT(rect != NULL);
+      default:
+        break;
+    }
 
-  /* Check if we just removed the whole screen update from the queue */
+  /* Attempt to use RRE encoding */
 
-  if (session->nwhupd > 0 && rect->whupd)
+  ret = vnc_rre(session, rect);
+  if (ret == 0)
     {
-      session->nwhupd--;
-      updinfo("Whole screen update: nwhupd=%d\n", session->nwhupd);
+      /* Perform the framebuffer update using the default RAW encoding */
+
+      ret = vnc_raw(session, rect);
     }
 
-  sched_unlock();
-  return rect;
+  return ret < 0 ? ret : OK;
 }
 
 /****************************************************************************
- * Name: vnc_add_queue
+ * Name: vnc_send_tiles
  *
  * Description:
- *   Add one rectangle entry to the list of queued rectangles to be updated.
+ *   Send all of the tiles marked since the last pass.  Adjacent tiles are
+ *   coalesced:  Each horizontal run of tiles is extended downward for as
+ *   long as the rows below contain the same run, and the resulting
+ *   rectangle is sent at once.
  *
  * Input Parameters:
  *   session - A reference to the VNC session structure.
- *   rect    - The rectangle to be added to the queue.
  *
  * Returned Value:
- *   None
+ *   Zero (OK) on success; a negated errno value on failure.
  *
  ****************************************************************************/
 
-static void vnc_add_queue(FAR struct vnc_session_s *session,
-                          FAR struct vnc_fbupdate_s *rect)
+static int vnc_send_tiles(FAR struct vnc_session_s *session)
 {
-  /* Lock the scheduler to assure that the sq_addlast() and the nxsem_post()
-   * are atomic.
+  struct nxgl_rect_s rect;
+  unsigned int row;
+  unsigned int col;
+  unsigned int ncols;
+  unsigned int nrows;
+  unsigned int i;
+  uint8_t colorfmt;
+  int ret;
+
+  /* Take the tiles marked since the last pass.  Anything marked after this
+   * point is sent on the next pass.
    */
 
   sched_lock();
-  vnc_sem_debug(session, "Before add", 1);
+  memcpy(session->updtiles, session->dirty, sizeof(session->dirty));
+  memset(session->dirty, 0, sizeof(session->dirty));
+#ifdef CONFIG_VNCSERVER_SHADOWFB
+  memcpy(session->updforced, session->forced, sizeof(session->forced));
+  memset(session->forced, 0, sizeof(session->forced));
+#endif
+  session->damaged = false;
+  sched_unlock();
 
-  /* Put the entry into the list of queued rectangles. */
+  colorfmt = session->colorfmt;
 
-  sq_addlast((FAR sq_entry_t *)rect, &session->updqueue);
+#ifdef CONFIG_VNCSERVER_SHADOWFB
+  vnc_diff_tiles(session);
+#endif
 
-  /* Post the semaphore to indicate the availability of one more rectangle
-   * in the queue.  This may wakeup the updater.
-   */
+  for (row = 0; row < VNC_TILEROWS; row++)
+    {
+      for (col = 0; col < VNC_TILECOLS; col++)
+        {
+          if (!vnc_test_tile(session->updtiles[row], col))
+            {
+              continue;
+            }
 
-  nxsem_post(&session->queuesem);
+          /* Find the end of this run of tiles */
+
+          for (ncols = 1;
+               col + ncols < VNC_TILECOLS &&
+               vnc_test_tile(session->updtiles[row], col + ncols);
+               ncols++)
+            {
+            }
 
-  vnc_sem_debug(session, "After add", 0);
-  DEBUGASSERT(session->queuesem.semcount <= CONFIG_VNCSERVER_NUPDATES);
+          /* Then extend it downward */
 
-  sched_unlock();
+          for (nrows = 1; row + nrows < VNC_TILEROWS; nrows++)
+            {
+              for (i = 0; i < ncols; i++)
+                {
+                  if (!vnc_test_tile(session->updtiles[row + nrows],
+                                     col + i))
+                    {
+                      break;
+                    }
+                }
+
+              if (i < ncols)
+                {
+                  break;
+                }
+
+              for (i = 0; i < ncols; i++)
+                {
+                  vnc_clear_tile(session->updtiles[row + nrows], col + i);
+                }
+            }
+
+          rect.pt1.x = col << VNC_TILESHIFT;
+          rect.pt1.y = row << VNC_TILESHIFT;
+          rect.pt2.x = MIN((col + ncols) << VNC_TILESHIFT,
+                           CONFIG_VNCSERVER_SCREENWIDTH) - 1;
+          rect.pt2.y = MIN((row + nrows) << VNC_TILESHIFT,
+                           CONFIG_VNCSERVER_SCREENHEIGHT) - 1;
+
+          ret = vnc_send_rectangle(session, &rect);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          /* The encoder stopped early if the pixel format changed.  Send
+           * the rest of the tiles on the next pass in the new format.
+           */
+
+          if (colorfmt != session->colorfmt)
+            {
+              updinfo("Pixel format changed, requeueing tiles\n");
+              vnc_requeue_tiles(session, row, col, nrows, ncols);
+              return OK;
+            }
+
+          col += ncols - 1;
+        }
+    }
+
+  return OK;
 }
 
 /****************************************************************************
@@ -354,47 +442,29 @@ static void vnc_add_queue(FAR struct vnc_session_s *session,
 static FAR void *vnc_updater(FAR void *arg)
 {
   FAR struct vnc_session_s *session = (FAR struct vnc_session_s *)arg;
-  FAR struct vnc_fbupdate_s *srcrect;
   int ret;
 
   DEBUGASSERT(session != NULL);
   ginfo("Updater running for Display %d\n", session->display);
 
-  /* Loop, processing updates until we are asked to stop.
-   * REVISIT: Probably need some kind of signal mechanism to wake up
-   * vnc_remove_queue() in order to stop.  Or perhaps a special STOP
-   * message in the queue?
+  /* Loop, processing updates until we are asked to stop.  All updates
+   * marked while the previous pass was being sent are merged into one
+   * pass.
    */
 
   while (session->state == VNCSERVER_RUNNING)
     {
-      /* Get the next queued rectangle update.  This call will block until an
-       * update is available for the case where the update queue is empty.
-       */
-
-      srcrect = vnc_remove_queue(session);
-      DEBUGASSERT(srcrect != NULL);
-
-      updinfo("Dequeued {(%d, %d),(%d, %d)}\n",
-              srcrect->rect.pt1.x, srcrect->rect.pt1.y,
-              srcrect->rect.pt2.x, srcrect->rect.pt2.y);
-
-      /* Attempt to use RRE encoding */
+      /* Wait until some tiles are marked or until we are asked to stop */
 
-      ret = vnc_rre(session, &srcrect->rect);
-      if (ret == 0)
+      nxsem_wait_uninterruptible(&session->updsem);
+      if (session->state != VNCSERVER_RUNNING)
         {
-          /* Perform the framebuffer update using the default RAW encoding */
-
-          ret = vnc_raw(session, &srcrect->rect);
+          break;
         }
 
-      /* Release the update structure */
-
-      vnc_free_update(session, srcrect);
-
       /* Break out and terminate the server if the encoding failed */
 
+      ret = vnc_send_tiles(session);
       if (ret < 0)
         {
           gerr("ERROR: Encoding failed: %d\n", ret);
@@ -481,6 +551,7 @@ int vnc_stop_updater(FAR struct vnc_session_s *session)
       /* Yes.. ask it to please stop */
 
       session->state = VNCSERVER_STOPPING;
+      nxsem_post(&session->updsem);
 
       /* Wait for the thread to comply with our request */
 
@@ -504,12 +575,14 @@ int vnc_stop_updater(FAR struct vnc_session_s *session)
  * Name: vnc_update_rectangle
  *
  * Description:
- *  Queue an update of the specified rectangular region on the display.
+ *  Mark the tiles of the specified rectangular region on the display for
+ *  the next update.
  *
  * Input Parameters:
  *   session - An instance of the session structure.
  *   rect    - The rectanglular region to be updated.
- *   change  - True: Frame buffer data has changed
+ *   change  - True: Frame buffer data has changed.  False: The region was
+ *             requested by the client and must be sent even if unchanged.
  *
  * Returned Value:
  *   Zero (OK) is returned on success; a negated errno value is returned on
@@ -520,9 +593,10 @@ int vnc_stop_updater(FAR struct vnc_session_s *session)
 int vnc_update_rectangle(FAR struct vnc_session_s *session,
                          FAR const struct nxgl_rect_s *rect, bool change)
 {
-  FAR struct vnc_fbupdate_s *update;
   struct nxgl_rect_s intersection;
-  bool whupd;
+  FAR uint32_t (*map)[VNC_TILEWORDS];
+  unsigned int row;
+  unsigned int col;
 
   /* Clip rectangle to the screen dimensions */
 
@@ -532,93 +606,47 @@ int vnc_update_rectangle(FAR struct vnc_session_s *session,
 
   if (!nxgl_nullrect(&intersection))
     {
-      /* Check for a whole screen update.  The RealVNC client sends a lot
-       * of these (especially when it is confused)
-       */
+      /* Without the shadow framebuffer, every marked tile is sent */
 
-      whupd = (memcmp(&intersection, &g_wholescreen,
-                      sizeof(struct nxgl_rect_s)) == 0);
+#ifdef CONFIG_VNCSERVER_SHADOWFB
+      map = change ? session->dirty : session->forced;
+#else
+      map = session->dirty;
+      UNUSED(change);
+#endif
 
-      /* Ignore any client update requests if there have been no changes to
-       * the framebuffer since the last whole screen update.
+      /* Mark the tiles and wake up the updater, unless it has already been
+       * woken up for tiles that it did not yet take.
        */
 
       sched_lock();
-      if (!change && !session->change)
-        {
-          /* No.. ignore the client update.  We have nothing new to report. */
-
-          sched_unlock();
-          return OK;
-        }
-
-      /* Ignore all updates if there is a queued whole screen update */
-
-      if (session->nwhupd == 0)
+      for (row = intersection.pt1.y >> VNC_TILESHIFT;
+           row <= intersection.pt2.y >> VNC_TILESHIFT;
+           row++)
         {
-          /* No whole screen updates in the queue.  Is this a new whole
-           * screen update?
-           */
-
-          if (whupd)
-            {
-              /* Yes.. Discard all of the previously queued updates */
-
-              FAR struct vnc_fbupdate_s *curr;
-              FAR struct vnc_fbupdate_s *next;
-
-              updinfo("New whole screen update...\n");
-
-              curr = (FAR struct vnc_fbupdate_s *)session->updqueue.head;
-              sq_init(&session->updqueue);
-              nxsem_reset(&session->queuesem, 0);
-
-              for (; curr != NULL; curr = next)
-                {
-                  next = curr->flink;
-                  vnc_free_update(session, curr);
-                }
-
-              /* One whole screen update will be queued.  There have been
-               * no frame buffer data changes since this update was queued.
-               */
-
-              session->nwhupd = 1;
-              session->change = false;
-            }
-          else
+          for (col = intersection.pt1.x >> VNC_TILESHIFT;
+               col <= intersection.pt2.x >> VNC_TILESHIFT;
+               col++)
             {
-              /* We are not updating the whole screen.  Remember if this
-               * update (OR a preceding update) was due to a data change.
-               */
-
-              session->change |= change;
+              vnc_set_tile(map[row], col);
             }
+        }
 
-          /* Allocate an update structure... waiting if necessary */
-
-          update = vnc_alloc_update(session);
-          DEBUGASSERT(update != NULL);
-
-          /* Copy the clipped rectangle into the update structure */
-
-          update->whupd = whupd;
-          nxgl_rectcopy(&update->rect, &intersection);
-
-          /* Add the update to the end of the update queue. */
-
-          vnc_add_queue(session, update);
-
-          updinfo("Queued {(%d, %d),(%d, %d)}\n",
-                  intersection.pt1.x, intersection.pt1.y,
-                  intersection.pt2.x, intersection.pt2.y);
+      if (!session->damaged)
+        {
+          session->damaged = true;
+          nxsem_post(&session->updsem);
         }
 
       sched_unlock();
+
+      updinfo("Marked {(%d, %d),(%d, %d)}\n",
+              intersection.pt1.x, intersection.pt1.y,
+              intersection.pt2.x, intersection.pt2.y);
     }
 
-  /* Since we ignore bad rectangles and wait for update structures, there is
-   * really no way a failure can occur.
+  /* Since we ignore bad rectangles, there is really no way a failure can
+   * occur.
    */
 
   return OK;
@@ -0,0 +1,456 @@
+/****************************************************************************
+ * graphics/vnc/server/vnc_zrle.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+
+#if defined(CONFIG_VNCSERVER_DEBUG) && !defined(CONFIG_DEBUG_GRAPHICS)
+#  undef  CONFIG_DEBUG_ERROR
+#  undef  CONFIG_DEBUG_WARN
+#  undef  CONFIG_DEBUG_INFO
+#  undef  CONFIG_DEBUG_GRAPHICS_ERROR
+#  undef  CONFIG_DEBUG_GRAPHICS_WARN
+#  undef  CONFIG_DEBUG_GRAPHICS_INFO
+#  define CONFIG_DEBUG_ERROR          1
+#  define CONFIG_DEBUG_WARN           1
+#  define CONFIG_DEBUG_INFO           1
+#  define CONFIG_DEBUG_GRAPHICS       1
+#  define CONFIG_DEBUG_GRAPHICS_ERROR 1
+#  define CONFIG_DEBUG_GRAPHICS_WARN  1
+#  define CONFIG_DEBUG_GRAPHICS_INFO  1
+#endif
+#include <debug.h>
+
+#include "vnc_server.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The largest palette used.  ZRLE permits palettes of up to 127 colors,
+ * but only palettes of up to 16 colors can be packed.
+ */
+
+#define ZRLE_MAXPALETTE 16
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Describes the CPIXELs of one rectangle */
+
+struct vnc_zrle_s
+{
+  uint8_t cpixel;                      /* Bytes per CPIXEL */
+  bool bigendian;                      /* True: Big-endian pixels */
+  uint8_t npalette;                    /* Number of colors in palette[] */
+  uint32_t palette[ZRLE_MAXPALETTE];   /* Colors of the tile */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_zrle_index
+ *
+ * Description:
+ *   Return the index of a pixel in the palette, or -1 if it is not there.
+ *
+ ****************************************************************************/
+
+static int vnc_zrle_index(FAR struct vnc_zrle_s *zrle, uint32_t pixel)
+{
+  int i;
+
+  for (i = 0; i < zrle->npalette; i++)
+    {
+      if (zrle->palette[i] == pixel)
+        {
+          return i;
+        }
+    }
+
+  return -1;
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_runlength
+ *
+ * Description:
+ *   Append a run length:  (length - 1) as a sequence of bytes that are 255
+ *   except for the last one.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *vnc_zrle_runlength(FAR uint8_t *dest,
+                                       unsigned int length)
+{
+  for (length--; length >= 255; length -= 255)
+    {
+      *dest++ = 255;
+    }
+
+  *dest++ = (uint8_t)length;
+  return dest;
+}
+
+/****************************************************************************
+ * Name: vnc_zrle_tile
+ *
+ * Description:
+ *   Encode one tile of remote pixels using the smallest of the raw, solid,
+ *   packed palette, plain RLE and palette RLE subencodings.  None of these
+ *   is ever larger than the raw subencoding.
+ *
+ * Input Parameters:
+ *   zrle   - Describes the CPIXELs.
+ *   pixels - The remote pixels of the tile.
+ *   width  - The width of the tile.
+ *   height - The height of the tile.
+ *   dest   - Receives the uncompressed tile data.
+ *
+ * Returned Value:
+ *   The size of the uncompressed tile data.
+ *
+ ****************************************************************************/
+
+static size_t vnc_zrle_tile(FAR struct vnc_zrle_s *zrle,
+                            FAR const uint32_t *pixels,
+                            unsigned int width, unsigned int height,
+                            FAR uint8_t *dest)
+{
+  FAR uint8_t *start = dest;
+  unsigned int npixels = width * height;
+  unsigned int cpixel = zrle->cpixel;
+  unsigned int bits = 0;
+  unsigned int i;
+  unsigned int j;
+  unsigned int x;
+  size_t rawsize;
+  size_t rlesize = 0;
+  size_t palrlesize = 0;
+  size_t size;
+  uint8_t subencoding;
+  uint8_t packed;
+  bool palette = true;
+
+  /* Collect the palette and the sizes of the RLE subencodings, run by
+   * run.  Runs continue from the end of one row to the next.
+   */
+
+  zrle->npalette = 0;
+  for (i = 0; i < npixels; i = j)
+    {
+      for (j = i + 1; j < npixels && pixels[j] == pixels[i]; j++)
+        {
+        }
+
+      size        = (j - i - 1) / 255 + 1;
+      rlesize    += cpixel + size;
+      palrlesize += (j - i == 1) ? 1 : 1 + size;
+
+      if (palette && vnc_zrle_index(zrle, pixels[i]) < 0)
+        {
+          if (zrle->npalette < ZRLE_MAXPALETTE)
+            {
+              zrle->palette[zrle->npalette++] = pixels[i];
+            }
+          else
+            {
+              palette = false;
+            }
+        }
+    }
+
+  /* A single color is sent as a solid tile */
+
+  if (palette && zrle->npalette == 1)
+    {
+      *dest++ = RFB_SUBENCODING_SOLID;
+      dest    = vnc_put_pixel(dest, pixels[0], cpixel, zrle->bigendian);
+      return dest - start;
+    }
+
+  /* Otherwise pick the smallest subencoding */
+
+  rawsize     = npixels * cpixel;
+  size        = rawsize;
+  subencoding = RFB_SUBENCODING_RAW;
+
+  if (palette)
+    {
+      bits = zrle->npalette <= 2 ? 1 : zrle->npalette <= 4 ? 2 : 4;
+      palrlesize += zrle->npalette * cpixel;
+
+      if (zrle->npalette * cpixel + height * ((width * bits + 7) >> 3) <
+          size)
+        {
+          size        = zrle->npalette * cpixel +
+                        height * ((width * bits + 7) >> 3);
+          subencoding = zrle->npalette;
+        }
+
+      if (palrlesize < size)
+        {
+          size        = palrlesize;
+          subencoding = RFB_SUBENCODING_PALRLE;
+        }
+    }
+
+  if (rlesize < size)
+    {
+      subencoding = RFB_SUBENCODING_RLE;
+    }
+
+  /* Emit the palette, which is followed by the packed pixels or the
+   * palette RLE runs.
+   */
+
+  if (subencoding == RFB_SUBENCODING_PALRLE)
+    {
+      *dest++ = RFB_SUBENCODING_RLE | zrle->npalette;
+    }
+  else
+    {
+      *dest++ = subencoding;
+    }
+
+  if (subencoding != RFB_SUBENCODING_RAW &&
+      subencoding != RFB_SUBENCODING_RLE)
+    {
+      for (i = 0; i < zrle->npalette; i++)
+        {
+          dest = vnc_put_pixel(dest, zrle->palette[i], cpixel,
+                               zrle->bigendian);
+        }
+    }
+
+  switch (subencoding)
+    {
+      case RFB_SUBENCODING_RAW:
+        for (i = 0; i < npixels; i++)
+          {
+            dest = vnc_put_pixel(dest, pixels[i], cpixel, zrle->bigendian);
+          }
+        break;
+
+      case RFB_SUBENCODING_RLE:
+        for (i = 0; i < npixels; i = j)
+          {
+            for (j = i + 1; j < npixels && pixels[j] == pixels[i]; j++)
+              {
+              }
+
+            dest = vnc_put_pixel(dest, pixels[i], cpixel, zrle->bigendian);
+            dest = vnc_zrle_runlength(dest, j - i);
+          }
+        break;
+
+      case RFB_SUBENCODING_PALRLE:
+        for (i = 0; i < npixels; i = j)
+          {
+            for (j = i + 1; j < npixels && pixels[j] == pixels[i]; j++)
+              {
+              }
+
+            if (j - i == 1)
+              {
+                *dest++ = (uint8_t)vnc_zrle_index(zrle, pixels[i]);
+              }
+            else
+              {
+                *dest++ = (uint8_t)(vnc_zrle_index(zrle, pixels[i]) | 128);
+                dest    = vnc_zrle_runlength(dest, j - i);
+              }
+          }
+        break;
+
+      default:
+
+        /* Packed palette:  Each row starts on a byte boundary with the
+         * leftmost pixel in the most significant bits.
+         */
+
+        for (i = 0; i < npixels; i += width)
+          {
+            packed = 0;
+            for (x = 0, j = 0; x < width; x++)
+              {
+                packed = (packed << bits) |
+                         (uint8_t)vnc_zrle_index(zrle, pixels[i + x]);
+                j     += bits;
+
+                if (j == 8)
+                  {
+                    *dest++ = packed;
+                    packed  = 0;
+                    j       = 0;
+                  }
+              }
+
+            if (j > 0)
+              {
+                *dest++ = (uint8_t)(packed << (8 - j));
+              }
+          }
+        break;
+    }
+
+  return dest - start;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_zrle
+ *
+ * Description:
+ *  Send the framebuffer update using the ZRLE encoding.
+ *
+ *  Each tile is sent as a separate rectangle with a sync flush of the zlib
+ *  stream, so that its compressed size is known before it is sent.  The
+ *  number of rows of a tile is limited so that the compressed data always
+ *  fits into the update buffer.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; A negated errno value is returned on failure that
+ *   indicates the nature of the failure.  A failure is only returned
+ *   in cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+int vnc_zrle(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect)
+{
+  FAR struct rfb_framebufferupdate_s *update;
+  struct vnc_zrle_s zrle;
+  FAR uint8_t *input;
+  nxgl_coord_t tileheight;
+  nxgl_coord_t width;
+  nxgl_coord_t height;
+  nxgl_coord_t x;
+  nxgl_coord_t y;
+  size_t maxin;
+  size_t inlen;
+  size_t outlen;
+  uint8_t colorfmt;
+  int ret;
+
+  /* Set up characteristics of the client pixel format to use on this
+   * update.  A CPIXEL is three bytes for 32-bit pixels of up to 24 bits
+   * depth; our pixels always leave the most significant byte unused.
+   */
+
+  colorfmt       = session->colorfmt;
+  zrle.bigendian = session->bigendian;
+  zrle.cpixel    = (session->bpp + 7) >> 3;
+
+  if (zrle.cpixel == 4 && session->depth <= 24)
+    {
+      zrle.cpixel = 3;
+    }
+
+  /* The compressed size of a tile of up to 'maxin' bytes fits into the
+   * update buffer after the length field.
+   */
+
+  maxin      = ((CONFIG_VNCSERVER_UPDATE_BUFSIZE - 4 - 12) * 8 - 7) / 9;
+  tileheight = (maxin - 1) / (VNC_ZRLE_TILEWIDTH * zrle.cpixel);
+  tileheight = MAX(MIN(tileheight, VNC_ZRLE_TILEHEIGHT), 1);
+
+  update = (FAR struct rfb_framebufferupdate_s *)session->outbuf;
+
+  /* Loop until all tiles have been sent, or until the color format changes
+   * asynchronously.
+   */
+
+  for (y = rect->pt1.y;
+       y <= rect->pt2.y && colorfmt == session->colorfmt;
+       y += tileheight)
+    {
+      height = MIN(tileheight, rect->pt2.y - y + 1);
+
+      for (x = rect->pt1.x;
+           x <= rect->pt2.x && colorfmt == session->colorfmt;
+           x += VNC_ZRLE_TILEWIDTH)
+        {
+          width = MIN(VNC_ZRLE_TILEWIDTH, rect->pt2.x - x + 1);
+
+          ret = vnc_convert_tile(session, colorfmt, x, y, width, height,
+                                 session->pixels);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          input = vnc_deflate_input(&session->zstream);
+          inlen = vnc_zrle_tile(&zrle, session->pixels, width, height,
+                                input);
+          DEBUGASSERT(inlen <= maxin);
+
+          /* Once data is compressed, it must be sent to keep the zlib
+           * stream of the client in sync.
+           */
+
+          outlen = vnc_deflate(&session->zstream, inlen,
+                               &update->rect[0].data[4],
+                               CONFIG_VNCSERVER_UPDATE_BUFSIZE - 4);
+
+          /* Format the FramebufferUpdate message */
+
+          update->msgtype = RFB_FBUPDATE_MSG;
+          update->padding = 0;
+          rfb_putbe16(update->nrect, 1);
+
+          rfb_putbe16(update->rect[0].xpos, x);
+          rfb_putbe16(update->rect[0].ypos, y);
+          rfb_putbe16(update->rect[0].width, width);
+          rfb_putbe16(update->rect[0].height, height);
+          rfb_putbe32(update->rect[0].encoding, RFB_ENCODING_ZRLE);
+          rfb_putbe32(update->rect[0].data, outlen);
+
+          ret = vnc_send(session, session->outbuf,
+                         VNCSERVER_UPDATE_HDRSIZE + 4 + outlen);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          updinfo("Sent ZRLE {(%d, %d),(%d, %d)}: %lu -> %lu bytes\n",
+                  x, y, x + width - 1, y + height - 1,
+                  (unsigned long)inlen, (unsigned long)outlen);
+        }
+    }
+
+  return OK;
+}
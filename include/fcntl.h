@@ -110,6 +110,8 @@
 #define F_SETLKW    12 /* Like F_SETLK, but wait for lock to become available */
 #define F_SETOWN    13 /* Set pid that will receive SIGIO and SIGURG signals for fd */
 #define F_SETSIG    14 /* Set the signal to be sent */
+#define F_SETPIPE_SZ 15 /* Set the capacity of a pipe (linux) */
+#define F_GETPIPE_SZ 16 /* Get the capacity of a pipe (linux) */
 
 /* For posix fcntl() and lockf() */
 
@@ -130,6 +132,12 @@
 #define DN_RENAME   4  /* A file was renamed */
 #define DN_ATTRIB   5  /* Attributes of a file were changed */
 
+/* Flags for splice() (linux) */
+
+#define SPLICE_F_MOVE     (1 << 0) /* Ignored:  Data is always moved */
+#define SPLICE_F_NONBLOCK (1 << 1) /* Do not block on the pipe */
+#define SPLICE_F_MORE     (1 << 2) /* Ignored:  More data will follow */
+
 /* int creat(const char *path, mode_t mode);
  *
  * is equivalent to open with O_WRONLY|O_CREAT|O_TRUNC.
@@ -174,6 +182,11 @@ extern "C"
 int open(const char *path, int oflag, ...);
 int fcntl(int fd, int cmd, ...);
 
+#ifdef CONFIG_PIPES
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out,
+               FAR off_t *off_out, size_t len, unsigned int flags);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -42,21 +42,57 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
 #include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
 #define AES128_KEY_SIZE    16
+#define AES192_KEY_SIZE    24
+#define AES256_KEY_SIZE    32
+
+#define AES_BLOCK_SIZE     16
+#define AES_MAXROUNDS      14
+
+/* Tag sizes accepted by aes_gcm_encrypt() and aes_gcm_decrypt() */
+
+#define AES_GCM_MINTAG     4
+#define AES_GCM_MAXTAG     16
 
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* The round keys are big-endian words, one per column of the state.  An
+ * up_aes_setupkey() may store its round keys in ek and dk in any format.
+ */
+
 struct aes_state_s
 {
-  uint8_t expanded_key[176];
+  uint32_t ek[4 * AES_MAXROUNDS + 4];  /* Round keys of the cipher */
+#if !defined(CONFIG_CRYPTO_SW_AES_BITSLICED) || \
+    defined(CONFIG_CRYPTO_ARCH_AES)
+  uint32_t dk[4 * AES_MAXROUNDS + 4];  /* Round keys of the inverse cipher */
+#endif
+  uint8_t nrounds;                     /* 10, 12 or 14 */
+#ifdef CONFIG_CRYPTO_ARCH_AES
+  bool arch;                           /* Set up by up_aes_setupkey() */
+#endif
+};
+
+/* An AES key with the multiples of the GHASH key H = AES(K, 0^128) that
+ * are needed to multiply by H four bits at a time.
+ */
+
+struct aes_gcm_s
+{
+  struct aes_state_s aes;              /* The AES key */
+  uint64_t hl[16];                     /* Low halves of i * H */
+  uint64_t hh[16];                     /* High halves of i * H */
 };
 
 /****************************************************************************
@@ -118,14 +154,12 @@ void aes_decrypt(FAR uint8_t *state, FAR const uint8_t *key);
  *
  * Input Parameters:
  *  state  an AES context that can be used for AES operations
- *  key    a pointer to a 16-byte buffer holding the AES-128 key
- *  len    length of the key, must be 16
- *
- * TODO: Support other key lengths of 24 (AES-192) and 32 (AES-256)
+ *  key    a pointer to a buffer holding the AES key
+ *  len    length of the key, 16, 24 or 32 bytes
  *
  * Returned Value:
  *   0 if OK
- *   -EINVAL if len is not 16
+ *   -EINVAL if len is not valid
  *
  ****************************************************************************/
 
@@ -164,6 +198,127 @@ void aes_encipher(FAR struct aes_state_s *state, FAR uint8_t *blocks,
 void aes_decipher(FAR struct aes_state_s *state, FAR uint8_t *blocks,
                   int nblk);
 
+/****************************************************************************
+ * Name: aes_ctr
+ *
+ * Description:
+ *   Encrypt or decrypt data in CTR mode.  The counter block is incremented
+ *   as a 128-bit big-endian number for each block.  On return, it holds the
+ *   counter of the next block, so a message may be processed in several
+ *   calls as long as all but the last have a multiple of 16 bytes.
+ *
+ * Input Parameters:
+ *  state  an AES context set up by aes_setupkey()
+ *  ctr    the 16-byte counter block
+ *  in     the input data
+ *  out    the output data, which may be the same as in
+ *  len    the number of bytes to process
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void aes_ctr(FAR struct aes_state_s *state, FAR uint8_t *ctr,
+             FAR const uint8_t *in, FAR uint8_t *out, size_t len);
+
+/****************************************************************************
+ * Name: aes_gcm_setkey
+ *
+ * Description:
+ *   Set up the AES key and the GHASH tables of a GCM context.  The context
+ *   may then be used for any number of messages.
+ *
+ * Input Parameters:
+ *  gcm    the GCM context
+ *  key    a pointer to a buffer holding the AES key
+ *  len    length of the key, 16, 24 or 32 bytes
+ *
+ * Returned Value:
+ *   0 if OK
+ *   -EINVAL if len is not valid
+ *
+ ****************************************************************************/
+
+int aes_gcm_setkey(FAR struct aes_gcm_s *gcm, FAR const uint8_t *key,
+                   int len);
+
+/****************************************************************************
+ * Name: aes_gcm_encrypt
+ *
+ * Description:
+ *   Encrypt a message and compute its authentication tag with AES-GCM.
+ *
+ * Input Parameters:
+ *  gcm    a GCM context set up by aes_gcm_setkey()
+ *  iv     the initialization vector, normally 12 bytes
+ *  ivlen  the length of iv
+ *  aad    additional data that is authenticated but not encrypted
+ *  aadlen the length of aad
+ *  in     the plain text
+ *  out    the cipher text, which may be the same as in
+ *  len    the length of the message
+ *  tag    receives the authentication tag
+ *  taglen the length of the tag, AES_GCM_MINTAG to AES_GCM_MAXTAG
+ *
+ * Returned Value:
+ *   0 if OK
+ *   -EINVAL if ivlen or taglen is not valid
+ *
+ ****************************************************************************/
+
+int aes_gcm_encrypt(FAR struct aes_gcm_s *gcm,
+                    FAR const uint8_t *iv, size_t ivlen,
+                    FAR const uint8_t *aad, size_t aadlen,
+                    FAR const uint8_t *in, FAR uint8_t *out, size_t len,
+                    FAR uint8_t *tag, size_t taglen);
+
+/****************************************************************************
+ * Name: aes_gcm_decrypt
+ *
+ * Description:
+ *   Verify the authentication tag of a message and decrypt it with
+ *   AES-GCM.  The output is cleared if the tag does not match.
+ *
+ * Input Parameters:
+ *   See aes_gcm_encrypt().  in is the cipher text, out the plain text and
+ *   tag the tag to verify.
+ *
+ * Returned Value:
+ *   0 if OK
+ *   -EINVAL if ivlen or taglen is not valid
+ *   -EBADMSG if the tag does not match
+ *
+ ****************************************************************************/
+
+int aes_gcm_decrypt(FAR struct aes_gcm_s *gcm,
+                    FAR const uint8_t *iv, size_t ivlen,
+                    FAR const uint8_t *aad, size_t aadlen,
+                    FAR const uint8_t *in, FAR uint8_t *out, size_t len,
+                    FAR const uint8_t *tag, size_t taglen);
+
+/****************************************************************************
+ * Name: up_aes_setupkey, up_aes_encipher and up_aes_decipher
+ *
+ * Description:
+ *   Architecture-specific AES with the instructions of the CPU.
+ *   up_aes_setupkey() is called by aes_setupkey() with nrounds set and may
+ *   return -ENOSYS if the CPU does not have the instructions; the software
+ *   implementation is then used for that key.  Otherwise, all blocks
+ *   ciphered with the key are passed to up_aes_encipher() and
+ *   up_aes_decipher() instead.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CRYPTO_ARCH_AES
+int up_aes_setupkey(FAR struct aes_state_s *state, FAR const uint8_t *key,
+                    int len);
+void up_aes_encipher(FAR struct aes_state_s *state, FAR uint8_t *blocks,
+                     int nblk);
+void up_aes_decipher(FAR struct aes_state_s *state, FAR uint8_t *blocks,
+                     int nblk);
+#endif
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
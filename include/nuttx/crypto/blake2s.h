@@ -96,7 +96,7 @@ typedef struct blake2s_param__
   uint8_t personal[BLAKE2S_PERSONALBYTES];      /* 32 */
 } blake2s_param;
 
-#ifdef __GNUC__ > 3
+#if defined(__GNUC__) && __GNUC__ > 3
 #define BLAKE2_UNALIGNED 1
 typedef uint32_t uint32_alias_t __attribute__((may_alias, aligned(1)));
 typedef uint16_t uint16_alias_t __attribute__((may_alias, aligned(1)));
@@ -124,16 +124,15 @@ int blake2s(FAR void *out, size_t outlen, FAR const void *in, size_t inlen,
  * Public Inline Functions
  ****************************************************************************/
 
+/* BLAKE2s is little-endian:  Words are loaded with a single, possibly
+ * unaligned, access on little-endian CPUs, and assembled from bytes
+ * otherwise.
+ */
+
 static inline uint32_t blake2_load32(FAR const void *src)
 {
 #if defined(BLAKE2_UNALIGNED) && !defined(CONFIG_ENDIAN_BIG)
   return *(FAR uint32_alias_t *)src;
-#elif !defined(CONFIG_ENDIAN_BIG)
-  FAR const uint8_t *p = (FAR const uint8_t *)src;
-  return ((uint32_t)(p[0]) << 24) |
-         ((uint32_t)(p[1]) << 16) |
-         ((uint32_t)(p[2]) << 8) |
-         ((uint32_t)(p[3]) << 0);
 #else
   FAR const uint8_t *p = (FAR const uint8_t *)src;
   return ((uint32_t)(p[0]) << 0) |
@@ -147,11 +146,8 @@ static inline uint16_t blake2_load16(FAR const void *src)
 {
 #if defined(BLAKE2_UNALIGNED) && !defined(CONFIG_ENDIAN_BIG)
   return *(FAR uint16_alias_t *)src;
-#elif !defined(CONFIG_ENDIAN_BIG)
-  const uint8_t *p = (FAR const uint8_t *)src;
-  return ((uint16_t)(p[0]) << 8) | ((uint16_t)(p[1]) << 0);
 #else
-  const uint8_t *p = (FAR const uint8_t *)src;
+  FAR const uint8_t *p = (FAR const uint8_t *)src;
   return ((uint16_t)(p[0]) << 0) | ((uint16_t)(p[1]) << 8);
 #endif
 }
@@ -160,10 +156,6 @@ static inline void blake2_store16(FAR void *dst, uint16_t w)
 {
 #if defined(BLAKE2_UNALIGNED) && !defined(CONFIG_ENDIAN_BIG)
   *(FAR uint16_alias_t *)dst = w;
-#elif !defined(CONFIG_ENDIAN_BIG)
-  FAR uint8_t *p = (FAR uint8_t *)dst;
-  p[1] = (uint8_t)w; w >>= 8;
-  p[0] = (uint8_t)w;
 #else
   FAR uint8_t *p = (FAR uint8_t *)dst;
   p[0] = (uint8_t)w; w >>= 8;
@@ -175,12 +167,6 @@ static inline void blake2_store32(FAR void *dst, uint32_t w)
 {
 #if defined(BLAKE2_UNALIGNED) && !defined(CONFIG_ENDIAN_BIG)
   *(FAR uint32_alias_t *)dst = w;
-#elif !defined(CONFIG_ENDIAN_BIG)
-  FAR uint8_t *p = (FAR uint8_t *) dst;
-  p[0] = (uint8_t)(w >> 24);
-  p[1] = (uint8_t)(w >> 16);
-  p[2] = (uint8_t)(w >> 8);
-  p[3] = (uint8_t)(w >> 0);
 #else
   FAR uint8_t *p = (FAR uint8_t *) dst;
   p[0] = (uint8_t)(w >> 0);
@@ -41,6 +41,11 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/compiler.h>
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <stdint.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -53,6 +58,7 @@
 #define CRYPTO_AES_ECB          1
 #define CRYPTO_AES_CBC          2
 #define CRYPTO_AES_CTR          3
+#define CRYPTO_AES_GCM          4
 #define CRYPTO_ALGORITHM_MAX    1
 
 #define CRYPTO_FLAG_HARDWARE    0x01000000 /* hardware accelerated */
@@ -65,6 +71,8 @@
 #define CIOCGSESSION            101
 #define CIOCFSESSION            102
 #define CIOCCRYPT               103
+#define CIOCCRYPTAEAD           104
+#define CIOCSUBMIT              105
 
 typedef char* caddr_t;
 
@@ -92,4 +100,181 @@ struct crypt_op
   caddr_t iv;
 };
 
+/* Authenticated encryption (CRYPTO_AES_GCM), with CIOCCRYPTAEAD.  The tag
+ * has AES_GCM_MAXTAG bytes.  It is returned when encrypting and checked
+ * when decrypting.
+ */
+
+struct crypt_aead
+{
+  uint32_t ses;
+  uint16_t op;        /* i.e. COP_ENCRYPT */
+  uint16_t flags;
+  unsigned len;       /* Length of src and dst */
+  unsigned aadlen;    /* Length of aad */
+  unsigned ivlen;     /* Length of iv */
+  caddr_t src, dst;
+  caddr_t aad;        /* Additional authenticated data */
+  caddr_t tag;        /* The authentication tag */
+  caddr_t iv;
+};
+
+/* One operation of a batch queued with CIOCSUBMIT.  The source and the
+ * destination are scattered over srccnt and dstcnt iovecs, with the same
+ * total length.  aad, iv and tag are used as in struct crypt_aead; aad is
+ * only used with CRYPTO_AES_GCM and iv not with CRYPTO_AES_ECB.
+ *
+ * The source, aad and iv are copied when the operation is queued.  The
+ * destination and, when encrypting with CRYPTO_AES_GCM, the tag are
+ * written when the result of the operation is read, so they must stay
+ * valid until then.
+ */
+
+struct crypt_req
+{
+  uint32_t ses;
+  uint16_t op;        /* i.e. COP_ENCRYPT */
+  uint16_t flags;
+  uint32_t id;        /* Returned in the result of the operation */
+  unsigned srccnt;    /* Number of iovecs in src */
+  unsigned dstcnt;    /* Number of iovecs in dst */
+  unsigned aadlen;    /* Length of aad */
+  unsigned ivlen;     /* Length of iv */
+  FAR const struct iovec *src;
+  FAR const struct iovec *dst;
+  caddr_t aad;        /* Additional authenticated data */
+  caddr_t tag;        /* The authentication tag */
+  caddr_t iv;
+};
+
+/* The argument of CIOCSUBMIT.  The ioctl returns the number of operations
+ * that were queued, which is less than nreqs if the queue of the file
+ * became full or an operation was not valid.
+ */
+
+struct crypt_batch
+{
+  unsigned nreqs;     /* Number of operations in reqs */
+  FAR struct crypt_req *reqs;
+};
+
+/* The results of queued operations are read from the file as an array of
+ * struct crypt_result, in the order of completion.  The file is readable
+ * (POLLIN) when a result is available.
+ */
+
+struct crypt_result
+{
+  uint32_t id;        /* The id of the operation */
+  int32_t status;     /* Zero or a negated errno value */
+};
+
+/* The interface between the /dev/crypto upper half driver and the lower
+ * half that does the cryptographic operations, in software or with a
+ * crypto engine.  The upper half keeps the sessions of each open file and
+ * queues the operations; the lower half keeps the expanded key of each of
+ * its sessions.
+ */
+
+struct cryptodev_lowerhalf_s;
+
+/* One operation.  The lower half either does the operation and returns
+ * its result from the process method, or returns -EINPROGRESS.  It must
+ * then set result and call callback when the operation completes, from
+ * any context.
+ */
+
+struct cryptodev_req_s
+{
+  FAR void *session;          /* The session of the lower half */
+  uint16_t op;                /* COP_ENCRYPT or COP_DECRYPT */
+  FAR const uint8_t *src;     /* Input data */
+  FAR uint8_t *dst;           /* Output data, may be the same as src */
+  size_t len;                 /* Length of src and dst */
+  FAR const uint8_t *iv;      /* Initialization vector or counter */
+  size_t ivlen;               /* Length of iv */
+  FAR const uint8_t *aad;     /* Additional authenticated data */
+  size_t aadlen;              /* Length of aad */
+  FAR uint8_t *tag;           /* AES_BLOCK_LEN bytes of tag, or NULL */
+  int result;                 /* Zero or a negated errno value */
+
+  /* Callback when an operation that is in progress completes */
+
+  CODE void (*callback)(FAR struct cryptodev_req_s *req);
+  FAR void *priv;             /* Used only by the upper half */
+};
+
+struct cryptodev_ops_s
+{
+  /* Set up a session with a key, i.e. expand the key.  A pointer to the
+   * state of the session is returned in session.
+   */
+
+  CODE int (*newsession)(FAR struct cryptodev_lowerhalf_s *lower,
+                         uint32_t cipher, FAR const uint8_t *key,
+                         size_t keylen, FAR void **session);
+
+  /* Release a session.  No operation of the session is in progress. */
+
+  CODE void (*freesession)(FAR struct cryptodev_lowerhalf_s *lower,
+                           FAR void *session);
+
+  /* Do an operation, or start it and return -EINPROGRESS */
+
+  CODE int (*process)(FAR struct cryptodev_lowerhalf_s *lower,
+                      FAR struct cryptodev_req_s *req);
+};
+
+struct cryptodev_lowerhalf_s
+{
+  FAR const struct cryptodev_ops_s *ops;
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: cryptodev_register
+ *
+ * Description:
+ *   Register a /dev/crypto compatible driver for a lower half.
+ *
+ * Input Parameters:
+ *   path  - The path of the driver, i.e. "/dev/crypto"
+ *   lower - The lower half
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno value on failure
+ *
+ ****************************************************************************/
+
+int cryptodev_register(FAR const char *path,
+                       FAR struct cryptodev_lowerhalf_s *lower);
+
+/****************************************************************************
+ * Name: cryptodev_swinitialize
+ *
+ * Description:
+ *   Return the lower half that does the operations with the software AES
+ *   library or with aes_cypher().  It is registered as /dev/crypto by
+ *   devcrypto_register().
+ *
+ ****************************************************************************/
+
+FAR struct cryptodev_lowerhalf_s *cryptodev_swinitialize(void);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* __INCLUDE_NUTTX_CRYPTO_CRYPTODEV_H */
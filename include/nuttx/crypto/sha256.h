@@ -0,0 +1,125 @@
+/****************************************************************************
+ * include/nuttx/crypto/sha256.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_CRYPTO_SHA256_H
+#define __INCLUDE_NUTTX_CRYPTO_SHA256_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stddef.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SHA256_BLOCK_SIZE  64
+#define SHA256_DIGEST_SIZE 32
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The state of a SHA-256 hash that is being computed */
+
+struct sha256_state_s
+{
+  uint32_t h[8];                       /* The intermediate hash value */
+  uint64_t nbytes;                     /* The number of bytes hashed */
+  uint8_t buf[SHA256_BLOCK_SIZE];      /* The last, partial block */
+};
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sha256_init
+ *
+ * Description:
+ *   Start to compute a SHA-256 hash.
+ *
+ ****************************************************************************/
+
+void sha256_init(FAR struct sha256_state_s *state);
+
+/****************************************************************************
+ * Name: sha256_update
+ *
+ * Description:
+ *   Add len bytes of the message to the hash.  Whole blocks are hashed
+ *   directly from the message, which need not be aligned.
+ *
+ ****************************************************************************/
+
+void sha256_update(FAR struct sha256_state_s *state, FAR const void *in,
+                   size_t len);
+
+/****************************************************************************
+ * Name: sha256_final
+ *
+ * Description:
+ *   Pad the message, store its hash of SHA256_DIGEST_SIZE bytes in digest
+ *   and erase the state.
+ *
+ ****************************************************************************/
+
+void sha256_final(FAR struct sha256_state_s *state, FAR uint8_t *digest);
+
+/****************************************************************************
+ * Name: sha256
+ *
+ * Description:
+ *   Compute the SHA-256 hash of a whole message.
+ *
+ ****************************************************************************/
+
+void sha256(FAR const void *in, size_t len, FAR uint8_t *digest);
+
+/****************************************************************************
+ * Name: up_sha256_transform
+ *
+ * Description:
+ *   Architecture-specific SHA-256 with the instructions of the CPU.  Update
+ *   the intermediate hash value h with nblk blocks of SHA256_BLOCK_SIZE
+ *   bytes, which need not be aligned.  Return -ENOSYS if the CPU does not
+ *   have the instructions; the blocks are then hashed in software.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_CRYPTO_ARCH_SHA256
+int up_sha256_transform(FAR uint32_t *h, FAR const uint8_t *blocks,
+                        size_t nblk);
+#endif
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __INCLUDE_NUTTX_CRYPTO_SHA256_H */
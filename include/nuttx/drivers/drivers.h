@@ -242,6 +242,30 @@ ssize_t bchlib_write(FAR void *handle, FAR const char *buffer, size_t offset,
 int pipe2(int fd[2], size_t bufsize);
 #endif
 
+/****************************************************************************
+ * Name: file_pipe
+ *
+ * Description:
+ *   Create an anonymous pipe and open it on a pair of detached file
+ *   structures.  filep[0] is opened for reading, filep[1] for writing.
+ *   The pipe is not visible in the pseudo-file system and is freed when
+ *   both ends have been closed with file_close().
+ *
+ * Input Parameters:
+ *   filep   - The zeroed file structures to open.
+ *   bufsize - The size of the in-memory, circular buffer in bytes.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_PIPES) && CONFIG_DEV_PIPE_SIZE > 0
+struct file;
+int file_pipe(FAR struct file *filep[2], size_t bufsize);
+#endif
+
 /****************************************************************************
  * Name: mkfifo2
  *
@@ -244,6 +244,24 @@ struct geometry
   size_t geo_sectorsize;   /* Size of one sector */
 };
 
+/* This structure is returned by the FIOC_GCSTATS IOCTL command.  It
+ * describes the activity of a FLASH file system's garbage collector (or
+ * packer), both when run synchronously by a writer that ran out of space
+ * and when run in the background while the volume is idle.
+ */
+
+struct fs_gcstats_s
+{
+  bool     gc_bgenabled;   /* true: Background collection is enabled */
+  uint32_t gc_bgsteps;     /* Number of background collection steps */
+  uint32_t gc_fgruns;      /* Number of collections run by a writer */
+  uint32_t gc_reclaimed;   /* Number of blocks reclaimed in the background */
+  uint32_t gc_erases;      /* Number of erase blocks erased by collection */
+  uint32_t gc_fgstall;     /* Total time that writers were stalled (msec) */
+  uint32_t gc_bgtime;      /* Total time spent collecting in the background.
+                            * This is the stall time avoided (msec) */
+};
+
 /* This structure is provided by block devices when they register with the
  * system.  It is used by file systems to perform filesystem transfers.  It
  * differs from the normal driver vtable in several ways -- most notably in
@@ -176,6 +176,16 @@
                                            *      int value.
                                            * OUT: Origin option.
                                            */
+#define FIOC_BGGC       _FIOC(0x000c)     /* IN:  Boolean option takes an
+                                           *      int value.  Non-zero enables
+                                           *      background garbage collection
+                                           *      (or packing), zero disables it.
+                                           * OUT: None
+                                           */
+#define FIOC_GCSTATS    _FIOC(0x000d)     /* IN:  Pointer to a writable instance
+                                           *      of struct fs_gcstats_s
+                                           * OUT: Garbage collection statistics
+                                           */
 
 /* NuttX file system ioctl definitions **************************************/
 
@@ -386,6 +396,15 @@
                                              *       (default)
                                              *     1=fre when empty
                                              * OUT: None */
+#define PIPEIOC_SETSIZE   _PIPEIOC(0x0002)  /* Set buffer size
+                                             * IN: unsigned long integer
+                                             *     The new buffer size in
+                                             *     bytes
+                                             * OUT: None */
+#define PIPEIOC_GETSIZE   _PIPEIOC(0x0003)  /* Get buffer size
+                                             * IN: Pointer to int
+                                             * OUT: The buffer size in
+                                             *      bytes */
 
 /* RTC driver ioctl definitions *********************************************/
 
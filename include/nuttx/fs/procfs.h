@@ -123,6 +123,14 @@ struct procfs_file_s
   FAR const struct procfs_entry_s *procfsentry;
 };
 
+/* Returns the garbage collection statistics of the mounted volume of a
+ * FLASH file system with the given index.  -ENOENT is returned if there is
+ * no volume with this index.  See procfs_gcstats_open().
+ */
+
+typedef CODE int (*procfs_gcstats_t)(int index,
+                                     FAR struct fs_gcstats_s *stats);
+
 /* The generic proc/ pseudo directory structure */
 
 struct procfs_dir_priv_s
@@ -212,6 +220,33 @@ size_t procfs_memcpy(FAR const char *src, size_t srclen,
 int procfs_register(FAR const struct procfs_entry_s *entry);
 #endif
 
+/****************************************************************************
+ * Name: procfs_gcstats_open, procfs_gcstats_close, procfs_gcstats_read,
+ *       procfs_gcstats_dup, procfs_gcstats_stat
+ *
+ * Description:
+ *   Common implementation of the read-only procfs files that report the
+ *   garbage collection statistics of the volumes of a FLASH file system,
+ *   such as /proc/fs/nxffs.  The file system provides open() and stat()
+ *   methods that pass the name of its file ('name') and the function that
+ *   returns the statistics of a volume ('getstats');  close(), read() and
+ *   dup() are used as they are.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NXFFS_BGPACK) || defined(CONFIG_SPIFFS_BGGC)
+int     procfs_gcstats_open(FAR struct file *filep, FAR const char *relpath,
+                            int oflags, FAR const char *name,
+                            procfs_gcstats_t getstats);
+int     procfs_gcstats_close(FAR struct file *filep);
+ssize_t procfs_gcstats_read(FAR struct file *filep, FAR char *buffer,
+                            size_t buflen);
+int     procfs_gcstats_dup(FAR const struct file *oldp,
+                           FAR struct file *newp);
+int     procfs_gcstats_stat(FAR const char *relpath, FAR const char *name,
+                            FAR struct stat *buf);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -235,6 +235,9 @@ struct mm_heap_s
   sem_t mm_semaphore;
   pid_t mm_holder;
   int mm_counts_held;
+#ifdef CONFIG_SEM_ADAPTIVE
+  struct sem_spinstats_s mm_spinstats;
+#endif
 
   /* This is the size of the heap provided to mm */
 
@@ -46,6 +46,7 @@
 #include <nuttx/signal.h>
 
 #include <sys/types.h>
+#include <limits.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <mqueue.h>
@@ -92,18 +93,29 @@
 #  define _MQ_GETERRVAL(r)            (-errno)
 #endif
 
+/* The number of 32-bit words in the bitmap of non-empty priorities */
+
+#define MQ_PRIOSET_NWORDS ((MQ_PRIO_MAX + 32) / 32)
+
 /****************************************************************************
  * Public Type Declarations
  ****************************************************************************/
 
 /* This structure defines a message queue */
 
-struct mq_des; /* forward reference */
+struct mq_des;       /* forward reference */
+struct mqueue_msg_s; /* forward reference */
 
 struct mqueue_inode_s
 {
   FAR struct inode *inode;    /* Containing inode */
   sq_queue_t msglist;         /* Prioritized message list */
+#ifdef CONFIG_MQ_PRIO_BUCKETS
+  uint32_t prioset[MQ_PRIOSET_NWORDS];              /* Non-empty priorities */
+  FAR struct mqueue_msg_s *priotail[MQ_PRIO_MAX + 1]; /* Last msg of each */
+#endif
+  dq_queue_t waitnotempty;    /* Tasks waiting for not empty */
+  dq_queue_t waitnotfull;     /* Tasks waiting for not full */
   int16_t maxmsgs;            /* Maximum number of messages in the queue */
   int16_t nmsgs;              /* Number of message in the queue */
   int16_t nwaitnotfull;       /* Number tasks waiting for not full */
@@ -97,6 +97,11 @@ struct mtd_smart_procfs_data_s
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
   uint32_t            uneven_wearcount; /* Number of uneven block erases */
 #endif
+#ifdef CONFIG_MTD_SMART_DATA_CACHE
+  uint32_t            cachehits;        /* Number of data cache hits */
+  uint32_t            cachemisses;      /* Number of data cache misses */
+  uint32_t            cachereadahead;   /* Number of sectors read ahead */
+#endif
 };
 
 /* The following defines debug command data passed from the procfs layer to
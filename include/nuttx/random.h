@@ -156,6 +156,18 @@ void up_rngaddentropy(enum rnd_source_t kindof, FAR const uint32_t *buf,
 
 void up_rngreseed(void);
 
+/****************************************************************************
+ * Name: up_rngbuf
+ *
+ * Description:
+ *   Fill a buffer with the output of the BLAKE2Xs generator of the entropy
+ *   pool, under the lock of the pool.  getrandom() should be used instead;
+ *   it is this unless CONFIG_CRYPTO_RANDOM_POOL_CHACHA20 is selected.
+ *
+ ****************************************************************************/
+
+void up_rngbuf(FAR void *bytes, size_t nbytes);
+
 /****************************************************************************
  * Name: up_randompool_initialize
  *
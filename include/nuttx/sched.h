@@ -664,6 +664,7 @@ struct tcb_s
   /* POSIX Semaphore Control Fields *********************************************/
 
   sem_t *waitsem;                        /* Semaphore ID waiting on             */
+  dq_entry_t semwaitnode;                /* Link in the semaphore's wait list   */
 
   /* POSIX Signal Control Fields ************************************************/
 
@@ -677,6 +678,7 @@ struct tcb_s
 
 #ifndef CONFIG_DISABLE_MQUEUE
   FAR struct mqueue_inode_s *msgwaitq;   /* Waiting for this message queue      */
+  dq_entry_t msgwaitnode;                /* Link in the queue's list of waiters */
 #endif
 
   /* POSIX Thread Specific Data *************************************************/
@@ -27,6 +27,7 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
 #include <errno.h>
 #include <semaphore.h>
 
@@ -85,6 +86,32 @@
 #  define _SEM_ERRVAL(r)        (-errno)
 #endif
 
+/* Direct changes of the count of a semaphore.  These are used by the
+ * semaphore logic and by the few places in the OS that adjust a count
+ * within a critical section without calling nxsem_wait() or nxsem_post(),
+ * e.g. because they may run in an interrupt handler.  With
+ * CONFIG_SEM_FASTPATH, the count may also be changed outside of the
+ * critical section, so every change of the count must be atomic.
+ *
+ * nxsem_count_cas(s,o,n) sets the count to 'n' if it is still '*o' and
+ * returns true.  Otherwise, it stores the current count in '*o' and
+ * returns false.
+ */
+
+#ifdef CONFIG_SEM_FASTPATH
+#  define nxsem_count_inc(s) \
+     __atomic_add_fetch(&(s)->semcount, 1, __ATOMIC_RELEASE)
+#  define nxsem_count_dec(s) \
+     __atomic_sub_fetch(&(s)->semcount, 1, __ATOMIC_ACQUIRE)
+#  define nxsem_count_cas(s,o,n) \
+     __atomic_compare_exchange_n(&(s)->semcount, (o), (n), false, \
+                                 __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)
+#else
+#  define nxsem_count_inc(s)     (++(s)->semcount)
+#  define nxsem_count_dec(s)     (--(s)->semcount)
+#  define nxsem_count_cas(s,o,n) ((s)->semcount = (n), true)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -107,6 +134,19 @@ struct nsem_inode_s
 };
 #endif
 
+#ifdef CONFIG_SEM_ADAPTIVE
+/* Statistics of a semaphore that is used as an adaptive mutex.  They are
+ * updated without any lock and so are only approximate.
+ */
+
+struct sem_spinstats_s
+{
+  uint32_t ss_nspin;    /* Number of times that a caller spun */
+  uint32_t ss_nacquire; /* The caller took the semaphore while spinning */
+  uint32_t ss_ngiveup;  /* The holder left its CPU or the limit was hit */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -604,6 +644,40 @@ int nxsem_timedwait_uninterruptible(FAR sem_t *sem,
 int nxsem_tickwait_uninterruptible(FAR sem_t *sem, clock_t start,
                                    uint32_t delay);
 
+/****************************************************************************
+ * Name: nxsem_spin
+ *
+ * Description:
+ *   Spin while a semaphore that is used as a mutex is held by a task that
+ *   is running on another CPU.  Such a holder is expected to post the
+ *   semaphore soon, and spinning is then cheaper than blocking and being
+ *   awakened again.
+ *
+ *   This function takes the semaphore with nxsem_trywait() as soon as it
+ *   becomes available.  Otherwise, it returns when the holder is no longer
+ *   running or after CONFIG_SEM_ADAPTIVE_SPINS polls, and the caller then
+ *   takes the semaphore as usual, perhaps waiting.
+ *
+ *   Nothing is done if the caller is in a critical section, because the
+ *   holder may then need the critical section to post the semaphore.
+ *
+ * Input Parameters:
+ *   sem    - The semaphore
+ *   holder - The location where the caller records the ID of the task
+ *            that holds the semaphore, negative if not known
+ *   stats  - The statistics of the semaphore
+ *
+ * Returned Value:
+ *   true if the semaphore was taken.  The caller then holds it and must
+ *   not wait for it again.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_ADAPTIVE
+bool nxsem_spin(FAR sem_t *sem, FAR const volatile pid_t *holder,
+                FAR struct sem_spinstats_s *stats);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -89,6 +89,12 @@
 #  endif
 #endif
 
+/* TX wakeup watermark */
+
+#ifndef CONFIG_SERIAL_TXWAKEUP_WATERMARK
+#  define CONFIG_SERIAL_TXWAKEUP_WATERMARK 0
+#endif
+
 /* vtable access helpers */
 
 #define uart_setup(dev)          dev->ops->setup(dev)
@@ -155,6 +161,22 @@ struct uart_dmaxfer_s
 };
 #endif /* CONFIG_SERIAL_RXDMA || CONFIG_SERIAL_TXDMA */
 
+/* This structure describes an RX DMA buffer that the DMA controller fills
+ * continuously in circular mode.  The buffer is usually serviced from the
+ * half-transfer and transfer-complete interrupts (ping-pong) and from the
+ * receiver idle interrupt.  It is allocated and initialized by the lower
+ * half driver, with 'offset' set to zero when the DMA is started.
+ */
+
+#ifdef CONFIG_SERIAL_RXDMA
+struct uart_dmapingpong_s
+{
+  FAR char        *buffer;  /* The circular DMA buffer */
+  size_t           size;    /* Size of the DMA buffer (both halves) */
+  size_t           offset;  /* Offset of the first byte not yet consumed */
+};
+#endif
+
 /* This structure defines all of the operations providd by the architecture specific
  * logic.  All fields must be provided with non-NULL function pointers by the
  * caller of uart_register().
@@ -495,6 +517,23 @@ void uart_recvchars_dma(FAR uart_dev_t *dev);
 void uart_recvchars_done(FAR uart_dev_t *dev);
 #endif
 
+/************************************************************************************
+ * Name: uart_recvchars_pingpong
+ *
+ * Description:
+ *   Move the data received into a circular (ping-pong) RX DMA buffer into the
+ *   RX circular buffer and wake up any threads waiting for it.  This is called
+ *   by the lower half from the DMA half-transfer and transfer-complete
+ *   interrupts and from the receiver idle interrupt.  'dmapos' is the offset
+ *   in the DMA buffer at which the DMA controller will store the next byte.
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA
+void uart_recvchars_pingpong(FAR uart_dev_t *dev,
+                             FAR struct uart_dmapingpong_s *pp, size_t dmapos);
+#endif
+
 /************************************************************************************
  * Name: uart_reset_sem
  *
@@ -45,6 +45,8 @@
 #include <sys/types.h>
 #include <stdint.h>
 
+#include <nuttx/irq.h>
+
 #ifdef CONFIG_SPINLOCK
 
 /* The architecture specific spinlock.h header file must also provide the
@@ -343,4 +345,105 @@ void spin_clrbit(FAR volatile cpu_set_t *set, unsigned int cpu,
 #endif
 
 #endif /* CONFIG_SPINLOCK */
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_SPINLOCKS
+/* Hold time statistics of one subsystem spinlock.  The times are in the
+ * units of up_critmon_gettime().
+ */
+
+struct spin_monitor_s
+{
+  FAR const char *name;          /* Name of the lock in /proc/spinlocks */
+  FAR volatile spinlock_t *lock; /* The monitored lock, NULL if unused */
+  uint32_t start;                /* Time that the lock was taken */
+  uint32_t max;                  /* Longest time that the lock was held */
+  uint32_t count;                /* Number of times that it was taken */
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+extern struct spin_monitor_s
+  g_spin_monitor[CONFIG_SCHED_CRITMONITOR_NSPINLOCKS];
+#endif
+
+/****************************************************************************
+ * Name: spin_lock_save
+ *
+ * Description:
+ *   Disable local interrupts and take a subsystem spinlock.  This protects
+ *   the data of one subsystem like enter_critical_section() does, but in
+ *   an SMP configuration it excludes only the other users of the same lock
+ *   instead of serializing all CPUs on the global critical section.  In a
+ *   single CPU configuration, disabling the local interrupts is all that
+ *   is needed and the lock is not used unless it is monitored.
+ *
+ *   The lock is not recursive.  The holder must not block and must not
+ *   call enter_critical_section():  A CPU in the critical section may be
+ *   waiting for the same lock.  Taking the lock from within the critical
+ *   section is permitted.
+ *
+ * Input Parameters:
+ *   lock - The spinlock that protects the data of the subsystem
+ *
+ * Returned Value:
+ *   The state of the interrupts prior to the call.  This must be passed
+ *   to spin_unlock_restore().
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SMP) || defined(CONFIG_SCHED_CRITMONITOR_SPINLOCKS)
+irqstate_t spin_lock_save(FAR volatile spinlock_t *lock);
+#else
+#  define spin_lock_save(l) up_irq_save()
+#endif
+
+/****************************************************************************
+ * Name: spin_unlock_restore
+ *
+ * Description:
+ *   Release a subsystem spinlock and restore the local interrupt state.
+ *
+ * Input Parameters:
+ *   lock  - The spinlock taken by spin_lock_save()
+ *   flags - The value returned by spin_lock_save()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SMP) || defined(CONFIG_SCHED_CRITMONITOR_SPINLOCKS)
+void spin_unlock_restore(FAR volatile spinlock_t *lock, irqstate_t flags);
+#else
+#  define spin_unlock_restore(l,f) up_irq_restore(f)
+#endif
+
+/****************************************************************************
+ * Name: spin_monitor
+ *
+ * Description:
+ *   Start to collect the hold time statistics of a subsystem spinlock.
+ *   The statistics are reported in /proc/spinlocks.
+ *
+ * Input Parameters:
+ *   lock - The spinlock to monitor
+ *   name - The name of the lock in the report
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if all monitor slots are in use.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_SPINLOCKS
+int spin_monitor(FAR volatile spinlock_t *lock, FAR const char *name);
+#else
+#  define spin_monitor(l,n) (0)
+#endif
+
 #endif /* __INCLUDE_NUTTX_SPINLOCK_H */
@@ -55,6 +55,10 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
 #include <nuttx/syslog/syslog.h>
 
 #ifdef CONFIG_RAMLOG
@@ -74,6 +78,9 @@
  *   used to generate debug output from interrupt level handlers.
  * CONFIG_RAMLOG_NPOLLWAITERS - The number of threads than can be waiting
  *   for this driver on poll().  Default: 4
+ * CONFIG_RAMLOG_MULTIREADER - Reading does not remove data from the log.
+ *   Each open file has its own read position and the oldest data is
+ *   overwritten when the log is full.  The log may be mapped with mmap().
  *
  * If CONFIG_RAMLOG_SYSLOG is selected, then the following may also be
  * provided:
@@ -94,11 +101,39 @@
 #endif
 
 /****************************************************************************
- * Public Data
+ * Public Types
  ****************************************************************************/
 
 #ifndef __ASSEMBLY__
 
+#ifdef CONFIG_RAMLOG_MULTIREADER
+/* With CONFIG_RAMLOG_MULTIREADER, mmap() of the RAM log device returns
+ * this header followed by the circular buffer of rh_size bytes (a power of
+ * two).  rh_head and rh_tail are free-running positions:  The byte at
+ * position 'pos' is at offset (pos & (rh_size - 1)) in the buffer and the
+ * valid data is at the positions from rh_tail up to (not including)
+ * rh_head.
+ *
+ * The writer moves rh_tail before overwriting old data and moves rh_head
+ * after adding new data.  A mapped reader therefore needs no lock:  Read
+ * rh_head, copy the data from the current position, and then re-read
+ * rh_tail.  If rh_tail has moved past the start of the copied data, the
+ * copy may have been overwritten and must be discarded; resume at
+ * rh_tail.
+ */
+
+struct ramlog_header_s
+{
+  volatile uint32_t rh_head;  /* Position where the next byte is added */
+  volatile uint32_t rh_tail;  /* Position of the oldest valid byte */
+  uint32_t rh_size;           /* Size of the circular buffer that follows */
+};
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
 #ifdef __cplusplus
 #define EXTERN extern "C"
 extern "C"
@@ -125,6 +160,11 @@ extern "C"
  *   CONFIG_RAMLOG_SYSLOG would be set to capture debug output only
  *   in the log.
  *
+ *   With CONFIG_RAMLOG_MULTIREADER, the buffer must be 32-bit aligned.  A
+ *   struct ramlog_header_s is placed at the beginning of the buffer and
+ *   the largest power of two that fits in the rest of it is used for the
+ *   log.
+ *
  ****************************************************************************/
 
 int ramlog_register(FAR const char *devpath, FAR char *buffer, size_t buflen);
@@ -154,6 +194,18 @@ void ramlog_syslog_register(void);
 int ramlog_putc(int ch);
 #endif
 
+/****************************************************************************
+ * Name: ramlog_syslog_write
+ *
+ * Description:
+ *   This is the low-level, multiple byte, system logging interface.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_RAMLOG_SYSLOG) && defined(CONFIG_SYSLOG_WRITE)
+ssize_t ramlog_syslog_write(FAR const char *buffer, size_t buflen);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
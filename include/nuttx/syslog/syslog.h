@@ -266,6 +266,11 @@ int syslog_flush(void);
  *   some compilers and passing of structures in the NuttX sycalls does
  *   not work.
  *
+ *   The number of bytes output is returned.  If CONFIG_SYSLOG_DEFERRED is
+ *   enabled and the message was deferred (or dropped because the buffer
+ *   was full), zero is returned instead:  The message is formatted later
+ *   and its length is not known.
+ *
  ****************************************************************************/
 
 int nx_vsyslog(int priority, FAR const IPTR char *src, FAR va_list *ap);
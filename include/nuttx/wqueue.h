@@ -274,8 +274,34 @@ struct work_s
   FAR void *arg;         /* Callback argument */
   clock_t qtime;         /* Time work queued */
   clock_t delay;         /* Delay until work performed */
+  uint8_t prio;          /* Priority among ready work (0: lowest) */
+#ifdef CONFIG_WQUEUE_STEALING
+  int8_t wndx;           /* Worker deque holding the work (-1: shared) */
+#endif
+#ifdef CONFIG_WQUEUE_BATCH
+  FAR struct work_batch_s *batch; /* Batch that the work is part of */
+#endif
 };
 
+/* Describes a batch of work.  Work is added to a batch with
+ * work_batch_queue() and the completion callback of the batch is queued
+ * once, after all of that work has been performed or cancelled and the
+ * batch has been closed with work_batch_close().  The batch structure is
+ * allocated by the caller and must persist until the completion callback
+ * runs.
+ */
+
+#ifdef CONFIG_WQUEUE_BATCH
+struct work_batch_s
+{
+  struct work_s work;    /* Used to queue the completion callback */
+  worker_t  worker;      /* Completion callback */
+  FAR void *arg;         /* Argument of the completion callback */
+  uint16_t  pending;     /* Work not yet performed, +1 until closed */
+  uint8_t   qid;         /* The work queue of the batch */
+};
+#endif
+
 /* This is an enumeration of the various events that may be
  * notified via work_notifier_signal().
  */
@@ -374,6 +400,111 @@ int work_usrstart(void);
 int work_queue(int qid, FAR struct work_s *work, worker_t worker,
                FAR void *arg, clock_t delay);
 
+/****************************************************************************
+ * Name: work_queue_prio
+ *
+ * Description:
+ *   Queue kernel-mode work with a priority.  Once ready, the work is
+ *   performed before ready work of a lower priority; work of equal
+ *   priority is performed in FIFO order.  work_queue() queues work with
+ *   priority zero.
+ *
+ *   Work on the low-priority work queue is also performed with the worker
+ *   thread running at least at this priority (up to
+ *   CONFIG_SCHED_LPWORKPRIOMAX), so that only the worker thread that
+ *   performs the work is boosted.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.  The callback will invoked
+ *            on the worker thread of execution.
+ *   arg    - The argument that will be passed to the worker callback when
+ *            it is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *   prio   - The priority of the work, typically the priority of the
+ *            requesting thread.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+int work_queue_prio(int qid, FAR struct work_s *work, worker_t worker,
+                    FAR void *arg, clock_t delay, uint8_t prio);
+#endif
+
+/****************************************************************************
+ * Name: work_batch_init
+ *
+ * Description:
+ *   Initialize a batch of work.  The batch is open until it is closed with
+ *   work_batch_close().
+ *
+ * Input Parameters:
+ *   batch  - The batch to initialize
+ *   qid    - The work queue to perform the work of the batch on
+ *   worker - The completion callback.  It is invoked once on the worker
+ *            thread after all work in the batch was performed.
+ *   arg    - The argument that will be passed to the completion callback
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WQUEUE_BATCH
+int work_batch_init(FAR struct work_batch_s *batch, int qid,
+                    worker_t worker, FAR void *arg);
+#endif
+
+/****************************************************************************
+ * Name: work_batch_queue
+ *
+ * Description:
+ *   Queue work as a part of an open batch.  The work is ready immediately.
+ *   It may be cancelled with work_cancel(), which also removes it from the
+ *   batch.
+ *
+ * Input Parameters:
+ *   batch  - The open batch
+ *   work   - The work structure to queue.  It must not be queued already.
+ *   worker - The worker callback to be invoked
+ *   arg    - The argument that will be passed to the worker callback
+ *   prio   - The priority of the work; see work_queue_prio()
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WQUEUE_BATCH
+int work_batch_queue(FAR struct work_batch_s *batch, FAR struct work_s *work,
+                     worker_t worker, FAR void *arg, uint8_t prio);
+#endif
+
+/****************************************************************************
+ * Name: work_batch_close
+ *
+ * Description:
+ *   Close a batch.  No more work may be added to it.  The completion
+ *   callback is queued when all work in the batch is done, which may be
+ *   right away.
+ *
+ * Input Parameters:
+ *   batch  - The open batch
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WQUEUE_BATCH
+int work_batch_close(FAR struct work_batch_s *batch);
+#endif
+
 /****************************************************************************
  * Name: work_cancel
  *
@@ -439,6 +570,9 @@ int work_signal(int qid);
  *   priority worker thread is at least at the requested level, reqprio. This
  *   function would normally be called just before calling work_queue().
  *
+ *   This boosts all of the low-priority worker threads.  work_queue_prio()
+ *   boosts only the worker thread that performs the work.
+ *
  * Input Parameters:
  *   reqprio - Requested minimum worker thread priority
  *
@@ -57,6 +57,8 @@
 
 #define PRIOINHERIT_FLAGS_DISABLE (1 << 0)  /* Bit 0: Priority inheritance
                                              * is disabled for this semaphore. */
+#define PRIOINHERIT_FLAGS_BOOSTED (1 << 1)  /* Bit 1: A holder may have been
+                                             * boosted by a waiter. */
 
 /****************************************************************************
  * Public Type Declarations
@@ -95,7 +97,8 @@ struct sem_s
 #ifdef CONFIG_PRIORITY_INHERITANCE
   uint8_t flags;                 /* See PRIOINHERIT_FLAGS_* definitions */
 # if CONFIG_SEM_PREALLOCHOLDERS > 0
-  FAR struct semholder_s *hhead; /* List of holders of semaphore counts */
+  FAR struct semholder_s *hhead; /* List of further holders of counts */
+  struct semholder_s holder;     /* Inline slot for the first holder */
 # else
   struct semholder_s holder[2];  /* Slot for old and new holder */
 # endif
@@ -109,7 +112,7 @@ typedef struct sem_s sem_t;
 #ifdef CONFIG_PRIORITY_INHERITANCE
 # if CONFIG_SEM_PREALLOCHOLDERS > 0
 #  define SEM_INITIALIZER(c) \
-    {(c), 0, NULL}               /* semcount, flags, hhead */
+    {(c), 0, NULL, SEMHOLDER_INITIALIZER} /* semcount, flags, hhead, holder */
 # else
 #  define SEM_INITIALIZER(c) \
     {(c), 0, {SEMHOLDER_INITIALIZER, SEMHOLDER_INITIALIZER}} /* semcount, flags, holder[2] */
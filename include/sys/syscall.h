@@ -353,12 +353,13 @@
 #define SYS_statfs                     (__SYS_filedesc + 13)
 #define SYS_fstatfs                    (__SYS_filedesc + 14)
 #define SYS_telldir                    (__SYS_filedesc + 15)
+#define SYS_msync                      (__SYS_filedesc + 16)
 
 #ifdef CONFIG_FS_RAMMAP
-#  define SYS_munmap                   (__SYS_filedesc + 16)
-#  define __SYS_link                   (__SYS_filedesc + 17)
+#  define SYS_munmap                   (__SYS_filedesc + 17)
+#  define __SYS_link                   (__SYS_filedesc + 18)
 #else
-#  define __SYS_link                   (__SYS_filedesc + 16)
+#  define __SYS_link                   (__SYS_filedesc + 17)
 #endif
 
 #if defined(CONFIG_PSEUDOFS_SOFTLINKS)
@@ -378,9 +379,16 @@
 
 #if defined(CONFIG_PIPES) && CONFIG_DEV_FIFO_SIZE > 0
 #  define SYS_mkfifo2                  (__SYS_mkfifo2 + 0)
-#  define __SYS_fs_fdopen              (__SYS_mkfifo2 + 1)
+#  define __SYS_splice                 (__SYS_mkfifo2 + 1)
+#else
+#  define __SYS_splice                 (__SYS_mkfifo2 + 0)
+#endif
+
+#if defined(CONFIG_PIPES)
+#  define SYS_splice                   (__SYS_splice + 0)
+#  define __SYS_fs_fdopen              (__SYS_splice + 1)
 #else
-#  define __SYS_fs_fdopen              (__SYS_mkfifo2 + 0)
+#  define __SYS_fs_fdopen              (__SYS_splice + 0)
 #endif
 
 #if CONFIG_NFILE_STREAMS > 0
@@ -540,7 +548,8 @@
 #  define SYS_sendto                   (__SYS_network + 10)
 #  define SYS_setsockopt               (__SYS_network + 11)
 #  define SYS_socket                   (__SYS_network + 12)
-#  define __SYS_socket                 (__SYS_network + 13)
+#  define SYS_socketpair               (__SYS_network + 13)
+#  define __SYS_socket                 (__SYS_network + 14)
 #else
 #  define __SYS_socket                 (__SYS_network + 0)
 #endif
@@ -40,15 +40,131 @@
 #include <nuttx/config.h>
 
 #include <sys/sendfile.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <errno.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 
 #include "libc.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sendfile_mapped
+ *
+ * Description:
+ *   If the input file can be accessed directly in memory (as is a file on
+ *   an XIP ROMFS volume), then write the data directly from that memory to
+ *   the output file without copying it through an intermediate buffer.
+ *
+ *   This is only done for regular files on ROMFS.  Character devices may
+ *   support FIOC_MMAP too, but they do not report a size.  And other file
+ *   systems may move the memory of a file while it is being written, for
+ *   example tmpfs when a concurrent write extends the file.
+ *
+ * Returned Value:
+ *   The number of bytes transferred or ERROR with errno set.  -ENOTTY is
+ *   returned (without setting errno) if the input file does not support
+ *   direct access.
+ *
+ ****************************************************************************/
+
+static ssize_t sendfile_mapped(int outfd, int infd, FAR off_t *offset,
+                               size_t count)
+{
+  FAR const uint8_t *addr;
+  FAR void *base = NULL;
+  struct statfs fsbuf;
+  struct stat buf;
+  ssize_t nbyteswritten;
+  size_t ntransferred;
+  off_t pos;
+
+  if (fstat(infd, &buf) < 0 || !S_ISREG(buf.st_mode) ||
+      fstatfs(infd, &fsbuf) < 0 || fsbuf.f_type != ROMFS_MAGIC)
+    {
+      return -ENOTTY;
+    }
+
+  if (ioctl(infd, FIOC_MMAP, (unsigned long)((uintptr_t)&base)) < 0 ||
+      base == NULL)
+    {
+      return -ENOTTY;
+    }
+
+  /* Get the position to start from */
+
+  if (offset)
+    {
+      pos = *offset;
+    }
+  else
+    {
+      pos = lseek(infd, 0, SEEK_CUR);
+      if (pos == (off_t)-1)
+        {
+          return ERROR;
+        }
+    }
+
+  if (pos >= buf.st_size)
+    {
+      return 0;
+    }
+
+  if (count > buf.st_size - pos)
+    {
+      count = buf.st_size - pos;
+    }
+
+  /* Write the data directly from the file's memory */
+
+  addr = (FAR const uint8_t *)base + pos;
+  for (ntransferred = 0; ntransferred < count; )
+    {
+      nbyteswritten = _NX_WRITE(outfd, addr + ntransferred,
+                                count - ntransferred);
+      if (nbyteswritten < 0)
+        {
+          int errcode = _NX_GETERRNO(nbyteswritten);
+
+          /* EINTR is not an error (but will still stop the copy) */
+
+          if (errcode != EINTR || ntransferred == 0)
+            {
+              _NX_SETERRNO(nbyteswritten);
+              return ERROR;
+            }
+
+          break;
+        }
+
+      ntransferred += nbyteswritten;
+    }
+
+  /* Update the offset or the file position */
+
+  if (offset)
+    {
+      *offset = pos + ntransferred;
+    }
+  else if (lseek(infd, pos + ntransferred, SEEK_SET) == (off_t)-1)
+    {
+      return ERROR;
+    }
+
+  return ntransferred;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -111,6 +227,14 @@ ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
   size_t  ntransferred;
   bool endxfr;
 
+  /* Try to transfer the data without copying it first */
+
+  nbyteswritten = sendfile_mapped(outfd, infd, offset, count);
+  if (nbyteswritten != -ENOTTY)
+    {
+      return nbyteswritten;
+    }
+
   /* Get the current file position. */
 
   if (offset)
@@ -45,6 +45,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/mm/iob.h>
 
 #include "iob.h"
@@ -175,11 +176,11 @@ static FAR struct iob_s *iob_allocwait(bool throttled,
             {
               if (throttled)
                 {
-                  g_iob_sem.semcount--;
+                  nxsem_count_dec(&g_iob_sem);
                 }
               else
                 {
-                  g_throttle_sem.semcount--;
+                  nxsem_count_dec(&g_throttle_sem);
                 }
             }
 #endif
@@ -274,7 +275,7 @@ FAR struct iob_s *iob_tryalloc(bool throttled, enum iob_user_e consumerid)
            * so a simple decrement is all that is needed.
            */
 
-          g_iob_sem.semcount--;
+          nxsem_count_dec(&g_iob_sem);
           DEBUGASSERT(g_iob_sem.semcount >= 0);
 
 #if CONFIG_IOB_THROTTLE > 0
@@ -282,7 +283,7 @@ FAR struct iob_s *iob_tryalloc(bool throttled, enum iob_user_e consumerid)
            * it can be negative!  Decrementing is still safe, however.
            */
 
-          g_throttle_sem.semcount--;
+          nxsem_count_dec(&g_throttle_sem);
           DEBUGASSERT(g_throttle_sem.semcount >= -CONFIG_IOB_THROTTLE);
 #endif
 
@@ -41,6 +41,8 @@
 #include <nuttx/config.h>
 
 #include <unistd.h>
+#include <stdbool.h>
+#include <string.h>
 #include <errno.h>
 #include <assert.h>
 
@@ -79,6 +81,15 @@
 #  define _SEM_GETERROR(r)  (r) = -errno
 #endif
 
+/* Spinning on a heap that is held by a running task is only possible where
+ * the internal nxsem_* interfaces are available.
+ */
+
+#if defined(CONFIG_SEM_ADAPTIVE) && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define MM_SEM_SPIN 1
+#endif
+
 /* This is a special value that indicates that there is no holder of the
  * semaphore.  The valid range of PIDs is 0-32767 and any value outside of
  * that range could be used (except -ESRCH which is a special return value
@@ -127,6 +138,10 @@ void mm_seminitialize(FAR struct mm_heap_s *heap)
 
   heap->mm_holder      = NO_HOLDER;
   heap->mm_counts_held = 0;
+
+#ifdef CONFIG_SEM_ADAPTIVE
+  memset(&heap->mm_spinstats, 0, sizeof(struct sem_spinstats_s));
+#endif
 }
 
 /****************************************************************************
@@ -233,13 +248,39 @@ errout:
 void mm_takesemaphore(FAR struct mm_heap_s *heap)
 {
 #ifdef CONFIG_SMP
-  irqstate_t flags = enter_critical_section();
+  irqstate_t flags;
 #endif
   pid_t my_pid = getpid();
+  bool taken = false;
+
+#ifdef MM_SEM_SPIN
+  /* If another task holds the heap and is running on another CPU, spin
+   * until it releases the heap, before entering the critical section,
+   * which it needs to do so.
+   */
+
+  if (heap->mm_holder != my_pid)
+    {
+      taken = nxsem_spin(&heap->mm_semaphore, &heap->mm_holder,
+                         &heap->mm_spinstats);
+    }
+#endif
+
+#ifdef CONFIG_SMP
+  flags = enter_critical_section();
+#endif
+
+  /* Was the semaphore taken while spinning? */
+
+  if (taken)
+    {
+      heap->mm_holder      = my_pid;
+      heap->mm_counts_held = 1;
+    }
 
   /* Does the current task already hold the semaphore? */
 
-  if (heap->mm_holder == my_pid)
+  else if (heap->mm_holder == my_pid)
     {
       /* Yes, just increment the number of references held by the current
        * task.
@@ -158,8 +158,6 @@ struct local_conn_s
   struct file lc_infile;       /* File for read-only FIFO (peers) */
   struct file lc_outfile;      /* File descriptor of write-only FIFO (peers) */
   char lc_path[UNIX_PATH_MAX]; /* Path assigned by bind() */
-  int32_t lc_instance_id;      /* Connection instance ID for stream
-                                * server<->client connection pair */
 
 #ifdef CONFIG_NET_LOCAL_STREAM
   /* SOCK_STREAM fields common to both client and server */
@@ -196,6 +194,8 @@ struct local_conn_s
     {
       uint16_t lc_remaining;   /* (For binary compatibility with peer) */
       volatile int lc_result;  /* Result of the connection operation (client) */
+      struct file lc_srvin;    /* Server end of the client-to-server pipe */
+      struct file lc_srvout;   /* Server end of the server-to-client pipe */
     } client;
 
     /* Fields common to connected peers (connected or accepted) */
@@ -542,15 +542,18 @@ int local_getaddr(FAR struct local_conn_s *conn, FAR struct sockaddr *addr,
 int local_sync(FAR struct file *filep);
 
 /****************************************************************************
- * Name: local_create_fifos
+ * Name: local_create_pipes
  *
  * Description:
- *   Create the FIFO pair needed for a SOCK_STREAM connection.
+ *   Create the pair of anonymous pipes needed for a SOCK_STREAM connection.
+ *   The client ends are opened on the client's lc_infile and lc_outfile;
+ *   the server ends are opened on lc_srvin and lc_srvout, to be taken over
+ *   by the server when it accepts the connection.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_LOCAL_STREAM
-int local_create_fifos(FAR struct local_conn_s *conn);
+int local_create_pipes(FAR struct local_conn_s *client, bool nonblock);
 #endif
 
 /****************************************************************************
@@ -567,75 +570,45 @@ int local_create_halfduplex(FAR struct local_conn_s *conn,
 #endif
 
 /****************************************************************************
- * Name: local_release_fifos
+ * Name: local_release_pipes
  *
  * Description:
- *   Release references to the FIFO pair used for a SOCK_STREAM connection.
+ *   Close all pipe ends held by a SOCK_STREAM connection, including the
+ *   server ends of a connection that was never accepted.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_LOCAL_STREAM
-int local_release_fifos(FAR struct local_conn_s *conn);
+void local_release_pipes(FAR struct local_conn_s *conn);
 #endif
 
 /****************************************************************************
- * Name: local_release_halfduplex
- *
- * Description:
- *   Release a reference to the FIFO used for SOCK_DGRAM communication
- *
- ****************************************************************************/
-
-#ifdef CONFIG_NET_LOCAL_DGRAM
-int local_release_halfduplex(FAR struct local_conn_s *conn);
-#endif
-
-/****************************************************************************
- * Name: local_open_client_rx
- *
- * Description:
- *   Only the client-side Rx FIFO.
- *
- ****************************************************************************/
-
-#ifdef CONFIG_NET_LOCAL_STREAM
-int local_open_client_rx(FAR struct local_conn_s *client, bool nonblock);
-#endif
-
-/****************************************************************************
- * Name: local_open_client_tx
+ * Name: local_connect_pair
  *
  * Description:
- *   Only the client-side Tx FIFO.
- *
- ****************************************************************************/
-
-#ifdef CONFIG_NET_LOCAL_STREAM
-int local_open_client_tx(FAR struct local_conn_s *client, bool nonblock);
-#endif
-
-/****************************************************************************
- * Name: local_open_server_rx
+ *   Connect two unbound SOCK_STREAM connections to each other, as for
+ *   socketpair().
  *
- * Description:
- *   Only the server-side Rx FIFO.
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_LOCAL_STREAM
-int local_open_server_rx(FAR struct local_conn_s *server, bool nonblock);
+int local_connect_pair(FAR struct local_conn_s *conn0,
+                       FAR struct local_conn_s *conn1);
 #endif
 
 /****************************************************************************
- * Name: local_open_server_tx
+ * Name: local_release_halfduplex
  *
  * Description:
- *   Only the server-side Tx FIFO.
+ *   Release a reference to the FIFO used for SOCK_DGRAM communication
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_LOCAL_STREAM
-int local_open_server_tx(FAR struct local_conn_s *server, bool nonblock);
+#ifdef CONFIG_NET_LOCAL_DGRAM
+int local_release_halfduplex(FAR struct local_conn_s *conn);
 #endif
 
 /****************************************************************************
@@ -41,6 +41,7 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_LOCAL_STREAM)
 
 #include <string.h>
+#include <fcntl.h>
 #include <errno.h>
 #include <assert.h>
 #include <queue.h>
@@ -180,53 +181,39 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
 
               strncpy(conn->lc_path, client->lc_path, UNIX_PATH_MAX - 1);
               conn->lc_path[UNIX_PATH_MAX - 1] = '\0';
-              conn->lc_instance_id = client->lc_instance_id;
 
-              /* Open the server-side write-only FIFO.  This should not
-               * block.
+              /* Take over the server ends of the pipes that the client
+               * created when it connected.
                */
 
-              ret = local_open_server_tx(conn,
-                                         _SS_ISNONBLOCK(psock->s_flags));
-              if (ret < 0)
-                {
-                   nerr("ERROR: Failed to open write-only FIFOs for %s: %d\n",
-                        conn->lc_path, ret);
-                }
-            }
-
-          /* Do we have a connection?  Is the write-side FIFO opened? */
+              memcpy(&conn->lc_infile, &client->u.client.lc_srvin,
+                     sizeof(struct file));
+              memcpy(&conn->lc_outfile, &client->u.client.lc_srvout,
+                     sizeof(struct file));
+              memset(&client->u.client.lc_srvin, 0, sizeof(struct file));
+              memset(&client->u.client.lc_srvout, 0, sizeof(struct file));
 
-          if (ret == OK)
-            {
-              DEBUGASSERT(conn->lc_outfile.f_inode != NULL);
+              DEBUGASSERT(conn->lc_infile.f_inode != NULL &&
+                          conn->lc_outfile.f_inode != NULL);
 
-              /* Open the server-side read-only FIFO.  This should not
-               * block because the client side has already opening it
-               * for writing.
-               */
-
-              ret = local_open_server_rx(conn,
-                                         _SS_ISNONBLOCK(psock->s_flags));
-              if (ret < 0)
+              if (_SS_ISNONBLOCK(psock->s_flags))
                 {
-                   nerr("ERROR: Failed to open read-only FIFOs for %s: %d\n",
-                        conn->lc_path, ret);
+                  conn->lc_infile.f_oflags  |= O_NONBLOCK;
+                  conn->lc_outfile.f_oflags |= O_NONBLOCK;
                 }
-            }
-
-          /* Do we have a connection?  Are the FIFOs opened? */
-
-          if (ret == OK)
-            {
-              DEBUGASSERT(conn->lc_infile.f_inode != NULL);
 
               /* Return the address family */
 
+              ret = OK;
               if (addr != NULL)
                 {
                   ret = local_getaddr(client, addr, addrlen);
                 }
+
+              if (ret < 0)
+                {
+                  local_free(conn);
+                }
             }
 
           if (ret == OK)
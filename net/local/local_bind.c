@@ -109,7 +109,6 @@ int psock_local_bind(FAR struct socket *psock,
 
           strncpy(conn->lc_path, unaddr->sun_path, UNIX_PATH_MAX - 1);
           conn->lc_path[UNIX_PATH_MAX - 1] = '\0';
-          conn->lc_instance_id = -1;
         }
     }
 
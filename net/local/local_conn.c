@@ -118,6 +118,12 @@ void local_free(FAR struct local_conn_s *conn)
 {
   DEBUGASSERT(conn != NULL);
 
+#ifdef CONFIG_NET_LOCAL_STREAM
+  /* Close all pipes associated with the connection */
+
+  local_release_pipes(conn);
+  nxsem_destroy(&conn->lc_waitsem);
+#else
   /* Make sure that the read-only FIFO is closed */
 
   if (conn->lc_infile.f_inode != NULL)
@@ -133,12 +139,6 @@ void local_free(FAR struct local_conn_s *conn)
       file_close(&conn->lc_outfile);
       conn->lc_outfile.f_inode = NULL;
     }
-
-#ifdef CONFIG_NET_LOCAL_STREAM
-  /* Destroy all FIFOs associted with the connection */
-
-  local_release_fifos(conn);
-  nxsem_destroy(&conn->lc_waitsem);
 #endif
 
   /* And free the connection structure */
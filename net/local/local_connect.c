@@ -47,6 +47,7 @@
 #include <debug.h>
 
 #include <nuttx/net/net.h>
+#include <nuttx/drivers/drivers.h>
 
 #include <arch/irq.h>
 
@@ -60,26 +61,6 @@
  * Private Functions
  ****************************************************************************/
 
-/****************************************************************************
- * Name: local_generate_instance_id
- ****************************************************************************/
-
-static int32_t local_generate_instance_id(void)
-{
-  static int32_t g_next_instance_id = 0;
-  int32_t id;
-
-  /* Called from local_connect with net_lock held. */
-
-  id = g_next_instance_id++;
-  if (g_next_instance_id < 0)
-    {
-      g_next_instance_id = 0;
-    }
-
-  return id;
-}
-
 /****************************************************************************
  * Name: _local_semtake() and _local_semgive()
  *
@@ -141,33 +122,24 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
   server->u.server.lc_pending++;
   DEBUGASSERT(server->u.server.lc_pending != 0);
 
-  /* Create the FIFOs needed for the connection */
-
-  ret = local_create_fifos(client);
-  if (ret < 0)
-    {
-      nerr("ERROR: Failed to create FIFOs for %s: %d\n",
-           client->lc_path, ret);
-
-      net_unlock();
-      return ret;
-    }
-
-  /* Open the client-side write-only FIFO.  This should not block and should
-   * prevent the server-side from blocking as well.
+  /* Create the pipes needed for the connection.  These are anonymous,
+   * in-memory pipes that are handed directly to the server; there is no
+   * named FIFO to create, look up, open or unlink.
    */
 
-  ret = local_open_client_tx(client, nonblock);
+  ret = local_create_pipes(client, nonblock);
   if (ret < 0)
     {
-      nerr("ERROR: Failed to open write-only FIFOs for %s: %d\n",
+      nerr("ERROR: Failed to create pipes for %s: %d\n",
            client->lc_path, ret);
 
+      server->u.server.lc_pending--;
       net_unlock();
-      goto errout_with_fifos;
+      return ret;
     }
 
-  DEBUGASSERT(client->lc_outfile.f_inode != NULL);
+  DEBUGASSERT(client->lc_outfile.f_inode != NULL &&
+              client->lc_infile.f_inode != NULL);
 
   /* Set the busy "result" before giving the semaphore. */
 
@@ -200,31 +172,13 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
   if (ret < 0)
     {
       nerr("ERROR: Failed to connect: %d\n", ret);
-      goto errout_with_outfd;
-    }
-
-  /* Yes.. open the read-only FIFO */
-
-  ret = local_open_client_rx(client, nonblock);
-  if (ret < 0)
-    {
-      nerr("ERROR: Failed to open write-only FIFOs for %s: %d\n",
-           client->lc_path, ret);
-      goto errout_with_outfd;
+      local_release_pipes(client);
+      client->lc_state = LOCAL_STATE_BOUND;
+      return ret;
     }
 
-  DEBUGASSERT(client->lc_infile.f_inode != NULL);
   client->lc_state = LOCAL_STATE_CONNECTED;
   return OK;
-
-errout_with_outfd:
-  file_close(&client->lc_outfile);
-  client->lc_outfile.f_inode = NULL;
-
-errout_with_fifos:
-  local_release_fifos(client);
-  client->lc_state = LOCAL_STATE_BOUND;
-  return ret;
 }
 
 /****************************************************************************
@@ -307,7 +261,6 @@ int psock_local_connect(FAR struct socket *psock,
                 client->lc_proto = conn->lc_proto;
                 strncpy(client->lc_path, unaddr->sun_path, UNIX_PATH_MAX - 1);
                 client->lc_path[UNIX_PATH_MAX - 1] = '\0';
-                client->lc_instance_id = local_generate_instance_id();
 
                 /* The client is now bound to an address */
 
@@ -345,4 +298,69 @@ int psock_local_connect(FAR struct socket *psock,
   return -EADDRNOTAVAIL;
 }
 
+/****************************************************************************
+ * Name: local_connect_pair
+ *
+ * Description:
+ *   Connect two unbound SOCK_STREAM connections to each other, as for
+ *   socketpair().  No server is involved:  Each connection simply gets the
+ *   read end of one anonymous pipe and the write end of the other.
+ *
+ * Input Parameters:
+ *   conn0, conn1 - The connections to be connected
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int local_connect_pair(FAR struct local_conn_s *conn0,
+                       FAR struct local_conn_s *conn1)
+{
+  FAR struct file *pipe01[2];
+  FAR struct file *pipe10[2];
+  int ret;
+
+  DEBUGASSERT(conn0 != NULL && conn1 != NULL);
+
+  if (conn0->lc_state != LOCAL_STATE_UNBOUND ||
+      conn1->lc_state != LOCAL_STATE_UNBOUND)
+    {
+      return -EISCONN;
+    }
+
+  /* Create the conn0-to-conn1 pipe */
+
+  pipe01[0] = &conn1->lc_infile;
+  pipe01[1] = &conn0->lc_outfile;
+
+  ret = file_pipe(pipe01, CONFIG_DEV_FIFO_SIZE);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Create the conn1-to-conn0 pipe */
+
+  pipe10[0] = &conn0->lc_infile;
+  pipe10[1] = &conn1->lc_outfile;
+
+  ret = file_pipe(pipe10, CONFIG_DEV_FIFO_SIZE);
+  if (ret < 0)
+    {
+      local_release_pipes(conn0);
+      local_release_pipes(conn1);
+      return ret;
+    }
+
+  conn0->lc_proto = SOCK_STREAM;
+  conn0->lc_type  = LOCAL_TYPE_UNNAMED;
+  conn0->lc_state = LOCAL_STATE_CONNECTED;
+
+  conn1->lc_proto = SOCK_STREAM;
+  conn1->lc_type  = LOCAL_TYPE_UNNAMED;
+  conn1->lc_state = LOCAL_STATE_CONNECTED;
+  return OK;
+}
+
 #endif /* CONFIG_NET_LOCAL_STREAM */
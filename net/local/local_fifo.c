@@ -51,14 +51,14 @@
 #include <errno.h>
 #include <assert.h>
 
+#include <nuttx/drivers/drivers.h>
+
 #include "local/local.h"
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define LOCAL_CS_SUFFIX    "CS"  /* Name of the client-to-server FIFO */
-#define LOCAL_SC_SUFFIX    "SC"  /* Name of the server-to-client FIFO */
 #define LOCAL_HD_SUFFIX    "HD"  /* Name of the half duplex datagram FIFO */
 #define LOCAL_SUFFIX_LEN   2
 
@@ -68,60 +68,6 @@
  * Private Functions
  ****************************************************************************/
 
-/****************************************************************************
- * Name: local_cs_name
- *
- * Description:
- *   Create the name of the client-to-server FIFO.
- *
- ****************************************************************************/
-
-#ifdef CONFIG_NET_LOCAL_STREAM
-static inline void local_cs_name(FAR struct local_conn_s *conn,
-                                 FAR char *path)
-{
-  if (conn->lc_instance_id < 0)
-    {
-      snprintf(path, LOCAL_FULLPATH_LEN - 1, "%s" LOCAL_CS_SUFFIX,
-               conn->lc_path);
-    }
-  else
-    {
-      snprintf(path, LOCAL_FULLPATH_LEN - 1, "%s" LOCAL_CS_SUFFIX "%x",
-               conn->lc_path, conn->lc_instance_id);
-    }
-
-  path[LOCAL_FULLPATH_LEN - 1] = '\0';
-}
-#endif /* CONFIG_NET_LOCAL_STREAM */
-
-/****************************************************************************
- * Name: local_sc_name
- *
- * Description:
- *   Create the name of the server-to-client FIFO.
- *
- ****************************************************************************/
-
-#ifdef CONFIG_NET_LOCAL_STREAM
-static inline void local_sc_name(FAR struct local_conn_s *conn,
-                                 FAR char *path)
-{
-  if (conn->lc_instance_id < 0)
-    {
-      snprintf(path, LOCAL_FULLPATH_LEN - 1, "%s" LOCAL_SC_SUFFIX,
-               conn->lc_path);
-    }
-  else
-    {
-      snprintf(path, LOCAL_FULLPATH_LEN - 1, "%s" LOCAL_SC_SUFFIX "%x",
-               conn->lc_path, conn->lc_instance_id);
-    }
-
-  path[LOCAL_FULLPATH_LEN - 1] = '\0';
-}
-#endif /* CONFIG_NET_LOCAL_STREAM */
-
 /****************************************************************************
  * Name: local_hd_name
  *
@@ -139,6 +85,7 @@ static inline void local_hd_name(FAR const char *inpath, FAR char *outpath)
 }
 #endif /* CONFIG_NET_LOCAL_DGRAM */
 
+#ifdef CONFIG_NET_LOCAL_DGRAM
 /****************************************************************************
  * Name: local_fifo_exists
  *
@@ -202,46 +149,6 @@ static int local_create_fifo(FAR const char *path)
   return OK;
 }
 
-/****************************************************************************
- * Name: local_release_fifo
- *
- * Description:
- *   Release a reference from one of the FIFOs used in a connection.
- *
- ****************************************************************************/
-
-#ifdef CONFIG_NET_LOCAL_STREAM /* Currently not used by datagram code */
-static int local_release_fifo(FAR const char *path)
-{
-  int ret;
-
-  /* Unlink the client-to-server FIFO if it exists. */
-
-  if (local_fifo_exists(path))
-    {
-      /* Un-linking the FIFO removes the FIFO from the namespace.  It will
-       * also mark the FIFO device "unlinked".  When all of the open
-       * references to the FIFO device are closed, the resources consumed
-       * by the device instance will also be freed.
-       */
-
-      ret = unlink(path);
-      if (ret < 0)
-        {
-          int errcode = get_errno();
-          DEBUGASSERT(errcode > 0);
-
-          nerr("ERROR: Failed to unlink FIFO %s: %d\n", path, errcode);
-          return -errcode;
-        }
-    }
-
-  /* The FIFO does not exist or we successfully unlinked it. */
-
-  return OK;
-}
-#endif
-
 /****************************************************************************
  * Name: local_rx_open
  *
@@ -335,38 +242,59 @@ static int local_set_policy(FAR struct file *filep, unsigned long policy)
 
   return ret;
 }
+#endif /* CONFIG_NET_LOCAL_DGRAM */
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: local_create_fifos
+ * Name: local_create_pipes
  *
  * Description:
- *   Create the FIFO pair needed for a SOCK_STREAM connection.
+ *   Create the pair of anonymous pipes needed for a SOCK_STREAM connection.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_LOCAL_STREAM
-int local_create_fifos(FAR struct local_conn_s *conn)
+int local_create_pipes(FAR struct local_conn_s *client, bool nonblock)
 {
-  char path[LOCAL_FULLPATH_LEN];
+  FAR struct file *cs[2];
+  FAR struct file *sc[2];
   int ret;
 
-  /* Create the client-to-server FIFO if it does not already exist. */
+  /* Create the client-to-server pipe */
 
-  local_cs_name(conn, path);
-  ret = local_create_fifo(path);
-  if (ret >= 0)
+  cs[0] = &client->u.client.lc_srvin;
+  cs[1] = &client->lc_outfile;
+
+  ret = file_pipe(cs, CONFIG_DEV_FIFO_SIZE);
+  if (ret < 0)
     {
-      /* Create the server-to-client FIFO if it does not already exist. */
+      nerr("ERROR: Failed to create client-to-server pipe: %d\n", ret);
+      return ret;
+    }
+
+  /* Create the server-to-client pipe */
+
+  sc[0] = &client->lc_infile;
+  sc[1] = &client->u.client.lc_srvout;
 
-      local_sc_name(conn, path);
-      ret = local_create_fifo(path);
+  ret = file_pipe(sc, CONFIG_DEV_FIFO_SIZE);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to create server-to-client pipe: %d\n", ret);
+      local_release_pipes(client);
+      return ret;
     }
 
-  return ret;
+  if (nonblock)
+    {
+      client->lc_infile.f_oflags  |= O_NONBLOCK;
+      client->lc_outfile.f_oflags |= O_NONBLOCK;
+    }
+
+  return OK;
 }
 #endif /* CONFIG_NET_LOCAL_STREAM */
 
@@ -391,33 +319,41 @@ int local_create_halfduplex(FAR struct local_conn_s *conn, FAR const char *path)
 #endif /* CONFIG_NET_LOCAL_DGRAM */
 
 /****************************************************************************
- * Name: local_release_fifos
+ * Name: local_release_pipes
  *
  * Description:
- *   Release references to the FIFO pair used for a SOCK_STREAM connection.
+ *   Close all pipe ends held by a SOCK_STREAM connection.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_LOCAL_STREAM
-int local_release_fifos(FAR struct local_conn_s *conn)
+void local_release_pipes(FAR struct local_conn_s *conn)
 {
-  char path[LOCAL_FULLPATH_LEN];
-  int ret1;
-  int ret2;
-
-  /* Destroy the client-to-server FIFO if it exists. */
+  FAR struct file *filep[4];
+  int i;
 
-  local_sc_name(conn, path);
-  ret1 = local_release_fifo(path);
+  filep[0] = &conn->lc_infile;
+  filep[1] = &conn->lc_outfile;
+  filep[2] = NULL;
+  filep[3] = NULL;
 
-  /* Destroy the server-to-client FIFO if it exists. */
+  /* The server ends are only held by a client that is not yet connected */
 
-  local_cs_name(conn, path);
-  ret2 = local_release_fifo(path);
-
-  /* Return a failure if one occurred. */
+  if (conn->lc_state == LOCAL_STATE_BOUND ||
+      conn->lc_state == LOCAL_STATE_ACCEPT)
+    {
+      filep[2] = &conn->u.client.lc_srvin;
+      filep[3] = &conn->u.client.lc_srvout;
+    }
 
-  return ret1 < 0 ? ret1 : ret2;
+  for (i = 0; i < 4; i++)
+    {
+      if (filep[i] != NULL && filep[i]->f_inode != NULL)
+        {
+          file_close(filep[i]);
+          filep[i]->f_inode = NULL;
+        }
+    }
 }
 #endif /* CONFIG_NET_LOCAL_STREAM */
 
@@ -460,134 +396,6 @@ int local_release_halfduplex(FAR struct local_conn_s *conn)
 }
 #endif /* CONFIG_NET_LOCAL_DGRAM */
 
-/****************************************************************************
- * Name: local_open_client_rx
- *
- * Description:
- *   Open the client-side of the server-to-client FIFO.
- *
- ****************************************************************************/
-
-#ifdef CONFIG_NET_LOCAL_STREAM
-int local_open_client_rx(FAR struct local_conn_s *client, bool nonblock)
-{
-  char path[LOCAL_FULLPATH_LEN];
-  int ret;
-
-  /* Get the server-to-client path name */
-
-  local_sc_name(client, path);
-
-  /* Then open the file for read-only access */
-
-  ret = local_rx_open(client, path, nonblock);
-  if (ret == OK)
-    {
-      /* Policy: Free FIFO resources when the last reference is closed */
-
-      ret = local_set_policy(&client->lc_infile, 0);
-    }
-
-  return ret;
-}
-#endif /* CONFIG_NET_LOCAL_STREAM */
-
-/****************************************************************************
- * Name: local_open_client_tx
- *
- * Description:
- *   Open the client-side of the client-to-server FIFO.
- *
- ****************************************************************************/
-
-#ifdef CONFIG_NET_LOCAL_STREAM
-int local_open_client_tx(FAR struct local_conn_s *client, bool nonblock)
-{
-  char path[LOCAL_FULLPATH_LEN];
-  int ret;
-
-  /* Get the client-to-server path name */
-
-  local_cs_name(client, path);
-
-  /* Then open the file for write-only access */
-
-  ret = local_tx_open(client, path, nonblock);
-  if (ret == OK)
-    {
-      /* Policy: Free FIFO resources when the last reference is closed */
-
-      ret = local_set_policy(&client->lc_outfile, 0);
-    }
-
-  return ret;
-}
-#endif /* CONFIG_NET_LOCAL_STREAM */
-
-/****************************************************************************
- * Name: local_open_server_rx
- *
- * Description:
- *   Open the server-side of the client-to-server FIFO.
- *
- ****************************************************************************/
-
-#ifdef CONFIG_NET_LOCAL_STREAM
-int local_open_server_rx(FAR struct local_conn_s *server, bool nonblock)
-{
-  char path[LOCAL_FULLPATH_LEN];
-  int ret;
-
-  /* Get the client-to-server path name */
-
-  local_cs_name(server, path);
-
-  /* Then open the file for write-only access */
-
-  ret = local_rx_open(server, path, nonblock);
-  if (ret == OK)
-    {
-      /* Policy: Free FIFO resources when the last reference is closed */
-
-      ret = local_set_policy(&server->lc_infile, 0);
-    }
-
-  return ret;
-}
-#endif /* CONFIG_NET_LOCAL_STREAM */
-
-/****************************************************************************
- * Name: local_open_server_tx
- *
- * Description:
- *   Only the server-side of the server-to-client FIFO.
- *
- ****************************************************************************/
-
-#ifdef CONFIG_NET_LOCAL_STREAM
-int local_open_server_tx(FAR struct local_conn_s *server, bool nonblock)
-{
-  char path[LOCAL_FULLPATH_LEN];
-  int ret;
-
-  /* Get the server-to-client path name */
-
-  local_sc_name(server, path);
-
-  /* Then open the file for read-only access */
-
-  ret = local_tx_open(server, path, nonblock);
-  if (ret == OK)
-    {
-      /* Policy: Free FIFO resources when the last reference is closed */
-
-      ret = local_set_policy(&server->lc_outfile, 0);
-    }
-
-  return ret;
-}
-#endif /* CONFIG_NET_LOCAL_STREAM */
-
 /****************************************************************************
  * Name: local_open_receiver
  *
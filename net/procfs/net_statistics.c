@@ -46,6 +46,7 @@
 
 #include <nuttx/net/netstats.h>
 
+#include "utils/utils.h"
 #include "procfs/procfs.h"
 
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
@@ -80,6 +81,9 @@ static int     netprocfs_sent(FAR struct netprocfs_file_s *netfile);
 #ifdef CONFIG_NET_TCP
 static int     netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NET_TCP */
+#ifdef CONFIG_SEM_ADAPTIVE
+static int     netprocfs_lockstats(FAR struct netprocfs_file_s *netfile);
+#endif /* CONFIG_SEM_ADAPTIVE */
 
 /****************************************************************************
  * Private Data
@@ -114,6 +118,10 @@ static const linegen_t g_stat_linegen[] =
 #ifdef CONFIG_NET_TCP
   , netprocfs_retransmissions
 #endif /* CONFIG_NET_TCP */
+
+#ifdef CONFIG_SEM_ADAPTIVE
+  , netprocfs_lockstats
+#endif /* CONFIG_SEM_ADAPTIVE */
 };
 
 #define NSTAT_LINES (sizeof(g_stat_linegen) / sizeof(linegen_t))
@@ -436,6 +444,24 @@ static int netprocfs_retransmissions(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_TCP */
 
+/****************************************************************************
+ * Name: netprocfs_lockstats
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_ADAPTIVE
+static int netprocfs_lockstats(FAR struct netprocfs_file_s *netfile)
+{
+  struct sem_spinstats_s stats;
+
+  net_lockstats(&stats);
+  return snprintf(netfile->line, NET_LINELEN,
+                  "\nLock spins %lu acquired %lu gave up %lu\n",
+                  (unsigned long)stats.ss_nspin,
+                  (unsigned long)stats.ss_nacquire,
+                  (unsigned long)stats.ss_ngiveup);
+}
+#endif /* CONFIG_SEM_ADAPTIVE */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -0,0 +1,140 @@
+/****************************************************************************
+ * net/socket/socketpair.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include "socket/socket.h"
+#include "local/local.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: socketpair
+ *
+ * Description:
+ *   Create an unnamed pair of connected sockets in the specified domain, of
+ *   the specified type, and using the optionally specified protocol.  The
+ *   file descriptors used in referencing the new sockets are returned in
+ *   sv[0] and sv[1].
+ *
+ *   Only AF_LOCAL (AF_UNIX) SOCK_STREAM sockets are supported.
+ *
+ * Input Parameters:
+ *   domain   (see sys/socket.h)
+ *   type     (see sys/socket.h)
+ *   protocol (see sys/socket.h)
+ *   sv       Receives the two socket descriptors
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -1 (ERROR) on failure with errno set:
+ *
+ *   EAFNOSUPPORT
+ *     The specified address family is not supported on this machine.
+ *   EOPNOTSUPP
+ *     The specified protocol does not support creation of socket pairs.
+ *   ENFILE
+ *     Not enough free socket descriptors.
+ *   ENOMEM
+ *     Insufficient memory is available.
+ *
+ ****************************************************************************/
+
+int socketpair(int domain, int type, int protocol, int sv[2])
+{
+#ifdef CONFIG_NET_LOCAL_STREAM
+  FAR struct socket *psock0;
+  FAR struct socket *psock1;
+  int errcode;
+  int ret;
+
+  if (domain != PF_LOCAL)
+    {
+      errcode = EAFNOSUPPORT;
+      goto errout;
+    }
+
+  if (type != SOCK_STREAM)
+    {
+      errcode = EOPNOTSUPP;
+      goto errout;
+    }
+
+  /* Create the two sockets */
+
+  sv[0] = socket(domain, type, protocol);
+  if (sv[0] < 0)
+    {
+      return ERROR;
+    }
+
+  sv[1] = socket(domain, type, protocol);
+  if (sv[1] < 0)
+    {
+      errcode = get_errno();
+      goto errout_with_sv0;
+    }
+
+  psock0 = sockfd_socket(sv[0]);
+  psock1 = sockfd_socket(sv[1]);
+  DEBUGASSERT(psock0 != NULL && psock1 != NULL);
+
+  /* And connect them to each other */
+
+  ret = local_connect_pair((FAR struct local_conn_s *)psock0->s_conn,
+                           (FAR struct local_conn_s *)psock1->s_conn);
+  if (ret < 0)
+    {
+      nerr("ERROR: local_connect_pair() failed: %d\n", ret);
+      errcode = -ret;
+      goto errout_with_sv1;
+    }
+
+  return OK;
+
+errout_with_sv1:
+  net_close(sv[1]);
+
+errout_with_sv0:
+  net_close(sv[0]);
+
+errout:
+  set_errno(errcode);
+  return ERROR;
+
+#else
+  set_errno(domain == PF_LOCAL ? EOPNOTSUPP : EAFNOSUPPORT);
+  return ERROR;
+#endif
+}
+
+#endif /* CONFIG_NET */
@@ -68,6 +68,10 @@ static sem_t        g_netlock;
 static pid_t        g_holder = NO_HOLDER;
 static unsigned int g_count  = 0;
 
+#ifdef CONFIG_SEM_ADAPTIVE
+static struct sem_spinstats_s g_spinstats;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -195,14 +199,39 @@ void net_lockinitialize(void)
 int net_lock(void)
 {
 #ifdef CONFIG_SMP
-  irqstate_t flags = enter_critical_section();
+  irqstate_t flags;
 #endif
   pid_t me = getpid();
+  bool taken = false;
   int ret = OK;
 
+#ifdef CONFIG_SEM_ADAPTIVE
+  /* If another thread holds the lock and is running on another CPU, spin
+   * until it releases the lock, before entering the critical section,
+   * which it needs to do so.
+   */
+
+  if (g_holder != me)
+    {
+      taken = nxsem_spin(&g_netlock, &g_holder, &g_spinstats);
+    }
+#endif
+
+#ifdef CONFIG_SMP
+  flags = enter_critical_section();
+#endif
+
+  /* Was the semaphore taken while spinning? */
+
+  if (taken)
+    {
+      g_holder = me;
+      g_count  = 1;
+    }
+
   /* Does this thread already hold the semaphore? */
 
-  if (g_holder == me)
+  else if (g_holder == me)
     {
       /* Yes.. just increment the reference count */
 
@@ -339,6 +368,21 @@ int net_restorelock(unsigned int count)
   return ret;
 }
 
+/****************************************************************************
+ * Name: net_lockstats
+ *
+ * Description:
+ *   Return the statistics of the spinning on the network lock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_ADAPTIVE
+void net_lockstats(FAR struct sem_spinstats_s *stats)
+{
+  *stats = g_spinstats;
+}
+#endif
+
 /****************************************************************************
  * Name: net_timedwait
  *
@@ -41,6 +41,7 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 
@@ -111,6 +112,18 @@ int net_breaklock(FAR unsigned int *count);
 
 int net_restorelock(unsigned int count);
 
+/****************************************************************************
+ * Name: net_lockstats
+ *
+ * Description:
+ *   Return the statistics of the spinning on the network lock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_ADAPTIVE
+void net_lockstats(FAR struct sem_spinstats_s *stats);
+#endif
+
 /****************************************************************************
  * Name: net_dsec2timeval
  *
@@ -138,6 +138,17 @@ volatile dq_queue_t g_readytorun;
  * CPU.  Tasks after the active task are ready-to-run and assigned to this
  * CPU. The tail of this assigned task list, the lowest priority task, is
  * always the CPU's IDLE task.
+ *
+ * The unassigned tasks are deliberately kept in the one shared g_readytorun
+ * list rather than in per-CPU run queues.  Every change to these lists is
+ * made within enter_critical_section(), which takes the global
+ * g_cpu_irqlock on SMP, and the g_tasklist_lock is only taken inside of it.
+ * Per-CPU queues with local locks would still be serialized by that global
+ * lock, so they only pay off once the scheduler no longer relies on the
+ * critical section.  The hold times that decide this can be measured:
+ * CONFIG_SCHED_CRITMONITOR reports the critical section time of each
+ * thread, and CONFIG_SCHED_CRITMONITOR_SPINLOCKS adds the hold time of
+ * g_tasklist_lock to /proc/spinlocks.
  */
 
 volatile dq_queue_t g_assignedtasks[CONFIG_SMP_NCPUS];
@@ -523,6 +534,7 @@ void nx_start(void)
       tasklist = TLIST_HEAD(TSTATE_TASK_RUNNING);
 #endif
       dq_addfirst((FAR dq_entry_t *)&g_idletcb[cpu], tasklist);
+      sched_prioindex_add(&g_idletcb[cpu].cmn, tasklist);
 
       /* Mark the idle task as the running task */
 
@@ -626,6 +638,12 @@ void nx_start(void)
       wd_initialize();
     }
 
+#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_CRITMONITOR_SPINLOCKS)
+  /* Collect the hold time statistics of the task list lock */
+
+  sched_tasklist_monitor();
+#endif
+
   /* Initialize the POSIX timer facility (if included in the link) */
 
 #ifdef CONFIG_HAVE_WEAKFUNCTIONS
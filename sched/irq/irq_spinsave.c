@@ -0,0 +1,211 @@
+/****************************************************************************
+ * sched/irq/irq_spinsave.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+
+#if defined(CONFIG_SMP) || defined(CONFIG_SCHED_CRITMONITOR_SPINLOCKS)
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_SPINLOCKS
+/* Hold time statistics of the monitored spinlocks */
+
+struct spin_monitor_s g_spin_monitor[CONFIG_SCHED_CRITMONITOR_NSPINLOCKS];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spin_monitor_find
+ *
+ * Description:
+ *   Return the statistics of a spinlock or NULL if it is not monitored.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_SPINLOCKS
+static FAR struct spin_monitor_s *
+spin_monitor_find(FAR volatile spinlock_t *lock)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_SCHED_CRITMONITOR_NSPINLOCKS; i++)
+    {
+      if (g_spin_monitor[i].lock == lock)
+        {
+          return &g_spin_monitor[i];
+        }
+    }
+
+  return NULL;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spin_lock_save
+ *
+ * Description:
+ *   Disable local interrupts and take a subsystem spinlock.  See
+ *   include/nuttx/spinlock.h.
+ *
+ * Input Parameters:
+ *   lock - The spinlock that protects the data of the subsystem
+ *
+ * Returned Value:
+ *   The state of the interrupts prior to the call.
+ *
+ ****************************************************************************/
+
+irqstate_t spin_lock_save(FAR volatile spinlock_t *lock)
+{
+#ifdef CONFIG_SCHED_CRITMONITOR_SPINLOCKS
+  FAR struct spin_monitor_s *monitor;
+#endif
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  spin_lock(lock);
+
+#ifdef CONFIG_SCHED_CRITMONITOR_SPINLOCKS
+  /* The statistics of the lock are protected by the lock itself */
+
+  monitor = spin_monitor_find(lock);
+  if (monitor != NULL)
+    {
+      monitor->start = up_critmon_gettime();
+      monitor->count++;
+    }
+#endif
+
+  return flags;
+}
+
+/****************************************************************************
+ * Name: spin_unlock_restore
+ *
+ * Description:
+ *   Release a subsystem spinlock and restore the local interrupt state.
+ *
+ * Input Parameters:
+ *   lock  - The spinlock taken by spin_lock_save()
+ *   flags - The value returned by spin_lock_save()
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void spin_unlock_restore(FAR volatile spinlock_t *lock, irqstate_t flags)
+{
+#ifdef CONFIG_SCHED_CRITMONITOR_SPINLOCKS
+  FAR struct spin_monitor_s *monitor;
+#endif
+
+  DEBUGASSERT(spin_islocked(lock));
+
+#ifdef CONFIG_SCHED_CRITMONITOR_SPINLOCKS
+  /* Zero means that the timer was not ready when the lock was taken */
+
+  monitor = spin_monitor_find(lock);
+  if (monitor != NULL && monitor->start != 0)
+    {
+      uint32_t elapsed = up_critmon_gettime() - monitor->start;
+      if (elapsed > monitor->max)
+        {
+          monitor->max = elapsed;
+        }
+    }
+#endif
+
+  spin_unlock(lock);
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: spin_monitor
+ *
+ * Description:
+ *   Start to collect the hold time statistics of a spinlock.  They are
+ *   reported in /proc/spinlocks.
+ *
+ * Input Parameters:
+ *   lock - The spinlock to monitor
+ *   name - The name of the lock in the report
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOMEM if all monitor slots are in use.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CRITMONITOR_SPINLOCKS
+int spin_monitor(FAR volatile spinlock_t *lock, FAR const char *name)
+{
+  irqstate_t flags;
+  int ret = -ENOMEM;
+  int i;
+
+  flags = enter_critical_section();
+  if (spin_monitor_find(lock) != NULL)
+    {
+      ret = OK;
+    }
+  else
+    {
+      for (i = 0; i < CONFIG_SCHED_CRITMONITOR_NSPINLOCKS; i++)
+        {
+          if (g_spin_monitor[i].lock == NULL)
+            {
+              g_spin_monitor[i].name  = name;
+              g_spin_monitor[i].start = 0;
+              g_spin_monitor[i].max   = 0;
+              g_spin_monitor[i].count = 0;
+              g_spin_monitor[i].lock  = lock;
+              ret = OK;
+              break;
+            }
+        }
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+#endif
+
+#endif /* CONFIG_SMP || CONFIG_SCHED_CRITMONITOR_SPINLOCKS */
@@ -0,0 +1,195 @@
+/****************************************************************************
+ * sched/mqueue/mq_msglist.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <strings.h>
+#include <queue.h>
+#include <assert.h>
+
+#include <nuttx/mqueue.h>
+
+#include "mqueue/mqueue.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_find_prev
+ *
+ * Description:
+ *   Return the message after which a new message of priority 'prio' must
+ *   be inserted, or NULL if it must be inserted at the head of the list.
+ *
+ *   The list is kept in descending priority order and is FIFO within a
+ *   priority, so this is the last message of the same priority or, if
+ *   there is none, the last message of the nearest higher priority.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MQ_PRIO_BUCKETS
+static FAR struct mqueue_msg_s *
+nxmq_find_prev(FAR struct mqueue_inode_s *msgq, unsigned int prio)
+{
+  unsigned int ndx;
+  uint32_t set;
+
+  if (msgq->priotail[prio] != NULL)
+    {
+      return msgq->priotail[prio];
+    }
+
+  /* Find the lowest non-empty priority above 'prio' */
+
+  if (prio >= MQ_PRIO_MAX)
+    {
+      return NULL;
+    }
+
+  ndx = (prio + 1) >> 5;
+  set = msgq->prioset[ndx] & (UINT32_MAX << ((prio + 1) & 31));
+
+  while (set == 0)
+    {
+      if (++ndx >= MQ_PRIOSET_NWORDS)
+        {
+          return NULL;
+        }
+
+      set = msgq->prioset[ndx];
+    }
+
+  return msgq->priotail[(ndx << 5) + ffs((int)set) - 1];
+}
+#else
+static FAR struct mqueue_msg_s *
+nxmq_find_prev(FAR struct mqueue_inode_s *msgq, unsigned int prio)
+{
+  FAR struct mqueue_msg_s *next;
+  FAR struct mqueue_msg_s *prev;
+
+  /* Search the message list to find the location to insert the new
+   * message. Each is list is maintained in ascending priority order.
+   */
+
+  for (prev = NULL, next = (FAR struct mqueue_msg_s *)msgq->msglist.head;
+       next && prio <= next->priority;
+       prev = next, next = next->next);
+
+  return prev;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_insert_msg
+ *
+ * Description:
+ *   Add a message to the prioritized message list of a message queue.  With
+ *   CONFIG_MQ_PRIO_BUCKETS, this takes constant time regardless of the
+ *   number of messages in the queue.
+ *
+ * Input Parameters:
+ *   msgq  - The message queue
+ *   mqmsg - The message to add.  The priority must already be set.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+void nxmq_insert_msg(FAR struct mqueue_inode_s *msgq,
+                     FAR struct mqueue_msg_s *mqmsg)
+{
+  FAR struct mqueue_msg_s *prev;
+  unsigned int prio = mqmsg->priority;
+
+  DEBUGASSERT(prio <= MQ_PRIO_MAX);
+
+  /* Add the message at the right place */
+
+  prev = nxmq_find_prev(msgq, prio);
+  if (prev)
+    {
+      sq_addafter((FAR sq_entry_t *)prev, (FAR sq_entry_t *)mqmsg,
+                  &msgq->msglist);
+    }
+  else
+    {
+      sq_addfirst((FAR sq_entry_t *)mqmsg, &msgq->msglist);
+    }
+
+#ifdef CONFIG_MQ_PRIO_BUCKETS
+  /* The new message is now the last one of its priority */
+
+  msgq->priotail[prio]       = mqmsg;
+  msgq->prioset[prio >> 5] |= (uint32_t)1 << (prio & 31);
+#endif
+}
+
+/****************************************************************************
+ * Name: nxmq_remove_msg
+ *
+ * Description:
+ *   Remove the highest priority message from a message queue.
+ *
+ * Input Parameters:
+ *   msgq - The message queue
+ *
+ * Returned Value:
+ *   The removed message or NULL if the queue is empty.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+FAR struct mqueue_msg_s *nxmq_remove_msg(FAR struct mqueue_inode_s *msgq)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+
+  mqmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&msgq->msglist);
+
+#ifdef CONFIG_MQ_PRIO_BUCKETS
+  if (mqmsg != NULL && msgq->priotail[mqmsg->priority] == mqmsg)
+    {
+      unsigned int prio = mqmsg->priority;
+
+      /* That was the last message of this priority */
+
+      msgq->priotail[prio]       = NULL;
+      msgq->prioset[prio >> 5] &= ~((uint32_t)1 << (prio & 31));
+    }
+#endif
+
+  return mqmsg;
+}
@@ -82,6 +82,8 @@ FAR struct mqueue_inode_s *nxmq_alloc_msgq(mode_t mode,
       /* Initialize the new named message queue */
 
       sq_init(&msgq->msglist);
+      dq_init(&msgq->waitnotempty);
+      dq_init(&msgq->waitnotfull);
       if (attr)
         {
           msgq->maxmsgs    = (int16_t)attr->mq_maxmsg;
@@ -148,8 +148,7 @@ int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg)
 
   /* Get the message from the head of the queue */
 
-  while ((newmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&msgq->msglist))
-          == NULL)
+  while ((newmsg = nxmq_remove_msg(msgq)) == NULL)
     {
       /* The queue is empty!  Should we block until there the above condition
        * has been satisfied?
@@ -164,6 +163,7 @@ int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg)
           rtcb           = this_task();
           rtcb->msgwaitq = msgq;
           msgq->nwaitnotempty++;
+          nxmq_add_waiter(&msgq->waitnotempty, rtcb);
 
           /* "Borrow" the per-task errno to communication wake-up error
            * conditions.
@@ -188,6 +188,19 @@ int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg)
           ret            = rtcb->pterrno;
           rtcb->pterrno  = saved_errno;
 
+          /* nxmq_wait_irq() has already ended the wait, but a task that was
+           * stopped while waiting is restarted with EINTR and is still a
+           * waiter (see sched_suspend()).
+           */
+
+          if (rtcb->msgwaitq != NULL)
+            {
+              DEBUGASSERT(msgq->nwaitnotempty > 0);
+              msgq->nwaitnotempty--;
+              nxmq_remove_waiter(&msgq->waitnotempty, rtcb);
+              rtcb->msgwaitq = NULL;
+            }
+
           if (ret != OK)
             {
               return -ret;
@@ -277,18 +290,13 @@ ssize_t nxmq_do_receive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
   msgq = mqdes->msgq;
   if (msgq->nwaitnotfull > 0)
     {
-      /* Find the highest priority task that is waiting for
-       * this queue to be not-full in g_waitingformqnotfull list.
-       * This must be performed in a critical section because
+      /* Find the highest priority task that is waiting for this queue to
+       * be not-full.  This must be performed in a critical section because
        * messages can be sent from interrupt handlers.
        */
 
       flags = enter_critical_section();
-      for (btcb = (FAR struct tcb_s *)g_waitingformqnotfull.head;
-           btcb && btcb->msgwaitq != msgq;
-           btcb = btcb->flink)
-        {
-        }
+      btcb  = nxmq_take_waiter(&msgq->waitnotfull);
 
       /* If one was found, unblock it.  NOTE:  There is a race
        * condition here:  the queue might be full again by the
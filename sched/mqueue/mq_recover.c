@@ -69,6 +69,7 @@ void nxmq_recover(FAR struct tcb_s *tcb)
 
       DEBUGASSERT(tcb->msgwaitq && tcb->msgwaitq->nwaitnotempty > 0);
       tcb->msgwaitq->nwaitnotempty--;
+      nxmq_remove_waiter(&tcb->msgwaitq->waitnotempty, tcb);
     }
 
   /* Was the task waiting for a message queue to become non-full? */
@@ -79,5 +80,6 @@ void nxmq_recover(FAR struct tcb_s *tcb)
 
       DEBUGASSERT(tcb->msgwaitq && tcb->msgwaitq->nwaitnotfull > 0);
       tcb->msgwaitq->nwaitnotfull--;
+      nxmq_remove_waiter(&tcb->msgwaitq->waitnotfull, tcb);
     }
 }
@@ -269,6 +269,7 @@ int nxmq_wait_send(mqd_t mqdes)
               rtcb           = this_task();
               rtcb->msgwaitq = msgq;
               msgq->nwaitnotfull++;
+              nxmq_add_waiter(&msgq->waitnotfull, rtcb);
 
               /* "Borrow" the per-task errno to communication wake-up error
                * conditions.
@@ -293,6 +294,19 @@ int nxmq_wait_send(mqd_t mqdes)
               ret           = rtcb->pterrno;
               rtcb->pterrno = saved_errno;
 
+              /* nxmq_wait_irq() has already ended the wait, but a task that
+               * was stopped while waiting is restarted with EINTR and is
+               * still a waiter (see sched_suspend()).
+               */
+
+              if (rtcb->msgwaitq != NULL)
+                {
+                  DEBUGASSERT(msgq->nwaitnotfull > 0);
+                  msgq->nwaitnotfull--;
+                  nxmq_remove_waiter(&msgq->waitnotfull, rtcb);
+                  rtcb->msgwaitq = NULL;
+                }
+
               if (ret != OK)
                 {
                   return -ret;
@@ -330,8 +344,6 @@ int nxmq_do_send(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
 {
   FAR struct tcb_s *btcb;
   FAR struct mqueue_inode_s *msgq;
-  FAR struct mqueue_msg_s *next;
-  FAR struct mqueue_msg_s *prev;
   irqstate_t flags;
 
   /* Get a pointer to the message queue */
@@ -351,26 +363,7 @@ int nxmq_do_send(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
   /* Insert the new message in the message queue */
 
   flags = enter_critical_section();
-
-  /* Search the message list to find the location to insert the new
-   * message. Each is list is maintained in ascending priority order.
-   */
-
-  for (prev = NULL, next = (FAR struct mqueue_msg_s *)msgq->msglist.head;
-       next && prio <= next->priority;
-       prev = next, next = next->next);
-
-  /* Add the message at the right place */
-
-  if (prev)
-    {
-      sq_addafter((FAR sq_entry_t *)prev, (FAR sq_entry_t *)mqmsg,
-                  &msgq->msglist);
-    }
-  else
-    {
-      sq_addfirst((FAR sq_entry_t *)mqmsg, &msgq->msglist);
-    }
+  nxmq_insert_msg(msgq, mqmsg);
 
   /* Increment the count of messages in the queue */
 
@@ -408,17 +401,11 @@ int nxmq_do_send(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
   flags = enter_critical_section();
   if (msgq->nwaitnotempty > 0)
     {
-      /* Find the highest priority task that is waiting for
-       * this queue to be non-empty in g_waitingformqnotempty
-       * list. sched_lock() should give us sufficient protection since
-       * interrupts should never cause a change in this list
+      /* Find the highest priority task that is waiting for this queue to
+       * be non-empty.  Only the waiters of this queue are examined.
        */
 
-      for (btcb = (FAR struct tcb_s *)g_waitingformqnotempty.head;
-           btcb && btcb->msgwaitq != msgq;
-           btcb = btcb->flink)
-        {
-        }
+      btcb = nxmq_take_waiter(&msgq->waitnotempty);
 
       /* If one was found, unblock it */
 
@@ -90,11 +90,13 @@ void nxmq_wait_irq(FAR struct tcb_s *wtcb, int errcode)
         {
           DEBUGASSERT(msgq->nwaitnotempty > 0);
           msgq->nwaitnotempty--;
+          nxmq_remove_waiter(&msgq->waitnotempty, wtcb);
         }
       else
         {
           DEBUGASSERT(msgq->nwaitnotfull > 0);
           msgq->nwaitnotfull--;
+          nxmq_remove_waiter(&msgq->waitnotfull, wtcb);
         }
 
       /* Mark the errno value for the thread. */
@@ -31,7 +31,9 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <limits.h>
+#include <queue.h>
 #include <mqueue.h>
 #include <sched.h>
 
@@ -59,6 +61,18 @@
 
 #define NUM_INTERRUPT_MSGS   8
 
+/* The tasks waiting for a message queue to become not empty (or not full)
+ * are also kept in msgq->waitnotempty (or msgq->waitnotfull) so that the
+ * waker only has to look at the waiters of this queue.  The lists are kept
+ * in priority order, so the waker takes the first waiter.
+ */
+
+#define nxmq_add_waiter(l,t) \
+  sched_waitlist_add((l), (t), offsetof(struct tcb_s, msgwaitnode))
+#define nxmq_remove_waiter(l,t) dq_rem(&(t)->msgwaitnode, (l))
+#define nxmq_take_waiter(l) \
+  sched_waitlist_take((l), offsetof(struct tcb_s, msgwaitnode), NULL, NULL)
+
 /********************************************************************************
  * Public Type Definitions
  ********************************************************************************/
@@ -149,6 +163,12 @@ int nxmq_wait_send(mqd_t mqdes);
 int nxmq_do_send(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
                  FAR const char *msg, size_t msglen, unsigned int prio);
 
+/* mq_msglist.c *****************************************************************/
+
+void nxmq_insert_msg(FAR struct mqueue_inode_s *msgq,
+                     FAR struct mqueue_msg_s *mqmsg);
+FAR struct mqueue_msg_s *nxmq_remove_msg(FAR struct mqueue_inode_s *msgq);
+
 /* mq_release.c *****************************************************************/
 
 void nxmq_release(FAR struct task_group_s *group);
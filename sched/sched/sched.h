@@ -29,6 +29,7 @@
 
 #include <sys/types.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <queue.h>
 #include <sched.h>
 
@@ -138,6 +139,13 @@ struct tasklist_s
   uint8_t attr;                   /* List attribute flags */
 };
 
+/* Selects the tasks that sched_waitlist_take() may return from a wait list
+ * that is shared by the waiters of several objects.
+ */
+
+typedef CODE bool (*sched_waitmatch_t)(FAR struct tcb_s *tcb,
+                                       FAR void *arg);
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -375,6 +383,31 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list);
 void sched_mergeprioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
                             uint8_t task_state);
 bool sched_mergepending(void);
+
+/* Priority index of the ready-to-run lists */
+
+#ifdef CONFIG_SCHED_PRIOINDEX
+bool sched_prioindex_prev(FAR dq_queue_t *list, uint8_t priority,
+                          FAR struct tcb_s **prev);
+void sched_prioindex_add(FAR struct tcb_s *tcb, FAR dq_queue_t *list);
+void sched_prioindex_remove(FAR struct tcb_s *tcb, FAR dq_queue_t *list);
+void sched_prioindex_rebuild(FAR dq_queue_t *list);
+#else
+#  define sched_prioindex_prev(l,p,t)  (false)
+#  define sched_prioindex_add(t,l)
+#  define sched_prioindex_remove(t,l)
+#  define sched_prioindex_rebuild(l)
+#endif
+
+/* Priority-ordered lists of tasks waiting for an object */
+
+void sched_waitlist_add(FAR dq_queue_t *waitlist, FAR struct tcb_s *tcb,
+                        size_t nodeoff);
+FAR struct tcb_s *sched_waitlist_take(FAR dq_queue_t *waitlist,
+                                      size_t nodeoff,
+                                      sched_waitmatch_t match,
+                                      FAR void *arg);
+
 void sched_addblocked(FAR struct tcb_s *btcb, tstate_t task_state);
 void sched_removeblocked(FAR struct tcb_s *btcb);
 int  nxsched_setpriority(FAR struct tcb_s *tcb, int sched_priority);
@@ -429,11 +462,14 @@ void sched_continue(FAR struct tcb_s *tcb);
 FAR struct tcb_s *this_task(void);
 #endif
 
-int  sched_cpu_select(cpu_set_t affinity);
+int  sched_cpu_select(cpu_set_t affinity, int prefcpu);
 int  sched_cpu_pause(FAR struct tcb_s *tcb);
 
 irqstate_t sched_tasklist_lock(void);
 void sched_tasklist_unlock(irqstate_t lock);
+#ifdef CONFIG_SCHED_CRITMONITOR_SPINLOCKS
+void sched_tasklist_monitor(void);
+#endif
 
 #if defined(CONFIG_ARCH_HAVE_FETCHADD) && !defined(CONFIG_ARCH_GLOBAL_IRQDISABLE)
 #  define sched_islocked_global() \
@@ -446,7 +482,7 @@ void sched_tasklist_unlock(irqstate_t lock);
 #  define sched_islocked_tcb(tcb) sched_islocked_global()
 
 #else
-#  define sched_cpu_select(a)     (0)
+#  define sched_cpu_select(a,p)   (0)
 #  define sched_cpu_pause(t)      (-38)  /* -ENOSYS */
 #  define sched_islocked_tcb(tcb) ((tcb)->lockcount > 0)
 #endif
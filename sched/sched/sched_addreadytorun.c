@@ -170,6 +170,7 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
   FAR dq_queue_t *tasklist;
   bool switched;
   bool doswitch;
+  bool remote;
   int task_state;
   int cpu;
   int me;
@@ -192,7 +193,7 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
        * (possibly its IDLE task).
        */
 
-      cpu = sched_cpu_select(btcb->affinity);
+      cpu = sched_cpu_select(btcb->affinity, btcb->cpu);
     }
 
   /* Get the task currently running on the CPU (may be the IDLE task) */
@@ -270,11 +271,14 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
     }
   else /* (task_state == TSTATE_TASK_ASSIGNED || task_state == TSTATE_TASK_RUNNING) */
     {
-      /* If we are modifying some assigned task list other than our own, we
-       * will need to stop that CPU.
+      /* If the new task will preempt the task running on some other CPU,
+       * we will need to stop that CPU.  A task that is only assigned goes
+       * behind the running task and does not affect the other CPU; the
+       * assigned task list is protected by the tasklist lock.
        */
 
-      if (cpu != me)
+      remote = (cpu != me && task_state == TSTATE_TASK_RUNNING);
+      if (remote)
         {
           sched_tasklist_unlock(lock);
           DEBUGVERIFY(up_cpu_pause(cpu));
@@ -383,6 +387,7 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
             {
               /* Remove the task from the assigned task list */
 
+              sched_prioindex_remove(next, tasklist);
               dq_rem((FAR dq_entry_t *)next, tasklist);
 
               /* Add the task to the g_readytorun or to the g_pendingtasks
@@ -422,11 +427,12 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
 
           btcb->cpu        = cpu;
           btcb->task_state = TSTATE_TASK_ASSIGNED;
+          doswitch         = false;
         }
 
       /* All done, restart the other CPU (if it was paused). */
 
-      if (cpu != me)
+      if (remote)
         {
           DEBUGVERIFY(up_cpu_resume(cpu));
           doswitch = false;
@@ -54,6 +54,27 @@
 
 #define IMPOSSIBLE_CPU 0xff
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name:  sched_cpu_rank
+ *
+ * Description:
+ *   Rank a CPU among the CPUs that run tasks of the same priority.  The
+ *   CPU that the task last ran on is preferred because its caches may
+ *   still hold the working set of the task.  Next is the calling CPU
+ *   because no inter-processor interrupt is needed to start the task
+ *   there.
+ *
+ ****************************************************************************/
+
+static inline int sched_cpu_rank(int cpu, int prefcpu, int me)
+{
+  return cpu == prefcpu ? 0 : cpu == me ? 1 : 2;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -63,10 +84,13 @@
  *
  * Description:
  *   Return the index to the CPU with the lowest priority running task,
- *   possibly its IDLE task.
+ *   possibly its IDLE task.  If several CPUs qualify, the preferred CPU is
+ *   selected, then the calling CPU.
  *
  * Input Parameters:
  *   affinity - The set of CPUs on which the thread is permitted to run.
+ *   prefcpu  - The preferred CPU, normally the CPU that the thread last
+ *              ran on.
  *
  * Returned Value:
  *   Index of the CPU with the lowest priority running task
@@ -76,18 +100,20 @@
  *
  ****************************************************************************/
 
-int sched_cpu_select(cpu_set_t affinity)
+int sched_cpu_select(cpu_set_t affinity, int prefcpu)
 {
   uint8_t minprio;
+  int me;
   int cpu;
   int i;
 
-  /* Otherwise, find the CPU that is executing the lowest priority task
-   * (possibly its IDLE task).
+  /* Find the CPU that is executing the lowest priority task (possibly its
+   * IDLE task).
    */
 
   minprio = SCHED_PRIORITY_MAX;
   cpu     = IMPOSSIBLE_CPU;
+  me      = this_cpu();
 
   for (i = 0; i < CONFIG_SMP_NCPUS; i++)
     {
@@ -98,24 +124,30 @@ int sched_cpu_select(cpu_set_t affinity)
           FAR struct tcb_s *rtcb = (FAR struct tcb_s *)
                                    g_assignedtasks[i].head;
 
-          /* If this thread is executing its IDLE task, the use it.  The
-           * IDLE task is always the last task in the assigned task list.
+          /* The IDLE task is always the last task in the assigned task
+           * list.  It should always be assigned to this CPU and have a
+           * priority of zero.
            */
 
-          if (rtcb->flink == NULL)
-            {
-              /* The IDLE task should always be assigned to this CPU and have
-               * a priority of zero.
-               */
+          DEBUGASSERT(rtcb->flink != NULL || rtcb->sched_priority == 0);
+          DEBUGASSERT(rtcb->flink == NULL || rtcb->sched_priority > 0);
 
-              DEBUGASSERT(rtcb->sched_priority == 0);
-              return i;
-            }
-          else if (rtcb->sched_priority < minprio)
+          if (cpu == IMPOSSIBLE_CPU || rtcb->sched_priority < minprio ||
+              (rtcb->sched_priority == minprio &&
+               sched_cpu_rank(i, prefcpu, me) <
+               sched_cpu_rank(cpu, prefcpu, me)))
             {
-              DEBUGASSERT(rtcb->sched_priority > 0);
               minprio = rtcb->sched_priority;
-              cpu = i;
+              cpu     = i;
+
+              /* Nothing is better than the preferred CPU in its IDLE
+               * loop.
+               */
+
+              if (minprio == 0 && i == prefcpu)
+                {
+                  break;
+                }
             }
         }
     }
@@ -36,12 +36,6 @@
 #include "irq/irq.h"
 #include "sched/sched.h"
 
-/****************************************************************************
- * Pre-processor Definitions
- ****************************************************************************/
-
-#define ALL_CPUS ((cpu_set_t)-1)
-
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -138,6 +132,12 @@ bool sched_mergepending(void)
           ptcb->task_state  = TSTATE_TASK_READYTORUN;
         }
 
+      /* ptcb was linked after any TCBs of the same priority, so it is the
+       * new last TCB of its priority.
+       */
+
+      sched_prioindex_add(ptcb, (FAR dq_queue_t *)&g_readytorun);
+
       /* Set up for the next time through */
 
       rtcb = ptcb;
@@ -207,7 +207,7 @@ bool sched_mergepending(void)
           goto errout_with_lock;
         }
 
-      cpu  = sched_cpu_select(ALL_CPUS); /* REVISIT:  Maybe ptcb->affinity */
+      cpu  = sched_cpu_select(ptcb->affinity, ptcb->cpu);
       rtcb = current_task(cpu);
 
       /* Loop while there is a higher priority task in the pending task list
@@ -265,7 +265,7 @@ bool sched_mergepending(void)
               goto errout_with_lock;
             }
 
-          cpu  = sched_cpu_select(ALL_CPUS); /* REVISIT:  Maybe ptcb->affinity */
+          cpu  = sched_cpu_select(ptcb->affinity, ptcb->cpu);
           rtcb = current_task(cpu);
         }
 
@@ -180,6 +180,11 @@ void sched_mergeprioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
 
 ret_with_lock:
 
+  /* Update the priority index of the lists, if they are indexed */
+
+  sched_prioindex_rebuild(list1);
+  sched_prioindex_rebuild(list2);
+
 #ifdef CONFIG_SMP
   /* Unlock the tasklists */
 
@@ -0,0 +1,250 @@
+/****************************************************************************
+ * sched/sched/sched_prioindex.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+#include <queue.h>
+#include <assert.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_PRIOINDEX
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PRIOINDEX_NWORDS ((SCHED_PRIORITY_MAX + 32) >> 5)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The ready-to-run lists are kept in descending priority order with the
+ * TCBs of the same priority in FIFO order.  Each list is thus a sequence
+ * of per-priority FIFOs.  This index holds the last TCB of each of these
+ * FIFOs and a bitmap of the priorities that are present in the list.  A
+ * new TCB is inserted after the last TCB of the lowest priority that is
+ * greater than or equal to its own priority; that priority is found with
+ * a bitmap search.
+ */
+
+struct sched_prioindex_s
+{
+  uint32_t bitmap[PRIOINDEX_NWORDS];           /* Priorities in the list */
+  FAR struct tcb_s *tail[SCHED_PRIORITY_MAX + 1]; /* Last TCB of each */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct sched_prioindex_s g_readytorun_index;
+
+#ifdef CONFIG_SMP
+static struct sched_prioindex_s g_assignedtasks_index[CONFIG_SMP_NCPUS];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_prioindex
+ *
+ * Description:
+ *   Return the index of a task list or NULL if the list is not indexed.
+ *
+ ****************************************************************************/
+
+static FAR struct sched_prioindex_s *
+sched_prioindex(FAR volatile dq_queue_t *list)
+{
+  if (list == &g_readytorun)
+    {
+      return &g_readytorun_index;
+    }
+
+#ifdef CONFIG_SMP
+  if (list >= g_assignedtasks && list < &g_assignedtasks[CONFIG_SMP_NCPUS])
+    {
+      return &g_assignedtasks_index[list - g_assignedtasks];
+    }
+#endif
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_prioindex_prev
+ *
+ * Description:
+ *   Find the position for a new TCB in an indexed, prioritized list.
+ *
+ * Input Parameters:
+ *   list     - The prioritized task list
+ *   priority - The priority of the new TCB
+ *   prev     - Location to return the TCB that the new TCB goes after.
+ *              NULL is returned if the new TCB goes at the head of the
+ *              list.
+ *
+ * Returned Value:
+ *   true if the list is indexed and 'prev' is valid.  false if the list
+ *   is not indexed and must be searched.
+ *
+ ****************************************************************************/
+
+bool sched_prioindex_prev(FAR dq_queue_t *list, uint8_t priority,
+                          FAR struct tcb_s **prev)
+{
+  FAR struct sched_prioindex_s *index = sched_prioindex(list);
+  uint32_t bits;
+  int word;
+
+  if (index == NULL)
+    {
+      return false;
+    }
+
+  /* Find the lowest priority in the list that is not lower than the
+   * priority of the new TCB.
+   */
+
+  word = priority >> 5;
+  bits = index->bitmap[word] & (UINT32_MAX << (priority & 31));
+
+  while (bits == 0)
+    {
+      if (++word >= PRIOINDEX_NWORDS)
+        {
+          /* There is no such priority.  The new TCB goes at the head */
+
+          *prev = NULL;
+          return true;
+        }
+
+      bits = index->bitmap[word];
+    }
+
+  *prev = index->tail[(word << 5) + ffs((int)bits) - 1];
+  DEBUGASSERT(*prev != NULL);
+  return true;
+}
+
+/****************************************************************************
+ * Name: sched_prioindex_add
+ *
+ * Description:
+ *   Update the index after a TCB was linked into a prioritized list.  The
+ *   TCB may have been linked anywhere that keeps the list in priority
+ *   order.  This does nothing if the list is not indexed.
+ *
+ ****************************************************************************/
+
+void sched_prioindex_add(FAR struct tcb_s *tcb, FAR dq_queue_t *list)
+{
+  FAR struct sched_prioindex_s *index = sched_prioindex(list);
+  FAR struct tcb_s *next = (FAR struct tcb_s *)tcb->flink;
+  uint8_t priority = tcb->sched_priority;
+
+  if (index != NULL)
+    {
+      if (next == NULL || next->sched_priority != priority)
+        {
+          /* The TCB is the last of its priority */
+
+          index->tail[priority] = tcb;
+        }
+
+      index->bitmap[priority >> 5] |= (uint32_t)1 << (priority & 31);
+    }
+}
+
+/****************************************************************************
+ * Name: sched_prioindex_remove
+ *
+ * Description:
+ *   Update the index before a TCB is unlinked from a prioritized list.
+ *   This does nothing if the list is not indexed.
+ *
+ ****************************************************************************/
+
+void sched_prioindex_remove(FAR struct tcb_s *tcb, FAR dq_queue_t *list)
+{
+  FAR struct sched_prioindex_s *index = sched_prioindex(list);
+  FAR struct tcb_s *prev = (FAR struct tcb_s *)tcb->blink;
+  uint8_t priority = tcb->sched_priority;
+
+  if (index != NULL && index->tail[priority] == tcb)
+    {
+      if (prev != NULL && prev->sched_priority == priority)
+        {
+          index->tail[priority] = prev;
+        }
+      else
+        {
+          /* This was the only TCB of its priority */
+
+          index->tail[priority] = NULL;
+          index->bitmap[priority >> 5] &= ~((uint32_t)1 << (priority & 31));
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: sched_prioindex_rebuild
+ *
+ * Description:
+ *   Rebuild the index of a list after the list was changed by bulk
+ *   operations like dq_move() or dq_cat().  This does nothing if the list
+ *   is not indexed.
+ *
+ ****************************************************************************/
+
+void sched_prioindex_rebuild(FAR dq_queue_t *list)
+{
+  FAR struct sched_prioindex_s *index = sched_prioindex(list);
+  FAR struct tcb_s *tcb;
+
+  if (index != NULL)
+    {
+      memset(index->bitmap, 0, sizeof(index->bitmap));
+
+      for (tcb  = (FAR struct tcb_s *)list->head;
+           tcb != NULL;
+           tcb  = (FAR struct tcb_s *)tcb->flink)
+        {
+          sched_prioindex_add(tcb, list);
+        }
+    }
+}
+
+#endif /* CONFIG_SCHED_PRIOINDEX */
@@ -33,6 +33,10 @@
 
 #include "irq/irq.h"
 #include "sched/sched.h"
+#include "semaphore/semaphore.h"
+#ifndef CONFIG_DISABLE_MQUEUE
+#  include "mqueue/mqueue.h"
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -121,6 +125,9 @@ static FAR struct tcb_s *nxsched_nexttcb(FAR struct tcb_s *tcb)
 static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
                                                int sched_priority)
 {
+#ifdef CONFIG_SCHED_PRIOINDEX
+  FAR dq_queue_t *tasklist;
+#endif
   FAR struct tcb_s *nxttcb;
 
   /* Get the TCB of the next highest priority, ready to run task */
@@ -149,9 +156,23 @@ static inline void nxsched_running_setpriority(FAR struct tcb_s *tcb,
 
   else
     {
-      /* Change the task priority */
+      /* Change the task priority.  The task stays at the head of its
+       * ready-to-run list.
+       */
+
+#ifdef CONFIG_SCHED_PRIOINDEX
+#ifdef CONFIG_SMP
+      tasklist = (FAR dq_queue_t *)&g_assignedtasks[tcb->cpu];
+#else
+      tasklist = (FAR dq_queue_t *)&g_readytorun;
+#endif
 
+      sched_prioindex_remove(tcb, tasklist);
       tcb->sched_priority = (uint8_t)sched_priority;
+      sched_prioindex_add(tcb, tasklist);
+#else
+      tcb->sched_priority = (uint8_t)sched_priority;
+#endif
     }
 }
 
@@ -188,7 +209,7 @@ static void nxsched_readytorun_setpriority(FAR struct tcb_s *tcb,
 
   if (tcb->task_state == TSTATE_TASK_READYTORUN)
     {
-      cpu = sched_cpu_select(tcb->affinity);
+      cpu = sched_cpu_select(tcb->affinity, tcb->cpu);
     }
 
   /* CASE 2b.  The task is ready to run, and assigned to a CPU.  An increase
@@ -274,8 +295,36 @@ static inline void nxsched_blocked_setpriority(FAR struct tcb_s *tcb,
                                                int sched_priority)
 {
   FAR dq_queue_t *tasklist;
+#ifndef CONFIG_DISABLE_MQUEUE
+  FAR dq_queue_t *waitlist = NULL;
+#endif
   tstate_t task_state = tcb->task_state;
 
+  /* A task waiting for a semaphore or a message queue is also in the
+   * priority-ordered wait list of that object.  Take it out while its
+   * priority changes.
+   */
+
+  if (task_state == TSTATE_WAIT_SEM)
+    {
+      nxsem_remove_waiter(tcb);
+    }
+#ifndef CONFIG_DISABLE_MQUEUE
+  else if (task_state == TSTATE_WAIT_MQNOTEMPTY)
+    {
+      waitlist = &tcb->msgwaitq->waitnotempty;
+    }
+  else if (task_state == TSTATE_WAIT_MQNOTFULL)
+    {
+      waitlist = &tcb->msgwaitq->waitnotfull;
+    }
+
+  if (waitlist != NULL)
+    {
+      nxmq_remove_waiter(waitlist, tcb);
+    }
+#endif
+
   /* CASE 3a. The task resides in a prioritized list. */
 
   tasklist = TLIST_BLOCKED(task_state);
@@ -302,6 +351,19 @@ static inline void nxsched_blocked_setpriority(FAR struct tcb_s *tcb,
 
       tcb->sched_priority = (uint8_t)sched_priority;
     }
+
+  /* Put it back into the wait list at the correct position */
+
+  if (task_state == TSTATE_WAIT_SEM)
+    {
+      nxsem_add_waiter(tcb);
+    }
+#ifndef CONFIG_DISABLE_MQUEUE
+  else if (waitlist != NULL)
+    {
+      nxmq_add_waiter(waitlist, tcb);
+    }
+#endif
 }
 
 /****************************************************************************
@@ -41,6 +41,7 @@
 #include <nuttx/spinlock.h>
 
 #include <sys/types.h>
+#include <assert.h>
 #include <arch/irq.h>
 
 #include "sched/sched.h"
@@ -87,7 +88,11 @@ irqstate_t sched_tasklist_lock(void)
 
   if (0 == g_tasklist_lock_count[me])
     {
-      spin_lock(&g_tasklist_lock);
+      /* Local interrupts are already disabled.  spin_lock_save() is used
+       * because it also collects the statistics of a monitored lock.
+       */
+
+      spin_lock_save(&g_tasklist_lock);
     }
 
   g_tasklist_lock_count[me]++;
@@ -126,8 +131,30 @@ void sched_tasklist_unlock(irqstate_t lock)
 
   if (0 == g_tasklist_lock_count[me])
     {
-      spin_unlock(&g_tasklist_lock);
+      /* This is the outermost call, so 'lock' is the interrupt state that
+       * was saved when the spinlock was taken.
+       */
+
+      spin_unlock_restore(&g_tasklist_lock, lock);
+    }
+  else
+    {
+      up_irq_restore(lock);
     }
+}
+
+/****************************************************************************
+ * Name: sched_tasklist_monitor()
+ *
+ * Description:
+ *   Start to collect the hold time statistics of the tasklist lock.  They
+ *   are reported in /proc/spinlocks.
+ *
+ ****************************************************************************/
 
-  up_irq_restore(lock);
+#ifdef CONFIG_SCHED_CRITMONITOR_SPINLOCKS
+void sched_tasklist_monitor(void)
+{
+  DEBUGVERIFY(spin_monitor(&g_tasklist_lock, "tasklist"));
 }
+#endif
@@ -0,0 +1,166 @@
+/****************************************************************************
+ * sched/sched/sched_waitlist.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <queue.h>
+
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_waitlist_add
+ *
+ * Description:
+ *   Add a task to a list of tasks waiting for some object, such as the
+ *   per-queue wait lists of message queues or the hashed wait lists of
+ *   semaphores.  The list is kept in priority order, and a task is added
+ *   after the tasks of the same priority, so tasks of equal priority are
+ *   served in the order that they started to wait.
+ *
+ * Input Parameters:
+ *   waitlist - The list of waiting tasks
+ *   tcb      - The task that is about to wait
+ *   nodeoff  - The offset of the list link in struct tcb_s
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+void sched_waitlist_add(FAR dq_queue_t *waitlist, FAR struct tcb_s *tcb,
+                        size_t nodeoff)
+{
+  FAR dq_entry_t *tnode = (FAR dq_entry_t *)((FAR char *)tcb + nodeoff);
+  FAR struct tcb_s *htcb;
+  FAR struct tcb_s *ntcb;
+  FAR dq_entry_t *node;
+  int priority = tcb->sched_priority;
+
+  if (dq_empty(waitlist))
+    {
+      dq_addfirst(tnode, waitlist);
+      return;
+    }
+
+  /* Search from the end of the list whose priority is nearer to that of
+   * the new task.  A task that waits again right after it was woken often
+   * has the highest priority in the list and is placed near the head.  A
+   * new waiter of low priority is placed near the tail.  In the worst
+   * case, the search still visits every task in the list.
+   */
+
+  htcb = (FAR struct tcb_s *)((FAR char *)dq_peek(waitlist) - nodeoff);
+  ntcb = (FAR struct tcb_s *)((FAR char *)dq_tail(waitlist) - nodeoff);
+
+  if (htcb->sched_priority - priority < priority - ntcb->sched_priority)
+    {
+      /* Search from the head for the first task of a lower priority */
+
+      for (node = dq_peek(waitlist); node != NULL; node = dq_next(node))
+        {
+          ntcb = (FAR struct tcb_s *)((FAR char *)node - nodeoff);
+          if (ntcb->sched_priority < priority)
+            {
+              dq_addbefore(node, tnode, waitlist);
+              return;
+            }
+        }
+
+      dq_addlast(tnode, waitlist);
+    }
+  else
+    {
+      /* Search from the tail for the last task of the same or a higher
+       * priority.
+       */
+
+      for (node = dq_tail(waitlist); node != NULL; node = dq_prev(node))
+        {
+          ntcb = (FAR struct tcb_s *)((FAR char *)node - nodeoff);
+          if (ntcb->sched_priority >= priority)
+            {
+              dq_addafter(node, tnode, waitlist);
+              return;
+            }
+        }
+
+      dq_addfirst(tnode, waitlist);
+    }
+}
+
+/****************************************************************************
+ * Name: sched_waitlist_take
+ *
+ * Description:
+ *   Remove and return the highest priority task in a wait list.  Since the
+ *   list is kept in priority order by sched_waitlist_add(), this is the
+ *   first task in the list that is selected by match().
+ *
+ * Input Parameters:
+ *   waitlist - The list of waiting tasks
+ *   nodeoff  - The offset of the list link in struct tcb_s
+ *   match    - If not NULL, only the tasks for which match() returns true
+ *              are considered.  Used when a list is shared by the waiters
+ *              of several objects.
+ *   arg      - Passed to match()
+ *
+ * Returned Value:
+ *   The TCB of the waiter or NULL if there is none.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *sched_waitlist_take(FAR dq_queue_t *waitlist,
+                                      size_t nodeoff,
+                                      sched_waitmatch_t match,
+                                      FAR void *arg)
+{
+  FAR struct tcb_s *tcb;
+  FAR dq_entry_t *node;
+
+  for (node = dq_peek(waitlist); node != NULL; node = dq_next(node))
+    {
+      tcb = (FAR struct tcb_s *)((FAR char *)node - nodeoff);
+      if (match == NULL || match(tcb, arg))
+        {
+          dq_rem(node, waitlist);
+          return tcb;
+        }
+    }
+
+  return NULL;
+}
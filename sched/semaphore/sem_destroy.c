@@ -73,6 +73,8 @@
 
 int nxsem_destroy (FAR sem_t *sem)
 {
+  int16_t semcount;
+
   /* Assure a valid semaphore is specified */
 
   if (sem != NULL)
@@ -87,9 +89,10 @@ int nxsem_destroy (FAR sem_t *sem)
        * leave the count unchanged but still return OK.
        */
 
-      if (sem->semcount >= 0)
+      semcount = sem->semcount;
+      while (semcount >= 0 && !nxsem_count_cas(sem, &semcount, 1))
         {
-          sem->semcount = 1;
+          /* The count was changed concurrently.  Try again. */
         }
 
       /* Release holders of the semaphore */
@@ -0,0 +1,148 @@
+/****************************************************************************
+ * sched/semaphore/sem_fastpath.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <semaphore.h>
+
+#include "semaphore/semaphore.h"
+
+#ifdef CONFIG_SEM_FASTPATH
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_fast_eligible
+ *
+ * Description:
+ *   Return true if the holders of the semaphore are not tracked.  The count
+ *   of such a semaphore may be changed without the critical section as long
+ *   as no task needs to be blocked or awakened.
+ *
+ ****************************************************************************/
+
+static inline bool nxsem_fast_eligible(FAR sem_t *sem)
+{
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  return (sem->flags & PRIOINHERIT_FLAGS_DISABLE) != 0;
+#else
+  return true;
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_count_trydec
+ *
+ * Description:
+ *   Atomically decrement the count of the semaphore if it is positive.
+ *
+ * Returned Value:
+ *   true if a count was taken.
+ *
+ ****************************************************************************/
+
+bool nxsem_count_trydec(FAR sem_t *sem)
+{
+  int16_t semcount = sem->semcount;
+
+  while (semcount > 0)
+    {
+      if (__atomic_compare_exchange_n(&sem->semcount, &semcount,
+                                      semcount - 1, false,
+                                      __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: nxsem_trywait_fast
+ *
+ * Description:
+ *   Take a count of the semaphore without entering the critical section.
+ *
+ * Returned Value:
+ *   true if a count was taken.  false if the semaphore is not available or
+ *   if its holders are tracked; the caller must then use the critical
+ *   section.
+ *
+ ****************************************************************************/
+
+bool nxsem_trywait_fast(FAR sem_t *sem)
+{
+  return nxsem_fast_eligible(sem) && nxsem_count_trydec(sem);
+}
+
+/****************************************************************************
+ * Name: nxsem_post_fast
+ *
+ * Description:
+ *   Release a count of the semaphore without entering the critical section
+ *   if no task is waiting for the semaphore.  A count that is not negative
+ *   means that there are no waiters and a waiter can only be added by
+ *   atomically making the count negative, so the compare-and-swap fails if
+ *   a task starts to wait concurrently.
+ *
+ * Returned Value:
+ *   true if the count was released.  false if a task may have to be
+ *   awakened or if the holders of the semaphore are tracked; the caller
+ *   must then use the critical section.
+ *
+ ****************************************************************************/
+
+bool nxsem_post_fast(FAR sem_t *sem)
+{
+  int16_t semcount = sem->semcount;
+
+  if (!nxsem_fast_eligible(sem))
+    {
+      return false;
+    }
+
+  while (semcount >= 0 && semcount < SEM_VALUE_MAX)
+    {
+      if (__atomic_compare_exchange_n(&sem->semcount, &semcount,
+                                      semcount + 1, false,
+                                      __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+#endif /* CONFIG_SEM_FASTPATH */
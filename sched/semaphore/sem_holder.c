@@ -76,8 +76,14 @@ static inline FAR struct semholder_s *nxsem_allocholder(sem_t *sem)
    */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  pholder = g_freeholders;
-  if (pholder != NULL)
+  if (sem->holder.htcb == NULL)
+    {
+      /* The inline holder is free.  It is not in the holder list. */
+
+      pholder          = &sem->holder;
+      pholder->counts  = 0;
+    }
+  else if ((pholder = g_freeholders) != NULL)
     {
       /* Remove the holder from the free list an put it into the semaphore's
        * holder list
@@ -123,8 +129,15 @@ static FAR struct semholder_s *nxsem_findholder(sem_t *sem,
   FAR struct semholder_s *pholder;
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  /* Try to find the holder in the list of holders associated with this
-   * semaphore
+  /* A mutex has at most one holder, which is then the inline holder */
+
+  if (sem->holder.htcb == htcb)
+    {
+      return &sem->holder;
+    }
+
+  /* Try to find the holder in the list of further holders associated with
+   * this semaphore
    */
 
   for (pholder = sem->hhead; pholder != NULL; pholder = pholder->flink)
@@ -193,6 +206,13 @@ static inline void nxsem_freeholder(sem_t *sem,
   pholder->counts = 0;
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
+  /* The inline holder is not in the list */
+
+  if (pholder == &sem->holder)
+    {
+      return;
+    }
+
   /* Search the list for the matching holder */
 
   for (prev = NULL, curr = sem->hhead;
@@ -252,6 +272,13 @@ static int nxsem_foreachholder(FAR sem_t *sem, holderhandler_t handler,
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
   FAR struct semholder_s *next;
 
+  /* The inline holder first */
+
+  if (sem->holder.htcb != NULL)
+    {
+      ret = handler(&sem->holder, sem, arg);
+    }
+
   for (pholder = sem->hhead; pholder && ret == 0; pholder = next)
     {
       /* In case this holder gets deleted */
@@ -338,6 +365,12 @@ static int nxsem_boostholderprio(FAR struct semholder_s *pholder,
 
   else if (rtcb->sched_priority > htcb->base_priority)
     {
+      /* The priority of this holder must be restored when a count is
+       * posted.
+       */
+
+      sem->flags |= PRIOINHERIT_FLAGS_BOOSTED;
+
       /* If the new priority is greater than the current, possibly already
        * boosted priority of the holder thread, then we will have to raise
        * the holder's priority now.
@@ -413,6 +446,7 @@ static int nxsem_boostholderprio(FAR struct semholder_s *pholder,
        * will occur during up_block_task() processing.
        */
 
+      sem->flags |= PRIOINHERIT_FLAGS_BOOSTED;
       nxsched_setpriority(htcb, rtcb->sched_priority);
     }
 #endif
@@ -649,39 +683,6 @@ static int nxsem_restoreholderprio_others(FAR struct semholder_s *pholder,
   return 0;
 }
 
-/****************************************************************************
- * Name: nxsem_restoreholderprio_self
- *
- * Description:
- *   Reprioritize only the currently executing task
- *
- ****************************************************************************/
-
-static int nxsem_restoreholderprio_self(FAR struct semholder_s *pholder,
-                                        FAR sem_t *sem, FAR void *arg)
-{
-  FAR struct tcb_s *rtcb = this_task();
-
-  if (pholder->htcb == rtcb)
-    {
-      /* The running task has given up a count on the semaphore */
-
-#if CONFIG_SEM_PREALLOCHOLDERS == 0
-      /* In the case where there are only 2 holders. This step
-       * is necessary to ensure we have space. Release the holder
-       * if all counts have been given up before reprioritizing
-       * causes a context switch.
-       */
-
-      nxsem_findandfreeholder(sem, rtcb);
-#endif
-      nxsem_restoreholderprio(rtcb, sem, arg);
-      return 1;
-    }
-
-  return 0;
-}
-
 /****************************************************************************
  * Name: nxsem_restorebaseprio_irq
  *
@@ -726,9 +727,14 @@ static inline void nxsem_restorebaseprio_irq(FAR struct tcb_s *stcb,
 
   if (stcb != NULL)
     {
-      /* Drop the priority of all holder threads */
+      /* Drop the priority of all holder threads, unless none of them was
+       * boosted by a waiter.
+       */
 
-      nxsem_foreachholder(sem, nxsem_restoreholderprioall, stcb);
+      if ((sem->flags & PRIOINHERIT_FLAGS_BOOSTED) != 0)
+        {
+          nxsem_foreachholder(sem, nxsem_restoreholderprioall, stcb);
+        }
     }
 
   /* If there are no tasks waiting for available counts, then all holders
@@ -779,6 +785,7 @@ static inline void nxsem_restorebaseprio_task(FAR struct tcb_s *stcb,
                                               FAR sem_t *sem)
 {
   FAR struct tcb_s *rtcb = this_task();
+  FAR struct semholder_s *pholder;
 
   /* Perform the following actions only if a new thread was given a count.
    * The thread that received the count should be the highest priority
@@ -787,22 +794,45 @@ static inline void nxsem_restorebaseprio_task(FAR struct tcb_s *stcb,
    * next highest pending priority.
    */
 
-  if (stcb != NULL)
+  if (stcb != NULL && (sem->flags & PRIOINHERIT_FLAGS_BOOSTED) != 0)
     {
       /* The currently executed thread should be the lower priority
        * thread that just posted the count and caused this action.
        * However, we cannot drop the priority of the currently running
        * thread -- because that will cause it to be suspended.
        *
-       * So, do this in two passes.  First, reprioritizing all holders
-       * except for the running thread.
+       * So, first reprioritize all holders except for the running thread.
+       * This is the only walk over all of the holders, and it is skipped
+       * if no holder was boosted by a waiter.  It is not bounded by a
+       * constant:  Its time grows with the number of holders, up to
+       * CONFIG_SEM_PREALLOCHOLDERS + 1 for a counting semaphore.  A mutex
+       * has only the inline holder.
        */
 
       nxsem_foreachholder(sem, nxsem_restoreholderprio_others, stcb);
 
-      /* Now, find an reprioritize only the ready to run task */
+      /* Now reprioritize only the running task.  Its holder is found
+       * without a walk if it is the inline holder, as for any mutex.
+       */
 
-      nxsem_foreachholder(sem, nxsem_restoreholderprio_self, stcb);
+      pholder = nxsem_findholder(sem, rtcb);
+      if (pholder != NULL)
+        {
+#if CONFIG_SEM_PREALLOCHOLDERS == 0
+          /* In the case where there are only 2 holders. This step
+           * is necessary to ensure we have space. Release the holder
+           * if all counts have been given up before reprioritizing
+           * causes a context switch.
+           */
+
+          if (pholder->counts <= 0)
+            {
+              nxsem_freeholder(sem, pholder);
+            }
+#endif
+
+          nxsem_restoreholderprio(rtcb, sem, stcb);
+        }
     }
 
   /* If there are no tasks waiting for available counts, then all holders
@@ -897,15 +927,12 @@ void nxsem_destroyholder(FAR sem_t *sem)
    */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  if (sem->hhead != NULL)
-    {
-      /* There may be an issue if there are multiple holders of
-       * the semaphore.
-       */
+  /* There may be an issue if there are multiple holders of the semaphore,
+   * i.e. if there are holders besides the inline holder.
+   */
 
-      DEBUGASSERT(sem->hhead->flink == NULL);
-      nxsem_foreachholder(sem, nxsem_recoverholders, NULL);
-    }
+  DEBUGASSERT(sem->holder.htcb == NULL || sem->hhead == NULL);
+  nxsem_foreachholder(sem, nxsem_recoverholders, NULL);
 
 #else
   /* There may be an issue if there are multiple holders of the semaphore. */
@@ -915,6 +942,8 @@ void nxsem_destroyholder(FAR sem_t *sem)
   sem->holder[0].htcb = NULL;
   sem->holder[1].htcb = NULL;
 #endif
+
+  sem->flags &= ~PRIOINHERIT_FLAGS_BOOSTED;
 }
 
 /****************************************************************************
@@ -1089,6 +1118,12 @@ void nxsem_restorebaseprio(FAR struct tcb_s *stcb, FAR sem_t *sem)
               (sem->semcount <= 0 && stcb != NULL));
 #endif
 
+  /* Restore the holders in one walk and only if needed:  Without a
+   * holder that was boosted by a waiter, there is nothing to restore.
+   * When a restore is needed, the walk visits every holder, so its time
+   * is proportional to the number of holders of the semaphore.
+   */
+
   /* Handler semaphore counts posed from an interrupt handler differently
    * from interrupts posted from threads.  The primary difference is that
    * if the semaphore is posted from a thread, then the poster thread is
@@ -1105,6 +1140,13 @@ void nxsem_restorebaseprio(FAR struct tcb_s *stcb, FAR sem_t *sem)
     {
       nxsem_restorebaseprio_task(stcb, sem);
     }
+
+  /* Once no task is waiting, every boost by a waiter has been undone */
+
+  if (sem->semcount >= 0)
+    {
+      sem->flags &= ~PRIOINHERIT_FLAGS_BOOSTED;
+    }
 }
 
 /****************************************************************************
@@ -1134,7 +1176,10 @@ void nxsem_canceled(FAR struct tcb_s *stcb, FAR sem_t *sem)
 
   /* Adjust the priority of every holder as necessary */
 
-  nxsem_foreachholder(sem, nxsem_restoreholderprioall, stcb);
+  if ((sem->flags & PRIOINHERIT_FLAGS_BOOSTED) != 0)
+    {
+      nxsem_foreachholder(sem, nxsem_restoreholderprioall, stcb);
+    }
 }
 
 /****************************************************************************
@@ -84,16 +84,15 @@ void nxsem_recover(FAR struct tcb_s *tcb)
    * to what you see in nxsem_wait_irq() except that no attempt is made to
    * restart the exiting task.
    *
-   * NOTE:  In the case that the task is waiting we can assume: (1) That the
-   * task state is TSTATE_WAIT_SEM and (2) that the 'waitsem' in the TCB is
-   * non-null.  If we get here via pthread_cancel() or via task_delete(),
-   * then the task state should be preserved; it will be altered in other
-   * cases but in those cases waitsem should be NULL anyway (but we do not
-   * enforce that here).
+   * NOTE:  A task is waiting exactly when the 'waitsem' in the TCB is
+   * non-null; it is cleared whenever the wait ends.  The task state is not
+   * a reliable indication:  A waiting task that was stopped with
+   * sched_suspend() is still counted by the semaphore and still linked in
+   * its wait list, but its state is TSTATE_TASK_STOPPED.
    */
 
   flags = enter_critical_section();
-  if (tcb->task_state == TSTATE_WAIT_SEM)
+  if (tcb->waitsem != NULL)
     {
       sem_t *sem = tcb->waitsem;
       DEBUGASSERT(sem != NULL && sem->semcount < 0);
@@ -110,14 +109,15 @@ void nxsem_recover(FAR struct tcb_s *tcb)
        * place.
        */
 
-      sem->semcount++;
+      nxsem_count_inc(sem);
 
-      /* Clear the semaphore to assure that it is not reused.  But leave the
-       * state as TSTATE_WAIT_SEM.  This is necessary because this is a
-       * necessary indication that the TCB still resides in the waiting-for-
-       * semaphore list.
+      /* Unlink the TCB from the wait list before it is freed and clear the
+       * semaphore to assure that it is not reused.  But leave the state
+       * unchanged.  This is necessary because this is a necessary
+       * indication of the task list that the TCB still resides in.
        */
 
+      nxsem_remove_waiter(tcb);
       tcb->waitsem = NULL;
     }
 
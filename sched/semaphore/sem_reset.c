@@ -73,6 +73,7 @@
 int nxsem_reset(FAR sem_t *sem, int16_t count)
 {
   irqstate_t flags;
+  int16_t semcount;
 
   DEBUGASSERT(sem != NULL && count >= 0);
 
@@ -88,32 +89,44 @@ int nxsem_reset(FAR sem_t *sem, int16_t count)
 
   flags = enter_critical_section();
 
-  /* A negative count indicates that the negated number of threads are
-   * waiting to take a count from the semaphore.  Loop here, handing
-   * out counts to any waiting threads.
-   */
-
-  while (sem->semcount < 0 && count > 0)
+  for (; ; )
     {
-      /* Give out one counting, waking up one of the waiting threads
-       * and, perhaps, kicking off a lot of priority inheritance
-       * logic (REVISIT).
+      /* A negative count indicates that the negated number of threads are
+       * waiting to take a count from the semaphore.  Loop here, handing
+       * out counts to any waiting threads.
        */
 
-      DEBUGVERIFY(nxsem_post(sem));
-      count--;
-    }
+      while (sem->semcount < 0 && count > 0)
+        {
+          /* Give out one counting, waking up one of the waiting threads
+           * and, perhaps, kicking off a lot of priority inheritance
+           * logic (REVISIT).
+           */
+
+          DEBUGVERIFY(nxsem_post(sem));
+          count--;
+        }
+
+      /* We exit the above loop with either (1) no threads waiting for the
+       * (i.e., with sem->semcount >= 0).  In this case, 'count' holds the
+       * the new value of the semaphore count.  OR (2) with threads still
+       * waiting but all of the semaphore counts exhausted:  The current
+       * value of sem->semcount is already correct in this case.
+       *
+       * The count may still be changed by the lock-free fast path, so it
+       * is only set if it did not change since it was checked.
+       */
 
-  /* We exit the above loop with either (1) no threads waiting for the
-   * (i.e., with sem->semcount >= 0).  In this case, 'count' holds the
-   * the new value of the semaphore count.  OR (2) with threads still
-   * waiting but all of the semaphore counts exhausted:  The current
-   * value of sem->semcount is already correct in this case.
-   */
+      semcount = sem->semcount;
+      if (semcount < 0 && count == 0)
+        {
+          break;
+        }
 
-  if (sem->semcount >= 0)
-    {
-      sem->semcount = count;
+      if (semcount >= 0 && nxsem_count_cas(sem, &semcount, count))
+        {
+          break;
+        }
     }
 
   /* Allow any pending context switches to occur now */
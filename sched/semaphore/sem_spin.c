@@ -0,0 +1,149 @@
+/****************************************************************************
+ * sched/semaphore/sem_spin.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sched.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/semaphore.h>
+
+#include "sched/sched.h"
+#include "semaphore/semaphore.h"
+
+#ifdef CONFIG_SEM_ADAPTIVE
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_running
+ *
+ * Description:
+ *   Return true if a task is running on any CPU.  The running tasks are
+ *   sampled without a lock, so the result is only a hint:  The task may be
+ *   switched in or out at any time.
+ *
+ ****************************************************************************/
+
+static bool nxsem_running(pid_t pid)
+{
+  FAR struct tcb_s *tcb;
+  int cpu;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+      tcb = current_task(cpu);
+      if (tcb != NULL && tcb->pid == pid)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_spin
+ *
+ * Description:
+ *   Spin while a semaphore that is used as a mutex is held by a task that
+ *   is running on another CPU.  See include/nuttx/semaphore.h.
+ *
+ * Input Parameters:
+ *   sem    - The semaphore
+ *   holder - The location where the caller records the ID of the task
+ *            that holds the semaphore, negative if not known
+ *   stats  - The statistics of the semaphore
+ *
+ * Returned Value:
+ *   true if the semaphore was taken while spinning.
+ *
+ ****************************************************************************/
+
+bool nxsem_spin(FAR sem_t *sem, FAR const volatile pid_t *holder,
+                FAR struct sem_spinstats_s *stats)
+{
+  FAR volatile int16_t *semcount = &sem->semcount;
+  FAR struct tcb_s *rtcb = this_task();
+  int polls;
+  pid_t pid;
+
+  DEBUGASSERT(sem != NULL && holder != NULL && stats != NULL);
+
+  /* Do not spin in a critical section or with pre-emption disabled:  The
+   * holder may need the critical section to post the semaphore, and a task
+   * that is ready to run on this CPU would be delayed.
+   */
+
+  if (up_interrupt_context() || rtcb->irqcount > 0 || rtcb->lockcount > 0)
+    {
+      return false;
+    }
+
+  /* Only spin if the holder is known to be running now */
+
+  pid = *holder;
+  if (*semcount > 0 || pid < 0 || !nxsem_running(pid))
+    {
+      return false;
+    }
+
+  stats->ss_nspin++;
+
+  for (polls = 0; polls < CONFIG_SEM_ADAPTIVE_SPINS; polls++)
+    {
+      /* Take the semaphore as soon as it is posted.  Another task may take
+       * it first; then keep spinning on the new holder.
+       */
+
+      if (*semcount > 0 && nxsem_trywait(sem) >= 0)
+        {
+          stats->ss_nacquire++;
+          return true;
+        }
+
+      /* The semaphore may have changed hands while spinning.  Follow the
+       * new holder as long as it is running too.
+       */
+
+      pid = *holder;
+      if (pid >= 0 && !nxsem_running(pid))
+        {
+          break;
+        }
+    }
+
+  stats->ss_ngiveup++;
+  return false;
+}
+
+#endif /* CONFIG_SEM_ADAPTIVE */
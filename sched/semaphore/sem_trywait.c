@@ -89,6 +89,15 @@ int nxsem_trywait(FAR sem_t *sem)
 
   if (sem != NULL)
     {
+      /* Take an available count without entering the critical section if
+       * that is possible for this semaphore.
+       */
+
+      if (nxsem_trywait_fast(sem))
+        {
+          return OK;
+        }
+
       /* The following operations must be performed with interrupts disabled
        * because sem_post() may be called from an interrupt handler.
        */
@@ -97,11 +106,10 @@ int nxsem_trywait(FAR sem_t *sem)
 
       /* If the semaphore is available, give it to the requesting task */
 
-      if (sem->semcount > 0)
+      if (nxsem_count_trydec(sem))
         {
           /* It is, let the task take the semaphore */
 
-          sem->semcount--;
           rtcb->waitsem = NULL;
           ret = OK;
         }
@@ -77,6 +77,15 @@ int nxsem_wait(FAR sem_t *sem)
 
   DEBUGASSERT(sem != NULL && up_interrupt_context() == false);
 
+  /* Take an available count without entering the critical section if
+   * that is possible for this semaphore.
+   */
+
+  if (sem != NULL && nxsem_trywait_fast(sem))
+    {
+      return OK;
+    }
+
   /* The following operations must be performed with interrupts
    * disabled because nxsem_post() may be called from an interrupt
    * handler.
@@ -88,13 +97,14 @@ int nxsem_wait(FAR sem_t *sem)
 
   if (sem != NULL)
     {
-      /* Check if the lock is available */
+      /* Check if the lock is available.  The count is decremented in
+       * either case:  A negative count is the number of waiters.
+       */
 
-      if (sem->semcount > 0)
+      if (nxsem_count_dec(sem) >= 0)
         {
           /* It is, let the task take the semaphore. */
 
-          sem->semcount--;
           nxsem_addholder(sem);
           rtcb->waitsem = NULL;
           ret = OK;
@@ -114,13 +124,10 @@ int nxsem_wait(FAR sem_t *sem)
 
           DEBUGASSERT(rtcb->waitsem == NULL);
 
-          /* Handle the POSIX semaphore (but don't set the owner yet) */
-
-          sem->semcount--;
-
           /* Save the waited on semaphore in the TCB */
 
           rtcb->waitsem = sem;
+          nxsem_add_waiter(rtcb);
 
           /* If priority inheritance is enabled, then check the priority of
            * the holder of the semaphore.
@@ -188,6 +195,16 @@ int nxsem_wait(FAR sem_t *sem)
           ret           = rtcb->pterrno != OK ? -rtcb->pterrno : OK;
           rtcb->pterrno = saved_errno;
 
+          /* A task that was stopped while waiting is restarted with EINTR
+           * but without any semaphore clean-up (see sched_suspend()).
+           */
+
+          if (rtcb->waitsem != NULL)
+            {
+              nxsem_remove_waiter(rtcb);
+              rtcb->waitsem = NULL;
+            }
+
 #ifdef CONFIG_PRIORITY_INHERITANCE
           sched_unlock();
 #endif
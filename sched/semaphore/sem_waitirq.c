@@ -109,10 +109,11 @@ void nxsem_wait_irq(FAR struct tcb_s *wtcb, int errcode)
        * place.
        */
 
-      sem->semcount++;
+      nxsem_count_inc(sem);
 
       /* Indicate that the semaphore wait is over. */
 
+      nxsem_remove_waiter(wtcb);
       wtcb->waitsem = NULL;
 
       /* Mark the errno value for the thread. */
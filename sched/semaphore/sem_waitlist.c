@@ -0,0 +1,175 @@
+/****************************************************************************
+ * sched/semaphore/sem_waitlist.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <queue.h>
+#include <assert.h>
+
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+#include "semaphore/semaphore.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_SEM_NWAITLISTS
+#  define CONFIG_SEM_NWAITLISTS 16
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The tasks waiting for a semaphore are kept in one of these lists, as
+ * selected by a hash of the address of the semaphore.  Keeping the lists
+ * outside of sem_t leaves the size of sem_t unchanged.  The tasks are also
+ * in the g_waitingforsemaphore list that holds the waiters of all
+ * semaphores, but nxsem_post() only needs to search one of these lists.
+ *
+ * A list is shared by the waiters of all semaphores with the same hash.
+ * It is kept in priority order, so nxsem_post() stops at the first waiter
+ * of its semaphore instead of examining the whole list.
+ */
+
+static dq_queue_t g_semwaitlists[CONFIG_SEM_NWAITLISTS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_waitlist
+ *
+ * Description:
+ *   Return the wait list that holds the waiters of a semaphore.
+ *
+ ****************************************************************************/
+
+static inline FAR dq_queue_t *nxsem_waitlist(FAR sem_t *sem)
+{
+  uintptr_t key = (uintptr_t)sem;
+
+  /* Semaphores are at least 4-byte aligned and often embedded at the same
+   * offset of equally sized structures.  Fold in some higher address bits.
+   */
+
+  key = (key >> 2) ^ (key >> 9);
+  return &g_semwaitlists[key % CONFIG_SEM_NWAITLISTS];
+}
+
+/****************************************************************************
+ * Name: nxsem_waitmatch
+ *
+ * Description:
+ *   A wait list holds the waiters of all semaphores with the same hash.
+ *   Select the tasks that are waiting for the semaphore 'arg'.
+ *
+ ****************************************************************************/
+
+static bool nxsem_waitmatch(FAR struct tcb_s *tcb, FAR void *arg)
+{
+  return tcb->waitsem == (FAR sem_t *)arg &&
+         tcb->task_state == TSTATE_WAIT_SEM;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_add_waiter
+ *
+ * Description:
+ *   Add a task to the wait list of the semaphore that it is about to wait
+ *   for.  tcb->waitsem must already refer to that semaphore.
+ *
+ * Input Parameters:
+ *   tcb - The task that is about to block
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+void nxsem_add_waiter(FAR struct tcb_s *tcb)
+{
+  DEBUGASSERT(tcb->waitsem != NULL);
+  sched_waitlist_add(nxsem_waitlist(tcb->waitsem), tcb,
+                     offsetof(struct tcb_s, semwaitnode));
+}
+
+/****************************************************************************
+ * Name: nxsem_remove_waiter
+ *
+ * Description:
+ *   Remove a task from the wait list of its semaphore because the wait was
+ *   ended by a signal, a timeout or because the task was deleted.  This
+ *   must be done before tcb->waitsem is cleared.
+ *
+ * Input Parameters:
+ *   tcb - The task that is no longer waiting
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+void nxsem_remove_waiter(FAR struct tcb_s *tcb)
+{
+  DEBUGASSERT(tcb->waitsem != NULL);
+  dq_rem(&tcb->semwaitnode, nxsem_waitlist(tcb->waitsem));
+}
+
+/****************************************************************************
+ * Name: nxsem_take_waiter
+ *
+ * Description:
+ *   Remove and return the highest priority task waiting for a semaphore.
+ *   Tasks of equal priority are served in the order that they started to
+ *   wait.  The wait list of the semaphore is searched only up to its first
+ *   waiter.
+ *
+ * Input Parameters:
+ *   sem - The semaphore that was posted
+ *
+ * Returned Value:
+ *   The TCB of the waiter or NULL if there is none.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *nxsem_take_waiter(FAR sem_t *sem)
+{
+  return sched_waitlist_take(nxsem_waitlist(sem),
+                             offsetof(struct tcb_s, semwaitnode),
+                             nxsem_waitmatch, sem);
+}
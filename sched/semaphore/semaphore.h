@@ -69,6 +69,27 @@ void nxsem_initialize(void);
 #  define nxsem_initialize()
 #endif
 
+/* Semaphore count operations.  See also nxsem_count_inc(), _dec() and
+ * _cas() in include/nuttx/semaphore.h.
+ */
+
+#ifdef CONFIG_SEM_FASTPATH
+bool nxsem_count_trydec(FAR sem_t *sem);
+bool nxsem_trywait_fast(FAR sem_t *sem);
+bool nxsem_post_fast(FAR sem_t *sem);
+#else
+#  define nxsem_count_trydec(sem) \
+     ((sem)->semcount > 0 ? ((sem)->semcount--, true) : false)
+#  define nxsem_trywait_fast(sem) (false)
+#  define nxsem_post_fast(sem)    (false)
+#endif
+
+/* Per-semaphore lists of waiting threads */
+
+void nxsem_add_waiter(FAR struct tcb_s *tcb);
+void nxsem_remove_waiter(FAR struct tcb_s *tcb);
+FAR struct tcb_s *nxsem_take_waiter(FAR sem_t *sem);
+
 /* Wake up a thread that is waiting on semaphore */
 
 void nxsem_wait_irq(FAR struct tcb_s *wtcb, int errcode);
@@ -81,6 +81,8 @@ int wd_delete(WDOG_ID wdog)
       wd_cancel(wdog);
     }
 
+  leave_critical_section(flags);
+
   /* Did this watchdog come from the pool of pre-allocated timers?  Or, was
    * it allocated from the heap?
    */
@@ -95,7 +97,6 @@ int wd_delete(WDOG_ID wdog)
        * We don't need interrupts disabled to do this.
        */
 
-      leave_critical_section(flags);
       kmm_free(wdog);
     }
 
@@ -104,22 +105,18 @@ int wd_delete(WDOG_ID wdog)
   else if (!WDOG_ISSTATIC(wdog))
     {
       /* Put the timer back on the free list and increment the count of free
-       * timers, all with interrupts disabled.
+       * timers, all with interrupts disabled and the free list locked.
        */
 
+      flags = spin_lock_save(&g_wdlock);
       sq_addlast((FAR sq_entry_t *)wdog, &g_wdfreelist);
       g_wdnfree++;
       DEBUGASSERT(g_wdnfree <= CONFIG_PREALLOC_WDOGS);
-      leave_critical_section(flags);
+      spin_unlock_restore(&g_wdlock, flags);
     }
 
   /* This function should not be called for statically allocated timers. */
 
-  else
-    {
-      leave_critical_section(flags);
-    }
-
   /* Return success */
 
   return OK;
@@ -25,6 +25,9 @@
 #include <nuttx/config.h>
 
 #include <queue.h>
+#include <assert.h>
+
+#include <nuttx/spinlock.h>
 
 #include "wdog/wdog.h"
 
@@ -52,6 +55,12 @@ sq_queue_t g_wdactivelist;
 
 uint16_t g_wdnfree;
 
+/* This lock protects g_wdfreelist and g_wdnfree */
+
+#ifdef CONFIG_SPINLOCK
+spinlock_t g_wdlock;
+#endif
+
 /* This is wdog tickbase, for wd_gettime() may called many times
  * between 2 times of wd_timer(), we use it to update wd_gettime().
  */
@@ -115,4 +124,9 @@ void wd_initialize(void)
   /* All watchdogs are free */
 
   g_wdnfree = CONFIG_PREALLOC_WDOGS;
+
+#ifdef CONFIG_SPINLOCK
+  spin_initialize(&g_wdlock, SP_UNLOCKED);
+#endif
+  DEBUGVERIFY(spin_monitor(&g_wdlock, "wdog"));
 }
@@ -33,6 +33,7 @@
 #include <nuttx/compiler.h>
 #include <nuttx/clock.h>
 #include <nuttx/wdog.h>
+#include <nuttx/spinlock.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -87,6 +88,12 @@ extern sq_queue_t g_wdactivelist;
 
 extern uint16_t g_wdnfree;
 
+/* This lock protects g_wdfreelist and g_wdnfree */
+
+#ifdef CONFIG_SPINLOCK
+extern spinlock_t g_wdlock;
+#endif
+
 /* This is wdog tickbase, for wd_gettime() may called many times
  * between 2 times of wd_timer(), we use it to update wd_gettime().
  */
@@ -0,0 +1,240 @@
+/****************************************************************************
+ * sched/wqueue/kwork_batch.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/wqueue.h>
+
+#include "wqueue/wqueue.h"
+
+#ifdef CONFIG_WQUEUE_BATCH
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_batch_release
+ *
+ * Description:
+ *   Drop one reference to a batch.  The references are the work of the
+ *   batch that was not yet performed or cancelled, plus one held by the
+ *   caller of work_batch_init() until the batch is closed.  When the last
+ *   reference is dropped, the completion callback of the batch is made
+ *   ready.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue of the batch
+ *   batch  - The batch
+ *
+ * Returned Value:
+ *   true if the completion became ready and a worker must be signalled.
+ *
+ * Assumptions:
+ *   The lock of the work queue is held.
+ *
+ ****************************************************************************/
+
+bool work_batch_release(FAR struct kwork_wqueue_s *wqueue,
+                        FAR struct work_batch_s *batch)
+{
+  DEBUGASSERT(batch->pending > 0);
+
+  if (--batch->pending > 0)
+    {
+      return false;
+    }
+
+  batch->work.worker = batch->worker;
+  batch->work.arg    = batch->arg;
+  batch->work.prio   = 0;
+  batch->work.batch  = NULL;
+
+  work_ready(wqueue, &batch->work, -1);
+  return true;
+}
+
+/****************************************************************************
+ * Name: work_batch_leave
+ *
+ * Description:
+ *   Remove work that was just unlinked from a work queue from its batch,
+ *   if it is part of one.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue of the batch
+ *   work   - The work that was unlinked
+ *
+ * Returned Value:
+ *   true if the completion became ready and a worker must be signalled.
+ *
+ * Assumptions:
+ *   The lock of the work queue is held.
+ *
+ ****************************************************************************/
+
+bool work_batch_leave(FAR struct kwork_wqueue_s *wqueue,
+                      FAR struct work_s *work)
+{
+  FAR struct work_batch_s *batch = work->batch;
+
+  if (batch == NULL)
+    {
+      return false;
+    }
+
+  work->batch = NULL;
+  return work_batch_release(wqueue, batch);
+}
+
+/****************************************************************************
+ * Name: work_batch_init
+ *
+ * Description:
+ *   Initialize a batch of work.  See include/nuttx/wqueue.h.
+ *
+ * Input Parameters:
+ *   batch  - The batch to initialize
+ *   qid    - The work queue to perform the work of the batch on
+ *   worker - The completion callback
+ *   arg    - The argument that will be passed to the completion callback
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+int work_batch_init(FAR struct work_batch_s *batch, int qid,
+                    worker_t worker, FAR void *arg)
+{
+  int nthreads;
+
+  DEBUGASSERT(batch != NULL && worker != NULL);
+
+  if (work_queue_get(qid, &nthreads) == NULL)
+    {
+      return -EINVAL;
+    }
+
+  memset(batch, 0, sizeof(struct work_batch_s));
+  batch->worker  = worker;
+  batch->arg     = arg;
+  batch->pending = 1;
+  batch->qid     = qid;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: work_batch_queue
+ *
+ * Description:
+ *   Queue work as a part of an open batch.  See include/nuttx/wqueue.h.
+ *
+ * Input Parameters:
+ *   batch  - The open batch
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked
+ *   arg    - The argument that will be passed to the worker callback
+ *   prio   - The priority of the work among ready work
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+int work_batch_queue(FAR struct work_batch_s *batch, FAR struct work_s *work,
+                     worker_t worker, FAR void *arg, uint8_t prio)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+  irqstate_t lock;
+  int nthreads;
+
+  DEBUGASSERT(batch != NULL && batch->pending > 0);
+  DEBUGASSERT(work != NULL && work_available(work));
+
+  wqueue = work_queue_get(batch->qid, &nthreads);
+  DEBUGASSERT(wqueue != NULL);
+
+  /* The reference is taken before the work is queued, because it may be
+   * performed as soon as it is ready.
+   */
+
+  lock = spin_lock_save(&wqueue->lock);
+  if (batch->pending == UINT16_MAX)
+    {
+      spin_unlock_restore(&wqueue->lock, lock);
+      return -EOVERFLOW;
+    }
+
+  batch->pending++;
+  work->batch = batch;
+  spin_unlock_restore(&wqueue->lock, lock);
+
+  work_qqueue(wqueue, batch->qid, nthreads, work, worker, arg, 0, prio);
+  return work_signal(batch->qid);
+}
+
+/****************************************************************************
+ * Name: work_batch_close
+ *
+ * Description:
+ *   Close a batch.  See include/nuttx/wqueue.h.
+ *
+ * Input Parameters:
+ *   batch  - The open batch
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ ****************************************************************************/
+
+int work_batch_close(FAR struct work_batch_s *batch)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+  irqstate_t lock;
+  bool ready;
+  int nthreads;
+
+  DEBUGASSERT(batch != NULL);
+
+  wqueue = work_queue_get(batch->qid, &nthreads);
+  DEBUGASSERT(wqueue != NULL);
+
+  /* Drop the reference held since work_batch_init() */
+
+  lock  = spin_lock_save(&wqueue->lock);
+  ready = work_batch_release(wqueue, batch);
+  spin_unlock_restore(&wqueue->lock, lock);
+
+  return ready ? work_signal(batch->qid) : OK;
+}
+
+#endif /* CONFIG_WQUEUE_BATCH */
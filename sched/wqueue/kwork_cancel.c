@@ -49,6 +49,7 @@
  *   work_queue() again.
  *
  * Input Parameters:
+ *   wqueue - The work queue
  *   qid    - The work queue ID
  *   work   - The previously queue work structure to cancel
  *
@@ -61,10 +62,11 @@
  *
  ****************************************************************************/
 
-static int work_qcancel(FAR struct kwork_wqueue_s *wqueue,
+static int work_qcancel(FAR struct kwork_wqueue_s *wqueue, int qid,
                         FAR struct work_s *work)
 {
   irqstate_t flags;
+  bool ready = false;
   int ret = -ENOENT;
 
   DEBUGASSERT(work != NULL);
@@ -74,26 +76,29 @@ static int work_qcancel(FAR struct kwork_wqueue_s *wqueue,
    * new work is typically added to the work queue from interrupt handlers.
    */
 
-  flags = enter_critical_section();
-  if (work->worker != NULL)
+  flags = spin_lock_save(&wqueue->lock);
+
+  /* Remove the entry from the work queue or from the delayed list and make
+   * sure that it is marked as available (i.e., the worker field is
+   * nullified).  If it was the first delayed work, the watchdog will
+   * expire early and then be restarted for the next delayed work.
+   */
+
+  if (work_unlink(wqueue, work))
     {
-      /* A little test of the integrity of the work queue */
+      /* Cancelled work no longer holds up the batch that it is part of */
 
-      DEBUGASSERT(work->dq.flink != NULL ||
-                  (FAR dq_entry_t *)work == wqueue->q.tail);
-      DEBUGASSERT(work->dq.blink != NULL ||
-                  (FAR dq_entry_t *)work == wqueue->q.head);
+      ready = work_batch_leave(wqueue, work);
+      ret   = OK;
+    }
 
-      /* Remove the entry from the work queue and make sure that it is
-       * marked as available (i.e., the worker field is nullified).
-       */
+  spin_unlock_restore(&wqueue->lock, flags);
 
-      dq_rem((FAR dq_entry_t *)work, &wqueue->q);
-      work->worker = NULL;
-      ret = OK;
+  if (ready)
+    {
+      work_signal(qid);
     }
 
-  leave_critical_section(flags);
   return ret;
 }
 
@@ -129,7 +134,8 @@ int work_cancel(int qid, FAR struct work_s *work)
     {
       /* Cancel high priority work */
 
-      return work_qcancel((FAR struct kwork_wqueue_s *)&g_hpwork, work);
+      return work_qcancel((FAR struct kwork_wqueue_s *)&g_hpwork, HPWORK,
+                          work);
     }
   else
 #endif
@@ -138,7 +144,8 @@ int work_cancel(int qid, FAR struct work_s *work)
     {
       /* Cancel low priority work */
 
-      return work_qcancel((FAR struct kwork_wqueue_s *)&g_lpwork, work);
+      return work_qcancel((FAR struct kwork_wqueue_s *)&g_lpwork, LPWORK,
+                          work);
     }
   else
 #endif
@@ -28,6 +28,7 @@
 #include <sched.h>
 #include <string.h>
 #include <errno.h>
+#include <assert.h>
 #include <queue.h>
 #include <debug.h>
 
@@ -35,6 +36,7 @@
 #include <nuttx/kthread.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/clock.h>
+#include <nuttx/wdog.h>
 
 #include "wqueue/wqueue.h"
 
@@ -104,7 +106,8 @@ static int work_lpthread(int argc, char *argv[])
        * triggered, or delayed work expires.
        */
 
-      work_process((FAR struct kwork_wqueue_s *)&g_lpwork, wndx);
+      work_process((FAR struct kwork_wqueue_s *)&g_lpwork,
+                   CONFIG_SCHED_LPNTHREADS, wndx);
     }
 
   return OK; /* To keep some compilers happy */
@@ -140,6 +143,15 @@ int work_lpstart(void)
 
   sched_lock();
 
+#ifdef CONFIG_SPINLOCK
+  spin_initialize(&g_lpwork.lock, SP_UNLOCKED);
+#endif
+  DEBUGVERIFY(spin_monitor(&g_lpwork.lock, "lpwork"));
+
+  /* The watchdog that moves expired delayed work to the work queue */
+
+  wd_static(&g_lpwork.timer);
+
   /* Start the low-priority, kernel mode worker thread(s) */
 
   sinfo("Starting low-priority kernel worker thread(s)\n");
@@ -35,33 +35,46 @@
 #include <nuttx/signal.h>
 #include <nuttx/wqueue.h>
 
+#include "sched/sched.h"
 #include "wqueue/wqueue.h"
 
 #ifdef CONFIG_SCHED_WORKQUEUE
 
 /****************************************************************************
- * Pre-processor Definitions
+ * Private Functions
  ****************************************************************************/
 
-/* Use CLOCK_MONOTONIC if it is available.  CLOCK_REALTIME can cause bad
- * delays if the time is changed.
- */
+/****************************************************************************
+ * Name: work_boostprio
+ *
+ * Description:
+ *   Return the priority that the calling worker thread must run at to
+ *   perform work of a priority, or zero if it need not be boosted.  Only
+ *   the worker threads of the low-priority work queue are boosted, and no
+ *   higher than CONFIG_SCHED_LPWORKPRIOMAX.
+ *
+ ****************************************************************************/
 
-#ifdef CONFIG_CLOCK_MONOTONIC
-#  define WORK_CLOCK CLOCK_MONOTONIC
-#else
-#  define WORK_CLOCK CLOCK_REALTIME
-#endif
+static inline uint8_t work_boostprio(FAR struct kwork_wqueue_s *wqueue,
+                                     uint8_t prio)
+{
+#ifdef CONFIG_SCHED_LPWORK
+  if (wqueue == (FAR struct kwork_wqueue_s *)&g_lpwork)
+    {
+      if (prio > CONFIG_SCHED_LPWORKPRIOMAX)
+        {
+          prio = CONFIG_SCHED_LPWORKPRIOMAX;
+        }
 
-#ifdef CONFIG_SYSTEM_TIME64
-#  define WORK_DELAY_MAX UINT64_MAX
-#else
-#  define WORK_DELAY_MAX UINT32_MAX
+      if (prio > this_task()->sched_priority)
+        {
+          return prio;
+        }
+    }
 #endif
 
-#ifndef MIN
-#  define MIN(a,b) ((a) < (b) ? (a) : (b))
-#endif
+  return 0;
+}
 
 /****************************************************************************
  * Public Functions
@@ -77,168 +90,148 @@
  *   be called from application level logic.
  *
  * Input Parameters:
- *   wqueue - Describes the work queue to be processed
+ *   wqueue   - Describes the work queue to be processed
+ *   nthreads - The number of worker threads of the work queue
+ *   wndx     - The worker thread index
  *
  * Returned Value:
  *   None
  *
  ****************************************************************************/
 
-void work_process(FAR struct kwork_wqueue_s *wqueue, int wndx)
+void work_process(FAR struct kwork_wqueue_s *wqueue, int nthreads,
+                  int wndx)
 {
-  volatile FAR struct work_s *work;
+  FAR struct tcb_s *rtcb = this_task();
+  FAR struct work_s *work;
+#ifdef CONFIG_WQUEUE_BATCH
+  FAR struct work_batch_s *batch;
+#endif
   worker_t  worker;
   irqstate_t flags;
+  irqstate_t lock;
   FAR void *arg;
-  clock_t elapsed;
-  clock_t remaining;
-  clock_t stick;
-  clock_t ctick;
-  clock_t next;
+  sigset_t set;
+  uint8_t oldprio = 0;
+  uint8_t boost;
+#ifdef CONFIG_WQUEUE_STATS
+  clock_t latency;
+#endif
 
   /* Then process queued work.  We need to keep interrupts disabled while
-   * we process items in the work list.
+   * we process items in the work list.  The work list itself is protected
+   * by the lock of the work queue.  The critical section is held too, from
+   * the time that the worker is marked as not busy until it waits for
+   * SIGWORK:  Signal delivery needs the critical section, so a signal sent
+   * by work_signal() cannot get lost in between.
    */
 
-  next  = WORK_DELAY_MAX;
   flags = enter_critical_section();
+  lock  = spin_lock_save(&wqueue->lock);
 
-  /* Get the time that we started processing the queue in clock ticks. */
-
-  stick = clock_systimer();
-
-  /* And check each entry in the work queue.  Since we have disabled
-   * interrupts we know:  (1) we will not be suspended unless we do
-   * so ourselves, and (2) there will be no changes to the work queue
+  /* Only ready work is in the ready lists.  Delayed work is moved there by
+   * the watchdog of the work queue when its delay expires, so the work is
+   * simply performed in the order of priority, then FIFO.
    */
 
-  work = (FAR struct work_s *)wqueue->q.head;
-  while (work != NULL)
+  while ((work = work_select(wqueue, nthreads, wndx)) != NULL)
     {
-      /* Is this work ready?  It is ready if there is no delay or if
-       * the delay has elapsed. qtime is the time that the work was added
-       * to the work queue.  It will always be greater than or equal to
-       * zero.  Therefore a delay of zero will always execute immediately.
+      /* Extract the work description from the entry (in case the work
+       * instance by the re-used after it has been de-queued).
        */
 
-      ctick   = clock_systimer();
-      elapsed = ctick - work->qtime;
-      if (elapsed >= work->delay)
-        {
-          /* Remove the ready-to-execute work from the list */
-
-          dq_rem((struct dq_entry_s *)work, &wqueue->q);
+      worker = work->worker;
+      arg    = work->arg;
+      DEBUGASSERT(worker != NULL);
 
-          /* Extract the work description from the entry (in case the work
-           * instance by the re-used after it has been de-queued).
-           */
+      /* Mark the work as no longer being queued */
 
-          worker = work->worker;
+      work->worker = NULL;
 
-          /* Check for a race condition where the work may be nullified
-           * before it is removed from the queue.
-           */
+#ifdef CONFIG_WQUEUE_STATS
+      /* qtime holds the time that the work became ready */
 
-          if (worker != NULL)
-            {
-              /* Extract the work argument (before re-enabling interrupts) */
+      latency = clock_systimer() - work->qtime;
+      if (latency > wqueue->stats.maxlatency)
+        {
+          wqueue->stats.maxlatency = latency;
+        }
 
-              arg = work->arg;
+      wqueue->stats.sumlatency += latency;
+      wqueue->stats.nperformed++;
+#endif
 
-              /* Mark the work as no longer being queued */
+#ifdef CONFIG_WQUEUE_BATCH
+      /* The batch is released after the work has been performed */
 
-              work->worker = NULL;
+      batch = work->batch;
+      work->batch = NULL;
+#endif
 
-              /* Do the work.  Re-enable interrupts while the work is being
-               * performed... we don't have any idea how long this will take!
-               */
+      /* Work of a priority above that of this worker thread is performed
+       * at that priority.  Only this worker thread is boosted.
+       */
 
-              leave_critical_section(flags);
-              worker(arg);
+      boost = work_boostprio(wqueue, work->prio);
 
-              /* Now, unfortunately, since we re-enabled interrupts we don't
-               * know the state of the work list and we will have to start
-               * back at the head of the list.
-               */
+      /* Do the work.  Re-enable interrupts while the work is being
+       * performed... we don't have any idea how long this will take!
+       */
 
-              flags = enter_critical_section();
-              work  = (FAR struct work_s *)wqueue->q.head;
-            }
-          else
-            {
-              /* Cancelled.. Just move to the next work in the list with
-               * interrupts still disabled.
-               */
+      spin_unlock_restore(&wqueue->lock, lock);
 
-              work = (FAR struct work_s *)work->dq.flink;
-            }
-        }
-      else /* elapsed < work->delay */
+      if (boost > 0)
         {
-          /* This one is not ready.
-           *
-           * NOTE that elapsed is relative to the current time,
-           * not the time of beginning of this queue processing pass.
-           * So it may need an adjustment.
-           */
+          oldprio = rtcb->sched_priority;
+          nxsched_setpriority(rtcb, boost);
+        }
 
-          elapsed += (ctick - stick);
-          if (elapsed > work->delay)
-            {
-              /* The delay has expired while we are processing */
+      leave_critical_section(flags);
+      worker(arg);
 
-              elapsed = work->delay;
-            }
+      /* Drop the boost unless the priority was changed by the work */
 
-          /* Will it be ready before the next scheduled wakeup interval? */
+      if (boost > 0 && rtcb->sched_priority == boost)
+        {
+          nxsched_setpriority(rtcb, oldprio);
+        }
 
-          remaining = work->delay - elapsed;
-          if (remaining < next)
-            {
-              /* Yes.. Then schedule to wake up when the work is ready */
+      /* Now, unfortunately, since we re-enabled interrupts we don't
+       * know the state of the work list and we will have to start
+       * back at the head of the list.
+       */
 
-              next = remaining;
-            }
+      flags = enter_critical_section();
+      lock  = spin_lock_save(&wqueue->lock);
 
-          /* Then try the next in the list. */
+#ifdef CONFIG_WQUEUE_BATCH
+      /* If this completes the batch, its completion callback is ready and
+       * will be found by this worker.
+       */
 
-          work = (FAR struct work_s *)work->dq.flink;
+      if (batch != NULL)
+        {
+          work_batch_release(wqueue, batch);
         }
+#endif
     }
 
-  /* When multiple worker threads are created for this work queue, only
-   * thread 0 (wndx = 0) will monitor the unexpired works.
-   *
-   * Other worker threads (wndx > 0) just process no-delay or expired
-   * works, then sleep. The unexpired works are left in the queue. They
-   * will be handled by thread 0 when it finishes current work and iterate
-   * over the queue again.
+  /* The worker is marked as not busy before the lock is released so that
+   * work queued after this point is signalled.
    */
 
-  if (wndx > 0 || next == WORK_DELAY_MAX)
-    {
-      sigset_t set;
-
-      /* Wait indefinitely until signalled with SIGWORK */
+  wqueue->worker[wndx].busy = false;
+  spin_unlock_restore(&wqueue->lock, lock);
 
-      sigemptyset(&set);
-      sigaddset(&set, SIGWORK);
+  /* Wait indefinitely until signalled with SIGWORK.  This happens when
+   * work is queued without a delay or when delayed work expires.
+   */
 
-      wqueue->worker[wndx].busy = false;
-      DEBUGVERIFY(nxsig_waitinfo(&set, NULL));
-      wqueue->worker[wndx].busy = true;
-    }
-  else
-    {
-      /* Wait a while to check the work list.  We will wait here until
-       * either the time elapses or until we are awakened by a signal.
-       * Interrupts will be re-enabled while we wait.
-       */
+  sigemptyset(&set);
+  sigaddset(&set, SIGWORK);
 
-      wqueue->worker[wndx].busy = false;
-      nxsig_usleep(next * USEC_PER_TICK);
-      wqueue->worker[wndx].busy = true;
-    }
+  DEBUGVERIFY(nxsig_waitinfo(&set, NULL));
+  wqueue->worker[wndx].busy = true;
 
   leave_critical_section(flags);
 }
@@ -39,9 +39,48 @@
 #ifdef CONFIG_SCHED_WORKQUEUE
 
 /****************************************************************************
- * Private Functions
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_queue_get
+ *
+ * Description:
+ *   Return the work queue and the number of its worker threads for a work
+ *   queue ID.
+ *
+ * Input Parameters:
+ *   qid      - The work queue ID (index)
+ *   nthreads - Location to return the number of worker threads
+ *
+ * Returned Value:
+ *   The work queue or NULL if the work queue ID is not valid.
+ *
  ****************************************************************************/
 
+FAR struct kwork_wqueue_s *work_queue_get(int qid, FAR int *nthreads)
+{
+#ifdef CONFIG_SCHED_HPWORK
+  if (qid == HPWORK)
+    {
+      *nthreads = CONFIG_SCHED_HPNTHREADS;
+      return (FAR struct kwork_wqueue_s *)&g_hpwork;
+    }
+  else
+#endif
+#ifdef CONFIG_SCHED_LPWORK
+  if (qid == LPWORK)
+    {
+      *nthreads = CONFIG_SCHED_LPNTHREADS;
+      return (FAR struct kwork_wqueue_s *)&g_lpwork;
+    }
+  else
+#endif
+    {
+      return NULL;
+    }
+}
+
 /****************************************************************************
  * Name: work_qqueue
  *
@@ -56,26 +95,35 @@
  *   from the queue, or (2) work_cancel() has been called to cancel the work
  *   and remove it from the work queue.
  *
+ *   Ready work queued by a worker thread of the same work queue is added to
+ *   the deque of that worker if CONFIG_WQUEUE_STEALING is enabled.
+ *
  * Input Parameters:
- *   qid    - The work queue ID (index)
- *   work   - The work structure to queue
- *   worker - The worker callback to be invoked.  The callback will invoked
- *            on the worker thread of execution.
- *   arg    - The argument that will be passed to the workder callback when
- *            int is invoked.
- *   delay  - Delay (in clock ticks) from the time queue until the worker
- *            is invoked. Zero means to perform the work immediately.
+ *   wqueue   - The work queue
+ *   qid      - The work queue ID (index)
+ *   nthreads - The number of worker threads of the work queue
+ *   work     - The work structure to queue
+ *   worker   - The worker callback to be invoked.  The callback will
+ *              invoked on the worker thread of execution.
+ *   arg      - The argument that will be passed to the workder callback
+ *              when int is invoked.
+ *   delay    - Delay (in clock ticks) from the time queue until the worker
+ *              is invoked. Zero means to perform the work immediately.
+ *   prio     - The priority of the work among ready work
  *
  * Returned Value:
- *   None
+ *   true if work became ready and a worker thread must be signalled.
  *
  ****************************************************************************/
 
-static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
-                        FAR struct work_s *work, worker_t worker,
-                        FAR void *arg, clock_t delay)
+bool work_qqueue(FAR struct kwork_wqueue_s *wqueue, int qid, int nthreads,
+                 FAR struct work_s *work, worker_t worker, FAR void *arg,
+                 clock_t delay, uint8_t prio)
 {
   irqstate_t flags;
+  irqstate_t lock;
+  bool ready = false;
+  bool first;
 
   DEBUGASSERT(work != NULL && worker != NULL);
 
@@ -83,38 +131,103 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
    * task logic or ifrom nterrupt handling logic.
    */
 
-  flags = enter_critical_section();
-
-  /* Is there already pending work? */
-
-  if (work->worker != NULL)
+  if (delay == 0)
     {
-      /* Remove the entry from the work queue.  It will re requeued at the
-       * end of the work queue.
+      int wndx = work_self(wqueue, nthreads);
+
+      /* Work that is ready needs only the lock of this work queue, not the
+       * global critical section.  If the work is already pending, it is
+       * removed and requeued at the end of the work queue.  A worker is
+       * signalled anyway, so it does not matter whether this completes
+       * the batch that the work was part of.
        */
 
-      dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+      lock = spin_lock_save(&wqueue->lock);
+      if (work_unlink(wqueue, work))
+        {
+          ready = work_batch_leave(wqueue, work);
+        }
+
+      work->worker = worker;  /* Work callback. non-NULL means queued */
+      work->arg    = arg;     /* Callback argument */
+      work->prio   = prio;    /* Priority among ready work */
+
+      work_ready(wqueue, work, wndx);
+      spin_unlock_restore(&wqueue->lock, lock);
+      return true;
     }
 
-  /* Initialize the work structure. */
+  /* Delayed work is parked until it expires.  The critical section is
+   * needed to restart the watchdog if this work is the first to expire.
+   */
 
-  work->worker = worker;           /* Work callback. non-NULL means queued */
-  work->arg    = arg;              /* Callback argument */
-  work->delay  = delay;            /* Delay until work performed */
+  flags = enter_critical_section();
+  lock  = spin_lock_save(&wqueue->lock);
+  if (work_unlink(wqueue, work))
+    {
+      ready = work_batch_leave(wqueue, work);
+    }
 
-  /* Now, time-tag that entry and put it in the work queue */
+  work->worker = worker;
+  work->arg    = arg;
+  work->prio   = prio;
 
-  work->qtime  = clock_systimer(); /* Time work queued */
+  first = work_park(wqueue, work, delay);
+  spin_unlock_restore(&wqueue->lock, lock);
 
-  dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+  if (first)
+    {
+      work_timer_start(wqueue, qid);
+    }
 
   leave_critical_section(flags);
+  return ready;
 }
 
 /****************************************************************************
- * Public Functions
+ * Name: work_queue_prio
+ *
+ * Description:
+ *   Queue kernel-mode work with a priority.  See include/nuttx/wqueue.h.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID (index)
+ *   work   - The work structure to queue
+ *   worker - The worker callback to be invoked.  The callback will invoked
+ *            on the worker thread of execution.
+ *   arg    - The argument that will be passed to the workder callback when
+ *            int is invoked.
+ *   delay  - Delay (in clock ticks) from the time queue until the worker
+ *            is invoked. Zero means to perform the work immediately.
+ *   prio   - The priority of the work among ready work
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
  ****************************************************************************/
 
+int work_queue_prio(int qid, FAR struct work_s *work, worker_t worker,
+                    FAR void *arg, clock_t delay, uint8_t prio)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+  int nthreads;
+
+  wqueue = work_queue_get(qid, &nthreads);
+  if (wqueue == NULL)
+    {
+      return -EINVAL;
+    }
+
+  /* Queue the new work and wake up a worker thread if it is ready */
+
+  if (work_qqueue(wqueue, qid, nthreads, work, worker, arg, delay, prio))
+    {
+      return work_signal(qid);
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: work_queue
  *
@@ -148,33 +261,7 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
 int work_queue(int qid, FAR struct work_s *work, worker_t worker,
                FAR void *arg, clock_t delay)
 {
-  /* Queue the new work */
-
-#ifdef CONFIG_SCHED_HPWORK
-  if (qid == HPWORK)
-    {
-      /* Queue high priority work */
-
-      work_qqueue((FAR struct kwork_wqueue_s *)&g_hpwork, work, worker,
-                  arg, delay);
-      return work_signal(HPWORK);
-    }
-  else
-#endif
-#ifdef CONFIG_SCHED_LPWORK
-  if (qid == LPWORK)
-    {
-      /* Queue low priority work */
-
-      work_qqueue((FAR struct kwork_wqueue_s *)&g_lpwork, work, worker,
-                  arg, delay);
-      return work_signal(LPWORK);
-    }
-  else
-#endif
-    {
-      return -EINVAL;
-    }
+  return work_queue_prio(qid, work, worker, arg, delay, 0);
 }
 
 #endif /* CONFIG_SCHED_WORKQUEUE */
@@ -0,0 +1,309 @@
+/****************************************************************************
+ * sched/wqueue/kwork_ready.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <queue.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
+
+#include "wqueue/wqueue.h"
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_readylist
+ *
+ * Description:
+ *   Return the ready list that holds (or will hold) ready work.
+ *
+ ****************************************************************************/
+
+static inline FAR dq_queue_t *
+work_readylist(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *work)
+{
+#ifdef CONFIG_WQUEUE_STEALING
+  if (work->wndx >= 0)
+    {
+      return &wqueue->worker[work->wndx].q;
+    }
+#endif
+
+  return &wqueue->q;
+}
+
+/****************************************************************************
+ * Name: work_insert
+ *
+ * Description:
+ *   Add work to a ready list, behind all work of the same or a higher
+ *   priority.  The search starts at the tail because most work is queued
+ *   with the default priority of zero, in which case the work is simply
+ *   appended.
+ *
+ ****************************************************************************/
+
+static void work_insert(FAR dq_queue_t *list, FAR struct work_s *work)
+{
+  FAR struct work_s *prev = (FAR struct work_s *)list->tail;
+
+  while (prev != NULL && prev->prio < work->prio)
+    {
+      prev = (FAR struct work_s *)prev->dq.blink;
+    }
+
+  if (prev == NULL)
+    {
+      dq_addfirst((FAR dq_entry_t *)work, list);
+    }
+  else
+    {
+      dq_addafter((FAR dq_entry_t *)prev, (FAR dq_entry_t *)work, list);
+    }
+}
+
+/****************************************************************************
+ * Name: work_better
+ *
+ * Description:
+ *   Return true if the work at the head of a ready list must be performed
+ *   before the best work found so far.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WQUEUE_STEALING
+static inline bool work_better(FAR struct work_s *work,
+                               FAR struct work_s *best)
+{
+  return work != NULL && (best == NULL || work->prio > best->prio);
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_ready
+ *
+ * Description:
+ *   Add work to a ready list in the order of its priority.  The time that
+ *   the work became ready is kept in qtime; a delay of zero marks the work
+ *   as ready.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue
+ *   work   - The work that is ready.  worker, arg and prio are set.
+ *   wndx   - The index of the worker whose deque receives the work, or -1
+ *            for the ready queue that is shared by all workers.  Always -1
+ *            without CONFIG_WQUEUE_STEALING.
+ *
+ * Assumptions:
+ *   The lock of the work queue is held.
+ *
+ ****************************************************************************/
+
+void work_ready(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *work,
+                int wndx)
+{
+  work->qtime = clock_systimer();
+  work->delay = 0;
+#ifdef CONFIG_WQUEUE_STEALING
+  work->wndx  = wndx;
+#else
+  DEBUGASSERT(wndx < 0);
+#endif
+
+  work_insert(work_readylist(wqueue, work), work);
+
+#ifdef CONFIG_WQUEUE_STATS
+  if (++wqueue->stats.nready > wqueue->stats.maxready)
+    {
+      wqueue->stats.maxready = wqueue->stats.nready;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: work_select
+ *
+ * Description:
+ *   Remove the next work to be performed by a worker thread from the ready
+ *   lists.
+ *
+ *   With CONFIG_WQUEUE_STEALING, the worker takes the work of the higher
+ *   priority at the head of its own deque or of the shared ready queue.
+ *   The shared queue wins ties, so that a worker that keeps requeuing work
+ *   to itself cannot starve the work queued by others.  Both are FIFO, and
+ *   the worker only steals if both are empty:  It then takes the work of
+ *   the highest priority at the head of the deques of the other workers,
+ *   starting with the next worker so that the victims rotate.
+ *
+ * Input Parameters:
+ *   wqueue   - The work queue
+ *   nthreads - The number of worker threads of the work queue
+ *   wndx     - The index of the calling worker thread
+ *
+ * Returned Value:
+ *   The work or NULL if no work is ready.
+ *
+ * Assumptions:
+ *   The lock of the work queue is held.
+ *
+ ****************************************************************************/
+
+FAR struct work_s *work_select(FAR struct kwork_wqueue_s *wqueue,
+                               int nthreads, int wndx)
+{
+  FAR struct work_s *work = (FAR struct work_s *)dq_peek(&wqueue->q);
+  FAR dq_queue_t *list = &wqueue->q;
+#ifdef CONFIG_WQUEUE_STEALING
+  FAR struct work_s *head;
+  FAR dq_queue_t *victim;
+  int i;
+
+  victim = &wqueue->worker[wndx].q;
+  head   = (FAR struct work_s *)dq_peek(victim);
+
+  if (work_better(head, work))
+    {
+      work = head;
+      list = victim;
+    }
+
+  for (i = 1; work == NULL && i < nthreads; i++)
+    {
+      victim = &wqueue->worker[(wndx + i) % nthreads].q;
+      head   = (FAR struct work_s *)dq_peek(victim);
+
+      if (work_better(head, work))
+        {
+          work = head;
+          list = victim;
+        }
+    }
+#else
+  UNUSED(nthreads);
+  UNUSED(wndx);
+#endif
+
+  if (work != NULL)
+    {
+      dq_rem((FAR dq_entry_t *)work, list);
+#ifdef CONFIG_WQUEUE_STATS
+      wqueue->stats.nready--;
+#endif
+    }
+
+  return work;
+}
+
+/****************************************************************************
+ * Name: work_unlink
+ *
+ * Description:
+ *   Remove work from the ready lists or from the delayed list, whichever
+ *   it is in, and mark it as available.  The watchdog is not restarted if
+ *   the first delayed work is removed:  It then expires early and is
+ *   restarted for the new first work.
+ *
+ * Returned Value:
+ *   true if the work was queued.
+ *
+ * Assumptions:
+ *   The lock of the work queue is held.
+ *
+ ****************************************************************************/
+
+bool work_unlink(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *work)
+{
+  if (work->worker == NULL)
+    {
+      return false;
+    }
+
+  if (work->delay != 0)
+    {
+      dq_rem((FAR dq_entry_t *)work, &wqueue->delayed);
+#ifdef CONFIG_WQUEUE_STATS
+      wqueue->stats.ndelayed--;
+#endif
+    }
+  else
+    {
+      dq_rem((FAR dq_entry_t *)work, work_readylist(wqueue, work));
+#ifdef CONFIG_WQUEUE_STATS
+      wqueue->stats.nready--;
+#endif
+    }
+
+  work->worker = NULL;
+  return true;
+}
+
+/****************************************************************************
+ * Name: work_self
+ *
+ * Description:
+ *   Return the index of the calling worker thread in a work queue, or -1 if
+ *   the caller is not one of its worker threads.  Work queued from an
+ *   interrupt handler is never attributed to the interrupted worker.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WQUEUE_STEALING
+int work_self(FAR struct kwork_wqueue_s *wqueue, int nthreads)
+{
+  pid_t me;
+  int wndx;
+
+  if (up_interrupt_context())
+    {
+      return -1;
+    }
+
+  me = getpid();
+  for (wndx = 0; wndx < nthreads; wndx++)
+    {
+      if (wqueue->worker[wndx].pid == me)
+        {
+          return wndx;
+        }
+    }
+
+  return -1;
+}
+#endif
+
+#endif /* CONFIG_SCHED_WORKQUEUE */
@@ -0,0 +1,246 @@
+/****************************************************************************
+ * sched/wqueue/kwork_timer.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <queue.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/wdog.h>
+#include <nuttx/wqueue.h>
+
+#include "wqueue/wqueue.h"
+
+#ifdef CONFIG_SCHED_WORKQUEUE
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void work_timer_expiry(int argc, wdparm_t arg1, ...);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_expiration
+ *
+ * Description:
+ *   Return the time at which delayed work expires.
+ *
+ ****************************************************************************/
+
+static inline clock_t work_expiration(FAR struct work_s *work)
+{
+  return work->qtime + work->delay;
+}
+
+/****************************************************************************
+ * Name: work_timer_expiry
+ *
+ * Description:
+ *   The watchdog handler of a work queue.  Move the delayed work that has
+ *   expired to the ready queue, restart the watchdog for the rest and wake
+ *   up a worker thread.
+ *
+ * Input Parameters:
+ *   argc - The number of parameters (2)
+ *   arg1 - The work queue
+ *   ...  - The work queue ID
+ *
+ * Assumptions:
+ *   Called from the timer interrupt handler within the critical section.
+ *
+ ****************************************************************************/
+
+static void work_timer_expiry(int argc, wdparm_t arg1, ...)
+{
+  FAR struct kwork_wqueue_s *wqueue = (FAR struct kwork_wqueue_s *)arg1;
+  FAR struct work_s *work;
+  irqstate_t lock;
+  clock_t now;
+  bool ready = false;
+  va_list ap;
+  int qid;
+
+  DEBUGASSERT(argc == 2);
+
+  va_start(ap, arg1);
+  qid = (int)va_arg(ap, wdparm_t);
+  va_end(ap);
+
+  now  = clock_systimer();
+  lock = spin_lock_save(&wqueue->lock);
+
+  /* The delayed list is in the order of expiration, so only the work at
+   * its head needs to be examined.
+   */
+
+  while ((work = (FAR struct work_s *)wqueue->delayed.head) != NULL &&
+         now - work->qtime >= work->delay)
+    {
+      dq_rem((FAR dq_entry_t *)work, &wqueue->delayed);
+#ifdef CONFIG_WQUEUE_STATS
+      wqueue->stats.ndelayed--;
+#endif
+      work_ready(wqueue, work, -1);
+      ready = true;
+    }
+
+  spin_unlock_restore(&wqueue->lock, lock);
+
+  work_timer_start(wqueue, qid);
+  if (ready)
+    {
+      work_signal(qid);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_park
+ *
+ * Description:
+ *   Add work to the delayed list of a work queue, keeping the list in the
+ *   order of expiration.  Work that expires at the same time is kept in
+ *   FIFO order.  The search starts at the tail because most work is queued
+ *   with the same delay as earlier work.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue
+ *   work   - The work to park.  worker and arg are already set.
+ *   delay  - Delay (in clock ticks) until the work is ready.  Not zero.
+ *
+ * Returned Value:
+ *   true if the work is now the first to expire and the watchdog must be
+ *   restarted.
+ *
+ * Assumptions:
+ *   The lock of the work queue is held.
+ *
+ ****************************************************************************/
+
+bool work_park(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *work,
+               clock_t delay)
+{
+  FAR struct work_s *prev;
+  clock_t expiration;
+
+  DEBUGASSERT(delay != 0);
+
+  work->qtime = clock_systimer();
+  work->delay = delay;
+  expiration  = work_expiration(work);
+
+  prev = (FAR struct work_s *)wqueue->delayed.tail;
+  while (prev != NULL && (sclock_t)(work_expiration(prev) - expiration) > 0)
+    {
+      prev = (FAR struct work_s *)prev->dq.blink;
+    }
+
+  if (prev == NULL)
+    {
+      dq_addfirst((FAR dq_entry_t *)work, &wqueue->delayed);
+    }
+  else
+    {
+      dq_addafter((FAR dq_entry_t *)prev, (FAR dq_entry_t *)work,
+                  &wqueue->delayed);
+    }
+
+#ifdef CONFIG_WQUEUE_STATS
+  wqueue->stats.ndelayed++;
+#endif
+
+  return prev == NULL;
+}
+
+/****************************************************************************
+ * Name: work_timer_start
+ *
+ * Description:
+ *   Start the watchdog of a work queue for the first delayed work, or stop
+ *   it if there is no delayed work.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue
+ *   qid    - The work queue ID
+ *
+ * Assumptions:
+ *   Called within the critical section, which serializes the restarts of
+ *   the watchdog.  The lock of the work queue is not held.
+ *
+ ****************************************************************************/
+
+void work_timer_start(FAR struct kwork_wqueue_s *wqueue, int qid)
+{
+  FAR struct work_s *work;
+  irqstate_t lock;
+  clock_t elapsed;
+  clock_t delay = 0;
+
+  lock = spin_lock_save(&wqueue->lock);
+  work = (FAR struct work_s *)wqueue->delayed.head;
+  if (work != NULL)
+    {
+      elapsed = clock_systimer() - work->qtime;
+      if (elapsed < work->delay)
+        {
+          delay = work->delay - elapsed;
+        }
+    }
+
+  spin_unlock_restore(&wqueue->lock, lock);
+
+  if (work == NULL)
+    {
+      if (WDOG_ISACTIVE(&wqueue->timer))
+        {
+          wd_cancel(&wqueue->timer);
+        }
+    }
+  else
+    {
+      if (delay > INT32_MAX)
+        {
+          /* Expire early and restart for the rest of the delay */
+
+          delay = INT32_MAX;
+        }
+
+      wd_start(&wqueue->timer, (int32_t)delay, work_timer_expiry, 2,
+               (wdparm_t)wqueue, (wdparm_t)qid);
+    }
+}
+
+#endif /* CONFIG_SCHED_WORKQUEUE */
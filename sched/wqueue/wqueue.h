@@ -31,6 +31,9 @@
 #include <queue.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/wdog.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/spinlock.h>
 
 #ifdef CONFIG_SCHED_WORKQUEUE
 
@@ -47,19 +50,54 @@
  * Public Type Definitions
  ****************************************************************************/
 
-/* This represents one worker */
+/* This represents one worker.  With CONFIG_WQUEUE_STEALING, work that a
+ * worker thread queues to its own work queue is kept in the deque of that
+ * worker; idle worker threads steal from the deques of the others.
+ */
 
 struct kworker_s
 {
   pid_t             pid;    /* The task ID of the worker thread */
   volatile bool     busy;   /* True: Worker is not available */
+#ifdef CONFIG_WQUEUE_STEALING
+  struct dq_queue_s q;      /* Ready work queued by this worker */
+#endif
+};
+
+/* Backlog and latency statistics of one kernel-mode work queue.  The
+ * latency is the time from when work becomes ready until a worker thread
+ * starts to perform it.
+ */
+
+#ifdef CONFIG_WQUEUE_STATS
+struct kwork_stats_s
+{
+  uint32_t nready;      /* Work ready to be performed */
+  uint32_t ndelayed;    /* Work waiting for its delay to expire */
+  uint32_t maxready;    /* Largest nready since the last report */
+  uint32_t nperformed;  /* Work performed since the last report */
+  clock_t  maxlatency;  /* Longest latency since the last report */
+  clock_t  sumlatency;  /* Sum of the latencies since the last report */
 };
+#endif
 
-/* This structure defines the state of one kernel-mode work queue */
+/* This structure defines the state of one kernel-mode work queue.  Only
+ * ready work is in q.  Delayed work is parked in the delayed list until
+ * the watchdog timer moves it to q, so the worker threads never search
+ * for expired work.
+ */
 
 struct kwork_wqueue_s
 {
-  struct dq_queue_s q;         /* The queue of pending work */
+  struct dq_queue_s q;         /* The queue of ready work */
+#ifdef CONFIG_SPINLOCK
+  spinlock_t        lock;      /* Protects q, delayed and the busy flags */
+#endif
+  struct dq_queue_s delayed;   /* Delayed work in order of expiration */
+  struct wdog_s     timer;     /* Expires with the first delayed work */
+#ifdef CONFIG_WQUEUE_STATS
+  struct kwork_stats_s stats;  /* Backlog and latency statistics */
+#endif
   struct kworker_s  worker[1]; /* Describes a worker thread */
 };
 
@@ -70,7 +108,15 @@ struct kwork_wqueue_s
 #ifdef CONFIG_SCHED_HPWORK
 struct hp_wqueue_s
 {
-  struct dq_queue_s q;         /* The queue of pending work */
+  struct dq_queue_s q;         /* The queue of ready work */
+#ifdef CONFIG_SPINLOCK
+  spinlock_t        lock;      /* Protects q, delayed and the busy flags */
+#endif
+  struct dq_queue_s delayed;   /* Delayed work in order of expiration */
+  struct wdog_s     timer;     /* Expires with the first delayed work */
+#ifdef CONFIG_WQUEUE_STATS
+  struct kwork_stats_s stats;  /* Backlog and latency statistics */
+#endif
 
   /* Describes each thread in the high priority queue's thread pool */
 
@@ -85,7 +131,15 @@ struct hp_wqueue_s
 #ifdef CONFIG_SCHED_LPWORK
 struct lp_wqueue_s
 {
-  struct dq_queue_s q;      /* The queue of pending work */
+  struct dq_queue_s q;         /* The queue of ready work */
+#ifdef CONFIG_SPINLOCK
+  spinlock_t        lock;      /* Protects q, delayed and the busy flags */
+#endif
+  struct dq_queue_s delayed;   /* Delayed work in order of expiration */
+  struct wdog_s     timer;     /* Expires with the first delayed work */
+#ifdef CONFIG_WQUEUE_STATS
+  struct kwork_stats_s stats;  /* Backlog and latency statistics */
+#endif
 
   /* Describes each thread in the low priority queue's thread pool */
 
@@ -161,15 +215,136 @@ int work_lpstart(void);
  *   be called from application level logic.
  *
  * Input Parameters:
- *   wqueue - Describes the work queue to be processed
- *   wndx   - The worker thread index
+ *   wqueue   - Describes the work queue to be processed
+ *   nthreads - The number of worker threads of the work queue
+ *   wndx     - The worker thread index
  *
  * Returned Value:
  *   None
  *
  ****************************************************************************/
 
-void work_process(FAR struct kwork_wqueue_s *wqueue, int wndx);
+void work_process(FAR struct kwork_wqueue_s *wqueue, int nthreads,
+                  int wndx);
+
+/****************************************************************************
+ * Name: work_ready, work_select, work_unlink
+ *
+ * Description:
+ *   Add work to a ready list, remove the next work to perform from the
+ *   ready lists or remove work from whichever list it is in.  See
+ *   sched/wqueue/kwork_ready.c.
+ *
+ * Assumptions:
+ *   The lock of the work queue is held.
+ *
+ ****************************************************************************/
+
+void work_ready(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *work,
+                int wndx);
+FAR struct work_s *work_select(FAR struct kwork_wqueue_s *wqueue,
+                               int nthreads, int wndx);
+bool work_unlink(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *work);
+
+/****************************************************************************
+ * Name: work_self
+ *
+ * Description:
+ *   Return the index of the calling worker thread in a work queue, or -1 if
+ *   the caller is not one of its worker threads.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WQUEUE_STEALING
+int work_self(FAR struct kwork_wqueue_s *wqueue, int nthreads);
+#else
+#  define work_self(wqueue, nthreads) (-1)
+#endif
+
+/****************************************************************************
+ * Name: work_park
+ *
+ * Description:
+ *   Add work to the delayed list of a work queue.  See
+ *   sched/wqueue/kwork_timer.c.
+ *
+ * Assumptions:
+ *   The lock of the work queue is held.
+ *
+ ****************************************************************************/
+
+bool work_park(FAR struct kwork_wqueue_s *wqueue, FAR struct work_s *work,
+               clock_t delay);
+
+/****************************************************************************
+ * Name: work_timer_start
+ *
+ * Description:
+ *   Start the watchdog of a work queue for the first delayed work, or stop
+ *   it if there is no delayed work.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue
+ *   qid    - The work queue ID
+ *
+ * Assumptions:
+ *   Called within the critical section.  The lock of the work queue is not
+ *   held.
+ *
+ ****************************************************************************/
+
+void work_timer_start(FAR struct kwork_wqueue_s *wqueue, int qid);
+
+/****************************************************************************
+ * Name: work_qqueue
+ *
+ * Description:
+ *   Queue work on a work queue.  See sched/wqueue/kwork_queue.c.
+ *
+ * Returned Value:
+ *   true if work became ready and a worker thread must be signalled.
+ *
+ ****************************************************************************/
+
+bool work_qqueue(FAR struct kwork_wqueue_s *wqueue, int qid, int nthreads,
+                 FAR struct work_s *work, worker_t worker, FAR void *arg,
+                 clock_t delay, uint8_t prio);
+
+/****************************************************************************
+ * Name: work_queue_get
+ *
+ * Description:
+ *   Return the work queue and the number of its worker threads for a work
+ *   queue ID, or NULL if the ID is not valid.
+ *
+ ****************************************************************************/
+
+FAR struct kwork_wqueue_s *work_queue_get(int qid, FAR int *nthreads);
+
+/****************************************************************************
+ * Name: work_batch_leave, work_batch_release
+ *
+ * Description:
+ *   Remove unlinked work from its batch, or drop one reference to a batch.
+ *   If this completes the batch, its completion callback is made ready.
+ *   See sched/wqueue/kwork_batch.c.
+ *
+ * Returned Value:
+ *   true if the completion became ready and a worker must be signalled.
+ *
+ * Assumptions:
+ *   The lock of the work queue is held.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WQUEUE_BATCH
+bool work_batch_leave(FAR struct kwork_wqueue_s *wqueue,
+                      FAR struct work_s *work);
+bool work_batch_release(FAR struct kwork_wqueue_s *wqueue,
+                        FAR struct work_batch_s *batch);
+#else
+#  define work_batch_leave(wqueue, work) (false)
+#endif
 
 /****************************************************************************
  * Name: work_notifier_initialize